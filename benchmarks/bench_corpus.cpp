@@ -0,0 +1,144 @@
+/* bench_corpus: the fuzz regression corpus (fuzz/corpus/read_state) as a throughput run
+- every input through the fuzz target (parse, batch decode, frame decoder, input_cycle),
+repeated, at every SIMD level: ns per input and MB/s
+- then the motor_temperature values the corpus decodes to, by float class, through a
+typical downstream statistic (EWMA of mean and variance): a class far slower than
+"normal" is a slow path the decoder lets through (denormals on x86 take microcode assists),
+and the same after a FloatPolicy (flush denormals, replace NaN/inf) ran over them
+
+usage: bench_corpus [corpus directory] [rounds]
+*/
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+#include "cpu_dispatch.hpp"
+#include "data_structuring.hpp"
+#include "simd_kernels.hpp"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+
+namespace {
+
+std::vector<std::vector<uint8_t>> load_corpus(const std::string& directory) {
+    std::vector<std::vector<uint8_t>> inputs;
+    for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+        std::ifstream in(entry.path(), std::ios::binary);
+        inputs.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+    return inputs;
+}
+
+const char* class_name(int category) {
+    switch (category) {
+    case FP_NORMAL: return "normal";
+    case FP_SUBNORMAL: return "denormal";
+    case FP_ZERO: return "zero";
+    case FP_INFINITE: return "infinite";
+    case FP_NAN: return "nan";
+    }
+    return "?";
+}
+
+//what statistics code does with each new sample; volatile sink keeps it from being folded
+double ewma_statistics(const std::vector<float>& samples, size_t rounds) {
+    float mean = 0.0f;
+    float variance = 0.0f;
+    for (size_t r = 0; r < rounds; ++r) {
+        for (float x : samples) {
+            const float delta = x - mean;
+            mean += 0.01f * delta;
+            variance = 0.99f * (variance + 0.01f * delta * delta);
+        }
+    }
+    volatile float sink = mean + variance;
+    (void)sink;
+    return static_cast<double>(mean);
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    const std::string directory = argc > 1 ? argv[1] : STAR_FUZZ_CORPUS_DIR;
+    const size_t rounds = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 2000;
+
+    const std::vector<std::vector<uint8_t>> corpus = load_corpus(directory);
+    size_t bytes = 0;
+    for (const auto& input : corpus) {
+        bytes += input.size();
+    }
+    std::printf("%zu inputs, %zu bytes from %s\n", corpus.size(), bytes, directory.c_str());
+    if (corpus.empty()) {
+        return 1;
+    }
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel level : levels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            for (const auto& input : corpus) {
+                LLVMFuzzerTestOneInput(input.data(), input.size());
+            }
+        }
+        const double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        std::printf("%-8s %8.1f ns/input  %8.1f MB/s\n", simd_level_name(level),
+                    ns / static_cast<double>(rounds * corpus.size()), static_cast<double>(bytes * rounds) * 1e3 / ns);
+    }
+    reset_simd_level();
+
+    //temperatures of every whole slave frame in the corpus, by class
+    ReadState parser;
+    std::vector<float> by_class[5];
+    const int categories[] = {FP_NORMAL, FP_SUBNORMAL, FP_ZERO, FP_INFINITE, FP_NAN};
+    for (const auto& input : corpus) {
+        for (size_t offset = 0; offset + PdoInputLayout::size <= input.size(); offset += PdoInputLayout::size) {
+            const float value = parser.parse(input.data() + offset, PdoInputLayout::size).motor_temperature;
+            for (size_t c = 0; c < 5; ++c) {
+                if (std::fpclassify(value) == categories[c]) {
+                    by_class[c].push_back(value);
+                }
+            }
+        }
+    }
+    FloatPolicy policy;
+    policy.flush_denormals = true;
+    policy.replace_non_finite = true;
+    std::printf("downstream EWMA statistics on the decoded motor_temperature (raw / sanitized):\n");
+    for (size_t c = 0; c < 5; ++c) {
+        if (by_class[c].empty()) {
+            continue;
+        }
+        std::vector<float> samples(4096);
+        for (size_t i = 0; i < samples.size(); ++i) {
+            samples[i] = by_class[c][i % by_class[c].size()];
+        }
+        const size_t passes = rounds / 10 + 1;
+        auto start = std::chrono::steady_clock::now();
+        ewma_statistics(samples, passes);
+        const double raw_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<float> last_good(samples.size(), 40.0f);
+        std::vector<uint8_t> flags(samples.size());
+        sanitize_f32(samples.data(), last_good.data(), flags.data(), kInvalidMotorTemperature, samples.size(), policy);
+        start = std::chrono::steady_clock::now();
+        ewma_statistics(samples, passes);
+        const double clean_ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+        const double per_sample = static_cast<double>(samples.size() * passes);
+        std::printf("  %-9s %3zu values  %6.2f / %6.2f ns/sample\n", class_name(categories[c]), by_class[c].size(),
+                    raw_ns / per_sample, clean_ns / per_sample);
+    }
+    return 0;
+}
@@ -0,0 +1,200 @@
+/* bench_kernels:
+- times synthetic frame generation (LoadGenerator), StarManager input (per slave vs
+whole cycle), batch decode, change detection (frames, and error-code edges),
+the SoA reductions, float sanitization, fixed-point columns and
+digital I/O bitset extraction (pext with BMI2 at AVX2 and above)
+- runs every kernel once per SIMD level this CPU supports (force_simd_level)
+- prints ns per call and ns per item, one row per kernel and level
+
+usage: bench_kernels [slaves] [iterations]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "cpu_dispatch.hpp"
+#include "data_structuring.hpp"
+#include "load_generator.hpp"
+#include "simd_kernels.hpp"
+#include "slave_columns.hpp"
+#include "Star_Manager.hpp"
+
+
+namespace {
+
+//keeps results alive so the optimizer cannot drop the timed calls
+volatile uint64_t g_sink = 0;
+
+template <typename Fn>
+double time_ns_per_call(size_t iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+        fn();
+    }
+    auto stop = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(iterations);
+}
+
+//per item: per slave, or per channel for digital_io
+void report(const char* kernel, SimdLevel level, double ns, size_t items) {
+    std::printf("%-16s %-8s %12.1f ns/call %8.2f ns/item\n",
+                kernel, simd_level_name(level), ns, ns / static_cast<double>(items));
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    const size_t slaves = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 256;
+    const size_t iterations = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const size_t stride = PdoInputLayout::size;
+
+    //two consecutive cycles of a simulated line: moving drives change, standing ones repeat
+    LoadGenerator generator(slaves);
+    std::vector<uint8_t> previous(generator.image_size());
+    std::vector<uint8_t> image(generator.image_size());
+    generator.next_cycle(previous);
+    generator.next_cycle(image);
+    std::vector<uint8_t> changed(slaves);
+
+    //digital I/O: one input every 3 bits over a 64-byte image (170 inputs)
+    std::vector<uint8_t> io_image(64);
+    for (size_t i = 0; i < io_image.size(); ++i) {
+        io_image[i] = image[i % image.size()];
+    }
+    std::vector<size_t> io_offsets;
+    for (size_t bit = 0; bit < io_image.size() * 8; bit += 3) {
+        io_offsets.push_back(bit);
+    }
+    DigitalIoMap io_map(io_offsets);
+    std::vector<uint64_t> io_bits;
+
+    SlaveColumnStore store(slaves);
+    const SlaveColumns& cols = store.columns();
+    decode_frames(image.data(), slaves, stride, cols);
+    //error codes of the previous cycle: one slave in 64 changed (the usual case is none)
+    std::vector<uint16_t> previous_error(cols.error_code, cols.error_code + slaves);
+    for (size_t i = 0; i < slaves; i += 64) {
+        previous_error[i] = static_cast<uint16_t>(previous_error[i] + 1);
+    }
+    std::vector<uint16_t> changed_slots(slaves);
+    std::vector<float> last_good(slaves);
+    std::vector<uint8_t> invalid_fields(slaves);
+    FloatPolicy float_policy;
+    float_policy.flush_denormals = true;
+    float_policy.replace_non_finite = true;
+    float_policy.min = -50.0f;
+    float_policy.max = 250.0f;
+
+    std::printf("detected level: %s, %zu slaves, %zu iterations\n",
+                simd_level_name(detect_simd_level()), slaves, iterations);
+
+    //synthetic frame generation (WriteState, not dispatched)
+    std::vector<uint8_t> scratch(generator.image_size());
+    double encode_ns = time_ns_per_call(iterations, [&] { generator.next_cycle(scratch); });
+    std::printf("%-16s %-8s %12.1f ns/call %8.2f ns/item\n", "encode", "-",
+                encode_ns, encode_ns / static_cast<double>(slaves));
+
+    //registry input: one input_handler() per slave (frame copied into a vector first, as a caller must)
+    const size_t registry_slaves = slaves < kMaxSlaves ? slaves : kMaxSlaves;
+    StarManager manager;
+    std::vector<uint8_t> frame(stride);
+    double handler_ns = time_ns_per_call(iterations, [&] {
+        for (size_t i = 0; i < registry_slaves; ++i) {
+            frame.assign(image.begin() + i * stride, image.begin() + (i + 1) * stride);
+            manager.input_handler(static_cast<uint8_t>(i), frame);
+        }
+        manager.commit();
+    });
+    std::printf("%-16s %-8s %12.1f ns/call %8.2f ns/item\n", "input_handler", "-",
+                handler_ns, handler_ns / static_cast<double>(registry_slaves));
+
+    std::vector<SlaveFrame> cycle_frames;
+    for (size_t i = 0; i < registry_slaves; ++i) {
+        cycle_frames.push_back(SlaveFrame{static_cast<uint8_t>(i), image.data() + i * stride, stride});
+    }
+
+    //lazy registry: frames stored raw, one field of every slave read back (a monitor polling positions)
+    StarManager lazy(kAnyNumaNode, DecodeMode::Lazy);
+    double lazy_ns = time_ns_per_call(iterations, [&] {
+        lazy.input_cycle(cycle_frames);
+        for (size_t i = 0; i < registry_slaves; ++i) {
+            g_sink = g_sink + static_cast<uint64_t>(
+                lazy.getField<&SlaveRealTimeData::actual_position>(static_cast<uint8_t>(i)));
+        }
+    });
+    std::printf("%-16s %-8s %12.1f ns/call %8.2f ns/item\n", "lazy_cycle+1", "-",
+                lazy_ns, lazy_ns / static_cast<double>(registry_slaves));
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel level : levels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        report("decode", level, time_ns_per_call(iterations, [&] {
+            decode_frames(image.data(), slaves, stride, cols);
+            g_sink = g_sink + static_cast<uint64_t>(cols.actual_position[0]);
+        }), slaves);
+
+        report("input_cycle", level, time_ns_per_call(iterations, [&] {
+            manager.input_cycle(cycle_frames);
+        }), registry_slaves);
+
+        report("detect_changed", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + detect_changed_frames(image.data(), previous.data(), slaves, stride, changed.data());
+        }), slaves);
+
+        report("max_f32", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + static_cast<uint64_t>(reduce_max_f32(cols.motor_temperature, slaves) != 0.0f);
+        }), slaves);
+
+        report("sum_i16", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + static_cast<uint64_t>(reduce_sum_i16(cols.actual_torque, slaves));
+        }), slaves);
+
+        report("min_u64", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + reduce_min_u64(cols.timestamp, slaves);
+        }), slaves);
+
+        report("count_flagged", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + count_flagged_u16(cols.status_word, slaves, 0x0008);
+        }), slaves);
+
+        report("find_changed", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + find_changed_u16(cols.error_code, previous_error.data(), slaves, changed_slots.data());
+        }), slaves);
+
+        //clean temperatures (the usual case): one vector classification per block
+        report("sanitize_f32", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + sanitize_f32(cols.motor_temperature, last_good.data(), invalid_fields.data(),
+                                           kInvalidMotorTemperature, slaves, float_policy);
+        }), slaves);
+
+        report("decode_scaled", level, time_ns_per_call(iterations, [&] {
+            decode_scaled_field(image.data(), slaves, stride, PdoInputLayout::motor_temperature,
+                                ValueEncoding::Int16, cols.motor_temperature_raw);
+            g_sink = g_sink + static_cast<uint64_t>(cols.motor_temperature_raw[0]);
+        }), slaves);
+
+        report("fixed_to_float", level, time_ns_per_call(iterations, [&] {
+            fixed_to_float(cols.motor_temperature_raw, slaves, 0.1f, 0.0f, cols.motor_temperature);
+            g_sink = g_sink + static_cast<uint64_t>(cols.motor_temperature[0] != 0.0f);
+        }), slaves);
+
+        report("max_i32", level, time_ns_per_call(iterations, [&] {
+            g_sink = g_sink + static_cast<uint64_t>(reduce_max_i32(cols.motor_temperature_raw, slaves));
+        }), slaves);
+
+        report("digital_io", level, time_ns_per_call(iterations, [&] {
+            io_map.extract(io_image, io_bits);
+            g_sink = g_sink + io_bits[0];
+        }), io_map.size());
+    }
+
+    reset_simd_level();
+    return 0;
+}
@@ -0,0 +1,63 @@
+/* bench_logger:
+- cost of LogChannel::log() on the calling thread, with the logger thread draining
+into a sink that discards the lines (the formatting cost stays off the timed thread)
+- a second run with the logger stopped shows the full-ring path (drop + count)
+- prints ns per message, p50/p99 of single calls and how many were dropped; a tight
+loop logs far faster than one thread formats, so most of a long burst is dropped
+
+usage: bench_logger [messages] [ring capacity]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include "rt_logger.hpp"
+#include "timing_metrics.hpp"
+
+
+namespace {
+
+void run(const char* name, LogChannel& channel, LogFormat format, size_t messages) {
+    TimingMetrics single;
+    const uint64_t dropped_before = channel.dropped();
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < messages; ++i) {
+        if ((i & 1023) == 0) { //sampled, so the clock reads do not dominate the total
+            auto before = std::chrono::steady_clock::now();
+            channel.log(format, static_cast<uint8_t>(i), static_cast<uint16_t>(i), 0.5 * static_cast<double>(i));
+            single.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - before).count());
+        } else {
+            channel.log(format, static_cast<uint8_t>(i), static_cast<uint16_t>(i), 0.5 * static_cast<double>(i));
+        }
+    }
+    auto stop = std::chrono::steady_clock::now();
+    const double ns = std::chrono::duration<double, std::nano>(stop - start).count() / static_cast<double>(messages);
+    const TimingSummary s = single.summary();
+    std::printf("%-10s %8.1f ns/message  p50 <= %5llu ns  p99 <= %5llu ns  dropped %llu of %zu\n",
+                name, ns, static_cast<unsigned long long>(s.p50_ns), static_cast<unsigned long long>(s.p99_ns),
+                static_cast<unsigned long long>(channel.dropped() - dropped_before), messages);
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    const size_t messages = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 2000000;
+    const size_t capacity = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 65536;
+
+    AsyncLogger logger([](const std::string&) {});
+    const LogFormat format = logger.register_format(LogLevel::Warning, "slave {} invalid frame, status {x}, value {}");
+    LogChannel& channel = logger.open_channel("bench", capacity);
+
+    logger.start(-1, std::chrono::microseconds(100));
+    run("draining", channel, format, messages);
+    logger.stop();
+
+    run("stopped", channel, format, messages); //ring fills, then every call is a drop
+    logger.drain();
+    std::printf("written    %llu lines\n", static_cast<unsigned long long>(logger.written()));
+    return 0;
+}
@@ -0,0 +1,72 @@
+/* bench_plant:
+- PlantSimulator::step() for a line of axes at every SIMD level this CPU supports,
+every axis enabled in CSP/CSV/CST so the whole cascade runs
+- prints ns per step and per axis and the real-time factor: simulated time over
+wall time at the given period (how many such lines one core keeps up with)
+- cycle() adds decoding the outputs and encoding the inputs
+
+usage: bench_plant [axes] [steps] [substeps]
+*/
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+#include "cpu_dispatch.hpp"
+#include "data_structuring.hpp"
+#include "plant_simulator.hpp"
+
+
+namespace {
+
+constexpr std::chrono::nanoseconds kPeriod = std::chrono::milliseconds(1);
+
+void print(const char* name, double elapsed_ns, size_t steps, size_t axes) {
+    const double per_step = elapsed_ns / static_cast<double>(steps);
+    std::printf("%-14s %10.1f ns/step  %6.2f ns/axis  real-time factor %8.0fx\n", name, per_step,
+                per_step / static_cast<double>(axes), static_cast<double>(kPeriod.count()) / per_step);
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    const size_t axes = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 512;
+    const size_t steps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 20000;
+    const size_t substeps = argc > 3 ? std::strtoul(argv[3], nullptr, 10) : 4;
+
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512};
+    for (SimdLevel level : levels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+        PlantSimulator plant(axes, kPeriod, AxisParameters{}, substeps);
+        std::vector<uint8_t> outputs(plant.output_image_size());
+        std::vector<uint8_t> inputs(plant.input_image_size());
+        WriteState encoder;
+        for (size_t i = 0; i < axes; ++i) {
+            SlaveCommandData command{0x000F, static_cast<int32_t>(100 * i), static_cast<int32_t>(1000 + i),
+                                     static_cast<int16_t>(i % 100), static_cast<uint8_t>(8 + i % 3)};
+            encoder.encode_command(command, outputs.data() + i * PdoOutputLayout::size, PdoOutputLayout::size);
+        }
+        plant.apply_outputs(outputs.data(), outputs.size());
+
+        auto start = std::chrono::steady_clock::now();
+        for (size_t s = 0; s < steps; ++s) {
+            plant.step();
+        }
+        auto stop = std::chrono::steady_clock::now();
+        print(simd_level_name(level), std::chrono::duration<double, std::nano>(stop - start).count(), steps, axes);
+
+        start = std::chrono::steady_clock::now();
+        for (size_t s = 0; s < steps; ++s) {
+            plant.cycle(outputs.data(), outputs.size(), inputs.data(), inputs.size());
+        }
+        stop = std::chrono::steady_clock::now();
+        print("  + images", std::chrono::duration<double, std::nano>(stop - start).count(), steps, axes);
+    }
+    reset_simd_level();
+    return 0;
+}
@@ -0,0 +1,309 @@
+/* soak: the full pipeline under a production-sized load, for hours
+- `lines` EtherCAT lines x `slaves` simulated drives (LoadGenerator), each line on its
+own cycle thread: acquire (image source) -> parse (input_cycle) -> registry -> publish (commit)
+- a reader thread refreshes a GlobalView and records every new commit into a Recorder ring
+- every interval, one row per line and one for the process:
+  cycle time p50/p99/max of that interval (upper edges of histogram buckets), p99 drift and histogram distance from the
+  first interval, wake-up latency p99, cycles, overruns, skipped commits, deferred frames;
+  RSS and its growth since the first report, system_clock vs steady_clock drift,
+  recorder entries and wraps
+- checks that fail the run (exit 1): a line's cycle going backwards, ring entries out of
+  order after wrapping, a snapshot missing slaves
+
+usage: soak [lines] [slaves_per_line] [period_us] [duration_s] [interval_s] [pages]
+defaults: 8 250 1000 60 10 4k; a production shift is duration_s = 28800
+pages: 4k, thp or 2M for line storage and the recorder ring (what was obtained is reported)
+*/
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "ethercat_line.hpp"
+#include "global_view.hpp"
+#include "load_generator.hpp"
+#include "recorder.hpp"
+#include "thread_affinity.hpp"
+#include "timing_metrics.hpp"
+
+#ifdef __linux__
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+size_t arg_or(int argc, char** argv, int index, size_t fallback) {
+    return argc > index ? static_cast<size_t>(std::strtoull(argv[index], nullptr, 10)) : fallback;
+}
+
+//resident set size in bytes, 0 where /proc is not available
+uint64_t resident_bytes() {
+#ifdef __linux__
+    std::FILE* statm = std::fopen("/proc/self/statm", "r");
+    if (statm == nullptr) {
+        return 0;
+    }
+    unsigned long long size = 0;
+    unsigned long long resident = 0;
+    const int read = std::fscanf(statm, "%llu %llu", &size, &resident);
+    std::fclose(statm);
+    return read == 2 ? resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE)) : 0;
+#else
+    return 0;
+#endif
+}
+
+TimingMetrics::Histogram difference(const TimingMetrics::Histogram& now, const TimingMetrics::Histogram& before) {
+    TimingMetrics::Histogram delta{};
+    for (size_t b = 0; b < delta.size(); ++b) {
+        delta[b] = now[b] - before[b];
+    }
+    return delta;
+}
+
+//total variation distance of two histograms: 0 same shape, 1 disjoint
+double distance(const TimingMetrics::Histogram& a, const TimingMetrics::Histogram& b) {
+    double total_a = 0.0;
+    double total_b = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        total_a += static_cast<double>(a[i]);
+        total_b += static_cast<double>(b[i]);
+    }
+    if (total_a == 0.0 || total_b == 0.0) {
+        return 0.0;
+    }
+    double sum = 0.0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        sum += std::fabs(static_cast<double>(a[i]) / total_a - static_cast<double>(b[i]) / total_b);
+    }
+    return sum / 2.0;
+}
+
+uint64_t system_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+uint64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//each line's cycles strictly increase from the oldest entry to the newest, wraps included
+bool ring_in_order(const Recorder& recorder, size_t line_count) {
+    std::vector<uint64_t> seen(line_count, 0);
+    for (size_t i = 0; i < recorder.size(); ++i) {
+        const RecordedCycle& entry = recorder.at(i);
+        if (entry.line >= line_count || entry.cycle <= seen[entry.line]) {
+            return false;
+        }
+        seen[entry.line] = entry.cycle;
+    }
+    return true;
+}
+
+//per line: counters and histograms at the previous report, and of the first interval
+struct LineReport {
+    TimingMetrics::Histogram cycle_before{};
+    TimingMetrics::Histogram wakeup_before{};
+    TimingMetrics::Histogram cycle_first{};
+    uint64_t p99_first = 0;
+    bool have_first = false;
+};
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    const size_t line_count = arg_or(argc, argv, 1, 8);
+    size_t slaves = arg_or(argc, argv, 2, 250);
+    const size_t period_us = arg_or(argc, argv, 3, 1000);
+    const size_t duration_s = arg_or(argc, argv, 4, 60);
+    const size_t interval_s = arg_or(argc, argv, 5, 10);
+    const std::string page_arg = argc > 6 ? argv[6] : "4k";
+    const PagePolicy pages = page_arg == "2M" ? PagePolicy::Huge
+                           : page_arg == "thp" ? PagePolicy::Transparent : PagePolicy::Normal;
+    if (line_count == 0 || slaves == 0 || period_us == 0 || interval_s == 0) {
+        std::fprintf(stderr, "usage: soak [lines] [slaves_per_line] [period_us] [duration_s] [interval_s] [pages]\n");
+        return 2;
+    }
+    if (slaves > kMaxSlaves) {
+        slaves = kMaxSlaves; //slave ids are one byte per line
+    }
+
+    //one core per line if there are enough, the first allowed core left to this thread and the recorder
+    const std::vector<int> cores = allowed_cores();
+    const bool pin = cores.size() > line_count;
+
+    std::vector<uint8_t> order(slaves);
+    for (size_t i = 0; i < slaves; ++i) {
+        order[i] = static_cast<uint8_t>(i);
+    }
+
+    std::vector<std::unique_ptr<LoadGenerator>> generators;
+    std::vector<std::unique_ptr<EthercatLine>> lines;
+    std::vector<const StarManager*> managers;
+    for (size_t l = 0; l < line_count; ++l) {
+        generators.push_back(std::make_unique<LoadGenerator>(slaves));
+        LineConfig config;
+        config.name = "line " + std::to_string(l);
+        config.slaves_order = order;
+        config.cpu_core = pin ? cores[l + 1] : -1;
+        config.period = std::chrono::microseconds(period_us);
+        config.pages = pages;
+        LoadGenerator& generator = *generators.back();
+        lines.push_back(std::make_unique<EthercatLine>(config, [&generator](uint8_t* image, size_t size) {
+            generator.next_cycle(image, size);
+        }));
+        managers.push_back(&lines.back()->star_manager());
+    }
+
+    std::printf("soak: %zu lines x %zu slaves, period %zu us, %zu s, report every %zu s, %s\n",
+                line_count, slaves, period_us, duration_s, interval_s,
+                pin ? "lines pinned" : "lines not pinned (not enough cores)");
+
+    //record stage: its own thread, as a logger or exporter would run
+    Recorder recorder(1 << 16, kAnyNumaNode, pages);
+    std::printf("recorder ring: %zu entries on %s pages\n", recorder.capacity(), page_kind_name(recorder.page_kind()));
+    std::atomic<bool> recording{true};
+    std::atomic<uint64_t> backwards{0};
+    std::atomic<uint64_t> short_snapshots{0};
+    std::vector<std::atomic<uint64_t>> skipped(line_count);
+    std::vector<uint64_t> last_cycle(line_count, 0);
+    std::atomic<bool> report_due{false};
+    std::atomic<bool> ring_ok{true};
+    std::atomic<uint64_t> recorded{0}; //recorder.written(), for the reporting thread
+
+    std::thread recorder_thread([&] {
+        if (!cores.empty()) {
+            pin_current_thread(cores.front());
+        }
+        GlobalView view(managers);
+        while (recording.load(std::memory_order_relaxed)) {
+            view.refresh();
+            for (size_t l = 0; l < line_count; ++l) {
+                const StarSnapshot& snapshot = view.line(l);
+                if (snapshot.cycle == last_cycle[l]) {
+                    continue;
+                }
+                if (snapshot.cycle < last_cycle[l]) {
+                    backwards.fetch_add(1, std::memory_order_relaxed);
+                } else if (last_cycle[l] != 0) {
+                    skipped[l].fetch_add(snapshot.cycle - last_cycle[l] - 1, std::memory_order_relaxed);
+                }
+                if (snapshot.slave_count != slaves || snapshot.aggregates.slave_count != slaves) {
+                    short_snapshots.fetch_add(1, std::memory_order_relaxed);
+                }
+                last_cycle[l] = snapshot.cycle;
+                recorder.record(static_cast<uint32_t>(l), snapshot);
+            }
+            recorded.store(recorder.written(), std::memory_order_relaxed);
+
+            //the ring is only touched by this thread: verify it here, once per report
+            if (report_due.exchange(false) && !ring_in_order(recorder, line_count)) {
+                ring_ok.store(false);
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(period_us / 2 + 1));
+        }
+    });
+
+    for (auto& line : lines) {
+        line->start();
+    }
+
+    const uint64_t steady_start = steady_ns();
+    const uint64_t system_start = system_ns();
+    uint64_t rss_first = 0;
+    std::vector<LineReport> reports(line_count);
+
+    const auto started = std::chrono::steady_clock::now();
+    const auto end = started + std::chrono::seconds(duration_s);
+    auto next_report = started + std::chrono::seconds(interval_s);
+    bool ok = true;
+
+    while (next_report <= end) {
+        std::this_thread::sleep_until(next_report);
+        next_report += std::chrono::seconds(interval_s);
+        report_due.store(true);
+
+        const double elapsed_s = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+        const uint64_t rss = resident_bytes();
+        if (rss_first == 0) {
+            rss_first = rss;
+        }
+        const uint64_t written = recorded.load(std::memory_order_relaxed);
+        const double clock_drift_us =
+            (static_cast<double>(system_ns() - system_start) - static_cast<double>(steady_ns() - steady_start)) / 1e3;
+
+        std::printf("\n[%8.0f s] rss %.1f MiB (%+.1f MiB), system-steady clock drift %+.1f us, "
+                    "recorder %zu held, %llu wraps\n",
+                    elapsed_s, static_cast<double>(rss) / (1 << 20),
+                    (static_cast<double>(rss) - static_cast<double>(rss_first)) / (1 << 20), clock_drift_us,
+                    static_cast<size_t>(std::min<uint64_t>(written, recorder.capacity())),
+                    static_cast<unsigned long long>(written / recorder.capacity()));
+        std::printf("%-8s %10s %9s %9s %9s %9s %7s %11s %10s %9s %9s\n", "line", "cycles", "overruns", "p50 ns",
+                    "p99 ns", "max ns", "p99 x", "hist dist", "wake p99", "skipped", "deferred");
+
+        for (size_t l = 0; l < line_count; ++l) {
+            EthercatLine& line = *lines[l];
+            LineReport& report = reports[l];
+
+            const TimingMetrics::Histogram cycle_now = line.cycle_time().histogram();
+            const TimingMetrics::Histogram wakeup_now = line.wakeup_latency().histogram();
+            const TimingMetrics::Histogram cycle_delta = difference(cycle_now, report.cycle_before);
+            const TimingMetrics::Histogram wakeup_delta = difference(wakeup_now, report.wakeup_before);
+            report.cycle_before = cycle_now;
+            report.wakeup_before = wakeup_now;
+
+            const uint64_t p99 = TimingMetrics::percentile(cycle_delta, 990);
+            if (!report.have_first) {
+                report.cycle_first = cycle_delta;
+                report.p99_first = p99;
+                report.have_first = true;
+            }
+
+            std::printf("%-8zu %10llu %9llu %9llu %9llu %9llu %7.2f %11.3f %10llu %9llu %9llu\n", l,
+                        static_cast<unsigned long long>(line.cycles()),
+                        static_cast<unsigned long long>(line.overruns()),
+                        static_cast<unsigned long long>(TimingMetrics::percentile(cycle_delta, 500)),
+                        static_cast<unsigned long long>(p99),
+                        static_cast<unsigned long long>(TimingMetrics::percentile(cycle_delta, 1000)), //highest bucket hit
+                        report.p99_first != 0 ? static_cast<double>(p99) / static_cast<double>(report.p99_first) : 1.0,
+                        distance(cycle_delta, report.cycle_first),
+                        static_cast<unsigned long long>(TimingMetrics::percentile(wakeup_delta, 990)),
+                        static_cast<unsigned long long>(skipped[l].load(std::memory_order_relaxed)),
+                        static_cast<unsigned long long>(line.hardware().deferred_frames()));
+        }
+
+        if (backwards.load() != 0 || short_snapshots.load() != 0 || !ring_ok.load()) {
+            std::printf("FAIL: %llu cycles went backwards, %llu snapshots missing slaves, recorder ring %s\n",
+                        static_cast<unsigned long long>(backwards.load()),
+                        static_cast<unsigned long long>(short_snapshots.load()),
+                        ring_ok.load() ? "in order" : "out of order");
+            ok = false;
+            break;
+        }
+        std::fflush(stdout);
+    }
+
+    for (auto& line : lines) {
+        line->stop();
+    }
+    recording.store(false);
+    recorder_thread.join();
+    if (!ring_in_order(recorder, line_count)) {
+        std::printf("FAIL: recorder ring out of order\n");
+        ok = false;
+    }
+
+    std::printf("\nsoak %s\n", ok ? "passed" : "FAILED");
+    return ok ? 0 : 1;
+}
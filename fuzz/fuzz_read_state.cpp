@@ -0,0 +1,121 @@
+/* fuzz_read_state: libFuzzer target for everything that decodes wire bytes
+- the input as a run of slave frames: ReadState::parse (plain and fixed-point),
+checked field by field against the batch decoder (decode_frames) at the active SIMD level
+- the input as an Ethernet frame: decode_ecat_frame and CaptureDecoder, every
+datagram and slave frame must lie inside the input; the slave frames then go
+through StarManager::input_cycle like a captured cycle, with a FloatPolicy: no
+temperature may come out denormal, or NaN/inf without its invalid flag
+- nothing that keeps state lives across inputs (registry, decoder): only scratch
+buffers every input overwrites before reading
+- a mismatch or an out-of-bounds view aborts, so libFuzzer keeps the input as a crash;
+ReadState throwing std::out_of_range for a short buffer is the expected outcome
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "Star_Manager.hpp"
+#include "data_structuring.hpp"
+#include "ethercat_frame.hpp"
+#include "simd_kernels.hpp"
+#include "slave_columns.hpp"
+
+
+namespace {
+
+void check(bool condition) {
+    if (!condition) {
+        std::abort();
+    }
+}
+
+bool inside(const uint8_t* begin, size_t size, const uint8_t* p, size_t length) {
+    return p >= begin && p <= begin + size && length <= static_cast<size_t>(begin + size - p);
+}
+
+//bitwise, so a NaN temperature matches itself
+bool same_float(float a, float b) {
+    return std::memcmp(&a, &b, sizeof(a)) == 0;
+}
+
+void fuzz_slave_frames(const uint8_t* data, size_t size) {
+    ReadState parser;
+    if (size < PdoInputLayout::size) {
+        try {
+            parser.parse(data, size);
+        } catch (const std::out_of_range&) {
+            return;
+        }
+        std::abort(); //a short buffer must not parse
+    }
+
+    //fixed-point temperature: encoding and scale picked by the input itself
+    FieldFormats formats;
+    formats.motor_temperature.encoding = static_cast<ValueEncoding>(data[0] & 0x03);
+    formats.motor_temperature.scale = 0.1f;
+    parser.parse(data, size, formats);
+
+    static SlaveColumnStore store(kMaxSlaves); //slots [0, count) written before they are checked
+    const size_t count = std::min(size / PdoInputLayout::size, kMaxSlaves);
+    const SlaveColumns& columns = store.columns();
+    decode_frames(data, count, PdoInputLayout::size, columns);
+    for (size_t i = 0; i < count; ++i) {
+        const SlaveRealTimeData expected = parser.parse(data + i * PdoInputLayout::size, PdoInputLayout::size);
+        check(columns.status_word[i] == expected.status_word);
+        check(columns.actual_position[i] == expected.actual_position);
+        check(columns.actual_velocity[i] == expected.actual_velocity);
+        check(columns.actual_torque[i] == expected.actual_torque);
+        check(columns.mode_display[i] == expected.mode_display);
+        check(columns.error_code[i] == expected.error_code);
+        check(columns.system_status[i] == expected.system_status);
+        check(same_float(columns.motor_temperature[i], expected.motor_temperature));
+    }
+}
+
+void fuzz_ethernet_frame(const uint8_t* data, size_t size) {
+    static std::vector<EcatDatagram> datagrams;
+    if (decode_ecat_frame(data, size, datagrams) == FrameStatus::Ok) {
+        check(!datagrams.empty());
+        for (const EcatDatagram& datagram : datagrams) {
+            check(inside(data, size, datagram.data, datagram.length));
+        }
+    }
+
+    //three slaves from logical address 0, as the seed frames map them; a fresh registry
+    //per input, so a crash reproduces from that input alone
+    CaptureDecoder decoder({1, 2, 3});
+    StarManager manager;
+    static std::vector<SlaveFrame> slaves; //refilled by every decode
+    FloatPolicies policies;
+    policies.motor_temperature.flush_denormals = true;
+    policies.motor_temperature.replace_non_finite = true;
+    manager.setFloatPolicies(policies);
+    if (decoder.decode(data, size, slaves) != FrameStatus::Ok) {
+        check(slaves.empty());
+        return;
+    }
+    for (const SlaveFrame& slave : slaves) {
+        check(inside(data, size, slave.data, slave.size));
+    }
+    manager.input_cycle(slaves);
+    for (const SlaveFrame& slave : slaves) {
+        const SlaveRealTimeData data = manager.getSlaveData(slave.slave_id);
+        const int category = std::fpclassify(data.motor_temperature);
+        check(category != FP_SUBNORMAL);
+        //a replaced value is the last good one, finite but still flagged
+        check((category != FP_NAN && category != FP_INFINITE) || (data.invalid_fields & kInvalidMotorTemperature) != 0);
+    }
+}
+
+} // namespace
+
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    fuzz_slave_frames(data, size);
+    fuzz_ethernet_frame(data, size);
+    return 0;
+}
@@ -0,0 +1,60 @@
+/* replay driver for the fuzz targets without libFuzzer (GCC builds, CI):
+runs every file given, or every file in a directory given, through
+LLVMFuzzerTestOneInput once; a regression aborts like it would under the fuzzer
+
+usage: fuzz_read_state_replay <file or directory>...
+*/
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+
+namespace {
+
+std::vector<uint8_t> read_file(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: %s <file or directory>...\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<std::filesystem::path> inputs;
+    for (int i = 1; i < argc; ++i) {
+        const std::filesystem::path path(argv[i]);
+        if (std::filesystem::is_directory(path)) {
+            for (const auto& entry : std::filesystem::directory_iterator(path)) {
+                if (entry.is_regular_file()) {
+                    inputs.push_back(entry.path());
+                }
+            }
+        } else if (std::filesystem::is_regular_file(path)) {
+            inputs.push_back(path);
+        } else {
+            std::fprintf(stderr, "%s: not found\n", argv[i]);
+            return 2;
+        }
+    }
+    std::sort(inputs.begin(), inputs.end()); //same order on every run
+
+    for (const auto& path : inputs) {
+        const std::vector<uint8_t> data = read_file(path);
+        LLVMFuzzerTestOneInput(data.data(), data.size());
+    }
+    std::printf("replayed %zu inputs\n", inputs.size());
+    return inputs.empty() ? 1 : 0;
+}
@@ -1,12 +1,164 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+#include <cstdint>
 #include "Star_Manager.hpp"
+#include "data_structuring.hpp"
+#include "numa_placement.hpp"
+#include "slaves_state_struct.hpp"
+
+
+/* priority class of a slave, highest first: read_kernel decodes the classes in
+this order, and under overload defers the lower ones (see setDecodeBudget)
+*/
+enum class SlavePriority : uint8_t {
+    Safety = 0,      //never deferred
+    Motion = 1,      //default
+    Diagnostics = 2
+};
+constexpr size_t kPriorityClasses = 3;
 
 
+/* WkcGroup: slaves whose inputs travel in one datagram (an IgH domain, or one logical
+slave group of a domain), and the working counter that datagram returns when every
+one of them processed it
+*/
+struct WkcGroup {
+    std::vector<uint8_t> slaves; //slave ids
+    uint16_t expected = 0;
+    uint8_t domain = 0;          //groups of one domain are also counted together
+};
 
+//working-counter checks of one group or domain since setWkcGroups()
+struct WkcStats {
+    uint64_t checks = 0;
+    uint64_t mismatches = 0;
+    uint64_t consecutive = 0;          //mismatches in a row up to the last check (0: last one matched)
+    uint64_t longest_run = 0;
+    uint16_t last_working_counter = 0; //domain: sum over its groups
+};
+
+
+/* process images, as IgH exposes them after domain processing:
+- input image: one PdoInputLayout::size frame per slave, in slaves_order_ order
+- output image: one PdoOutputLayout::size frame per slave, in slaves_order_ order
+*/
 class Ethercat_Hardware_Interface {
+public:
+    //numa_node: node of the cycle thread, for the StarManager's registry; pages: its page size
+    explicit Ethercat_Hardware_Interface(const std::vector<uint8_t>& slaves_order,
+                                         int numa_node = kAnyNumaNode, PagePolicy pages = PagePolicy::Normal);
+
+    /* priority classes, parallel to slaves_order (empty: every slave Motion);
+    throws std::invalid_argument if the sizes differ
+    */
+    void setPriorities(const std::vector<SlavePriority>& priorities);
+    /* time read_kernel may spend before it stops starting new classes (0: no limit).
+    A class below Safety that would start past the budget is deferred: its slaves keep
+    last cycle's values in the commit, flagged SlaveRealTimeData::deferred, and their arrival
+    statistics skip the unread frame (StarManager::defer). A class deferred once is decoded the next cycle
+    regardless, so overload halves the rate of the low classes instead of starving them.
+    */
+    void setDecodeBudget(std::chrono::nanoseconds budget) { decode_budget_ = budget; }
+
+    /* working-counter groups (empty: none); a slave in no group is never invalidated.
+    Throws std::invalid_argument for a slave that is not in slaves_order or in two groups.
+    Not synchronized with the cycle: call it before the cycle runs
+    */
+    void setWkcGroups(const std::vector<WkcGroup>& groups);
+    const std::vector<WkcGroup>& wkc_groups() const { return wkc_groups_; }
+
+    //input image -> StarManager::input_cycle(): every slave's frame in one batch, then commit
+    void read_kernel(const std::vector<uint8_t>& buffer);
+    void read_kernel(const uint8_t* image, size_t size);
+    /* same, with the working counter each WkcGroup returned this cycle (parallel to
+    wkc_groups(), else std::invalid_argument), checked before anything is decoded: the
+    frames of a group whose counter differs from its expected value are not decoded, and
+    its slaves commit last cycle's values with data_valid cleared (StarManager::reject).
+    Without counters (overloads above) nothing is checked and data_valid stays set
+    */
+    void read_kernel(const uint8_t* image, size_t size, const uint16_t* working_counters, size_t count);
+    //commands -> output image, written in place; slaves without a command get an all-zero frame
+    void write_kernel(std::vector<uint8_t>& buffer);
+    void write_kernel(uint8_t* image, size_t size);
+
+    void setCommand(uint8_t slave_id, const SlaveCommandData& command);
+
+    size_t input_image_size() const { return slaves_order_.size() * PdoInputLayout::size; }
+    size_t output_image_size() const { return slaves_order_.size() * PdoOutputLayout::size; }
+    const std::vector<uint8_t>& slaves_order() const { return slaves_order_; }
+    SlavePriority priority(size_t index) const { return priorities_.at(index); } //index in slaves_order
+
+    //cycles in which a class was deferred, and frames left out in total; readable from any thread
+    uint64_t deferrals(SlavePriority priority) const {
+        return deferrals_[static_cast<size_t>(priority)].load(std::memory_order_relaxed);
+    }
+    uint64_t deferred_frames() const { return deferred_frames_.load(std::memory_order_relaxed); }
+
+    //working-counter statistics, readable from any thread; throw std::out_of_range for an unknown group/domain
+    WkcStats wkcStats(size_t group) const;         //index in wkc_groups()
+    WkcStats domainWkcStats(uint8_t domain) const; //mismatch: any of its groups mismatched
+    uint64_t invalidated_frames() const { return invalidated_frames_.load(std::memory_order_relaxed); }
+
+    /* warm restart (checkpoint.hpp): the StarManager's Registry section and the commands
+    (Commands section). Cycle stopped or cycle thread only; false if the checkpoint has neither
+    */
+    void writeCheckpoint(CheckpointWriter& writer) const;
+    bool restoreCheckpoint(CheckpointReader& reader);
+
+    //both sections read and checked, not applied yet (see StarManager::loadCheckpoint)
+    struct Checkpoint {
+        bool has_registry = false;
+        StarManager::RegistryCheckpoint registry;
+        bool has_commands = false;
+        std::map<uint8_t, SlaveCommandData> commands;
+    };
+    bool loadCheckpoint(CheckpointReader& reader, Checkpoint& out) const;
+    void applyCheckpoint(const Checkpoint& checkpoint);
+
+    StarManager& star_manager() { return star_manager_; }
+    const StarManager& star_manager() const { return star_manager_; }
+
 private:
     StarManager star_manager_;
     std::vector<uint8_t> slaves_order_;
 
-public:
-    
-};
\ No newline at end of file
+    std::map<uint8_t, SlaveCommandData> command_registry_;
+    std::vector<SlaveFrame> frames_; //views into the input image, one class at a time, reused every cycle
+
+    std::vector<SlavePriority> priorities_;
+    std::array<std::vector<size_t>, kPriorityClasses> class_slaves_; //slaves_order indices per class, in image order
+    std::chrono::nanoseconds decode_budget_{0};
+    std::array<bool, kPriorityClasses> deferred_last_cycle_{};
+    std::array<std::atomic<uint64_t>, kPriorityClasses> deferrals_{};
+    std::atomic<uint64_t> deferred_frames_{0};
+
+    //single writer (the cycle thread), relaxed atomics for the readers
+    struct WkcCounters {
+        std::atomic<uint64_t> checks{0};
+        std::atomic<uint64_t> mismatches{0};
+        std::atomic<uint64_t> consecutive{0};
+        std::atomic<uint64_t> longest_run{0};
+        std::atomic<uint16_t> last_working_counter{0};
+
+        void record(bool mismatch, uint16_t working_counter);
+        WkcStats load() const;
+    };
+    std::vector<WkcGroup> wkc_groups_;
+    std::unique_ptr<WkcCounters[]> group_wkc_;
+    std::unique_ptr<WkcCounters[]> domain_wkc_;
+    size_t wkc_domains_ = 0;
+    std::vector<uint8_t> domain_mismatch_;  //check_working_counters() scratch, per domain
+    std::vector<uint32_t> domain_sum_;
+    std::atomic<uint64_t> invalidated_frames_{0};
+    std::array<uint8_t, kMaxSlaves> rejected_{}; //by slave id: frame failed its working counter this cycle
+    bool any_rejected_ = false;
+
+    void check_working_counters(const uint16_t* working_counters);
+    WriteState encoder_;
+};
@@ -1,21 +1,297 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <vector>
 #include <map>
 #include <cstdint>
+#include <limits>
+#include "arrival_stats.hpp"
+#include "checkpoint.hpp"
+#include "device_events.hpp"
 #include "data_structuring.hpp"
+#include "raw_frame_store.hpp"
+#include "slave_columns.hpp"
 #include "slaves_state_struct.hpp"
 
 
+//one slave's TxPDO frame inside a cycle's process image (a view, not owned)
+struct SlaveFrame {
+    uint8_t slave_id;
+    const uint8_t* data;
+    size_t size;
+};
+
+
+constexpr size_t kMaxSupplyGroups = 8;
+constexpr uint16_t kFaultStatusBit = 0x0008; //CiA 402 statusword: Fault
+
+
+/* CycleAggregates: line-wide figures of one commit, computed once by commit()
+with the SoA reductions (simd_kernels.hpp) instead of by every consumer
+- over the slaves that have reported, whatever cycle they last reported in; the value
+figures (temperatures, faulted, supply_torque) skip slots with data_valid cleared
+- max_motor_temperature_raw: over the fixed-point slaves, in their raw units (meaningful
+when they share one ScaledFormat); the ones with keep_fixed_point are only counted there
+- supply_torque[g]: sum of actual_torque of the slaves in power-supply group g
+(setSupplyGroup, default group 0)
+*/
+struct CycleAggregates {
+    size_t slave_count = 0;
+    float max_motor_temperature = -std::numeric_limits<float>::infinity(); //NaNs skipped
+    int32_t max_motor_temperature_raw = std::numeric_limits<int32_t>::min(); //INT32_MIN: no fixed-point slave
+    size_t faulted = 0;                                                    //kFaultStatusBit set
+    size_t invalid = 0;                                                    //data_valid cleared (see invalidate)
+    size_t restored = 0;                                                   //from a checkpoint, not reported since
+    size_t invalid_fields = 0;                                             //a field flagged in invalid_fields (FloatPolicy)
+    size_t deferred = 0;                                                   //left unread this cycle (see defer)
+    uint64_t oldest_timestamp = UINT64_MAX;                                //UINT64_MAX: no slave
+    std::array<int64_t, kMaxSupplyGroups> supply_torque{};
+};
+
+
+/* StarSnapshot: the registry of one line as it was at one commit()
+- readers own their copy, so they never touch the cycle thread's memory
+- slots are assigned in the order slaves first reported, slot_of maps id -> slot
+*/
+struct StarSnapshot {
+    //node of the reader that owns it
+    explicit StarSnapshot(int numa_node = kAnyNumaNode, PagePolicy pages = PagePolicy::Normal);
+
+    uint64_t cycle = 0;          //0: nothing committed yet
+    uint64_t commit_time_ns = 0; //system_clock, same base as SlaveRealTimeData::timestamp
+    size_t slave_count = 0;
+    CycleAggregates aggregates;
+    std::array<int16_t, kMaxSlaves> slot_of; //-1: slave has not reported
+    SlaveColumnStore columns;
+    DecodeMode mode = DecodeMode::Eager; //of the StarManager it came from
+    RawFrameStore raw_frames;            //lazy modes: wire fields are decoded from here
+
+    bool contains(uint8_t slave_id) const { return slot_of[slave_id] >= 0; }
+    //throws std::out_of_range for a slave that is not in the snapshot
+    SlaveRealTimeData getSlaveData(uint8_t slave_id) const;
+
+    //one wire field, e.g. getField<&SlaveRealTimeData::actual_position>(id)
+    template <auto Member>
+    typename pdo_member<Member>::type getField(uint8_t slave_id) const {
+        const size_t slot = checked_slot(slave_id);
+        if (mode == DecodeMode::Eager) {
+            return load_slave(columns.columns(), slot).*Member;
+        }
+        return decode_stored_field<Member>(raw_frames, columns.columns(), slot);
+    }
+
+private:
+    size_t checked_slot(uint8_t slave_id) const;
+};
+
+
 class StarManager {
 public:
+    //registry and published snapshots on `numa_node`: the node of the cycle thread's core,
+    //and on hugepages if `pages` asks for them
+    explicit StarManager(int numa_node = kAnyNumaNode, DecodeMode mode = DecodeMode::Eager,
+                         PagePolicy pages = PagePolicy::Normal);
+
+    //registry lives in place and is published by address: not copyable, not movable
+    StarManager(const StarManager&) = delete;
+    StarManager& operator=(const StarManager&) = delete;
+
     void input_handler(uint8_t slave_id, const std::vector<uint8_t>& buffer);
-    SlaveRealTimeData getSlaveData(uint8_t slave_id) const;
+    /* cycle thread only (or cycle stopped), as getField: both read the registry the cycle
+    writes, and in LazyCached mode this writes the decoded slot back into it. Other threads
+    read a snapshot (readSnapshot). throws std::out_of_range for a slave that has not reported
+    */
+    SlaveRealTimeData getSlaveData(uint8_t slave_id);
+
+    /* a whole cycle at once, then commit():
+    - one timestamp for every frame of the cycle
+    - frames laid out back to back in slot order (the usual process image) are
+    decoded in one batch kernel call straight into the registry slots
+    - every frame is checked before anything is written: throws std::out_of_range
+    if one is shorter than PdoInputLayout::size, and the registry is left as it was
+    - timestamp_ns != 0 replaces the clock read (capture replay: the time the frame was captured)
+    - arrival statistics take their intervals from steady_clock, read beside the wall-clock
+    timestamp, so NTP steps and slews are not intervals; arrival_ns != 0 replaces that read,
+    and a timestamp_ns given alone (capture replay) is used for both
+    */
+    void input_cycle(const SlaveFrame* frames, size_t count, uint64_t timestamp_ns = 0, uint64_t arrival_ns = 0);
+    void input_cycle(const std::vector<SlaveFrame>& frames, uint64_t timestamp_ns = 0, uint64_t arrival_ns = 0);
+    //input_cycle() without the commit: for a cycle fed in several parts (e.g. by priority class);
+    //runs of frames that sit back to back in slot order are decoded with one kernel call each
+    void input_frames(const SlaveFrame* frames, size_t count, uint64_t timestamp_ns = 0, uint64_t arrival_ns = 0);
+    /* between the input and commit(): clears data_valid of a slave for this cycle (e.g. its
+    datagram came back with a wrong working counter); the next input sets it again.
+    false if the slave has not reported yet (there is nothing to flag)
+    */
+    bool invalidate(uint8_t slave_id);
+    /* instead of the input of a slave whose frame failed a check before the decode (e.g. a
+    wrong working counter): it keeps last cycle's values with data_valid cleared, and its
+    arrival statistics skip the frame. false if the slave has not reported yet
+    */
+    bool reject(uint8_t slave_id);
+    /* between the input and commit(): flags a slave whose frame was left unread this cycle
+    (decode budget), so readers see its values are last cycle's; its arrival statistics skip
+    the gap instead of taking it for one interval twice as long. The next input clears it.
+    false if the slave has not reported yet
+    */
+    bool defer(uint8_t slave_id);
+
+    //per-slave wire format of real-valued fields (default: IEEE float)
+    void setFieldFormats(uint8_t slave_id, const FieldFormats& formats);
+    /* what every input does with float values (FloatPolicy), line-wide per field; applied
+    in the batch right after the decode, the lazy modes decode the temperature on arrival
+    for it. Cycle thread, or before it runs
+    */
+    void setFloatPolicies(const FloatPolicies& policies) { float_policies_ = policies; }
+    const FloatPolicies& floatPolicies() const { return float_policies_; }
+
+    DecodeMode decodeMode() const { return mode_; }
+
+    //power-supply group of a slave for CycleAggregates::supply_torque;
+    //throws std::invalid_argument for group >= kMaxSupplyGroups
+    void setSupplyGroup(uint8_t slave_id, uint8_t group);
+
+    /* update rate of each slave, from the steady_clock arrival times input_handler/input_cycle
+    read (cycle thread only): EWMA mean/variance and min/max of the interval between two
+    frames; drift, jitter and silence beyond the thresholds are flagged
+    */
+    void setArrivalThresholds(const ArrivalThresholds& thresholds);
+    void setExpectedPeriod(uint8_t slave_id, uint64_t period_ns); //0: learn it during warm-up
+    //throws std::out_of_range for a slave that has not reported
+    ArrivalStats arrivalStats(uint8_t slave_id) const;
+    //slaves with kArrivalDrift, kArrivalJitter or kArrivalLate set, ascending id
+    std::vector<uint8_t> timingAnomalies() const;
+
+    /* one wire field, e.g. getField<&SlaveRealTimeData::actual_position>(id):
+    in the lazy modes only that field's bytes are decoded (offset and type from TxPdoLayout).
+    Cycle thread only, see getSlaveData; throws std::out_of_range for a slave that has not reported
+    */
+    template <auto Member>
+    typename pdo_member<Member>::type getField(uint8_t slave_id) const {
+        const size_t slot = checked_slot(slave_id);
+        if (mode_ == DecodeMode::Eager || cached_input_[slot] == input_epoch_) {
+            return load_slave(slave_registry_.columns(), slot).*Member;
+        }
+        return decode_stored_field<Member>(raw_frames_, slave_registry_.columns(), slot);
+    }
+
+    /* end of cycle, called by the cycle thread only:
+    publishes the registry as the next snapshot. Readers on other cores pick it up
+    with readSnapshot(); nothing they do writes to memory this thread owns.
+    */
+    void commit();
+
+    //latest committed snapshot into `out` (reader-owned), any thread
+    void readSnapshot(StarSnapshot& out) const;
+    uint64_t committedCycle() const { return committed_cycle_.load(std::memory_order_acquire); }
+
+    /* error_code / system_status edge detection at every commit() (nullptr: none); the
+    monitor pushes its events with the cycle number being committed. Cycle thread, or before it runs
+    */
+    void setErrorMonitor(ErrorMonitor* monitor) { error_monitor_ = monitor; }
+
+    //figures of the last commit(), cycle thread only; readers get them with the snapshot
+    const CycleAggregates& aggregates() const { return aggregates_; }
+    //lazy modes: slots commit() decoded for the aggregates, one per frame received since the
+    //previous commit and not read through getSlaveData in LazyCached mode
+    uint64_t aggregateDecodes() const { return aggregate_decodes_; }
+
+    /* warm restart (checkpoint.hpp), cycle thread or cycle stopped: the Registry section holds
+    every slot's last values and arrival statistics, and the committed cycle. Restoring
+    flags the slots restored, continues the cycle count and commits, so readers get the
+    last-known values at once. false if the checkpoint has no Registry section
+    */
+    void writeCheckpoint(CheckpointWriter& writer) const;
+    bool restoreCheckpoint(CheckpointReader& reader);
+
+    //Registry section read and checked, not applied yet
+    struct RegistryCheckpoint {
+        struct Slot {
+            uint8_t slave_id = 0;
+            SlaveRealTimeData data{};
+            int32_t temperature_raw = 0;
+            ArrivalStats arrival;
+        };
+        uint64_t cycle = 0;
+        std::vector<Slot> slots;
+    };
+    /* restoreCheckpoint() in two steps, so a caller restoring several sections can read all
+    of them before it changes anything: loadCheckpoint() throws std::invalid_argument for a
+    malformed section and leaves the registry alone; applyCheckpoint() does not throw for what it loaded
+    */
+    bool loadCheckpoint(CheckpointReader& reader, RegistryCheckpoint& out) const;
+    void applyCheckpoint(const RegistryCheckpoint& checkpoint);
+
+    //placement, for the startup report: requested node, and where the pages actually are (-1: unknown)
+    int requested_numa_node() const { return numa_node_; }
+    int registry_numa_node() const { return slave_registry_.numa_node(); }
+    int snapshot_numa_node() const { return published_[0].snapshot.columns.numa_node(); }
+    //page size each got (hugepage requests may have fallen back to normal pages)
+    PageKind registry_page_kind() const { return slave_registry_.page_kind(); }
+    PageKind snapshot_page_kind() const { return published_[0].snapshot.columns.page_kind(); }
 
 
 private:
+    int numa_node_;
     ReadState parser_; //one instance for all slaves
 
-    //map each slave to its SlaveRealTimeData instance
-    std::map<uint8_t, SlaveRealTimeData> slave_registry;
-};
\ No newline at end of file
+    //registry in SoA form: slave_id -> slot -> one entry per column
+    SlaveColumnStore slave_registry_;
+    std::array<int16_t, kMaxSlaves> slot_of_;
+    std::array<uint8_t, kMaxSlaves> id_of_slot_{}; //inverse of slot_of_ over [0, slot_count_)
+    size_t slot_count_ = 0;
+    std::vector<uint16_t> cycle_slots_; //input_cycle() scratch, kMaxSlaves reserved
+
+    size_t slot_for(uint8_t slave_id);
+    size_t checked_slot(uint8_t slave_id) const;
+
+    //lazy modes: frames as received, and the input they were decoded for (LazyCached)
+    DecodeMode mode_;
+    RawFrameStore raw_frames_;
+    std::array<uint64_t, kMaxSlaves> cached_input_{}; //== input_epoch_: columns hold the decoded slot
+    uint64_t input_epoch_ = 1;                                 //bumped by every input_cycle()
+
+    void store_raw(size_t slot, const uint8_t* frame);
+
+    //lazy modes: slots with a frame the aggregated fields have not been decoded from yet
+    std::vector<uint16_t> undecoded_slots_; //kMaxSlaves reserved
+    std::array<uint8_t, kMaxSlaves> undecoded_{};
+    uint64_t aggregate_decodes_ = 0;
+
+    //only slaves that deviate from the IEEE float default have an entry
+    std::map<uint8_t, FieldFormats> field_formats_;
+    std::array<const ScaledFormat*, kMaxSlaves> slot_format_{}; //by slot, into field_formats_; nullptr: IEEE float
+
+    const ScaledFormat* temperature_format(uint8_t slave_id) const;
+    bool keeps_fixed_point(size_t slot) const {
+        return slot_format_[slot] != nullptr && slot_format_[slot]->keep_fixed_point;
+    }
+    void decode_fixed_point(const uint8_t* frames, size_t count, size_t stride, size_t first_slot,
+                            const ScaledFormat& format);
+
+    FloatPolicies float_policies_;
+    alignas(64) std::array<float, kMaxSlaves> last_good_temperature_; //by slot, NaN: none yet
+    void sanitize_temperatures(size_t first_slot, size_t count);
+
+    std::array<uint8_t, kMaxSlaves> supply_group_of_{}; //by slave id
+    std::array<uint8_t, kMaxSlaves> slot_group_{};      //by slot, kept in step with slot_of_
+    bool supply_groups_used_ = false;                   //false: every slave in group 0
+    CycleAggregates aggregates_;
+    ArrivalTracker arrivals_;
+    ErrorMonitor* error_monitor_ = nullptr;
+
+    void compute_aggregates();
+
+    /* two published buffers, each behind a sequence counter (odd: being written).
+    commit() always writes the buffer readers are not directed to, so a reader
+    only retries if it is slower than a whole cycle.
+    */
+    struct alignas(64) PublishedBuffer {
+        PublishedBuffer(int numa_node, PagePolicy pages) : snapshot(numa_node, pages) {}
+        std::atomic<uint64_t> seq{0};
+        StarSnapshot snapshot;
+    };
+    std::array<PublishedBuffer, 2> published_;
+    alignas(64) std::atomic<uint64_t> committed_cycle_{0};
+};
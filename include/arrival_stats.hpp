@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+//ArrivalStats::flags
+constexpr uint8_t kArrivalDrift = 0x01;  //mean interval moved away from the baseline
+constexpr uint8_t kArrivalJitter = 0x02; //intervals spread too much around their mean
+constexpr uint8_t kArrivalLate = 0x04;   //nothing received for several baseline periods
+
+
+struct ArrivalThresholds {
+    double alpha = 1.0 / 16.0;  //EWMA weight of the newest interval
+    uint32_t warmup = 16;       //intervals before anything is flagged (and the baseline is taken)
+    double max_drift = 0.2;     //|mean - baseline| / baseline
+    double max_jitter = 0.25;   //stddev / mean
+    double late_periods = 4.0;  //silence, in baseline periods
+};
+
+
+//inter-arrival times of one slave, updated per frame
+struct ArrivalStats {
+    uint64_t intervals = 0;        //frames - 1
+    uint64_t last_ns = 0;          //arrival of the latest frame (monotonic clock), 0: none yet
+    double mean_ns = 0.0;          //EWMA
+    double variance_ns2 = 0.0;     //EWMA
+    uint64_t min_ns = UINT64_MAX;
+    uint64_t max_ns = 0;
+    double baseline_ns = 0.0;      //expected period, or the mean at the end of warm-up
+    uint8_t flags = 0;             //kArrivalDrift | kArrivalJitter, as of the latest frame
+
+    double stddev_ns() const;
+    double rate_hz() const { return mean_ns > 0.0 ? 1e9 / mean_ns : 0.0; }
+};
+
+
+/* ArrivalTracker class: per-slave update rate, by slave id
+- record() is O(1) and allocation free: no history is kept, only EWMA mean and
+variance of the interval between two frames, plus min/max
+- a slave is flagged when its mean drifts from the baseline (setExpectedPeriod,
+or what it ran at during warm-up) or its jitter exceeds the threshold;
+kArrivalLate is decided at query time, a silent slave records nothing
+- timestamps come from a monotonic clock (StarManager: steady_clock); a wall clock
+stepped forward by NTP would be taken for one huge interval
+- one writer (the cycle thread), like the registry it sits next to
+*/
+class ArrivalTracker {
+public:
+    explicit ArrivalTracker(const ArrivalThresholds& thresholds = ArrivalThresholds());
+
+    //throws std::invalid_argument for alpha outside (0, 1] or a negative threshold
+    void setThresholds(const ArrivalThresholds& thresholds);
+    const ArrivalThresholds& thresholds() const { return thresholds_; }
+
+    //nominal period of a slave (0: learn it during warm-up)
+    void setExpectedPeriod(uint8_t slave_id, uint64_t period_ns);
+
+    void record(uint8_t slave_id, uint64_t timestamp_ns);
+
+    const ArrivalStats& stats(uint8_t slave_id) const { return stats_[slave_id]; }
+    //flags including kArrivalLate as of `now_ns`
+    uint8_t flags(uint8_t slave_id, uint64_t now_ns) const;
+    //slaves with any flag set, ascending id
+    std::vector<uint8_t> anomalies(uint64_t now_ns) const;
+
+    //the slave's latest frame went unread (deferred): the next one starts a new interval
+    //instead of closing one that spans the skipped frame
+    void skip(uint8_t slave_id) { stats_[slave_id].last_ns = 0; }
+
+    void reset(uint8_t slave_id);
+    //statistics of a slave from a checkpoint; last_ns is dropped so the restart gap is not taken for an interval
+    void restore(uint8_t slave_id, const ArrivalStats& stats);
+
+private:
+    ArrivalThresholds thresholds_;
+    std::array<ArrivalStats, 256> stats_{};
+    std::array<uint64_t, 256> expected_ns_{};
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include "ethercat_frame.hpp"
+
+
+//one captured Ethernet frame; `data` points into the capture (mapped file or caller buffer)
+struct CapturedPacket {
+    const uint8_t* data = nullptr;
+    uint32_t captured_length = 0; //bytes at `data`
+    uint32_t original_length = 0; //on the wire; more than captured_length if the snap length cut it
+    uint64_t timestamp_ns = 0;    //since the Unix epoch; 0 if the record has none (pcapng SPB)
+};
+
+
+/* CaptureFile class: Wireshark/tcpdump captures, read in place
+- pcap (micro- and nanosecond, either byte order) and pcapng (SHB, IDB, EPB, SPB;
+other blocks skipped; several sections and interfaces; if_tsresol honoured)
+- the file is mmap'd read-only and packets are handed out as pointers into the mapping:
+gigabytes are walked at page-cache speed, nothing is copied
+- only Ethernet (linktype 1) interfaces are read; packets of other interfaces are skipped
+- a file cut off mid-record (capture still running, copy interrupted) ends at the last
+whole packet and reports truncated()
+
+construction throws std::runtime_error if the file cannot be opened or mapped, and
+std::invalid_argument if it is neither pcap nor pcapng, or a pcap of another linktype;
+next() throws std::invalid_argument for a corrupt pcapng block
+*/
+class CaptureFile {
+public:
+    enum class Format : uint8_t { Pcap, PcapNg };
+
+    explicit CaptureFile(const std::string& path);
+    //capture already in memory (not owned, must outlive the CaptureFile)
+    CaptureFile(const uint8_t* data, size_t size);
+    ~CaptureFile();
+
+    CaptureFile(const CaptureFile&) = delete;
+    CaptureFile& operator=(const CaptureFile&) = delete;
+
+    //false at the end of the capture
+    bool next(CapturedPacket& packet);
+    void rewind();
+
+    Format format() const { return format_; }
+    size_t size() const { return size_; }
+    bool truncated() const { return truncated_; }
+
+private:
+    struct Interface {
+        bool ethernet;
+        uint64_t units_per_second; //timestamp resolution
+        bool power_of_two;         //if_tsresol with the MSB set: 2^-n seconds
+        uint8_t exponent;
+    };
+
+    void open();
+    bool next_pcap(CapturedPacket& packet);
+    bool next_pcapng(CapturedPacket& packet);
+    void read_section_header(size_t offset);
+    void read_interface(const uint8_t* body, size_t length);
+    uint16_t u16(const uint8_t* p) const;
+    uint32_t u32(const uint8_t* p) const;
+
+    const uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    bool mapped_ = false;
+    std::vector<uint8_t> copy_; //platforms without mmap
+
+    Format format_ = Format::Pcap;
+    bool swapped_ = false;       //big-endian file
+    bool nanoseconds_ = false;   //pcap only
+    size_t first_record_ = 0;
+    size_t offset_ = 0;
+    bool truncated_ = false;
+    std::vector<Interface> interfaces_; //pcapng, current section
+};
+
+
+//what replay_capture() saw
+struct CaptureStats {
+    uint64_t packets = 0;
+    uint64_t cycles = 0;        //frames that carried process data of at least one mapped slave
+    uint64_t slave_frames = 0;
+    uint64_t not_ethercat = 0;
+    uint64_t truncated = 0;
+    uint64_t malformed = 0;
+};
+
+/* replay_capture: every packet of `capture` (from where it stands) through `decoder`
+into `manager`, one input_cycle() per frame that carries process data, stamped with the
+capture time; the snapshots then hold what the line saw, frame by frame
+- `on_cycle` (may be empty) runs after each commit, e.g. to read a snapshot or aggregates
+*/
+CaptureStats replay_capture(CaptureFile& capture, CaptureDecoder& decoder, StarManager& manager,
+                            const std::function<void(const CapturedPacket&)>& on_cycle = {});
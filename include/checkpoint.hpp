@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include "pdo_field.hpp"
+
+class Ethercat_Hardware_Interface;
+class Recorder;
+
+
+/* checkpoint file: the warm state of a line across a controlled restart
+  "STARCKPT" | u32 version | sections: u32 tag, u32 length, payload | u64 FNV-1a of all before it
+- little-endian and field by field (store_le), no struct dumps: padding and compiler
+layout never reach the file
+- each component writes and reads its own section (StarManager, hardware interface,
+Recorder), so a checkpoint without a recorder restores the rest
+*/
+constexpr uint32_t kCheckpointVersion = 2; //2: Registry slots carry invalid_fields
+
+enum class CheckpointSection : uint32_t {
+    Registry = 1, //StarManager: slots, last values, arrival statistics, committed cycle
+    Commands = 2, //Ethercat_Hardware_Interface: command per slave
+    Recorder = 3  //Recorder: ring entries and written count
+};
+
+
+class CheckpointWriter {
+public:
+    template <typename T>
+    void put(const T& value) {
+        const size_t at = bytes_.size();
+        bytes_.resize(at + sizeof(T));
+        store_le(bytes_.data() + at, value);
+    }
+
+    //sections do not nest; throws std::logic_error if they would
+    void begin_section(CheckpointSection section);
+    void end_section();
+
+    /* header, sections and checksum into `path + ".tmp"`, then renamed over `path`:
+    a crash while writing leaves the previous checkpoint in place.
+    Throws std::runtime_error if the file cannot be written
+    */
+    void save(const std::string& path) const;
+
+private:
+    std::vector<uint8_t> bytes_; //sections only
+    size_t section_start_ = 0;
+    bool in_section_ = false;
+};
+
+
+/* CheckpointReader class: a checkpoint file, checked as a whole before anything is read
+(magic, version, section bounds, checksum); throws std::invalid_argument otherwise
+*/
+class CheckpointReader {
+public:
+    explicit CheckpointReader(std::vector<uint8_t> file);
+
+    //false if there is no file at `path`; throws std::invalid_argument for a corrupt one
+    static bool load(const std::string& path, std::vector<uint8_t>& file);
+
+    //positions reading at the start of a section; false if the file has none
+    bool open(CheckpointSection section);
+
+    //next value of the open section; throws std::invalid_argument past its end
+    template <typename T>
+    T get() {
+        if (section_end_ - cursor_ < sizeof(T)) {
+            throw std::invalid_argument("checkpoint section shorter than its contents");
+        }
+        const T value = load_le<T>(file_.data() + cursor_);
+        cursor_ += sizeof(T);
+        return value;
+    }
+
+private:
+    std::vector<uint8_t> file_;
+    std::map<uint32_t, std::pair<size_t, size_t>> sections_; //tag -> payload offset, length
+    size_t cursor_ = 0;
+    size_t section_end_ = 0;
+};
+
+
+/* a line's warm state: call with the cycle stopped (or from the cycle thread), since
+the registry and its statistics belong to the cycle thread. `recorder` may be null.
+*/
+void save_checkpoint(const std::string& path, const Ethercat_Hardware_Interface& hardware,
+                     const Recorder* recorder = nullptr);
+
+/* before the first cycle: slaves come back with their last-known values, flagged
+restored (SlaveRealTimeData::restored) until they report again, and the restored
+registry is committed so readers see it at once.
+false if there is no checkpoint at `path`; throws std::invalid_argument for a corrupt
+or foreign file: the whole file is checked, and every section read, before anything is applied
+*/
+bool restore_checkpoint(const std::string& path, Ethercat_Hardware_Interface& hardware, Recorder* recorder = nullptr);
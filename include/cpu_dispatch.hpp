@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+
+/* runtime CPU dispatch:
+one binary runs on old Atom-class IPCs and on new Xeons, so the hot kernels
+(batch decode, change detection, SoA reductions) are compiled once per level
+and the best level the CPU supports is picked at startup.
+
+STAR_SIMD_LEVEL=scalar|sse4.2|avx2|avx512 in the environment caps the level
+at startup; force_simd_level() does the same at runtime (tests, benchmarks).
+*/
+
+//ordered: a higher level implies every lower one
+enum class SimdLevel : uint8_t {
+    Scalar = 0,
+    SSE42 = 1,
+    AVX2 = 2,
+    AVX512 = 3
+};
+
+//highest level supported by CPU and OS
+SimdLevel detect_simd_level();
+
+//level the kernels currently dispatch to
+SimdLevel active_simd_level();
+
+//throws std::invalid_argument if the CPU does not support `level`
+void force_simd_level(SimdLevel level);
+
+//back to the startup selection (detected level, capped by STAR_SIMD_LEVEL)
+void reset_simd_level();
+
+bool simd_level_supported(SimdLevel level);
+const char* simd_level_name(SimdLevel level);
+
+//BMI2 (pext/pdep) is tracked apart from the vector levels
+bool cpu_has_bmi2();
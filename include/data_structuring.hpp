@@ -1,12 +1,179 @@
 #pragma once
 
 #include "slaves_state_struct.hpp"
+#include "pdo_field.hpp"
+#include <cstddef>
+#include <limits>
 #include <vector>
 
+//byte offsets of the input PDO fields in a slave's buffer (little-endian, packed)
+//offset = sum of bytes in previous objects
+struct PdoInputLayout {
+    static constexpr size_t status_word = 0;
+    static constexpr size_t actual_position = 2;
+    static constexpr size_t actual_velocity = 6;
+    static constexpr size_t actual_torque = 10;
+    static constexpr size_t mode_display = 12;
+    static constexpr size_t error_code = 13;
+    static constexpr size_t system_status = 15;
+    static constexpr size_t motor_temperature = 17;
+
+    static constexpr size_t size = 21; //bytes of PDO data per slave
+};
+
+//byte offsets of the output PDO fields (SlaveCommandData)
+struct PdoOutputLayout {
+    static constexpr size_t control_word = 0;
+    static constexpr size_t target_position = 2;
+    static constexpr size_t target_velocity = 6;
+    static constexpr size_t target_torque = 10;
+    static constexpr size_t mode_of_operation = 12;
+
+    static constexpr size_t size = 13;
+};
+
+//the layout definitions ReadState and WriteState are generated from (pdo_field.hpp)
+using TxPdoLayout = std::tuple<
+    PdoEntry<&SlaveRealTimeData::status_word, PdoInputLayout::status_word>,
+    PdoEntry<&SlaveRealTimeData::actual_position, PdoInputLayout::actual_position>,
+    PdoEntry<&SlaveRealTimeData::actual_velocity, PdoInputLayout::actual_velocity>,
+    PdoEntry<&SlaveRealTimeData::actual_torque, PdoInputLayout::actual_torque>,
+    PdoEntry<&SlaveRealTimeData::mode_display, PdoInputLayout::mode_display>,
+    PdoEntry<&SlaveRealTimeData::error_code, PdoInputLayout::error_code>,
+    PdoEntry<&SlaveRealTimeData::system_status, PdoInputLayout::system_status>,
+    PdoEntry<&SlaveRealTimeData::motor_temperature, PdoInputLayout::motor_temperature>>;
+
+using RxPdoLayout = std::tuple<
+    PdoEntry<&SlaveCommandData::control_word, PdoOutputLayout::control_word>,
+    PdoEntry<&SlaveCommandData::target_position, PdoOutputLayout::target_position>,
+    PdoEntry<&SlaveCommandData::target_velocity, PdoOutputLayout::target_velocity>,
+    PdoEntry<&SlaveCommandData::target_torque, PdoOutputLayout::target_torque>,
+    PdoEntry<&SlaveCommandData::mode_of_operation, PdoOutputLayout::mode_of_operation>>;
+
+static_assert(pdo_layout_size<SlaveRealTimeData, TxPdoLayout>() == PdoInputLayout::size,
+              "TxPdoLayout does not cover the input PDO");
+static_assert(pdo_layout_size<SlaveCommandData, RxPdoLayout>() == PdoOutputLayout::size,
+              "RxPdoLayout does not cover the output PDO");
+
+//how a real-valued field is carried on the wire: IEEE float, or a scaled integer
+//(STM32 boards without float PDOs), value = raw * scale + offset
+enum class ValueEncoding : uint8_t {
+    Float32,    //4 bytes IEEE-754, scale/offset not applied
+    Int16,
+    UInt16,
+    Int32
+};
+
+/* keep_fixed_point: the StarManager keeps the raw integer only (motor_temperature_raw
+column, CycleAggregates::max_motor_temperature_raw) and the float column reads NaN, so
+integer-only consumers on low-end IPCs pay for no conversion; ReadState::parse still converts
+*/
+struct ScaledFormat {
+    ValueEncoding encoding = ValueEncoding::Float32;
+    float scale = 1.0f;
+    float offset = 0.0f;
+    bool keep_fixed_point = false;
+};
+
+//per-field formats of one slave's input PDO
+struct FieldFormats {
+    ScaledFormat motor_temperature;
+};
+
+/* what the decode does with float values downstream math should not see, per field
+(StarManager::setFloatPolicies); the default passes every value through
+- denormals (glitchy sensors) are flushed to zero: float math on them takes microcode
+assists, dozens of times slower
+- NaN and +-inf are replaced with the slave's last good value and flagged in
+SlaveRealTimeData::invalid_fields, so they do not poison statistics
+- finite values are clamped to [min, max]
+*/
+struct FloatPolicy {
+    bool flush_denormals = false;
+    bool replace_non_finite = false;
+    float min = -std::numeric_limits<float>::infinity();
+    float max = std::numeric_limits<float>::infinity();
+
+    bool active() const {
+        return flush_denormals || replace_non_finite || min > -std::numeric_limits<float>::infinity() ||
+               max < std::numeric_limits<float>::infinity();
+    }
+};
+
+struct FloatPolicies {
+    FloatPolicy motor_temperature;
+};
+
+//raw integer of a fixed-point field (sign- or zero-extended), unchecked like load_le
+int32_t load_scaled_raw(const uint8_t* p, ValueEncoding encoding);
+//both throw std::out_of_range if the field does not fit in the buffer
+float decode_scaled(const uint8_t* data, size_t size, size_t offset, const ScaledFormat& format);
+//nearest raw integer (saturated to the encoding's range) for Int* encodings
+void encode_scaled(uint8_t* data, size_t size, size_t offset, const ScaledFormat& format, float value);
+
+//sub-byte PDO entry (packed digital I/O: 1-bit, 4-bit, ... fields, not byte aligned)
+//bit_offset counts from bit 0 (LSB) of byte 0, EtherCAT bit order
+struct BitField {
+    size_t bit_offset;
+    uint8_t bit_width; //1..32
+};
+
+//throw std::out_of_range if the field does not fit in the buffer, std::invalid_argument for a bad width
+uint32_t extract_bits(const std::vector<uint8_t>& buffer, BitField field);
+void insert_bits(std::vector<uint8_t>& buffer, BitField field, uint32_t value);
+
+
+/* DigitalIoMap class:
+- built once from the bit offsets of all 1-bit inputs/outputs in an I/O image
+- extract(): whole image -> dense bitset, bit k = k-th mapped bit in image order
+- insert(): dense bitset -> image, other image bits untouched
+- works on 64-bit words of the image with one pext/pdep per word (shift/mask loop without BMI2)
+*/
+class DigitalIoMap {
+public:
+    explicit DigitalIoMap(std::vector<size_t> bit_offsets);
+
+    size_t size() const { return channel_count_; }
+
+    //bits is resized to hold size() bits
+    void extract(const std::vector<uint8_t>& image, std::vector<uint64_t>& bits) const;
+    void insert(const std::vector<uint64_t>& bits, std::vector<uint8_t>& image) const;
+
+private:
+    struct Word {
+        size_t byte_offset; //8-byte window of the image
+        uint64_t mask;      //mapped bits in that window
+        size_t first_bit;   //bitset position of the window's lowest mapped bit
+        unsigned bit_count; //number of mapped bits in the window
+    };
+
+    std::vector<Word> words_;
+    size_t channel_count_ = 0;
+    size_t min_image_size_ = 0;
+};
+
 class ReadState {
 public:
 
     SlaveRealTimeData parse(const std::vector<uint8_t>& buffer);
+    SlaveRealTimeData parse(const uint8_t* data, size_t size);
+    //fixed-point fields are decoded with their FieldFormats instead of as IEEE floats
+    SlaveRealTimeData parse(const uint8_t* data, size_t size, const FieldFormats& formats);
 
+    //output side, used by simulated slaves to see what the master commanded
+    SlaveCommandData parse_command(const uint8_t* data, size_t size);
+};
+
+
+/* WriteState class: the encoder mirroring ReadState
+- generated from the same TxPdoLayout / RxPdoLayout
+- writes in place into caller buffers, throws std::out_of_range if a buffer is too small
+*/
+class WriteState {
+public:
+    void encode(const SlaveRealTimeData& data, uint8_t* out, size_t size);
+    void encode(const SlaveRealTimeData& data, std::vector<uint8_t>& buffer);
+    void encode(const SlaveRealTimeData& data, uint8_t* out, size_t size, const FieldFormats& formats);
 
-};
\ No newline at end of file
+    void encode_command(const SlaveCommandData& command, uint8_t* out, size_t size);
+};
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include "error_catalogue.hpp"
+#include "numa_placement.hpp"
+#include "slave_columns.hpp"
+
+
+/* DeviceEvent: one change of a slave's error_code or system_status, as the cycle saw it
+- ErrorCode: code is the new error code (0: the error cleared), severity from the catalogue
+- SystemStatus: code is the new status word; severity of the bits that came on (Info if
+bits only went off)
+*/
+struct DeviceEvent {
+    enum class Kind : uint8_t { ErrorCode, SystemStatus };
+
+    uint64_t cycle;    //commit that first carried the new value
+    uint16_t code;
+    uint16_t previous; //value before the change
+    uint8_t slave_id;
+    Kind kind;
+    Severity severity;
+    DeviceType device_type;
+};
+static_assert(sizeof(DeviceEvent) == 16, "DeviceEvent is 16 bytes");
+
+//"cycle 12 slave 7 [servo-x] error 0x2310 Continuous overcurrent (error)", for logs and HMIs
+std::string describe_event(const DeviceEvent& event, const ErrorCatalogue& catalogue);
+
+
+/* EventQueue class: single-producer single-consumer ring of DeviceEvents
+- producer: the cycle thread (ErrorMonitor::scan); consumer: one other thread (pop)
+- push never waits: a full queue drops the event and counts it
+*/
+class EventQueue {
+public:
+    //capacity rounded up to a power of two; throws std::invalid_argument for 0
+    explicit EventQueue(size_t capacity = 4096, int numa_node = kAnyNumaNode);
+
+    EventQueue(const EventQueue&) = delete;
+    EventQueue& operator=(const EventQueue&) = delete;
+
+    //producer; false if the queue was full
+    bool push(const DeviceEvent& event);
+    //consumer: up to `max` events, oldest first; returns how many
+    size_t pop(DeviceEvent* out, size_t max);
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const; //any thread, approximate while both sides run
+    uint64_t pushed() const { return head_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    const size_t capacity_;
+    MemoryRegion storage_;
+    DeviceEvent* ring_ = nullptr;
+
+    alignas(64) std::atomic<uint64_t> head_{0}; //producer
+    uint64_t tail_cache_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+    alignas(64) std::atomic<uint64_t> tail_{0}; //consumer
+};
+
+
+/* ErrorMonitor class: edge detection on error_code and system_status, once per commit
+- scan() compares both columns of every slot with the previous scan in bulk
+(find_changed_u16), then looks up the catalogue and pushes one event per slot that
+changed; a cycle without changes costs two vector compares per 8-32 slaves
+- slots seen for the first time are compared with 0: a slave that comes up with an
+error raises it
+- slots with data_valid cleared are skipped: a rejected frame raises nothing, and
+its slave is compared with its last valid codes once it is valid again
+- attach it with StarManager::setErrorMonitor; consumers then read a few events
+from the queue instead of scanning every slave every cycle
+*/
+class ErrorMonitor {
+public:
+    ErrorMonitor(const ErrorCatalogue& catalogue, EventQueue& events);
+
+    //not synchronized with the cycle: before it runs; throws std::out_of_range for an unknown type
+    void setDeviceType(uint8_t slave_id, DeviceType type);
+    DeviceType deviceType(uint8_t slave_id) const { return device_type_[slave_id]; }
+
+    //cycle thread; slave_id_of_slot maps slots [0, count) to slave ids; returns the changes found
+    size_t scan(const SlaveColumns& columns, size_t count, const uint8_t* slave_id_of_slot, uint64_t cycle);
+
+    uint64_t events() const { return events_.load(std::memory_order_relaxed); } //changes found, dropped ones too
+    const EventQueue& queue() const { return queue_; }
+
+private:
+    size_t emit(DeviceEvent::Kind kind, const uint16_t* current, uint16_t* previous, const uint8_t* data_valid,
+                size_t count, const uint8_t* slave_id_of_slot, uint64_t cycle);
+
+    const ErrorCatalogue& catalogue_;
+    EventQueue& queue_;
+    std::array<DeviceType, kMaxSlaves> device_type_{}; //by slave id
+    std::array<uint16_t, kMaxSlaves> error_code_{};    //by slot, as of the last scan
+    std::array<uint16_t, kMaxSlaves> system_status_{};
+    std::array<uint16_t, kMaxSlaves> changed_{};       //scan() scratch
+    std::atomic<uint64_t> events_{0};
+};
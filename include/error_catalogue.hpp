@@ -0,0 +1,81 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+
+enum class Severity : uint8_t { Info, Warning, Error, Fatal };
+
+const char* severity_name(Severity severity); //"info", "warning", "error", "fatal"
+
+using DeviceType = uint8_t; //index of a type registered with ErrorCatalogue::add_device_type
+
+struct ErrorCodeInfo {
+    Severity severity = Severity::Error;
+    std::string text;
+};
+
+
+/* ErrorCatalogue class: what a slave's error_code and system_status bits mean,
+per device type (one drive model, one I/O terminal family, ...)
+- device type 0 ("default") always exists; slaves without a type use it
+- an error code the catalogue does not list is Severity::Error, code 0 is "no error" (Info);
+a status bit it does not list is Info
+- filled in code (add_code/add_status_bit) or from a text file (load):
+
+    # comment
+    [servo-x]
+    code 0x2310 error Continuous overcurrent
+    status 3 warning Fan failure
+
+- read-only once the cycle runs: lookups are a binary search (codes) or an array index
+(status bits), no allocation
+*/
+class ErrorCatalogue {
+public:
+    static constexpr DeviceType kDefaultDevice = 0;
+
+    ErrorCatalogue();
+
+    //same name -> same type; throws std::length_error past 256 types
+    DeviceType add_device_type(const std::string& name);
+    //throws std::out_of_range for a name that was not added
+    DeviceType device_type(const std::string& name) const;
+    const std::string& device_type_name(DeviceType type) const;
+    size_t device_type_count() const { return devices_.size(); }
+
+    //throw std::out_of_range for an unknown type; a second entry for a code or bit replaces the first
+    void add_code(DeviceType type, uint16_t code, Severity severity, std::string text);
+    void add_status_bit(DeviceType type, uint8_t bit, Severity severity, std::string text); //bit < 16
+
+    //nullptr if the catalogue does not list it
+    const ErrorCodeInfo* code_info(DeviceType type, uint16_t code) const;
+    const ErrorCodeInfo* status_bit_info(DeviceType type, uint8_t bit) const;
+
+    Severity code_severity(DeviceType type, uint16_t code) const;
+    //highest severity among the bits set in `bits`
+    Severity status_severity(DeviceType type, uint16_t bits) const;
+
+    /* adds the file's types and entries to the catalogue; throws std::runtime_error if it
+    cannot be read, std::invalid_argument (with the line number) for a malformed line
+    */
+    void load(const std::string& path);
+
+private:
+    struct Device {
+        std::string name;
+        std::vector<uint16_t> codes;      //ascending
+        std::vector<ErrorCodeInfo> infos; //parallel to codes
+        std::array<ErrorCodeInfo, 16> bits;
+        std::array<Severity, 16> bit_severity{}; //Info unless listed
+        uint16_t listed_bits = 0;
+    };
+
+    const Device& device(DeviceType type) const; //throws std::out_of_range
+    Device& device(DeviceType type);
+
+    std::vector<Device> devices_;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Star_Manager.hpp"
+
+
+/* EtherCAT on the wire (ETG.1000.4), as a capture shows it:
+Ethernet header (optionally one 802.1Q tag), EtherType 0x88A4, a 2-byte EtherCAT
+header (length, type 1 = datagrams), then datagrams back to back:
+  10-byte header | data (length bytes) | 2-byte working counter
+everything little-endian except the EtherType.
+*/
+
+constexpr uint16_t kEthercatEtherType = 0x88A4;
+
+//datagram commands
+enum class EcatCommand : uint8_t {
+    NOP = 0,
+    APRD = 1, APWR = 2, APRW = 3,    //auto-increment physical addressing
+    FPRD = 4, FPWR = 5, FPRW = 6,    //configured station address
+    BRD = 7, BWR = 8, BRW = 9,       //broadcast
+    LRD = 10, LWR = 11, LRW = 12,    //logical: the process data
+    ARMW = 13, FRMW = 14
+};
+
+//one datagram of a frame; `data` points into the frame (nothing is copied)
+struct EcatDatagram {
+    EcatCommand command;
+    uint8_t index;
+    uint32_t address;        //logical address, or ADP (low 16 bits) and ADO (high 16 bits)
+    uint16_t length;
+    bool circulating;
+    const uint8_t* data;
+    uint16_t working_counter;
+};
+
+enum class FrameStatus : uint8_t {
+    Ok,
+    NotEthercat, //other EtherType, or an EtherCAT frame that carries no datagrams (e.g. mailbox gateway)
+    Truncated,   //shorter than its headers say (snap length of the capture, or a cut frame)
+    Malformed    //datagram chain inconsistent with the EtherCAT header
+};
+
+//splits one Ethernet frame into its datagrams; `datagrams` is cleared and refilled
+FrameStatus decode_ecat_frame(const uint8_t* frame, size_t size, std::vector<EcatDatagram>& datagrams);
+
+
+//where a slave's input PDO sits in the logical address space of the domain
+struct ProcessDataMapping {
+    uint8_t slave_id;
+    uint32_t logical_address;
+};
+
+
+/* CaptureDecoder class: EtherCAT frames -> per-slave input PDO frames
+- each slave's PdoInputLayout::size bytes are sliced out of the logical datagrams
+(LRD, LRW) that cover them, as SlaveFrame views into the frame: zero-copy, ready
+for StarManager::input_cycle() or ReadState::parse()
+- only datagrams that came back processed (working counter != 0) are used: in a
+capture the outgoing copy of the same frame carries no input data yet
+- reuses its buffers, so decoding does not allocate once warmed up
+*/
+class CaptureDecoder {
+public:
+    //input PDOs back to back from `logical_base` in slaves_order order (the process image layout)
+    explicit CaptureDecoder(const std::vector<uint8_t>& slaves_order, uint32_t logical_base = 0);
+    //any layout; throws std::invalid_argument if two slaves share an id
+    explicit CaptureDecoder(std::vector<ProcessDataMapping> mapping);
+
+    //`slaves` is cleared and refilled with every mapped slave the frame carries
+    FrameStatus decode(const uint8_t* frame, size_t size, std::vector<SlaveFrame>& slaves);
+
+    //datagrams of the last decoded frame
+    const std::vector<EcatDatagram>& datagrams() const { return datagrams_; }
+    const std::vector<ProcessDataMapping>& mapping() const { return mapping_; }
+
+private:
+    std::vector<ProcessDataMapping> mapping_; //sorted by logical address
+    std::vector<EcatDatagram> datagrams_;
+};
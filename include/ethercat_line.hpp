@@ -0,0 +1,113 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Ethercat_Hardware_Interface.hpp"
+#include "Star_Manager.hpp"
+#include "numa_placement.hpp"
+#include "rt_logger.hpp"
+#include "timing_metrics.hpp"
+
+
+struct LineConfig {
+    std::string name;
+    std::vector<uint8_t> slaves_order;
+    std::vector<SlavePriority> priorities; //parallel to slaves_order, empty: all Motion
+    std::chrono::nanoseconds decode_budget{0}; //see Ethercat_Hardware_Interface::setDecodeBudget
+    int cpu_core = -1; //-1: leave the cycle thread to the scheduler
+    std::chrono::nanoseconds period = std::chrono::milliseconds(1);
+    PagePolicy pages = PagePolicy::Normal; //process images, registry and snapshots
+    std::vector<WkcGroup> wkc_groups; //see Ethercat_Hardware_Interface::setWkcGroups
+    bool report_placement = true; //print placement_report() to stderr when the cycle thread starts
+    AsyncLogger* logger = nullptr; //cycle diagnostics (overruns, working-counter mismatches) on a channel named after the line
+    ErrorMonitor* error_monitor = nullptr; //error_code / system_status events, see StarManager::setErrorMonitor
+    FloatPolicies float_policies; //see StarManager::setFloatPolicies
+};
+
+//fills the input process image for the next cycle (IgH domain, pcap replay, LoadGenerator)
+using ImageSource = std::function<void(uint8_t* input_image, size_t size)>;
+//receives the output process image after write_kernel (optional)
+using ImageSink = std::function<void(const uint8_t* output_image, size_t size)>;
+//after the source: the working counter of each LineConfig::wkc_groups entry this cycle
+//(IgH: ecrt_domain_state of each domain); optional, without it nothing is checked
+using WorkingCounterSource = std::function<void(uint16_t* working_counters, size_t count)>;
+
+
+/* EthercatLine class: one EtherCAT line of a cell
+- owns its Ethercat_Hardware_Interface (and with it its StarManager) and process images,
+all allocated on the NUMA node of config.cpu_core, on hugepages if config.pages asks
+- start() runs the cycle on its own thread, pinned to config.cpu_core:
+  source -> working counters -> read_kernel (decode + validate + commit) -> write_kernel -> sink,
+  once per period
+- nothing on the cycle path is shared with other lines; other threads only read
+the committed snapshot (StarManager::readSnapshot) and the metrics
+
+setCommand() is not synchronized with the cycle thread: set commands before start()
+or from inside the source callback.
+*/
+class EthercatLine {
+public:
+    EthercatLine(LineConfig config, ImageSource source, ImageSink sink = nullptr,
+                 WorkingCounterSource working_counters = nullptr);
+    ~EthercatLine(); //stops the cycle thread
+
+    EthercatLine(const EthercatLine&) = delete;
+    EthercatLine& operator=(const EthercatLine&) = delete;
+
+    void start();
+    void stop();
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+    //one cycle on the calling thread; for tests and for callers with their own loop
+    void run_cycle();
+
+    const LineConfig& config() const { return config_; }
+    Ethercat_Hardware_Interface& hardware() { return hardware_; }
+    //non-const: cycle thread or line stopped (getSlaveData); other threads use readSnapshot
+    StarManager& star_manager() { return hardware_.star_manager(); }
+    const StarManager& star_manager() const { return hardware_.star_manager(); }
+
+    //metrics, readable from any thread while the line runs
+    uint64_t cycles() const { return cycles_.load(std::memory_order_relaxed); }
+    uint64_t overruns() const { return overruns_.load(std::memory_order_relaxed); } //cycle ran past the next deadline
+    //working-counter mismatches (per group and domain: hardware().wkcStats / domainWkcStats)
+    uint64_t invalidated_frames() const { return hardware_.invalidated_frames(); }
+    const TimingMetrics& cycle_time() const { return cycle_time_; }         //source .. sink
+    const TimingMetrics& wakeup_latency() const { return wakeup_latency_; } //deadline -> thread running
+    int pinned_core() const { return pinned_core_.load(std::memory_order_relaxed); } //-1 if not pinned
+
+    //node of config.cpu_core (-1: not pinned or no NUMA), and where each buffer actually is, on which pages
+    int numa_node() const { return numa_node_; }
+    std::string placement_report() const;
+
+private:
+    void cycle_loop();
+
+    LineConfig config_;
+    ImageSource source_;
+    ImageSink sink_;
+    WorkingCounterSource working_counter_source_;
+    std::vector<uint16_t> working_counters_; //one per config_.wkc_groups entry
+    int numa_node_;
+    Ethercat_Hardware_Interface hardware_;
+    MemoryRegion input_image_;
+    MemoryRegion output_image_;
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<int> pinned_core_{-1};
+
+    LogChannel* log_ = nullptr; //config_.logger's channel of this line's cycle thread
+    LogFormat overrun_format_ = 0;
+    LogFormat wkc_format_ = 0;
+
+    std::atomic<uint64_t> cycles_{0};
+    std::atomic<uint64_t> overruns_{0};
+    TimingMetrics cycle_time_;
+    TimingMetrics wakeup_latency_;
+};
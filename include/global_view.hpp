@@ -0,0 +1,36 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Star_Manager.hpp"
+#include "slaves_state_struct.hpp"
+
+
+/* GlobalView class: read-only view over every line of a cell
+- refresh() copies the latest committed snapshot of each StarManager into
+buffers owned by the view; the cycle threads are never written to or blocked
+- lines are addressed by their index in the constructor's vector,
+slaves by (line, slave_id) since ids repeat across lines
+- one GlobalView per reader thread; refresh() and the getters are not synchronized
+- numa_node: node of that reader thread, for the view's own snapshot copies
+*/
+class GlobalView {
+public:
+    explicit GlobalView(std::vector<const StarManager*> lines, int numa_node = kAnyNumaNode);
+
+    void refresh();
+
+    size_t line_count() const { return lines_.size(); }
+    const StarSnapshot& line(size_t index) const { return snapshots_.at(index); }
+
+    //throws std::out_of_range for an unknown line or a slave missing from its snapshot
+    SlaveRealTimeData getSlaveData(size_t line, uint8_t slave_id) const;
+
+    size_t slave_count() const; //over all lines
+    uint64_t oldest_commit_ns() const; //line lagging the most; 0 if a line has not committed yet
+
+private:
+    std::vector<const StarManager*> lines_;
+    std::vector<StarSnapshot> snapshots_;
+};
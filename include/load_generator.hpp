@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "data_structuring.hpp"
+#include "slaves_state_struct.hpp"
+
+
+/* LoadGenerator class:
+- simulates `slave_count` drives for tests and benchmarks
+- every cycle advances each drive (position += velocity, torque and temperature wander)
+- encodes all of them into an input process image with WriteState, in place
+- every 4th drive stands still, so its frame repeats from cycle to cycle
+*/
+class LoadGenerator {
+public:
+    explicit LoadGenerator(size_t slave_count);
+
+    //writes the next cycle into image[0, image_size()), throws std::out_of_range if smaller
+    void next_cycle(uint8_t* image, size_t size);
+    void next_cycle(std::vector<uint8_t>& image);
+
+    size_t slave_count() const { return slaves_.size(); }
+    size_t image_size() const { return slaves_.size() * PdoInputLayout::size; }
+    uint64_t cycle() const { return cycle_; }
+
+    //values encoded for slave `index` in the last cycle, for comparing against the decoder
+    const SlaveRealTimeData& slave(size_t index) const { return slaves_.at(index); }
+
+private:
+    std::vector<SlaveRealTimeData> slaves_;
+    uint64_t cycle_ = 0;
+    WriteState encoder_;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/* NUMA placement:
+on dual-socket hosts a cycle thread whose registry sits on the other socket pays
+the interconnect on every input_handler() call, so per-line memory is allocated
+on the node of the line's cycle core.
+
+backends, picked at build time:
+- libnuma (STAR_HAVE_LIBNUMA, found by CMake): numa_alloc_onnode
+- Linux without libnuma: mmap + mbind(MPOL_PREFERRED) through the raw syscall
+- anything else: plain aligned heap memory, node reported as unknown (-1)
+*/
+
+constexpr int kAnyNumaNode = -1;
+
+//"libnuma", "mbind" or "none"
+const char* numa_backend_name();
+
+//nodes with memory on this host; 1 when NUMA is unavailable
+int host_numa_nodes();
+
+//-1 if unknown (no NUMA support, or no such cpu)
+int cpu_numa_node(int cpu);
+
+//node holding the page at `address`, -1 if unknown
+int memory_numa_node(const void* address);
+
+
+/* page size of a region (TLB reach): registries, snapshots and rings of many lines
+add up to many MB, and with 4 kB pages every few slots cost a TLB entry
+- Normal: system default pages
+- Transparent: 2 MB aligned mapping with madvise(MADV_HUGEPAGE); the kernel may or may not comply
+- Huge: explicit 2 MB hugepages (MAP_HUGETLB, needs vm.nr_hugepages), else as Transparent
+both hugepage policies round the region up to 2 MB: meant for hosts that have the memory to spare.
+Off Linux every policy is Normal.
+*/
+enum class PagePolicy : uint8_t {
+    Normal,
+    Transparent,
+    Huge
+};
+
+//what a region actually got
+enum class PageKind : uint8_t {
+    None,            //empty region
+    Normal,
+    TransparentHuge, //at least part of the region is backed by THP
+    Huge             //MAP_HUGETLB
+};
+
+constexpr size_t kHugePageSize = size_t{2} << 20;
+
+//"none", "4k", "thp" or "2M"
+const char* page_kind_name(PageKind kind);
+
+
+/* MemoryRegion class:
+- owns `bytes` of zero-filled memory, 64-byte aligned, preferably on `numa_node`
+(kAnyNumaNode: wherever the allocator puts it), with pages as `pages` asks, falling
+back to normal pages when hugepages are not available
+- zero-filling touches every page here, so the pages exist before the first cycle
+- move-only; moves keep the address
+*/
+class MemoryRegion {
+public:
+    MemoryRegion() = default;
+    explicit MemoryRegion(size_t bytes, int numa_node = kAnyNumaNode, PagePolicy pages = PagePolicy::Normal);
+    ~MemoryRegion();
+
+    MemoryRegion(MemoryRegion&& other) noexcept;
+    MemoryRegion& operator=(MemoryRegion&& other) noexcept;
+    MemoryRegion(const MemoryRegion&) = delete;
+    MemoryRegion& operator=(const MemoryRegion&) = delete;
+
+    uint8_t* data() const { return data_; }
+    size_t size() const { return size_; }
+    int requested_node() const { return requested_node_; }
+    int node() const { return memory_numa_node(data_); } //where the pages actually are
+    PageKind page_kind() const { return page_kind_; }     //decided when the region was filled
+
+private:
+    enum class Backing : uint8_t { None, Heap, LibNuma, Mmap };
+
+    void release();
+
+    uint8_t* data_ = nullptr;
+    size_t size_ = 0;
+    size_t mapped_ = 0; //bytes handed to munmap/numa_free (whole pages)
+    int requested_node_ = kAnyNumaNode;
+    Backing backing_ = Backing::None;
+    PageKind page_kind_ = PageKind::None;
+};
@@ -0,0 +1,221 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* generic PDO field access:
+extract<T>() reads and insert<T>() writes one field of type T at a byte offset,
+EtherCAT little-endian, packed (a field takes sizeof(T) bytes on the wire).
+
+T can be any integer width, float, double, an enum, or a std::array of those
+(e.g. std::array<int16_t, 8> analog channels). Decoder and encoder use the same
+templates, and the size per call site is a compile-time constant.
+
+load_le/store_le are the unchecked versions for kernels that already checked bounds;
+extract/insert throw std::out_of_range if the field does not fit in the buffer.
+*/
+
+template <typename T>
+struct is_std_array : std::false_type {};
+
+template <typename E, size_t N>
+struct is_std_array<std::array<E, N>> : std::true_type {};
+
+
+template <typename T>
+T load_le(const uint8_t* p) {
+    static_assert(std::is_trivially_copyable<T>::value, "PDO fields must be trivially copyable");
+
+    if constexpr (is_std_array<T>::value) {
+        using Element = typename T::value_type;
+        static_assert(sizeof(T) == sizeof(Element) * std::tuple_size<T>::value, "padded std::array");
+        T value;
+        for (size_t i = 0; i < value.size(); ++i) {
+            value[i] = load_le<Element>(p + i * sizeof(Element));
+        }
+        return value;
+    } else if constexpr (std::is_enum<T>::value) {
+        return static_cast<T>(load_le<std::underlying_type_t<T>>(p));
+    } else if constexpr (std::is_floating_point<T>::value) {
+        //same-size unsigned integer carries the IEEE bits
+        using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        static_assert(sizeof(T) == sizeof(Bits), "only float and double are supported");
+        Bits bits = load_le<Bits>(p);
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    } else if constexpr (std::is_same<T, bool>::value) {
+        return p[0] != 0;
+    } else {
+        static_assert(std::is_integral<T>::value, "unsupported PDO field type");
+        //Ethercat buffer is Little-Endian: byte i holds bits 8i..8i+7, independent of the host order
+        using Unsigned = std::make_unsigned_t<T>;
+        Unsigned value = 0;
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            value |= static_cast<Unsigned>(static_cast<Unsigned>(p[i]) << (8 * i));
+        }
+        return static_cast<T>(value); //casting to signed handles the sign bit
+    }
+}
+
+template <typename T>
+void store_le(uint8_t* p, const T& value) {
+    static_assert(std::is_trivially_copyable<T>::value, "PDO fields must be trivially copyable");
+
+    if constexpr (is_std_array<T>::value) {
+        using Element = typename T::value_type;
+        for (size_t i = 0; i < value.size(); ++i) {
+            store_le<Element>(p + i * sizeof(Element), value[i]);
+        }
+    } else if constexpr (std::is_enum<T>::value) {
+        store_le<std::underlying_type_t<T>>(p, static_cast<std::underlying_type_t<T>>(value));
+    } else if constexpr (std::is_floating_point<T>::value) {
+        using Bits = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+        static_assert(sizeof(T) == sizeof(Bits), "only float and double are supported");
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        store_le<Bits>(p, bits);
+    } else if constexpr (std::is_same<T, bool>::value) {
+        p[0] = value ? 1 : 0;
+    } else {
+        static_assert(std::is_integral<T>::value, "unsupported PDO field type");
+        using Unsigned = std::make_unsigned_t<T>;
+        Unsigned bits = static_cast<Unsigned>(value);
+        for (size_t i = 0; i < sizeof(T); ++i) {
+            p[i] = static_cast<uint8_t>(bits >> (8 * i));
+        }
+    }
+}
+
+
+inline void check_field_bounds(size_t buffer_size, size_t offset, size_t field_size) {
+    if (offset > buffer_size || field_size > buffer_size - offset) {
+        throw std::out_of_range("PDO field outside of buffer");
+    }
+}
+
+template <typename T>
+T extract(const uint8_t* data, size_t size, size_t offset) {
+    check_field_bounds(size, offset, sizeof(T));
+    return load_le<T>(data + offset);
+}
+
+template <typename T>
+T extract(const std::vector<uint8_t>& buffer, size_t offset) {
+    return extract<T>(buffer.data(), buffer.size(), offset);
+}
+
+template <typename T>
+void insert(uint8_t* data, size_t size, size_t offset, const T& value) {
+    check_field_bounds(size, offset, sizeof(T));
+    store_le<T>(data + offset, value);
+}
+
+template <typename T>
+void insert(std::vector<uint8_t>& buffer, size_t offset, const T& value) {
+    insert<T>(buffer.data(), buffer.size(), offset, value);
+}
+
+
+/* layout-driven decode/encode:
+a layout is a std::tuple of PdoEntry<&Struct::member, byte offset>, written once
+per PDO (see TxPdoLayout / RxPdoLayout in data_structuring.hpp). decode_layout and
+encode_layout expand it into one load_le/store_le per entry, so the parser and the
+encoder cannot disagree on offsets or types.
+*/
+
+template <auto Member, size_t Offset>
+struct PdoEntry {
+    static constexpr auto member = Member;
+    static constexpr size_t offset = Offset;
+};
+
+template <typename Struct, typename Entry>
+using pdo_entry_type = std::remove_reference_t<decltype(std::declval<Struct&>().*Entry::member)>;
+
+//bytes a layout covers: end of the entry reaching furthest
+template <typename Struct, typename Layout, size_t... I>
+constexpr size_t pdo_layout_size_impl(std::index_sequence<I...>) {
+    size_t size = 0;
+    ((size = std::max(size, std::tuple_element_t<I, Layout>::offset +
+                                sizeof(pdo_entry_type<Struct, std::tuple_element_t<I, Layout>>))), ...);
+    return size;
+}
+
+template <typename Struct, typename Layout>
+constexpr size_t pdo_layout_size() {
+    return pdo_layout_size_impl<Struct, Layout>(std::make_index_sequence<std::tuple_size<Layout>::value>{});
+}
+
+template <typename Struct, typename Layout, size_t... I>
+void decode_layout_impl(const uint8_t* data, Struct& out, std::index_sequence<I...>) {
+    ((out.*std::tuple_element_t<I, Layout>::member =
+          load_le<pdo_entry_type<Struct, std::tuple_element_t<I, Layout>>>(
+              data + std::tuple_element_t<I, Layout>::offset)), ...);
+}
+
+template <typename Struct, typename Layout, size_t... I>
+void encode_layout_impl(const Struct& in, uint8_t* data, std::index_sequence<I...>) {
+    (store_le<pdo_entry_type<Struct, std::tuple_element_t<I, Layout>>>(
+         data + std::tuple_element_t<I, Layout>::offset, in.*std::tuple_element_t<I, Layout>::member), ...);
+}
+
+//one bounds check for the whole frame, then unchecked field access
+template <typename Layout, typename Struct>
+void decode_layout(const uint8_t* data, size_t size, Struct& out) {
+    check_field_bounds(size, 0, pdo_layout_size<Struct, Layout>());
+    decode_layout_impl<Struct, Layout>(data, out, std::make_index_sequence<std::tuple_size<Layout>::value>{});
+}
+
+template <typename Layout, typename Struct>
+void encode_layout(const Struct& in, uint8_t* data, size_t size) {
+    check_field_bounds(size, 0, pdo_layout_size<Struct, Layout>());
+    encode_layout_impl<Struct, Layout>(in, data, std::make_index_sequence<std::tuple_size<Layout>::value>{});
+}
+
+
+/* one field of a layout, by member: offset and type come from the layout entry,
+so a reader that wants only actual_position decodes 4 bytes instead of the frame.
+extract_entry<TxPdoLayout, &SlaveRealTimeData::actual_position>(data, size)
+*/
+template <typename Layout, auto Member, size_t I = 0>
+constexpr size_t pdo_entry_offset() {
+    static_assert(I < std::tuple_size<Layout>::value, "member is not part of this PDO layout");
+    if constexpr (I < std::tuple_size<Layout>::value) {
+        using Entry = std::tuple_element_t<I, Layout>;
+        if constexpr (std::is_same<std::remove_cv_t<decltype(Entry::member)>, decltype(Member)>::value) {
+            if constexpr (Entry::member == Member) {
+                return Entry::offset;
+            } else {
+                return pdo_entry_offset<Layout, Member, I + 1>();
+            }
+        } else {
+            return pdo_entry_offset<Layout, Member, I + 1>();
+        }
+    } else {
+        return 0;
+    }
+}
+
+template <auto Member>
+struct pdo_member;
+
+template <typename Struct, typename T, T Struct::*Member>
+struct pdo_member<Member> {
+    using struct_type = Struct;
+    using type = T;
+};
+
+template <typename Layout, auto Member>
+typename pdo_member<Member>::type extract_entry(const uint8_t* data, size_t size) {
+    using T = typename pdo_member<Member>::type;
+    return extract<T>(data, size, pdo_entry_offset<Layout, Member>());
+}
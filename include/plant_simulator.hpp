@@ -0,0 +1,111 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "numa_placement.hpp"
+#include "simd_kernels.hpp"
+#include "slaves_state_struct.hpp"
+
+
+/* AxisParameters: one simulated drive and its motor
+- positions in counts, velocities in counts/s, torques in per mille of rated torque
+(the units of the PDO fields), temperatures in degrees C
+- mechanics: second order, accel = torque * accel_per_torque - damping * velocity
+- current loop: first order lag of torque_time_constant on the torque command
+- the drive's own cascade closes the loop: P position loop (CSP) -> PI velocity
+loop (CSP, CSV) -> torque command, clamped to +-torque_limit; CST adds the target
+torque straight to the command
+- thermal: first order towards ambient + heating * torque^2
+*/
+struct AxisParameters {
+    double accel_per_torque = 2000.0; //counts/s^2 per mille
+    double damping = 5.0;             //1/s, viscous friction over inertia
+    double torque_limit = 3000.0;     //per mille, at most 32767
+    double torque_time_constant = 0.0005; //s
+
+    double position_gain = 30.0;      //1/s
+    double velocity_gain = 0.05;      //per mille per counts/s
+    double integral_gain = 1.25;      //per mille per count (velocity error integrated over time)
+
+    double ambient_temperature = 25.0;
+    double thermal_time_constant = 60.0; //s
+    double heating = 40e-6;           //steady-state rise in degrees C per (per mille)^2
+    double trip_temperature = 110.0;  //over-temperature fault above this
+};
+
+
+/* PlantSimulator class: closed-loop drives behind a simulated line
+- one axis per slave, in slave order: apply_outputs() reads the output process
+image (PdoOutputLayout per slave), step() advances every axis by one period,
+write_inputs() encodes the input process image (PdoInputLayout per slave)
+- step() runs the plant_step kernel (simd_kernels.hpp) over all axes at once, in
+`substeps` Euler steps per period; the state lives in SoA columns of doubles
+- CiA402, reduced to what a controller test needs:
+  - enabled while (control_word & 0x0F) == 0x0F and no fault: status_word 0x0237,
+  else 0x0250 (switch on disabled) and the axis coasts
+  - modes 8 (CSP), 9 (CSV), 10 (CST); any other mode holds no torque
+  - above trip_temperature the drive faults (status_word 0x0218, error_code 0x4310)
+  and coasts; control_word bit 7 clears the fault once it has cooled down
+- with an EthercatLine: apply_outputs() from the sink, step() + write_inputs() from
+the source (or cycle() where the caller owns the loop)
+*/
+class PlantSimulator {
+public:
+    static constexpr uint16_t kOverTemperatureError = 0x4310;
+
+    //throws std::invalid_argument for a non-positive period or no substeps
+    PlantSimulator(size_t axis_count, std::chrono::nanoseconds period, const AxisParameters& parameters = {},
+                   size_t substeps = 4, int numa_node = kAnyNumaNode);
+
+    PlantSimulator(const PlantSimulator&) = delete;
+    PlantSimulator& operator=(const PlantSimulator&) = delete;
+
+    //throws std::out_of_range for an axis past axis_count(), std::invalid_argument for bad parameters
+    void setParameters(size_t axis, const AxisParameters& parameters);
+    const AxisParameters& parameters(size_t axis) const { return parameters_.at(axis); }
+
+    //throw std::out_of_range if the image is smaller than output_image_size() / input_image_size()
+    void apply_outputs(const uint8_t* image, size_t size);
+    void step();
+    void write_inputs(uint8_t* image, size_t size) const;
+    //all three, for callers with their own loop
+    void cycle(const uint8_t* outputs, size_t output_size, uint8_t* inputs, size_t input_size);
+
+    //what write_inputs() encodes for `axis` (std::out_of_range past axis_count())
+    SlaveRealTimeData axis(size_t axis) const;
+    //the model itself, unrounded
+    double position(size_t axis) const { return columns_.position[checked(axis)]; }
+    double velocity(size_t axis) const { return columns_.velocity[checked(axis)]; }
+    double torque(size_t axis) const { return columns_.torque[checked(axis)]; }
+    double temperature(size_t axis) const { return columns_.temperature[checked(axis)]; }
+    bool faulted(size_t axis) const { return drives_[checked(axis)].faulted; }
+
+    size_t axis_count() const { return drives_.size(); }
+    size_t substeps() const { return substeps_; }
+    uint64_t steps() const { return steps_; }
+    std::chrono::nanoseconds period() const { return period_; }
+    size_t input_image_size() const;
+    size_t output_image_size() const;
+
+private:
+    //CiA402 side of one axis, scalar
+    struct Drive {
+        SlaveCommandData command{}; //last one applied
+        bool enabled = false;
+        bool faulted = false;
+    };
+
+    size_t checked(size_t axis) const;
+    void apply_command(size_t axis, const SlaveCommandData& command);
+
+    const std::chrono::nanoseconds period_;
+    const size_t substeps_;
+    const double dt_; //one substep, s
+    MemoryRegion storage_;
+    PlantColumns columns_;
+    std::vector<AxisParameters> parameters_;
+    std::vector<Drive> drives_;
+    uint64_t steps_ = 0;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "data_structuring.hpp"
+#include "numa_placement.hpp"
+#include "pdo_field.hpp"
+#include "slave_columns.hpp"
+#include "slaves_state_struct.hpp"
+
+
+/* registry decode modes:
+- Eager: every frame is decoded into the columns when it arrives (default)
+- Lazy: the raw frame is stored, fields are decoded when read (getField, getSlaveData)
+- LazyCached: as Lazy, and the first getSlaveData() of a slave in a cycle
+decodes it into the columns, later reads in that cycle come from there
+*/
+enum class DecodeMode : uint8_t {
+    Eager,
+    Lazy,
+    LazyCached
+};
+
+
+/* RawFrameStore class: one PdoInputLayout::size frame per registry slot
+- `scaled[slot]` = 1: the temperature is read from the motor_temperature column, not
+the frame: a fixed-point temperature (FieldFormats), converted when the frame arrives,
+or one sanitized on arrival (FloatPolicy)
+*/
+class RawFrameStore {
+public:
+    static constexpr size_t kFrameSize = PdoInputLayout::size;
+
+    explicit RawFrameStore(size_t capacity = kMaxSlaves, int numa_node = kAnyNumaNode,
+                           PagePolicy pages = PagePolicy::Normal);
+
+    uint8_t* frame(size_t slot) { return frames_.data() + slot * kFrameSize; }
+    const uint8_t* frame(size_t slot) const { return frames_.data() + slot * kFrameSize; }
+
+    PageKind page_kind() const { return frames_.page_kind(); }
+
+    //slots [0, count) of frames and flags
+    void copy_from(const RawFrameStore& other, size_t count);
+
+    std::array<uint8_t, kMaxSlaves> scaled{};
+
+private:
+    MemoryRegion frames_;
+};
+
+
+//whole record of a lazily stored slot: wire fields from the frame, the rest from the columns
+SlaveRealTimeData decode_stored_slave(const RawFrameStore& store, const SlaveColumns& columns, size_t slot);
+
+//one wire field of a lazily stored slot
+template <auto Member>
+typename pdo_member<Member>::type decode_stored_field(const RawFrameStore& store, const SlaveColumns& columns,
+                                                      size_t slot) {
+    if constexpr (std::is_same<decltype(Member), float SlaveRealTimeData::*>::value) {
+        if (Member == &SlaveRealTimeData::motor_temperature && store.scaled[slot]) {
+            return columns.motor_temperature[slot];
+        }
+    }
+    return load_le<typename pdo_member<Member>::type>(store.frame(slot) + pdo_entry_offset<TxPdoLayout, Member>());
+}
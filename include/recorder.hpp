@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "Star_Manager.hpp"
+#include "checkpoint.hpp"
+#include "numa_placement.hpp"
+
+
+//what the recorder keeps of one committed cycle of one line
+struct RecordedCycle {
+    uint32_t line = 0;
+    uint64_t cycle = 0;
+    uint64_t commit_time_ns = 0;
+    CycleAggregates aggregates;
+};
+
+
+/* Recorder class: ring of the latest committed cycles, for post-mortem and export
+- storage is allocated once in the constructor (optionally on a NUMA node and on
+hugepages, see MemoryRegion); record() never allocates
+- when full, record() overwrites the oldest entry and counts it in overwritten()
+- one thread records and reads (e.g. the thread refreshing a GlobalView)
+*/
+class Recorder {
+public:
+    //throws std::invalid_argument for capacity 0
+    explicit Recorder(size_t capacity, int numa_node = kAnyNumaNode, PagePolicy pages = PagePolicy::Normal);
+
+    void record(const RecordedCycle& entry);
+    void record(uint32_t line, const StarSnapshot& snapshot);
+
+    size_t capacity() const { return capacity_; }
+    size_t size() const { return written_ < capacity_ ? static_cast<size_t>(written_) : capacity_; }
+    uint64_t written() const { return written_; }
+    uint64_t overwritten() const { return written_ - size(); }
+
+    //0: oldest entry still held; throws std::out_of_range for index >= size()
+    const RecordedCycle& at(size_t index) const;
+    const RecordedCycle& latest() const { return at(size() - 1); }
+
+    void clear() { written_ = 0; }
+
+    /* warm restart (checkpoint.hpp), Recorder section: the entries held and the written count.
+    A smaller ring keeps the newest entries; false if the checkpoint has no Recorder section
+    */
+    void write_checkpoint(CheckpointWriter& writer) const;
+    bool restore_checkpoint(CheckpointReader& reader);
+
+    //Recorder section read and checked (throws std::invalid_argument), not applied yet
+    struct Checkpoint {
+        uint64_t written = 0;
+        std::vector<RecordedCycle> entries;
+    };
+    bool load_checkpoint(CheckpointReader& reader, Checkpoint& out) const;
+    void apply_checkpoint(const Checkpoint& checkpoint);
+
+    PageKind page_kind() const { return storage_.page_kind(); }
+
+private:
+    MemoryRegion storage_;
+    RecordedCycle* ring_ = nullptr;
+    size_t capacity_ = 0;
+    uint64_t written_ = 0; //total, never wraps; slot of entry n is n % capacity
+};
@@ -0,0 +1,197 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "numa_placement.hpp"
+
+
+enum class LogLevel : uint8_t { Debug, Info, Warning, Error };
+
+using LogFormat = uint16_t; //index of a text registered with AsyncLogger::register_format
+
+//one formatted line, without the newline: "<seconds since start> <LEVEL> [<channel>] <text>"
+using LogSink = std::function<void(const std::string& line)>;
+
+constexpr size_t kMaxLogArgs = 6;
+
+
+/* LogRecord: one message as the cycle thread leaves it, a cache line each
+- the format id and the raw arguments, no text: formatting happens on the logger thread
+- types: 2 bits per argument (LogRecord::Type)
+*/
+struct alignas(64) LogRecord {
+    enum Type : uint8_t { Signed = 0, Unsigned = 1, Float = 2 };
+
+    uint64_t timestamp_ns; //steady_clock
+    LogFormat format;
+    uint8_t count;
+    uint16_t types;
+    uint64_t args[kMaxLogArgs];
+};
+static_assert(sizeof(LogRecord) == 64, "LogRecord is one cache line");
+
+
+/* LogChannel class: single-producer ring of LogRecords, one per logging thread
+- log() is a clock read, a few stores and one release store: no lock, no allocation,
+no formatting, no system call; safe on a cycle thread
+- ring full: the message is dropped and counted, the producer never waits. The logger
+thread reports the drops as a line of their own
+- arguments: integers, bools, enums and floating-point values only (no strings: a
+pointer may be gone by the time the logger thread formats it)
+*/
+class LogChannel {
+public:
+    LogChannel(std::string name, size_t capacity, int numa_node);
+
+    LogChannel(const LogChannel&) = delete;
+    LogChannel& operator=(const LogChannel&) = delete;
+
+    //owning thread only; false if the ring was full and the message dropped
+    template <typename... Args>
+    bool log(LogFormat format, Args... args) {
+        static_assert(sizeof...(Args) <= kMaxLogArgs, "too many log arguments");
+        const uint64_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ == capacity_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ == capacity_) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+        }
+        LogRecord& record = ring_[head & (capacity_ - 1)];
+        record.timestamp_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+        record.format = format;
+        record.count = static_cast<uint8_t>(sizeof...(Args));
+        record.types = 0;
+        size_t index = 0;
+        (put_arg(record, index++, args), ...);
+        (void)index;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    const std::string& name() const { return name_; }
+    size_t capacity() const { return capacity_; }
+    //any thread
+    uint64_t logged() const { return head_.load(std::memory_order_relaxed); }
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+
+private:
+    friend class AsyncLogger;
+
+    template <typename T>
+    static void put_arg(LogRecord& record, size_t index, T value) {
+        static_assert(std::is_arithmetic<T>::value || std::is_enum<T>::value,
+                      "log arguments are numbers or enums");
+        uint64_t bits = 0;
+        uint16_t type = LogRecord::Signed;
+        if constexpr (std::is_enum<T>::value) {
+            using Underlying = std::underlying_type_t<T>;
+            return put_arg(record, index, static_cast<Underlying>(value));
+        } else if constexpr (std::is_floating_point<T>::value) {
+            const double wide = static_cast<double>(value);
+            std::memcpy(&bits, &wide, sizeof(bits));
+            type = LogRecord::Float;
+        } else if constexpr (std::is_signed<T>::value) {
+            bits = static_cast<uint64_t>(static_cast<int64_t>(value));
+        } else {
+            bits = static_cast<uint64_t>(value);
+            type = LogRecord::Unsigned;
+        }
+        record.args[index] = bits;
+        record.types = static_cast<uint16_t>(record.types | (type << (2 * index)));
+    }
+
+    //logger thread: copies out what the producer published, then frees the slots
+    size_t drain(std::vector<LogRecord>& out);
+
+    const std::string name_;
+    const size_t capacity_; //power of two
+    MemoryRegion storage_;
+    LogRecord* ring_ = nullptr;
+
+    alignas(64) std::atomic<uint64_t> head_{0}; //producer
+    uint64_t tail_cache_ = 0;                    //producer's last view of tail_
+    std::atomic<uint64_t> dropped_{0};          //producer
+    alignas(64) std::atomic<uint64_t> tail_{0}; //logger thread
+    uint64_t reported_drops_ = 0;                //logger thread
+};
+
+
+/* AsyncLogger class: binary logging for the cycle threads, text on a thread of its own
+- formats are registered up front (register_format), messages carry only the id:
+"slave {} invalid frame", `{}` an argument in decimal (%g for floating point), `{x}` in hex
+- every logging thread opens its own channel (open_channel) and logs through it; the
+logger thread (start(), pinned to a non-RT core) or drain() collects all channels,
+orders the messages by timestamp and hands each formatted line to the sink
+- lines for drops ("<n> messages dropped") are emitted as Warning on the channel
+that dropped them
+- the destructor stops the thread and drains what is left
+*/
+class AsyncLogger {
+public:
+    //sink null: std::clog
+    explicit AsyncLogger(LogSink sink = nullptr);
+    ~AsyncLogger();
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    //any thread, before logging it; same level and text -> same id; throws std::length_error past 65536 formats
+    LogFormat register_format(LogLevel level, const std::string& text);
+
+    /* a ring of `capacity` messages (rounded up to a power of two, 64 bytes each) on
+    `numa_node` (the node of the logging thread's core). Owned by the logger and valid
+    as long as it; throws std::invalid_argument for capacity 0
+    */
+    LogChannel& open_channel(const std::string& name, size_t capacity = 1024, int numa_node = kAnyNumaNode);
+
+    //logger thread, pinned to cpu_core if >= 0, draining every poll_interval
+    void start(int cpu_core = -1, std::chrono::nanoseconds poll_interval = std::chrono::milliseconds(1));
+    void stop(); //drains once more after the thread is gone
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+    //formats and writes everything published so far, on the calling thread; returns the lines written
+    size_t drain();
+
+    uint64_t written() const { return written_.load(std::memory_order_relaxed); } //lines, drop reports included
+    uint64_t dropped() const; //over all channels
+
+    //"{}" / "{x}" filled from the record's arguments; a placeholder without an argument prints "{?}"
+    static std::string format(const std::string& text, const LogRecord& record);
+
+private:
+    struct Format {
+        LogLevel level;
+        std::string text;
+    };
+
+    void drain_loop(int cpu_core, std::chrono::nanoseconds poll_interval);
+    std::string line(const LogRecord& record, const std::string& channel) const;
+
+    LogSink sink_;
+    const uint64_t start_ns_;
+
+    mutable std::mutex mutex_; //formats_ and channels_
+    std::vector<Format> formats_;
+    std::vector<std::unique_ptr<LogChannel>> channels_;
+
+    std::mutex drain_mutex_; //one drain() at a time: the sink is not assumed thread-safe
+    std::vector<LogRecord> batch_;
+    std::vector<size_t> batch_channel_; //channel index of each batch_ entry
+
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<uint64_t> written_{0};
+};
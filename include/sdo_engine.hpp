@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "sdo_mailbox.hpp"
+#include "timing_metrics.hpp"
+
+
+enum class SdoStatus : uint8_t {
+    Ok,
+    Aborted,   //the slave answered with an abort code
+    Timeout,   //no answer before the request's deadline
+    Cancelled  //the engine was destroyed first
+};
+
+struct SdoResult {
+    SdoStatus status = SdoStatus::Ok;
+    uint32_t abort_code = 0;
+    std::vector<uint8_t> data; //upload: the value
+};
+
+using SdoCallback = std::function<void(uint8_t slave_id, const SdoResult& result)>;
+
+struct SdoEngineStats {
+    uint64_t completed = 0; //every outcome
+    uint64_t aborted = 0;
+    uint64_t timed_out = 0;
+    uint64_t callback_failures = 0; //callbacks that threw
+    size_t max_in_flight = 0;
+    TimingSummary latency;  //submit -> result, answered requests only
+};
+
+
+/* SdoEngine class: asynchronous CoE SDO requests over a MailboxTransport
+- any thread submits uploads/downloads and gets a std::future or a callback;
+nothing waits for the answer
+- per slave, requests go out in submission order, one at a time (one mailbox
+per slave); across slaves they are all in flight at once, so reading the identity
+of 100 drives costs about one mailbox round trip instead of 100
+- every request has a deadline (submission + timeout); a request that misses it,
+queued or sent, completes with SdoStatus::Timeout and the slave moves on to its next
+- start(rt_cores) polls on a thread of its own, kept on the cores outside `rt_cores`
+(non_rt_cores()): mailbox work never runs on a cycle thread, the cycle only carries
+the datagrams. start(cpu_core) pins it to one core of the caller's choosing (-1: not
+pinned). Callers with their own loop call poll() instead
+- callbacks and futures complete on the polling thread, outside the engine's lock;
+a callback that throws is counted and ignored
+- the destructor stops the thread and completes what is left with SdoStatus::Cancelled
+*/
+class SdoEngine {
+public:
+    explicit SdoEngine(MailboxTransport& transport,
+                       std::chrono::nanoseconds default_timeout = std::chrono::milliseconds(100));
+    ~SdoEngine();
+
+    SdoEngine(const SdoEngine&) = delete;
+    SdoEngine& operator=(const SdoEngine&) = delete;
+
+    //timeout 0: the default timeout
+    std::future<SdoResult> upload(uint8_t slave_id, uint16_t index, uint8_t subindex,
+                                  std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+    std::future<SdoResult> download(uint8_t slave_id, uint16_t index, uint8_t subindex, std::vector<uint8_t> data,
+                                    std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+    void upload(uint8_t slave_id, uint16_t index, uint8_t subindex, SdoCallback done,
+                std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+    void download(uint8_t slave_id, uint16_t index, uint8_t subindex, std::vector<uint8_t> data, SdoCallback done,
+                  std::chrono::nanoseconds timeout = std::chrono::nanoseconds(0));
+
+    /* polling thread; it sleeps while nothing is queued and checks the mailboxes every
+    poll_interval while something is in flight. Pinned to non_rt_cores(rt_cores) (e.g. the
+    cpu_core of every EthercatLine; std::invalid_argument if that leaves no core, rather than
+    polling on a cycle core), or to cpu_core if >= 0; start(-1) leaves it unpinned
+    */
+    void start(const std::vector<int>& rt_cores, std::chrono::nanoseconds poll_interval = std::chrono::microseconds(50));
+    void start(int cpu_core = -1, std::chrono::nanoseconds poll_interval = std::chrono::microseconds(50));
+    void stop(); //requests stay queued; poll() or a new start() continues them
+    bool running() const { return running_.load(std::memory_order_relaxed); }
+
+    //one pass over the mailboxes: send, collect, expire; returns the requests it completed
+    size_t poll();
+
+    size_t queued() const;    //submitted, not sent yet
+    size_t in_flight() const; //sent, not answered yet
+    SdoEngineStats stats() const;
+
+private:
+    struct Pending {
+        SdoRequest request;
+        SdoCallback done;
+        std::chrono::steady_clock::time_point submitted;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    struct Completion {
+        uint8_t slave_id;
+        SdoCallback done;
+        SdoResult result;
+    };
+
+    void submit(uint8_t slave_id, SdoRequest request, SdoCallback done, std::chrono::nanoseconds timeout);
+    void complete(uint8_t slave_id, Pending& pending, SdoResult result, std::chrono::steady_clock::time_point now);
+    void run_callbacks();
+    void poll_loop(std::vector<int> cores, std::chrono::nanoseconds poll_interval); //cores empty: not pinned
+
+    MailboxTransport& transport_;
+    const std::chrono::nanoseconds default_timeout_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::array<std::deque<Pending>, kMaxSlaves> queues_;
+    std::array<Pending, kMaxSlaves> in_flight_;
+    std::array<bool, kMaxSlaves> busy_{};
+    std::vector<uint8_t> active_; //slaves with a queued or in-flight request
+    std::array<bool, kMaxSlaves> listed_{};
+    size_t queued_ = 0;
+    size_t in_flight_count_ = 0;
+    std::vector<Completion> completions_; //filled under the lock, run outside it
+
+    std::mutex poll_mutex_; //one poll() at a time: the transport is single-threaded
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+
+    SdoEngineStats counters_; //under mutex_, except latency
+    TimingMetrics latency_;   //written by the polling thread
+    std::atomic<uint64_t> callback_failures_{0};
+};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <utility>
+#include <vector>
+#include "slave_columns.hpp"
+
+
+/* CoE SDO services as the mailbox carries them: one expedited or segmented
+upload/download of one object dictionary entry (index:subindex). The segmenting
+itself is the transport's business; requests and responses here are whole values.
+*/
+struct SdoRequest {
+    enum class Kind : uint8_t { Upload, Download };
+    Kind kind = Kind::Upload;
+    uint16_t index = 0;
+    uint8_t subindex = 0;
+    std::vector<uint8_t> data; //download only
+};
+
+struct SdoResponse {
+    uint32_t abort_code = 0;   //0: success, else the CoE abort code (ETG.1000.6)
+    std::vector<uint8_t> data; //upload only
+};
+
+//CoE abort codes the simulated mailbox answers with
+constexpr uint32_t kSdoAbortObjectMissing = 0x06020000;   //object does not exist in the dictionary
+constexpr uint32_t kSdoAbortSubindexMissing = 0x06090011; //subindex does not exist
+constexpr uint32_t kSdoAbortLengthMismatch = 0x06070010;  //data type length does not match
+
+
+/* MailboxTransport: one mailbox per slave, one request in it at a time (the
+slave has a single receive mailbox); the SdoEngine keeps many in flight by
+using many slaves at once. Called by the engine's polling thread only, and
+never blocking: a real transport queues the mailbox datagrams for the master's
+next non-cyclic frame and answers from what came back.
+*/
+class MailboxTransport {
+public:
+    virtual ~MailboxTransport() = default;
+
+    //false if the slave's mailbox is still busy with an earlier request
+    virtual bool send(uint8_t slave_id, const SdoRequest& request) = 0;
+    //true (and `response` filled) once the slave has answered the request sent last
+    virtual bool receive(uint8_t slave_id, SdoResponse& response) = 0;
+    //the engine gave up on the outstanding request (timeout, shutdown)
+    virtual void abandon(uint8_t slave_id) = 0;
+};
+
+
+/* SimulatedMailbox class: stand-in for the slaves' mailboxes in tests and soak runs
+- an object dictionary per slave (setObject); uploads answer with the stored bytes,
+downloads overwrite them if the length matches, otherwise the CoE abort codes above
+- each answer becomes ready `latency` after the request was sent
+- a slave set unresponsive accepts requests and never answers (timeouts)
+- counts what was sent and the most requests outstanding at once
+configuration and counters are thread-safe; send/receive/abandon are for one thread
+*/
+class SimulatedMailbox : public MailboxTransport {
+public:
+    explicit SimulatedMailbox(std::chrono::nanoseconds latency = std::chrono::microseconds(200));
+
+    void setObject(uint8_t slave_id, uint16_t index, uint8_t subindex, std::vector<uint8_t> value);
+    //throws std::out_of_range if the entry does not exist
+    std::vector<uint8_t> object(uint8_t slave_id, uint16_t index, uint8_t subindex) const;
+    void setLatency(std::chrono::nanoseconds latency);
+    void setResponsive(uint8_t slave_id, bool responsive);
+
+    bool send(uint8_t slave_id, const SdoRequest& request) override;
+    bool receive(uint8_t slave_id, SdoResponse& response) override;
+    void abandon(uint8_t slave_id) override;
+
+    uint64_t requests() const;
+    size_t max_outstanding() const;
+
+private:
+    using Key = std::pair<uint16_t, uint8_t>; //index, subindex
+
+    struct Mailbox {
+        bool busy = false;
+        bool responsive = true;
+        std::chrono::steady_clock::time_point ready;
+        SdoResponse response;
+    };
+
+    mutable std::mutex mutex_;
+    std::chrono::nanoseconds latency_;
+    std::array<std::map<Key, std::vector<uint8_t>>, kMaxSlaves> dictionaries_;
+    std::array<Mailbox, kMaxSlaves> mailboxes_;
+    size_t outstanding_ = 0;
+    size_t max_outstanding_ = 0;
+    uint64_t requests_ = 0;
+
+    SdoResponse serve(uint8_t slave_id, const SdoRequest& request);
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "slave_columns.hpp"
+#include "data_structuring.hpp"
+
+/* batch kernels over many slaves at once, multi-versioned per SimdLevel
+(scalar / SSE4.2 / AVX2 / AVX-512) and dispatched on active_simd_level(),
+see cpu_dispatch.hpp
+
+frames are laid out back to back, `stride` bytes apart (stride >= PdoInputLayout::size),
+as in a process image
+*/
+
+//decode frames [0, count) into slots [0, count) of `out`
+//fills the PDO fields only; timestamp, slave_position, data_valid are left to the caller
+void decode_frames(const uint8_t* frames, size_t count, size_t stride, const SlaveColumns& out);
+
+//change detection between two process images:
+//changed[i] = 1 if frame i differs from the previous image, else 0; returns the number of changed frames
+size_t detect_changed_frames(const uint8_t* current, const uint8_t* previous,
+                             size_t count, size_t stride, uint8_t* changed);
+
+
+//fixed-point fields (ScaledFormat): raw integers of the field at `field_offset` of every frame
+//into out[0, count); throws std::invalid_argument for ValueEncoding::Float32
+void decode_scaled_field(const uint8_t* frames, size_t count, size_t stride, size_t field_offset,
+                         ValueEncoding encoding, int32_t* out);
+
+//batched conversion out[i] = raw[i] * scale + offset; skip it to keep integer-only columns
+void fixed_to_float(const int32_t* raw, size_t count, float scale, float offset, float* out);
+
+
+//SoA reductions
+
+//maximum, NaNs are skipped; -infinity if there is nothing to compare
+float reduce_max_f32(const float* values, size_t count);
+
+//maximum of a fixed-point column; INT32_MIN if count == 0
+int32_t reduce_max_i32(const int32_t* values, size_t count);
+
+int64_t reduce_sum_i16(const int16_t* values, size_t count);
+
+//minimum; UINT64_MAX if count == 0
+uint64_t reduce_min_u64(const uint64_t* values, size_t count);
+
+//number of values with at least one of the `mask` bits set
+size_t count_flagged_u16(const uint16_t* values, size_t count, uint16_t mask);
+
+//edge detection over a column: indices i with current[i] != previous[i], ascending,
+//into changed_index (room for `count`); returns how many. Cost is one compare per
+//vector when nothing changed, the usual case
+size_t find_changed_u16(const uint16_t* current, const uint16_t* previous, size_t count, uint16_t* changed_index);
+
+/* FloatPolicy (data_structuring.hpp) on values[0, count), in place:
+- last_good[i]: the slot's last value that came through finite (NaN: none yet), updated here
+- flags[i] |= flag where a NaN/inf was replaced with last_good[i]; returns how many were
+classification is one vector compare per block: clean blocks only refresh last_good
+*/
+size_t sanitize_f32(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t count,
+                    const FloatPolicy& policy);
+
+
+//closed-loop drive model of PlantSimulator (plant_simulator.hpp), one column per quantity
+struct PlantColumns {
+    //state
+    double* position = nullptr;    //counts
+    double* velocity = nullptr;    //counts/s
+    double* torque = nullptr;      //per mille of rated torque
+    double* integral = nullptr;    //velocity loop integrator, per mille
+    double* temperature = nullptr; //degrees C
+    //set per cycle from the commands: the drive's cascaded loop, modes folded into gains
+    double* target_position = nullptr;
+    double* velocity_reference = nullptr; //velocity feed-forward (CSV: the target)
+    double* torque_offset = nullptr;      //torque feed-forward (CST: the target)
+    double* position_gain = nullptr;      //1/s, 0 outside CSP
+    double* velocity_gain = nullptr;      //per mille per counts/s, 0 in CST and when disabled
+    double* integral_gain = nullptr;      //per mille per count (already times the substep)
+    //per axis, derived from AxisParameters
+    double* torque_limit = nullptr;
+    double* torque_alpha = nullptr;       //substep / current-loop time constant, <= 1
+    double* accel_per_torque = nullptr;   //counts/s^2 per mille
+    double* damping = nullptr;            //1/s
+    double* heating = nullptr;            //steady-state rise in degrees C per (per mille)^2
+    double* thermal_beta = nullptr;       //substep / thermal time constant, <= 1
+    double* ambient = nullptr;
+};
+
+/* `substeps` semi-implicit Euler steps of `dt` seconds for axes [0, count):
+  velocity_ref = position_gain * (target_position - position) + velocity_reference
+  error        = velocity_ref - velocity
+  integral     = clamp(integral + integral_gain * error, +-torque_limit)
+  torque      += (clamp(velocity_gain * error + integral + torque_offset, +-torque_limit) - torque) * torque_alpha
+  velocity    += (torque * accel_per_torque - damping * velocity) * dt
+  position    += velocity * dt
+  temperature += (ambient + heating * torque^2 - temperature) * thermal_beta
+every axis stays in registers for all its substeps
+*/
+void plant_step(const PlantColumns& axes, size_t count, double dt, size_t substeps);
+
+
+//BMI2 pext/pdep, used on x86-64 when the active level is AVX2 or higher and the CPU has BMI2;
+//otherwise a loop over the mask bits (Atom-class IPCs have no BMI2, 32-bit x86 no 64-bit pext)
+
+//gathers the bits of `value` selected by `mask` into the low bits of the result
+uint64_t extract_bits_u64(uint64_t value, uint64_t mask);
+
+//scatters the low bits of `value` to the positions selected by `mask`
+uint64_t deposit_bits_u64(uint64_t value, uint64_t mask);
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "numa_placement.hpp"
+#include "slaves_state_struct.hpp"
+
+//slave ids are uint8_t: one slot per possible id is enough for a whole line
+constexpr size_t kMaxSlaves = 256;
+
+
+/* SoA (structure of arrays) form of SlaveRealTimeData:
+column[i] holds the field of slot i, so batch kernels stream over one field
+for all slaves instead of hopping across structs.
+
+SlaveColumns is only a view (pointers + capacity), SlaveColumnStore owns the memory.
+*/
+struct SlaveColumns {
+    uint16_t* status_word = nullptr;
+    int32_t* actual_position = nullptr;
+    int32_t* actual_velocity = nullptr;
+    int16_t* actual_torque = nullptr;
+    uint8_t* mode_display = nullptr;
+    uint16_t* error_code = nullptr;
+    uint16_t* system_status = nullptr;
+    float* motor_temperature = nullptr;
+    int32_t* motor_temperature_raw = nullptr; //fixed-point boards: raw integer, see ScaledFormat; else INT32_MIN
+    uint64_t* timestamp = nullptr;
+    uint16_t* slave_position = nullptr;
+    uint8_t* data_valid = nullptr;
+    uint8_t* restored = nullptr;
+    uint8_t* invalid_fields = nullptr;
+    uint8_t* deferred = nullptr;
+
+    size_t capacity = 0;
+};
+
+
+//one block holding every column, each column 64-byte aligned for the vector kernels,
+//optionally on one NUMA node (the node of the thread that writes it) and on hugepages
+class SlaveColumnStore {
+public:
+    explicit SlaveColumnStore(size_t capacity, int numa_node = kAnyNumaNode, PagePolicy pages = PagePolicy::Normal);
+
+    //pointers stay valid for the lifetime of the store, moves included
+    SlaveColumnStore(SlaveColumnStore&&) = default;
+    SlaveColumnStore& operator=(SlaveColumnStore&&) = default;
+    SlaveColumnStore(const SlaveColumnStore&) = delete;
+    SlaveColumnStore& operator=(const SlaveColumnStore&) = delete;
+
+    const SlaveColumns& columns() const { return columns_; }
+    size_t capacity() const { return columns_.capacity; }
+    int numa_node() const { return storage_.node(); } //-1 if unknown
+    PageKind page_kind() const { return storage_.page_kind(); }
+
+private:
+    MemoryRegion storage_;
+    SlaveColumns columns_;
+};
+
+
+//AoS <-> SoA for one slot
+void store_slave(const SlaveColumns& columns, size_t slot, const SlaveRealTimeData& data);
+SlaveRealTimeData load_slave(const SlaveColumns& columns, size_t slot);
+
+//slots [0, count) of every column
+void copy_columns(const SlaveColumns& from, const SlaveColumns& to, size_t count);
+
+//view of slots [first_slot, capacity): lets batch kernels write into the middle of a store
+SlaveColumns columns_from(const SlaveColumns& columns, size_t first_slot);
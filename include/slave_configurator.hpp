@@ -0,0 +1,141 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "data_structuring.hpp"
+#include "sdo_engine.hpp"
+
+
+//one object dictionary write of a slave's startup configuration
+struct SdoWrite {
+    uint16_t index;
+    uint8_t subindex;
+    std::vector<uint8_t> value; //little-endian, as it goes into the mailbox
+};
+
+//everything written to one slave at startup, in order (PDO mapping, then parameters)
+struct SlaveConfiguration {
+    uint8_t slave_id;
+    std::vector<SdoWrite> writes;
+};
+
+
+/* CoE PDO mapping entries: index << 16 | subindex << 8 | bit length.
+The input and output PDOs of PdoInputLayout / PdoOutputLayout, field by field
+in layout order (status word 0x6041, ..., motor temperature in vendor 0x2002)
+*/
+constexpr std::array<uint32_t, 8> kTxPdoMappingEntries = {
+    0x60410010, 0x60640020, 0x606C0020, 0x60770010, 0x60610008, 0x603F0010, 0x20010010, 0x20020020};
+constexpr std::array<uint32_t, 5> kRxPdoMappingEntries = {
+    0x60400010, 0x607A0020, 0x60FF0020, 0x60710010, 0x60600008};
+
+template <size_t N>
+constexpr size_t mapped_bytes(const std::array<uint32_t, N>& entries) {
+    size_t bits = 0;
+    for (uint32_t entry : entries) {
+        bits += entry & 0xFF;
+    }
+    return bits / 8;
+}
+static_assert(mapped_bytes(kTxPdoMappingEntries) == PdoInputLayout::size, "TxPDO mapping does not cover PdoInputLayout");
+static_assert(mapped_bytes(kRxPdoMappingEntries) == PdoOutputLayout::size, "RxPDO mapping does not cover PdoOutputLayout");
+
+/* the CoE sequence that maps one PDO and assigns it to a sync manager:
+clear the assignment (assign_index:0 = 0) and the mapping (pdo_index:0 = 0), write
+the entries, set the entry count, assign the PDO, set the assignment count
+*/
+std::vector<SdoWrite> pdo_mapping_writes(uint16_t assign_index, uint16_t pdo_index, const uint32_t* entries,
+                                         size_t count);
+//RxPDO 0x1600 on SM2 (0x1C12) and TxPDO 0x1A00 on SM3 (0x1C13) with the entries above
+std::vector<SdoWrite> standard_pdo_mapping();
+
+//FNV-1a over the writes (index, subindex, length, value), not the slave id: equal configurations hash equal
+uint64_t configuration_hash(const SlaveConfiguration& configuration);
+
+
+/* ConfigCache class: what the configurator last applied to each slave
+- keyed by slave id, and only trusted while the slave at that id reports the same
+serial number (0x1018:04): a swapped drive is configured again
+- survives master restarts through save()/load(); a slave that lost its power (and
+with it its configuration) while the master kept running has to be forget()-ed
+*/
+class ConfigCache {
+public:
+    struct Entry {
+        uint32_t serial;
+        uint64_t hash;
+    };
+
+    bool matches(uint8_t slave_id, uint32_t serial, uint64_t hash) const;
+    void store(uint8_t slave_id, Entry entry) { entries_[slave_id] = entry; }
+    void forget(uint8_t slave_id) { entries_.erase(slave_id); }
+    void clear() { entries_.clear(); }
+    size_t size() const { return entries_.size(); }
+
+    //a missing file is an empty cache; throws std::invalid_argument for a malformed line
+    void load(const std::string& path);
+    //throws std::runtime_error if the file cannot be written
+    void save(const std::string& path) const;
+
+private:
+    std::map<uint8_t, Entry> entries_;
+};
+
+
+struct SlaveConfigResult {
+    enum class Outcome : uint8_t { Configured, Skipped, Failed };
+    uint8_t slave_id = 0;
+    Outcome outcome = Outcome::Failed;
+    SdoStatus status = SdoStatus::Ok; //Failed: of the first request that failed
+    uint32_t abort_code = 0;
+    uint16_t index = 0;               //Failed: object of that request (0x1018:04 for the identity read)
+    uint8_t subindex = 0;
+};
+
+struct ConfigureReport {
+    std::vector<SlaveConfigResult> slaves; //in the order they were passed in
+    size_t configured = 0;
+    size_t skipped = 0;
+    size_t failed = 0;
+    uint64_t writes = 0; //SDO downloads sent (a failed slave's sequence stops at the failed one)
+    std::chrono::nanoseconds elapsed{0};
+};
+
+
+/* SlaveConfigurator class: line bring-up through the SdoEngine
+- reads every slave's serial number at once, then starts the writes of every slave
+whose cached configuration is missing or differs; the engine runs the slaves'
+mailboxes in parallel
+- each slave's writes go out as a chain, the next one submitted when the previous
+succeeded: after a failed write nothing more is sent to that slave (no PDO count or
+sync manager assignment behind a half-written mapping)
+- a slave whose writes all succeeded is stored in the cache, a failed one is forgotten
+(next start configures it again)
+- warm restart with an unchanged line: one serial-number round trip, no writes
+- blocks the calling thread (startup); drives engine.poll() itself if the engine has
+no polling thread
+*/
+class SlaveConfigurator {
+public:
+    SlaveConfigurator(SdoEngine& engine, ConfigCache& cache);
+
+    //throws std::invalid_argument if a slave id appears twice (before anything is sent)
+    ConfigureReport configure(const std::vector<SlaveConfiguration>& slaves);
+
+private:
+    struct WriteChain;
+
+    template <typename T>
+    void wait(std::future<T>& future);
+    void write_next(const std::shared_ptr<WriteChain>& chain);
+
+    SdoEngine& engine_;
+    ConfigCache& cache_;
+};
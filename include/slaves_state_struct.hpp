@@ -17,4 +17,19 @@ struct SlaveRealTimeData
     uint64_t timestamp;
     uint16_t slave_position;
     bool data_valid;
-};
\ No newline at end of file
+    bool restored;  //last-known value from a checkpoint, the slave has not reported since the restart
+    uint8_t invalid_fields; //kInvalid* bits: a float field arrived as NaN/inf and holds the last good value (FloatPolicy)
+    bool deferred;  //frame left unread this cycle (decode budget): the values are last cycle's
+};
+
+constexpr uint8_t kInvalidMotorTemperature = 0x01;
+
+//outputs written to a Slave every cycle (CiA402 RxPDO)
+struct SlaveCommandData
+{
+    uint16_t control_word;      //0x6040
+    int32_t target_position;    //0x607A
+    int32_t target_velocity;    //0x60FF
+    int16_t target_torque;      //0x6071
+    uint8_t mode_of_operation;  //0x6060
+};
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Star_Manager.hpp"
+#include "task_pool.hpp"
+
+
+//whole line, once per committed cycle (statistics, decimation, export)
+using CycleJob = std::function<void(const StarSnapshot& snapshot)>;
+//one slave group, e.g. the drives of one axis or one power supply (trend detection)
+using GroupJob = std::function<void(const StarSnapshot& snapshot, const std::vector<uint8_t>& slave_ids)>;
+
+
+/* SnapshotAnalytics class: feeds committed snapshots of one StarManager to a TaskPool
+- poll() (non-RT thread) checks for a new commit; if there is one, it copies the
+snapshot once and spawns every due job as a task sharing that copy
+- the copy is read-only and released when the last job using it finishes
+- the cycle thread is only read (readSnapshot), never waited on
+- a job runs at the first poll at least `every_n_cycles` commits after its last run
+(for the first time from cycle every_n_cycles on), so its rate holds when polls miss
+commits; commits between two polls are skipped, not queued, and counted in skipped_cycles()
+*/
+class SnapshotAnalytics {
+public:
+    SnapshotAnalytics(TaskPool& pool, const StarManager& manager);
+
+    //throws std::invalid_argument for every_n_cycles == 0 or an empty group
+    void add_cycle_job(const std::string& name, CycleJob job, uint32_t every_n_cycles = 1);
+    void add_group_job(const std::string& name, std::vector<uint8_t> slave_ids, GroupJob job,
+                       uint32_t every_n_cycles = 1);
+
+    //returns the number of tasks spawned (0: no new commit)
+    size_t poll();
+
+    uint64_t last_cycle() const { return last_cycle_; }
+    uint64_t skipped_cycles() const { return skipped_cycles_; }
+
+private:
+    struct Job {
+        TaskKind kind;
+        uint32_t every_n_cycles;
+        std::vector<uint8_t> slave_ids; //empty for cycle jobs
+        CycleJob cycle_job;
+        GroupJob group_job;
+    };
+
+    TaskPool& pool_;
+    const StarManager& manager_;
+    std::vector<std::shared_ptr<const Job>> jobs_; //shared with queued tasks, not copied per cycle
+    std::vector<uint64_t> last_run_;               //by job: cycle it last ran for, 0: never
+    uint64_t last_cycle_ = 0;
+    uint64_t skipped_cycles_ = 0;
+};
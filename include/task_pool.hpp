@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "timing_metrics.hpp"
+
+
+using TaskKind = uint16_t; //index of a name registered with TaskPool::register_kind
+
+struct TaskKindStats {
+    std::string name;
+    TimingSummary queue_wait; //submit -> start
+    TimingSummary run_time;   //start -> done
+    uint64_t failed = 0;      //tasks that threw
+};
+
+
+/* TaskPool class: work-stealing pool for non-RT work (analytics, export)
+- one worker per entry of `cores`, each pinned to its core; pass non_rt_cores()
+so the RT cores of the EtherCAT lines never run a task. An empty list throws rather
+than leaving the workers to the scheduler; unpinned workers are asked for explicitly
+- every worker has its own deque: it pops its newest task, idle workers steal
+the oldest task of another worker; tasks submitted from a worker go to its own deque
+- per task kind: queue wait and run time (one TimingMetrics per worker and kind)
+- a task that throws is counted as failed, the worker keeps running
+- the destructor runs every task already submitted, then joins the workers
+*/
+class TaskPool {
+public:
+    using Task = std::function<void()>;
+    static constexpr size_t kMaxTaskKinds = 32;
+
+    //opt-in tag: workers the scheduler may put on any core, RT cores included (tests, tools)
+    struct Unpinned {};
+
+    /* workers == 0: one per core, else `workers` spread over `cores`. Throws std::invalid_argument
+    for a negative core or no core at all (e.g. non_rt_cores() left none: the RT cores would run tasks)
+    */
+    explicit TaskPool(std::vector<int> cores, size_t workers = 0);
+    TaskPool(Unpinned, size_t workers); //at least one
+    ~TaskPool();
+
+    TaskPool(const TaskPool&) = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    //throws std::length_error after kMaxTaskKinds names; same name -> same kind
+    TaskKind register_kind(const std::string& name);
+
+    //any thread, including tasks (nested spawn); throws std::out_of_range for an unknown kind
+    void submit(TaskKind kind, Task task);
+
+    //blocks until every submitted task has finished (do not call from a task)
+    void wait_idle();
+
+    size_t worker_count() const { return workers_.size(); }
+    const std::vector<int>& cores() const { return cores_; }
+    uint64_t completed() const { return completed_.load(std::memory_order_relaxed); }
+    uint64_t stolen() const { return stolen_.load(std::memory_order_relaxed); }
+
+    TaskKindStats stats(TaskKind kind) const;
+
+private:
+    struct Item {
+        Task task;
+        TaskKind kind;
+        std::chrono::steady_clock::time_point submitted;
+    };
+
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Item> deque; //back: owner's end, front: thieves' end
+        std::thread thread;
+        std::array<TimingMetrics, kMaxTaskKinds> queue_wait;
+        std::array<TimingMetrics, kMaxTaskKinds> run_time;
+        std::array<std::atomic<uint64_t>, kMaxTaskKinds> failed{};
+    };
+
+    void start_workers(size_t workers);
+    void worker_loop(size_t index);
+    bool pop_local(size_t index, Item& item);
+    bool steal(size_t thief, Item& item);
+    void run(size_t index, Item& item);
+
+    std::vector<int> cores_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+
+    mutable std::mutex kinds_mutex_;
+    std::vector<std::string> kinds_;
+
+    std::mutex sleep_mutex_;
+    std::condition_variable wake_;
+    std::condition_variable idle_;
+    std::atomic<size_t> queued_{0};  //in some deque
+    std::atomic<size_t> pending_{0}; //submitted and not finished
+    std::atomic<size_t> next_worker_{0};
+    std::atomic<bool> stopping_{false};
+
+    std::atomic<uint64_t> completed_{0};
+    std::atomic<uint64_t> stolen_{0};
+};
@@ -0,0 +1,19 @@
+#pragma once
+
+#include <vector>
+
+/* CPU affinity helpers shared by the cycle threads (EthercatLine) and the
+analytics workers (TaskPool): RT cores run one cycle thread each, everything
+else is kept on the remaining cores.
+*/
+
+//pins the calling thread to `core`; false if the core does not exist or is outside the process' cpuset
+bool pin_current_thread(int core);
+//pins the calling thread to the set `cores` (the scheduler picks among them); false if none of them is allowed
+bool pin_current_thread(const std::vector<int>& cores);
+
+//cores this process may run on (sched_getaffinity); 0..hardware_concurrency-1 where that is unknown
+std::vector<int> allowed_cores();
+
+//allowed_cores() minus `rt_cores`, e.g. the cpu_core of every EthercatLine
+std::vector<int> non_rt_cores(const std::vector<int>& rt_cores);
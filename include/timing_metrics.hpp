@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+struct TimingSummary {
+    uint64_t count = 0;
+    uint64_t min_ns = 0;
+    uint64_t max_ns = 0;
+    double mean_ns = 0.0;
+    uint64_t p50_ns = 0; //upper edge of the histogram bucket, see TimingMetrics
+    uint64_t p99_ns = 0;
+};
+
+
+/* TimingMetrics class:
+- one writer (the thread that owns the measured loop), any number of readers
+- record() is plain loads and relaxed stores, no locked instructions, so the
+writer never waits on a reader's cache line
+- durations go into power-of-two buckets: bucket b holds [2^(b-1), 2^b) ns,
+percentiles are reported as the upper edge of their bucket
+*/
+class TimingMetrics {
+public:
+    static constexpr size_t kBuckets = 64;
+
+    //writer thread only
+    void record(uint64_t ns);
+
+    //any thread; values recorded concurrently may or may not be included
+    TimingSummary summary() const;
+    //one summary over several single-writer instances (e.g. one per worker thread)
+    static TimingSummary merged(const std::vector<const TimingMetrics*>& parts);
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+
+    //bucket counts, any thread; the difference of two reads is the histogram of that interval
+    using Histogram = std::array<uint64_t, kBuckets>;
+    Histogram histogram() const;
+    //upper bucket edge below which `per_mille` of the histogram lies (0 if empty)
+    static uint64_t percentile(const Histogram& histogram, uint64_t per_mille);
+
+    //writer thread only, or while the writer is stopped
+    void reset();
+
+private:
+    static size_t bucket_of(uint64_t ns);
+
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> total_ns_{0};
+    std::atomic<uint64_t> min_ns_{UINT64_MAX};
+    std::atomic<uint64_t> max_ns_{0};
+    std::array<std::atomic<uint64_t>, kBuckets> buckets_{};
+};
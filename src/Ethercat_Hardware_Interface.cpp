@@ -2,26 +2,291 @@
 - knows which slaves exist from slaves_order_ vector
 - copies a Slave's data from Kernel Space buffer into 
 std::vector<uint8_t>& buffer
-- for each slave: calls StarManager::input_handler() to structure 
-data from the buffer into slave_registry maps: slave_id, SlaveRealTimeData
+- hands the slaves' frames to StarManager::input_frames() one priority class at
+a time (Safety, Motion, Diagnostics), which structures them into the slave
+registry (slave_id -> slot); the cycle is committed once, after the last class
+- a decode budget lets overload defer the lower classes by a cycle instead of
+making the whole cycle late
+- working counters: each WkcGroup's counter is compared with its expected value
+before the commit; a mismatch clears data_valid of exactly that group's slaves for
+the cycle, and is counted per group and per domain
+- output path: encodes each slave's SlaveCommandData into the output image
+with WriteState (same layout definitions as ReadState)
 */
 
+#include "Ethercat_Hardware_Interface.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+
+namespace {
+
+//single writer: read-modify-write without a locked instruction
+void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
 
 Ethercat_Hardware_Interface::Ethercat_Hardware_Interface(
-    const std::vector<uint8_t>& slaves_order)
-    : slaves_order_(slaves_order) 
+    const std::vector<uint8_t>& slaves_order, int numa_node, PagePolicy pages)
+    : star_manager_(numa_node, DecodeMode::Eager, pages)
+    , slaves_order_(slaves_order) 
     //does same as `slaves_order_ = slaves_order;` more efficient
+    , frames_(slaves_order.size())
 {
-    
+    setPriorities({});
 }
 
 
+void Ethercat_Hardware_Interface::setPriorities(const std::vector<SlavePriority>& priorities){
+    if (!priorities.empty() && priorities.size() != slaves_order_.size()) {
+        throw std::invalid_argument("one priority per slave of slaves_order expected");
+    }
+    priorities_ = priorities.empty() ? std::vector<SlavePriority>(slaves_order_.size(), SlavePriority::Motion)
+                                     : priorities;
+    for (auto& slaves : class_slaves_) {
+        slaves.clear();
+    }
+    for (size_t i = 0; i < priorities_.size(); ++i) {
+        class_slaves_.at(static_cast<size_t>(priorities_[i])).push_back(i);
+    }
+}
+
+
+
+void Ethercat_Hardware_Interface::setWkcGroups(const std::vector<WkcGroup>& groups){
+    std::array<bool, kMaxSlaves> in_line{};
+    for (uint8_t id : slaves_order_) {
+        in_line[id] = true;
+    }
+    std::array<bool, kMaxSlaves> grouped{};
+    size_t domains = 0;
+    for (const WkcGroup& group : groups) {
+        for (uint8_t id : group.slaves) {
+            if (!in_line[id]) {
+                throw std::invalid_argument("WkcGroup slave is not in slaves_order");
+            }
+            if (grouped[id]) {
+                throw std::invalid_argument("slave in two WkcGroups");
+            }
+            grouped[id] = true;
+        }
+        domains = std::max(domains, size_t{group.domain} + 1);
+    }
+
+    wkc_groups_ = groups;
+    group_wkc_ = std::make_unique<WkcCounters[]>(groups.size());
+    domain_wkc_ = std::make_unique<WkcCounters[]>(domains);
+    wkc_domains_ = domains;
+    domain_mismatch_.assign(domains, 0);
+    domain_sum_.assign(domains, 0);
+}
+
+
+void Ethercat_Hardware_Interface::read_kernel(const std::vector<uint8_t>& buffer){
+    read_kernel(buffer.data(), buffer.size());
+}
+
+void Ethercat_Hardware_Interface::read_kernel(const uint8_t* image, size_t size){
+    read_kernel(image, size, nullptr, 0);
+}
+
+void Ethercat_Hardware_Interface::read_kernel(const uint8_t* image, size_t size,
+                                              const uint16_t* working_counters, size_t count){
+    if (size < input_image_size()) {
+        throw std::out_of_range("input process image smaller than slaves_order");
+    }
+    if (working_counters != nullptr && count != wkc_groups_.size()) {
+        throw std::invalid_argument("one working counter per WkcGroup expected");
+    }
+
+    //the counters arrive with the image: a garbled datagram is dropped before its decode
+    if (any_rejected_) {
+        rejected_.fill(0);
+        any_rejected_ = false;
+    }
+    if (working_counters != nullptr) {
+        check_working_counters(working_counters);
+    }
+
+    const bool budgeted = decode_budget_.count() > 0;
+    const auto started = budgeted ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+    for (size_t cls = 0; cls < kPriorityClasses; ++cls) {
+        const std::vector<size_t>& slaves = class_slaves_[cls];
+        if (slaves.empty()) {
+            continue;
+        }
+
+        const bool defer = cls != static_cast<size_t>(SlavePriority::Safety) &&
+                           budgeted && !deferred_last_cycle_[cls] &&
+                           std::chrono::steady_clock::now() - started >= decode_budget_;
+        deferred_last_cycle_[cls] = defer;
+        if (defer) {
+            bump(deferrals_[cls], 1);
+            bump(deferred_frames_, slaves.size());
+            for (size_t i : slaves) {
+                star_manager_.defer(slaves_order_[i]);
+            }
+            continue;
+        }
+
+        size_t taken = 0;
+        for (size_t i : slaves) {
+            if (rejected_[slaves_order_[i]]) {
+                continue;
+            }
+            frames_[taken++] = SlaveFrame{slaves_order_[i], image + i * PdoInputLayout::size, PdoInputLayout::size};
+        }
+        star_manager_.input_frames(frames_.data(), taken);
+    }
+    star_manager_.commit();
+}
+
+
+void Ethercat_Hardware_Interface::check_working_counters(const uint16_t* working_counters){
+    std::fill(domain_mismatch_.begin(), domain_mismatch_.end(), 0);
+    std::fill(domain_sum_.begin(), domain_sum_.end(), 0);
+
+    for (size_t g = 0; g < wkc_groups_.size(); ++g) {
+        const WkcGroup& group = wkc_groups_[g];
+        const bool mismatch = working_counters[g] != group.expected;
+        group_wkc_[g].record(mismatch, working_counters[g]);
+        domain_sum_[group.domain] += working_counters[g];
+        if (!mismatch) {
+            continue;
+        }
+        domain_mismatch_[group.domain] = 1;
+        any_rejected_ = true;
+        for (uint8_t id : group.slaves) {
+            rejected_[id] = 1;
+            if (star_manager_.reject(id)) {
+                bump(invalidated_frames_, 1);
+            }
+        }
+    }
 
-void read_kernel::Ethercat_Hardware_Interface(std::vector<uint8_t>& buffer){
-    
+    for (size_t d = 0; d < wkc_domains_; ++d) {
+        domain_wkc_[d].record(domain_mismatch_[d] != 0, static_cast<uint16_t>(domain_sum_[d]));
+    }
 }
 
 
-void write_kernel::Ethercat_Hardware_Interface(std::vector<uint8_t>& buffer){
-    
-}
\ No newline at end of file
+void Ethercat_Hardware_Interface::WkcCounters::record(bool mismatch, uint16_t working_counter){
+    bump(checks, 1);
+    last_working_counter.store(working_counter, std::memory_order_relaxed);
+    if (!mismatch) {
+        consecutive.store(0, std::memory_order_relaxed);
+        return;
+    }
+    bump(mismatches, 1);
+    const uint64_t run = consecutive.load(std::memory_order_relaxed) + 1;
+    consecutive.store(run, std::memory_order_relaxed);
+    if (run > longest_run.load(std::memory_order_relaxed)) {
+        longest_run.store(run, std::memory_order_relaxed);
+    }
+}
+
+WkcStats Ethercat_Hardware_Interface::WkcCounters::load() const {
+    WkcStats stats;
+    stats.checks = checks.load(std::memory_order_relaxed);
+    stats.mismatches = mismatches.load(std::memory_order_relaxed);
+    stats.consecutive = consecutive.load(std::memory_order_relaxed);
+    stats.longest_run = longest_run.load(std::memory_order_relaxed);
+    stats.last_working_counter = last_working_counter.load(std::memory_order_relaxed);
+    return stats;
+}
+
+WkcStats Ethercat_Hardware_Interface::wkcStats(size_t group) const {
+    if (group >= wkc_groups_.size()) {
+        throw std::out_of_range("no such WkcGroup");
+    }
+    return group_wkc_[group].load();
+}
+
+WkcStats Ethercat_Hardware_Interface::domainWkcStats(uint8_t domain) const {
+    if (domain >= wkc_domains_) {
+        throw std::out_of_range("no WkcGroup in this domain");
+    }
+    return domain_wkc_[domain].load();
+}
+
+
+void Ethercat_Hardware_Interface::write_kernel(std::vector<uint8_t>& buffer){
+    write_kernel(buffer.data(), buffer.size());
+}
+
+void Ethercat_Hardware_Interface::write_kernel(uint8_t* image, size_t size){
+    if (size < output_image_size()) {
+        throw std::out_of_range("output process image smaller than slaves_order");
+    }
+
+    for (size_t i = 0; i < slaves_order_.size(); ++i) {
+        uint8_t* frame = image + i * PdoOutputLayout::size;
+        auto it = command_registry_.find(slaves_order_[i]);
+        SlaveCommandData command = it != command_registry_.end() ? it->second : SlaveCommandData{};
+        encoder_.encode_command(command, frame, PdoOutputLayout::size);
+    }
+}
+
+
+void Ethercat_Hardware_Interface::writeCheckpoint(CheckpointWriter& writer) const {
+    star_manager_.writeCheckpoint(writer);
+
+    writer.begin_section(CheckpointSection::Commands);
+    writer.put(static_cast<uint16_t>(command_registry_.size()));
+    for (const auto& entry : command_registry_) {
+        writer.put(entry.first);
+        writer.put(entry.second.control_word);
+        writer.put(entry.second.target_position);
+        writer.put(entry.second.target_velocity);
+        writer.put(entry.second.target_torque);
+        writer.put(entry.second.mode_of_operation);
+    }
+    writer.end_section();
+}
+
+bool Ethercat_Hardware_Interface::restoreCheckpoint(CheckpointReader& reader){
+    Checkpoint checkpoint;
+    if (!loadCheckpoint(reader, checkpoint)) {
+        return false;
+    }
+    applyCheckpoint(checkpoint);
+    return true;
+}
+
+bool Ethercat_Hardware_Interface::loadCheckpoint(CheckpointReader& reader, Checkpoint& out) const {
+    Checkpoint checkpoint;
+    checkpoint.has_registry = star_manager_.loadCheckpoint(reader, checkpoint.registry);
+    if (reader.open(CheckpointSection::Commands)) {
+        const size_t count = reader.get<uint16_t>();
+        for (size_t i = 0; i < count; ++i) {
+            const uint8_t id = reader.get<uint8_t>();
+            SlaveCommandData& command = checkpoint.commands[id];
+            command.control_word = reader.get<uint16_t>();
+            command.target_position = reader.get<int32_t>();
+            command.target_velocity = reader.get<int32_t>();
+            command.target_torque = reader.get<int16_t>();
+            command.mode_of_operation = reader.get<uint8_t>();
+        }
+        checkpoint.has_commands = true;
+    }
+    out = std::move(checkpoint);
+    return out.has_registry || out.has_commands;
+}
+
+void Ethercat_Hardware_Interface::applyCheckpoint(const Checkpoint& checkpoint){
+    if (checkpoint.has_registry) {
+        star_manager_.applyCheckpoint(checkpoint.registry);
+    }
+    if (checkpoint.has_commands) {
+        command_registry_ = checkpoint.commands;
+    }
+}
+
+
+void Ethercat_Hardware_Interface::setCommand(uint8_t slave_id, const SlaveCommandData& command){
+    command_registry_[slave_id] = command;
+}
@@ -12,34 +12,630 @@ that reads buffer from kernel space
 
 
 + timestamp to track when each slave last sent data
+
+- input_cycle(): all frames of a cycle in one call, one timestamp, one commit
+- DecodeMode::Lazy: frames are stored raw, fields decoded on access (getField)
+- registry is kept as columns (SlaveColumnStore), one slot per slave
+- commit() publishes the registry once per cycle; readers copy it with
+readSnapshot() and never write to the cycle thread's memory
+- every frame also updates its slave's inter-arrival statistics (ArrivalTracker), timed
+on steady_clock: the wall-clock timestamp can be stepped or slewed by NTP
+- commit() also reduces the columns to CycleAggregates (max temperature,
+faults, torque per power supply, oldest timestamp)
+- FloatPolicies (denormal flush, NaN/inf replacement, clamp) run as one kernel over
+the decoded temperatures, before commit() reduces them
+- fixed-point temperatures (FieldFormats) are decoded and converted with one kernel call
+per run of slots that share a format; keep_fixed_point skips the conversion
 */
 
 #include "Star_Manager.hpp"
 
 #include "data_structuring.hpp"
+#include "simd_kernels.hpp"
 #include <vector>
+#include <algorithm>
 #include <chrono>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+
+namespace {
+
+uint64_t now_ns() {
+    // current time in nanoseconds since Unix epoch:
+    auto duration = std::chrono::system_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+//arrival times for the inter-arrival statistics: never stepped
+uint64_t steady_ns() {
+    auto duration = std::chrono::steady_clock::now().time_since_epoch();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+}
+
+bool same_format(const ScaledFormat* a, const ScaledFormat* b) {
+    return a == b || (a != nullptr && b != nullptr && a->encoding == b->encoding && a->scale == b->scale &&
+                      a->offset == b->offset && a->keep_fixed_point == b->keep_fixed_point);
+}
+
+} // namespace
+
+
+StarSnapshot::StarSnapshot(int numa_node, PagePolicy pages)
+    : columns(kMaxSlaves, numa_node, pages)
+    , raw_frames(kMaxSlaves, numa_node, pages)
+{
+    slot_of.fill(-1);
+}
+
+size_t StarSnapshot::checked_slot(uint8_t slave_id) const {
+    if (!contains(slave_id)) {
+        throw std::out_of_range("slave not in snapshot");
+    }
+    return static_cast<size_t>(slot_of[slave_id]);
+}
+
+SlaveRealTimeData StarSnapshot::getSlaveData(uint8_t slave_id) const {
+    const size_t slot = checked_slot(slave_id);
+    if (mode == DecodeMode::Eager) {
+        return load_slave(columns.columns(), slot);
+    }
+    return decode_stored_slave(raw_frames, columns.columns(), slot);
+}
+
+
+StarManager::StarManager(int numa_node, DecodeMode mode, PagePolicy pages)
+    : numa_node_(numa_node)
+    , slave_registry_(kMaxSlaves, numa_node, pages)
+    , mode_(mode)
+    , raw_frames_(mode == DecodeMode::Eager ? 0 : kMaxSlaves, numa_node, pages)
+    , published_{PublishedBuffer(numa_node, pages), PublishedBuffer(numa_node, pages)}
+{
+    slot_of_.fill(-1);
+    last_good_temperature_.fill(std::numeric_limits<float>::quiet_NaN());
+    cycle_slots_.reserve(kMaxSlaves);
+    undecoded_slots_.reserve(mode == DecodeMode::Eager ? 0 : kMaxSlaves);
+}
+
+//first report of this slave: next free slot
+size_t StarManager::slot_for(uint8_t slave_id){
+    if (slot_of_[slave_id] < 0) {
+        slot_group_[slot_count_] = supply_group_of_[slave_id];
+        slot_format_[slot_count_] = temperature_format(slave_id);
+        slave_registry_.columns().motor_temperature_raw[slot_count_] = std::numeric_limits<int32_t>::min();
+        id_of_slot_[slot_count_] = slave_id;
+        slot_of_[slave_id] = static_cast<int16_t>(slot_count_++);
+    }
+    return static_cast<size_t>(slot_of_[slave_id]);
+}
+
+size_t StarManager::checked_slot(uint8_t slave_id) const {
+    if (slot_of_[slave_id] < 0) {
+        throw std::out_of_range("slave has not reported");
+    }
+    return static_cast<size_t>(slot_of_[slave_id]);
+}
+
+//lazy modes: keep the frame; the temperature goes to its column if it is fixed-point (the caller
+//converts it, decode_fixed_point) or if the FloatPolicy has to see it (it needs the slot's last good value)
+void StarManager::store_raw(size_t slot, const uint8_t* frame){
+    std::memcpy(raw_frames_.frame(slot), frame, RawFrameStore::kFrameSize);
+    cached_input_[slot] = 0;
+    slave_registry_.columns().invalid_fields[slot] = 0;
+    if (!undecoded_[slot]) {
+        undecoded_[slot] = 1;
+        undecoded_slots_.push_back(static_cast<uint16_t>(slot));
+    }
+
+    raw_frames_.scaled[slot] = 0;
+    if (slot_format_[slot] != nullptr) {
+        raw_frames_.scaled[slot] = 1;
+    } else if (float_policies_.motor_temperature.active()) {
+        raw_frames_.scaled[slot] = 1;
+        slave_registry_.columns().motor_temperature[slot] = load_le<float>(frame + PdoInputLayout::motor_temperature);
+    }
+}
+
+const ScaledFormat* StarManager::temperature_format(uint8_t slave_id) const {
+    auto formats = field_formats_.find(slave_id);
+    if (formats == field_formats_.end() || formats->second.motor_temperature.encoding == ValueEncoding::Float32) {
+        return nullptr;
+    }
+    return &formats->second.motor_temperature;
+}
+
+//slots [first_slot, first_slot + count), frames `stride` apart, all in `format`
+void StarManager::decode_fixed_point(const uint8_t* frames, size_t count, size_t stride, size_t first_slot,
+                                     const ScaledFormat& format){
+    const SlaveColumns& columns = slave_registry_.columns();
+    decode_scaled_field(frames, count, stride, PdoInputLayout::motor_temperature, format.encoding,
+                        columns.motor_temperature_raw + first_slot);
+    if (format.keep_fixed_point) {
+        std::fill_n(columns.motor_temperature + first_slot, count, std::numeric_limits<float>::quiet_NaN());
+    } else {
+        fixed_to_float(columns.motor_temperature_raw + first_slot, count, format.scale, format.offset,
+                       columns.motor_temperature + first_slot);
+    }
+}
+
+//after the decode, before anyone reads the slots
+void StarManager::sanitize_temperatures(size_t first_slot, size_t count){
+    const SlaveColumns& columns = slave_registry_.columns();
+    sanitize_f32(columns.motor_temperature + first_slot, last_good_temperature_.data() + first_slot,
+                 columns.invalid_fields + first_slot, kInvalidMotorTemperature, count, float_policies_.motor_temperature);
+}
 
 
 void StarManager::input_handler(uint8_t slave_id, const std::vector<uint8_t>& buffer){
-    //parse() implementation is in data_structuring.cpp
+    if (mode_ != DecodeMode::Eager) {
+        check_field_bounds(buffer.size(), 0, PdoInputLayout::size);
+        const SlaveColumns& columns = slave_registry_.columns();
+        const size_t slot = slot_for(slave_id);
+        store_raw(slot, buffer.data());
+        if (slot_format_[slot] != nullptr) {
+            decode_fixed_point(buffer.data(), 1, PdoInputLayout::size, slot, *slot_format_[slot]);
+        }
+        columns.timestamp[slot] = now_ns();
+        arrivals_.record(slave_id, steady_ns());
+        columns.slave_position[slot] = slave_id;
+        columns.data_valid[slot] = 1;
+        columns.restored[slot] = 0;
+        columns.deferred[slot] = 0;
+        if (float_policies_.motor_temperature.active() && !keeps_fixed_point(slot)) {
+            sanitize_temperatures(slot, 1);
+        }
+        return;
+    }
+
+    //parse() implementation is in data_structuring.cpp; a fixed-point temperature is redone below
     SlaveRealTimeData result = parser_.parse(buffer);
 
-    // current time in nanoseconds since Unix epoch:
-    auto now = std::chrono::system_clock::now();
-    auto duration = now.time_since_epoch();
-    result.timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    result.timestamp = now_ns();
+    arrivals_.record(slave_id, steady_ns());
 
          
     result.slave_position = slave_id;
     result.data_valid= true;
 
-    slave_registry[slave_id] = result;
+    const size_t slot = slot_for(slave_id);
+    store_slave(slave_registry_.columns(), slot, result);
+    if (slot_format_[slot] != nullptr) {
+        decode_fixed_point(buffer.data(), 1, PdoInputLayout::size, slot, *slot_format_[slot]);
+    }
+    if (float_policies_.motor_temperature.active() && !keeps_fixed_point(slot)) {
+        sanitize_temperatures(slot, 1);
+    }
+}
+
+void StarManager::input_cycle(const std::vector<SlaveFrame>& frames, uint64_t timestamp_ns, uint64_t arrival_ns){
+    input_cycle(frames.data(), frames.size(), timestamp_ns, arrival_ns);
+}
+
+void StarManager::input_cycle(const SlaveFrame* frames, size_t count, uint64_t timestamp_ns, uint64_t arrival_ns){
+    input_frames(frames, count, timestamp_ns, arrival_ns);
+    commit();
+}
+
+void StarManager::input_frames(const SlaveFrame* frames, size_t count, uint64_t timestamp_ns, uint64_t arrival_ns){
+    for (size_t i = 0; i < count; ++i) {
+        if (frames[i].size < PdoInputLayout::size) {
+            throw std::out_of_range("slave frame shorter than the input PDO");
+        }
+    }
+
+    const uint64_t timestamp = timestamp_ns != 0 ? timestamp_ns : now_ns(); //one read of each clock per cycle
+    const uint64_t arrival = arrival_ns != 0 ? arrival_ns : timestamp_ns != 0 ? timestamp_ns : steady_ns();
+    const SlaveColumns& columns = slave_registry_.columns();
+    ++input_epoch_; //LazyCached: decodes of the previous input are stale
+
+    cycle_slots_.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        cycle_slots_[i] = static_cast<uint16_t>(slot_for(frames[i].slave_id));
+    }
+
+    if (mode_ != DecodeMode::Eager) {
+        for (size_t i = 0; i < count; ++i) {
+            store_raw(cycle_slots_[i], frames[i].data);
+        }
+    } else {
+        //runs where frames and slots both advance in step: one kernel call per run
+        //(the whole cycle for the usual process image)
+        for (size_t first = 0; first < count;) {
+            size_t last = first + 1;
+            const ptrdiff_t stride = last < count ? frames[last].data - frames[first].data : 0;
+            if (stride >= static_cast<ptrdiff_t>(PdoInputLayout::size)) {
+                while (last < count && cycle_slots_[last] == cycle_slots_[first] + (last - first) &&
+                       frames[last].data == frames[first].data + static_cast<ptrdiff_t>(last - first) * stride) {
+                    ++last;
+                }
+            }
+            const size_t run_stride = last - first > 1 ? static_cast<size_t>(stride) : PdoInputLayout::size;
+            decode_frames(frames[first].data, last - first, run_stride, columns_from(columns, cycle_slots_[first]));
+            first = last;
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const size_t slot = cycle_slots_[i];
+        columns.timestamp[slot] = timestamp;
+        columns.slave_position[slot] = frames[i].slave_id;
+        columns.data_valid[slot] = 1;
+        columns.restored[slot] = 0;
+        columns.invalid_fields[slot] = 0;
+        columns.deferred[slot] = 0;
+        arrivals_.record(frames[i].slave_id, arrival);
+    }
+
+    //fixed-point boards: redo their temperature from the raw integer, one decode and one
+    //conversion per run of consecutive slots in the same format (lazy: from the stored frames)
+    if (!field_formats_.empty()) {
+        const bool eager = mode_ == DecodeMode::Eager;
+        for (size_t first = 0; first < count;) {
+            const size_t slot = cycle_slots_[first];
+            const ScaledFormat* format = slot_format_[slot];
+            size_t last = first + 1;
+            if (format == nullptr) {
+                first = last;
+                continue;
+            }
+            ptrdiff_t stride = static_cast<ptrdiff_t>(PdoInputLayout::size);
+            if (eager && last < count && frames[last].data - frames[first].data > stride) {
+                stride = frames[last].data - frames[first].data;
+            }
+            while (last < count && cycle_slots_[last] == slot + (last - first) &&
+                   same_format(slot_format_[cycle_slots_[last]], format) &&
+                   (!eager || frames[last].data == frames[first].data + static_cast<ptrdiff_t>(last - first) * stride)) {
+                ++last;
+            }
+            decode_fixed_point(eager ? frames[first].data : raw_frames_.frame(slot), last - first,
+                               static_cast<size_t>(stride), slot, *format);
+            first = last;
+        }
+    }
+
+    //one kernel call per run of consecutive slots (the whole cycle for the usual process image);
+    //temperatures kept fixed-point have no float to sanitize
+    if (float_policies_.motor_temperature.active()) {
+        for (size_t first = 0; first < count;) {
+            size_t last = first + 1;
+            if (keeps_fixed_point(cycle_slots_[first])) {
+                first = last;
+                continue;
+            }
+            while (last < count && cycle_slots_[last] == cycle_slots_[first] + (last - first) &&
+                   !keeps_fixed_point(cycle_slots_[last])) {
+                ++last;
+            }
+            sanitize_temperatures(cycle_slots_[first], last - first);
+            first = last;
+        }
+    }
+}
+
+bool StarManager::invalidate(uint8_t slave_id){
+    if (slot_of_[slave_id] < 0) {
+        return false;
+    }
+    slave_registry_.columns().data_valid[slot_of_[slave_id]] = 0;
+    return true;
+}
+
+bool StarManager::reject(uint8_t slave_id){
+    if (slot_of_[slave_id] < 0) {
+        return false;
+    }
+    slave_registry_.columns().data_valid[slot_of_[slave_id]] = 0;
+    arrivals_.skip(slave_id);
+    return true;
+}
+
+bool StarManager::defer(uint8_t slave_id){
+    if (slot_of_[slave_id] < 0) {
+        return false;
+    }
+    slave_registry_.columns().deferred[slot_of_[slave_id]] = 1;
+    arrivals_.skip(slave_id);
+    return true;
+}
+
+//API: SlaveRealTimeData of one slave, for the cycle thread; other threads read snapshots
+SlaveRealTimeData StarManager::getSlaveData(uint8_t slave_id){
+    const size_t slot = checked_slot(slave_id);
+    const SlaveColumns& columns = slave_registry_.columns();
+    if (mode_ == DecodeMode::Eager || cached_input_[slot] == input_epoch_) {
+        return load_slave(columns, slot);
+    }
+
+    SlaveRealTimeData data = decode_stored_slave(raw_frames_, columns, slot);
+    if (mode_ == DecodeMode::LazyCached) {
+        store_slave(columns, slot, data); //later reads of this input come from the columns
+        cached_input_[slot] = input_epoch_;
+    }
+    return data;
+}
+
+void StarManager::setFieldFormats(uint8_t slave_id, const FieldFormats& formats){
+    field_formats_[slave_id] = formats;
+    if (slot_of_[slave_id] >= 0) {
+        const size_t slot = static_cast<size_t>(slot_of_[slave_id]);
+        slot_format_[slot] = temperature_format(slave_id);
+        if (slot_format_[slot] == nullptr) {
+            slave_registry_.columns().motor_temperature_raw[slot] = std::numeric_limits<int32_t>::min();
+        }
+    }
+}
+
+void StarManager::setSupplyGroup(uint8_t slave_id, uint8_t group){
+    if (group >= kMaxSupplyGroups) {
+        throw std::invalid_argument("power-supply group out of range");
+    }
+    supply_group_of_[slave_id] = group;
+    if (slot_of_[slave_id] >= 0) {
+        slot_group_[static_cast<size_t>(slot_of_[slave_id])] = group;
+    }
+    supply_groups_used_ = supply_groups_used_ || group != 0;
+}
+
+
+void StarManager::setArrivalThresholds(const ArrivalThresholds& thresholds){
+    arrivals_.setThresholds(thresholds);
+}
+
+void StarManager::setExpectedPeriod(uint8_t slave_id, uint64_t period_ns){
+    arrivals_.setExpectedPeriod(slave_id, period_ns);
+}
+
+ArrivalStats StarManager::arrivalStats(uint8_t slave_id) const {
+    checked_slot(slave_id);
+    return arrivals_.stats(slave_id);
+}
+
+std::vector<uint8_t> StarManager::timingAnomalies() const {
+    return arrivals_.anomalies(steady_ns());
+}
+
 
+void StarManager::compute_aggregates(){
+    const SlaveColumns& columns = slave_registry_.columns();
+    const size_t count = slot_count_;
+
+    //lazy modes: the three wire fields reduced here are decoded into their columns first, for the
+    //slots that got a frame since the last commit; the others still hold what was decoded then
+    //(a fixed-point temperature is already there, decode_stored_field returns it)
+    if (mode_ != DecodeMode::Eager) {
+        for (uint16_t slot : undecoded_slots_) {
+            undecoded_[slot] = 0;
+            if (cached_input_[slot] == input_epoch_) {
+                continue;
+            }
+            ++aggregate_decodes_;
+            columns.status_word[slot] =
+                decode_stored_field<&SlaveRealTimeData::status_word>(raw_frames_, columns, slot);
+            columns.actual_torque[slot] =
+                decode_stored_field<&SlaveRealTimeData::actual_torque>(raw_frames_, columns, slot);
+            columns.motor_temperature[slot] =
+                decode_stored_field<&SlaveRealTimeData::motor_temperature>(raw_frames_, columns, slot);
+            if (error_monitor_ != nullptr) {
+                columns.error_code[slot] =
+                    decode_stored_field<&SlaveRealTimeData::error_code>(raw_frames_, columns, slot);
+                columns.system_status[slot] =
+                    decode_stored_field<&SlaveRealTimeData::system_status>(raw_frames_, columns, slot);
+            }
+        }
+        undecoded_slots_.clear();
+    }
+
+    CycleAggregates& out = aggregates_;
+    out.slave_count = count;
+    out.oldest_timestamp = reduce_min_u64(columns.timestamp, count);
+    out.invalid = 0;
+    out.restored = 0;
+    out.invalid_fields = 0;
+    out.deferred = 0;
+    for (size_t slot = 0; slot < count; ++slot) {
+        out.invalid += columns.data_valid[slot] == 0;
+        out.restored += columns.restored[slot];
+        out.invalid_fields += columns.invalid_fields[slot] != 0;
+        out.deferred += columns.deferred[slot];
+    }
+
+    //value figures over the runs of valid slots: one run, the whole registry, unless a
+    //frame was rejected (its slot holds last cycle's values, or whatever came in before the check)
+    out.max_motor_temperature = -std::numeric_limits<float>::infinity();
+    out.max_motor_temperature_raw = std::numeric_limits<int32_t>::min();
+    out.faulted = 0;
+    out.supply_torque.fill(0);
+    for (size_t first = 0; first < count;) {
+        if (columns.data_valid[first] == 0) {
+            ++first;
+            continue;
+        }
+        size_t last = first + 1;
+        while (last < count && columns.data_valid[last] != 0) {
+            ++last;
+        }
+        const size_t run = last - first;
+        out.max_motor_temperature = std::max(out.max_motor_temperature,
+                                             reduce_max_f32(columns.motor_temperature + first, run));
+        out.max_motor_temperature_raw = std::max(out.max_motor_temperature_raw,
+                                                 reduce_max_i32(columns.motor_temperature_raw + first, run));
+        out.faulted += count_flagged_u16(columns.status_word + first, run, kFaultStatusBit);
+        if (!supply_groups_used_) {
+            out.supply_torque[0] += reduce_sum_i16(columns.actual_torque + first, run);
+        } else {
+            //groups are scattered over the slots: one pass, each torque added to its group
+            for (size_t slot = first; slot < last; ++slot) {
+                out.supply_torque[slot_group_[slot]] += columns.actual_torque[slot];
+            }
+        }
+        first = last;
+    }
+}
+
+
+void StarManager::commit(){
+    compute_aggregates(); //before the seq flips: the buffer is odd for as short as possible
+
+    const uint64_t cycle = committed_cycle_.load(std::memory_order_relaxed) + 1;
+    if (error_monitor_ != nullptr) {
+        error_monitor_->scan(slave_registry_.columns(), slot_count_, id_of_slot_.data(), cycle);
+    }
+    PublishedBuffer& target = published_[cycle % 2];
+
+    //odd: readers that already picked this buffer will retry
+    const uint64_t seq = target.seq.load(std::memory_order_relaxed);
+    target.seq.store(seq + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    StarSnapshot& snapshot = target.snapshot;
+    snapshot.cycle = cycle;
+    snapshot.commit_time_ns = now_ns();
+    snapshot.slave_count = slot_count_;
+    snapshot.aggregates = aggregates_;
+    snapshot.slot_of = slot_of_;
+    copy_columns(slave_registry_.columns(), snapshot.columns.columns(), slot_count_);
+    snapshot.mode = mode_;
+    if (mode_ != DecodeMode::Eager) {
+        snapshot.raw_frames.copy_from(raw_frames_, slot_count_);
+    }
+
+    target.seq.store(seq + 2, std::memory_order_release);
+    committed_cycle_.store(cycle, std::memory_order_release);
+}
+
+void StarManager::writeCheckpoint(CheckpointWriter& writer) const {
+    const SlaveColumns& columns = slave_registry_.columns();
+    writer.begin_section(CheckpointSection::Registry);
+    writer.put(committed_cycle_.load(std::memory_order_relaxed));
+    writer.put(static_cast<uint16_t>(slot_count_));
+    for (size_t slot = 0; slot < slot_count_; ++slot) { //slot order: restore assigns the same slots
+        const SlaveRealTimeData data = mode_ == DecodeMode::Eager || cached_input_[slot] == input_epoch_
+            ? load_slave(columns, slot)
+            : decode_stored_slave(raw_frames_, columns, slot);
+        writer.put(id_of_slot_[slot]);
+        writer.put(data.status_word);
+        writer.put(data.actual_position);
+        writer.put(data.actual_velocity);
+        writer.put(data.actual_torque);
+        writer.put(data.mode_display);
+        writer.put(data.error_code);
+        writer.put(data.system_status);
+        writer.put(data.motor_temperature);
+        writer.put(columns.motor_temperature_raw[slot]);
+        writer.put(data.timestamp);
+        writer.put(data.data_valid);
+        writer.put(data.invalid_fields);
+
+        const ArrivalStats& arrival = arrivals_.stats(id_of_slot_[slot]);
+        writer.put(arrival.intervals);
+        writer.put(arrival.mean_ns);
+        writer.put(arrival.variance_ns2);
+        writer.put(arrival.min_ns);
+        writer.put(arrival.max_ns);
+        writer.put(arrival.baseline_ns);
+        writer.put(arrival.flags);
+    }
+    writer.end_section();
+}
+
+bool StarManager::restoreCheckpoint(CheckpointReader& reader){
+    RegistryCheckpoint checkpoint;
+    if (!loadCheckpoint(reader, checkpoint)) {
+        return false;
+    }
+    applyCheckpoint(checkpoint);
+    return true;
+}
+
+bool StarManager::loadCheckpoint(CheckpointReader& reader, RegistryCheckpoint& out) const {
+    if (!reader.open(CheckpointSection::Registry)) {
+        return false;
+    }
+    RegistryCheckpoint checkpoint;
+    checkpoint.cycle = reader.get<uint64_t>();
+    const size_t count = reader.get<uint16_t>();
+    if (count > kMaxSlaves) {
+        throw std::invalid_argument("checkpoint holds more slots than a line has");
+    }
+    checkpoint.slots.resize(count);
+    for (RegistryCheckpoint::Slot& r : checkpoint.slots) {
+        r.slave_id = reader.get<uint8_t>();
+        r.data.status_word = reader.get<uint16_t>();
+        r.data.actual_position = reader.get<int32_t>();
+        r.data.actual_velocity = reader.get<int32_t>();
+        r.data.actual_torque = reader.get<int16_t>();
+        r.data.mode_display = reader.get<uint8_t>();
+        r.data.error_code = reader.get<uint16_t>();
+        r.data.system_status = reader.get<uint16_t>();
+        r.data.motor_temperature = reader.get<float>();
+        r.temperature_raw = reader.get<int32_t>();
+        r.data.timestamp = reader.get<uint64_t>();
+        r.data.data_valid = reader.get<bool>();
+        r.data.invalid_fields = reader.get<uint8_t>();
+        r.data.slave_position = r.slave_id;
+        r.data.restored = true;
+
+        r.arrival.intervals = reader.get<uint64_t>();
+        r.arrival.mean_ns = reader.get<double>();
+        r.arrival.variance_ns2 = reader.get<double>();
+        r.arrival.min_ns = reader.get<uint64_t>();
+        r.arrival.max_ns = reader.get<uint64_t>();
+        r.arrival.baseline_ns = reader.get<double>();
+        r.arrival.flags = reader.get<uint8_t>();
+    }
+    out = std::move(checkpoint);
+    return true;
 }
 
-//API: SlaveRealTimeData instances can be accessed by any class
-SlaveRealTimeData StarManager::getSlaveData(uint8_t slave_id) const {
+void StarManager::applyCheckpoint(const RegistryCheckpoint& checkpoint){
+    const SlaveColumns& columns = slave_registry_.columns();
+    WriteState encoder;
+    for (const RegistryCheckpoint::Slot& r : checkpoint.slots) {
+        const size_t slot = slot_for(r.slave_id);
+        store_slave(columns, slot, r.data);
+        columns.motor_temperature_raw[slot] = r.temperature_raw;
+        if (std::isfinite(r.data.motor_temperature)) {
+            last_good_temperature_[slot] = r.data.motor_temperature;
+        }
+        if (mode_ != DecodeMode::Eager) {
+            //lazy: the wire fields are read from the frame; the temperature comes from its column
+            encoder.encode(r.data, raw_frames_.frame(slot), RawFrameStore::kFrameSize);
+            raw_frames_.scaled[slot] = 1;
+            cached_input_[slot] = 0;
+        }
+        arrivals_.restore(r.slave_id, r.arrival);
+    }
 
-    return slave_registry.at(slave_id);
-}
\ No newline at end of file
+    committed_cycle_.store(checkpoint.cycle, std::memory_order_relaxed);
+    commit(); //cycle + 1, and readers see the restored registry
+}
+
+void StarManager::readSnapshot(StarSnapshot& out) const {
+    for (;;) {
+        const uint64_t cycle = committed_cycle_.load(std::memory_order_acquire);
+        const PublishedBuffer& source = published_[cycle % 2];
+
+        const uint64_t before = source.seq.load(std::memory_order_acquire);
+        if (before % 2 != 0) {
+            continue; //writer lapped us and is refilling this buffer
+        }
+
+        const StarSnapshot& snapshot = source.snapshot;
+        out.cycle = snapshot.cycle;
+        out.commit_time_ns = snapshot.commit_time_ns;
+        out.slave_count = snapshot.slave_count;
+        out.aggregates = snapshot.aggregates;
+        out.slot_of = snapshot.slot_of;
+        copy_columns(snapshot.columns.columns(), out.columns.columns(), snapshot.slave_count);
+        out.mode = snapshot.mode;
+        if (snapshot.mode != DecodeMode::Eager) {
+            out.raw_frames.copy_from(snapshot.raw_frames, snapshot.slave_count);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (source.seq.load(std::memory_order_relaxed) == before) {
+            return;
+        }
+    }
+}
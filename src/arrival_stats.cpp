@@ -0,0 +1,106 @@
+#include "arrival_stats.hpp"
+
+#include <cmath>
+#include <stdexcept>
+
+
+double ArrivalStats::stddev_ns() const {
+    return std::sqrt(variance_ns2);
+}
+
+
+ArrivalTracker::ArrivalTracker(const ArrivalThresholds& thresholds) {
+    setThresholds(thresholds);
+}
+
+void ArrivalTracker::setThresholds(const ArrivalThresholds& thresholds) {
+    if (!(thresholds.alpha > 0.0 && thresholds.alpha <= 1.0) || thresholds.max_drift < 0.0 ||
+        thresholds.max_jitter < 0.0 || thresholds.late_periods < 0.0) {
+        throw std::invalid_argument("ArrivalThresholds out of range");
+    }
+    thresholds_ = thresholds;
+}
+
+void ArrivalTracker::setExpectedPeriod(uint8_t slave_id, uint64_t period_ns) {
+    expected_ns_[slave_id] = period_ns;
+    stats_[slave_id].baseline_ns = static_cast<double>(period_ns); //0: taken again after warm-up
+}
+
+
+void ArrivalTracker::record(uint8_t slave_id, uint64_t timestamp_ns) {
+    ArrivalStats& s = stats_[slave_id];
+    const uint64_t previous = s.last_ns;
+    s.last_ns = timestamp_ns;
+    if (previous == 0 || timestamp_ns < previous) {
+        return; //first frame, or the timestamps went back (capture replay): no interval
+    }
+
+    const uint64_t interval = timestamp_ns - previous;
+    const double x = static_cast<double>(interval);
+    if (s.intervals == 0) {
+        s.mean_ns = x;
+        s.variance_ns2 = 0.0;
+    } else {
+        //incremental EWMA mean and variance
+        const double a = thresholds_.alpha;
+        const double diff = x - s.mean_ns;
+        s.mean_ns += a * diff;
+        s.variance_ns2 = (1.0 - a) * (s.variance_ns2 + a * diff * diff);
+    }
+    ++s.intervals;
+    if (interval < s.min_ns) {
+        s.min_ns = interval;
+    }
+    if (interval > s.max_ns) {
+        s.max_ns = interval;
+    }
+
+    if (s.intervals < thresholds_.warmup) {
+        return;
+    }
+    if (s.baseline_ns <= 0.0) {
+        s.baseline_ns = expected_ns_[slave_id] != 0 ? static_cast<double>(expected_ns_[slave_id]) : s.mean_ns;
+    }
+
+    uint8_t flags = 0;
+    if (std::fabs(s.mean_ns - s.baseline_ns) > thresholds_.max_drift * s.baseline_ns) {
+        flags |= kArrivalDrift;
+    }
+    if (s.stddev_ns() > thresholds_.max_jitter * s.mean_ns) {
+        flags |= kArrivalJitter;
+    }
+    s.flags = flags;
+}
+
+
+uint8_t ArrivalTracker::flags(uint8_t slave_id, uint64_t now_ns) const {
+    const ArrivalStats& s = stats_[slave_id];
+    uint8_t flags = s.flags;
+    if (s.baseline_ns > 0.0 && s.last_ns != 0 && now_ns > s.last_ns &&
+        static_cast<double>(now_ns - s.last_ns) > thresholds_.late_periods * s.baseline_ns) {
+        flags |= kArrivalLate;
+    }
+    return flags;
+}
+
+std::vector<uint8_t> ArrivalTracker::anomalies(uint64_t now_ns) const {
+    std::vector<uint8_t> ids;
+    for (size_t id = 0; id < stats_.size(); ++id) {
+        if (flags(static_cast<uint8_t>(id), now_ns) != 0) {
+            ids.push_back(static_cast<uint8_t>(id));
+        }
+    }
+    return ids;
+}
+
+void ArrivalTracker::restore(uint8_t slave_id, const ArrivalStats& stats) {
+    stats_[slave_id] = stats;
+    stats_[slave_id].last_ns = 0;
+}
+
+void ArrivalTracker::reset(uint8_t slave_id) {
+    stats_[slave_id] = ArrivalStats();
+    if (expected_ns_[slave_id] != 0) {
+        stats_[slave_id].baseline_ns = static_cast<double>(expected_ns_[slave_id]);
+    }
+}
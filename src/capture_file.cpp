@@ -0,0 +1,360 @@
+/* CaptureFile class:
+- pcap: 24-byte global header, then 16-byte record headers each followed by the frame
+- pcapng: blocks of (type, total length, body, total length); the section header
+fixes the byte order, interface description blocks the linktype and timestamp
+resolution of each interface, enhanced/simple packet blocks carry the frames
+- the mapping is read-only; a corrupt block length is an error, a cut-off tail is not
+*/
+
+#include "capture_file.hpp"
+#include "pdo_field.hpp"
+
+#include <stdexcept>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#else
+#include <fstream>
+#include <iterator>
+#endif
+
+
+namespace {
+
+constexpr uint32_t kPcapMicro = 0xA1B2C3D4;
+constexpr uint32_t kPcapNano = 0xA1B23C4D;
+constexpr uint32_t kPcapNgSection = 0x0A0D0D0A;
+constexpr uint32_t kPcapNgByteOrder = 0x1A2B3C4D;
+constexpr uint32_t kBlockInterface = 1;
+constexpr uint32_t kBlockSimplePacket = 3;
+constexpr uint32_t kBlockEnhancedPacket = 6;
+constexpr uint16_t kOptionEnd = 0;
+constexpr uint16_t kOptionTsResol = 9;
+constexpr uint32_t kLinkTypeEthernet = 1;
+
+constexpr size_t kPcapHeader = 24;
+constexpr size_t kPcapRecord = 16;
+
+uint32_t byteswap32(uint32_t v) {
+    return (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+}
+
+uint16_t byteswap16(uint16_t v) {
+    return static_cast<uint16_t>((v >> 8) | (v << 8));
+}
+
+uint64_t pow10(uint8_t exponent) {
+    uint64_t value = 1;
+    for (uint8_t i = 0; i < exponent; ++i) {
+        value *= 10;
+    }
+    return value;
+}
+
+size_t pad4(size_t length) {
+    return (length + 3) & ~size_t{3};
+}
+
+} // namespace
+
+
+CaptureFile::CaptureFile(const std::string& path) {
+#if defined(__unix__) || defined(__APPLE__)
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("cannot open capture " + path);
+    }
+    struct stat st {};
+    if (fstat(fd, &st) != 0) {
+        ::close(fd);
+        throw std::runtime_error("cannot stat capture " + path);
+    }
+    size_ = static_cast<size_t>(st.st_size);
+    if (size_ > 0) {
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error("cannot map capture " + path);
+        }
+        madvise(p, size_, MADV_SEQUENTIAL); //read-ahead: one pass front to back
+        data_ = static_cast<const uint8_t*>(p);
+        mapped_ = true;
+    }
+    ::close(fd); //the mapping keeps the file
+#else
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("cannot open capture " + path);
+    }
+    copy_.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    data_ = copy_.data();
+    size_ = copy_.size();
+#endif
+    try {
+        open();
+    } catch (...) {
+#if defined(__unix__) || defined(__APPLE__)
+        if (mapped_) {
+            munmap(const_cast<uint8_t*>(data_), size_);
+        }
+#endif
+        throw;
+    }
+}
+
+CaptureFile::CaptureFile(const uint8_t* data, size_t size)
+    : data_(data)
+    , size_(size)
+{
+    open();
+}
+
+CaptureFile::~CaptureFile() {
+#if defined(__unix__) || defined(__APPLE__)
+    if (mapped_) {
+        munmap(const_cast<uint8_t*>(data_), size_);
+    }
+#endif
+}
+
+
+uint16_t CaptureFile::u16(const uint8_t* p) const {
+    const uint16_t v = load_le<uint16_t>(p);
+    return swapped_ ? byteswap16(v) : v;
+}
+
+uint32_t CaptureFile::u32(const uint8_t* p) const {
+    const uint32_t v = load_le<uint32_t>(p);
+    return swapped_ ? byteswap32(v) : v;
+}
+
+
+void CaptureFile::open() {
+    if (size_ < 12) {
+        throw std::invalid_argument("capture too short for a pcap or pcapng header");
+    }
+    const uint32_t magic = load_le<uint32_t>(data_);
+
+    if (magic == kPcapNgSection) {
+        format_ = Format::PcapNg;
+        read_section_header(0);
+        first_record_ = 0; //the section header is walked again by next(), resetting interfaces
+        rewind();
+        return;
+    }
+
+    format_ = Format::Pcap;
+    if (magic == kPcapMicro || magic == kPcapNano) {
+        swapped_ = false;
+    } else if (byteswap32(magic) == kPcapMicro || byteswap32(magic) == kPcapNano) {
+        swapped_ = true;
+    } else {
+        throw std::invalid_argument("not a pcap or pcapng capture");
+    }
+    if (size_ < kPcapHeader) {
+        throw std::invalid_argument("pcap global header cut off");
+    }
+    nanoseconds_ = u32(data_) == kPcapNano;
+    if (u32(data_ + 20) != kLinkTypeEthernet) {
+        throw std::invalid_argument("pcap linktype is not Ethernet");
+    }
+    first_record_ = kPcapHeader;
+    rewind();
+}
+
+void CaptureFile::rewind() {
+    offset_ = first_record_;
+    truncated_ = false;
+    if (format_ == Format::PcapNg) {
+        interfaces_.clear();
+    }
+}
+
+
+bool CaptureFile::next(CapturedPacket& packet) {
+    return format_ == Format::Pcap ? next_pcap(packet) : next_pcapng(packet);
+}
+
+bool CaptureFile::next_pcap(CapturedPacket& packet) {
+    if (offset_ == size_) {
+        return false;
+    }
+    if (size_ - offset_ < kPcapRecord) {
+        truncated_ = true;
+        return false;
+    }
+    const uint8_t* record = data_ + offset_;
+    const uint32_t captured = u32(record + 8);
+    if (size_ - offset_ - kPcapRecord < captured) {
+        truncated_ = true;
+        return false;
+    }
+
+    const uint64_t seconds = u32(record);
+    const uint64_t fraction = u32(record + 4);
+    packet.data = record + kPcapRecord;
+    packet.captured_length = captured;
+    packet.original_length = u32(record + 12);
+    packet.timestamp_ns = seconds * 1000000000ull + (nanoseconds_ ? fraction : fraction * 1000);
+    offset_ += kPcapRecord + captured;
+    return true;
+}
+
+
+void CaptureFile::read_section_header(size_t offset) {
+    if (size_ - offset < 28) {
+        throw std::invalid_argument("pcapng section header cut off");
+    }
+    const uint32_t order = load_le<uint32_t>(data_ + offset + 8);
+    if (order == kPcapNgByteOrder) {
+        swapped_ = false;
+    } else if (byteswap32(order) == kPcapNgByteOrder) {
+        swapped_ = true;
+    } else {
+        throw std::invalid_argument("pcapng section header without byte-order magic");
+    }
+    interfaces_.clear();
+}
+
+void CaptureFile::read_interface(const uint8_t* body, size_t length) {
+    if (length < 8) {
+        throw std::invalid_argument("pcapng interface block too short");
+    }
+    Interface interface{u16(body) == kLinkTypeEthernet, 1000000, false, 6}; //default: microseconds
+
+    for (size_t offset = 8; offset + 4 <= length;) {
+        const uint16_t code = u16(body + offset);
+        const uint16_t option_length = u16(body + offset + 2);
+        if (code == kOptionEnd || offset + 4 + option_length > length) {
+            break;
+        }
+        if (code == kOptionTsResol && option_length >= 1) {
+            const uint8_t resolution = body[offset + 4];
+            interface.power_of_two = (resolution & 0x80) != 0;
+            interface.exponent = resolution & 0x7F;
+            if (!interface.power_of_two && interface.exponent > 19) {
+                throw std::invalid_argument("pcapng if_tsresol out of range");
+            }
+            interface.units_per_second = interface.power_of_two ? 0 : pow10(interface.exponent);
+        }
+        offset += 4 + pad4(option_length);
+    }
+    interfaces_.push_back(interface);
+}
+
+bool CaptureFile::next_pcapng(CapturedPacket& packet) {
+    for (;;) {
+        if (offset_ == size_) {
+            return false;
+        }
+        if (size_ - offset_ < 12) {
+            truncated_ = true;
+            return false;
+        }
+        const uint8_t* block = data_ + offset_;
+        const uint32_t type = load_le<uint32_t>(block) == kPcapNgSection ? kPcapNgSection : u32(block);
+        if (type == kPcapNgSection) {
+            read_section_header(offset_); //byte order may change between sections
+        }
+        const uint32_t total = u32(block + 4);
+        if (total < 12 || total % 4 != 0) {
+            throw std::invalid_argument("pcapng block with a corrupt length");
+        }
+        if (size_ - offset_ < total) {
+            truncated_ = true;
+            return false;
+        }
+        const uint8_t* body = block + 8;
+        const size_t body_length = total - 12;
+        offset_ += total;
+
+        if (type == kBlockInterface) {
+            read_interface(body, body_length);
+            continue;
+        }
+
+        if (type == kBlockEnhancedPacket) {
+            if (body_length < 20) {
+                throw std::invalid_argument("pcapng packet block too short");
+            }
+            const uint32_t interface_id = u32(body);
+            const uint32_t captured = u32(body + 12);
+            if (interface_id >= interfaces_.size() || captured > body_length - 20) {
+                throw std::invalid_argument("pcapng packet block inconsistent");
+            }
+            const Interface& interface = interfaces_[interface_id];
+            if (!interface.ethernet) {
+                continue;
+            }
+            const uint64_t units = (uint64_t{u32(body + 4)} << 32) | u32(body + 8);
+            if (interface.power_of_two) {
+                const uint64_t whole = units >> interface.exponent;
+                const uint64_t fraction = units & ((uint64_t{1} << interface.exponent) - 1);
+                packet.timestamp_ns = whole * 1000000000ull + ((fraction * 1000000000ull) >> interface.exponent);
+            } else if (interface.units_per_second <= 1000000000ull) {
+                packet.timestamp_ns = units * (1000000000ull / interface.units_per_second);
+            } else {
+                packet.timestamp_ns = units / (interface.units_per_second / 1000000000ull);
+            }
+            packet.data = body + 20;
+            packet.captured_length = captured;
+            packet.original_length = u32(body + 16);
+            return true;
+        }
+
+        if (type == kBlockSimplePacket) {
+            if (body_length < 4 || interfaces_.empty()) {
+                throw std::invalid_argument("pcapng simple packet block inconsistent");
+            }
+            if (!interfaces_.front().ethernet) {
+                continue;
+            }
+            const uint32_t original = u32(body);
+            packet.data = body + 4;
+            packet.original_length = original;
+            packet.captured_length = static_cast<uint32_t>(original < body_length - 4 ? original : body_length - 4);
+            packet.timestamp_ns = 0;
+            return true;
+        }
+        //section headers, statistics, name resolution, custom blocks: nothing to hand out
+    }
+}
+
+
+CaptureStats replay_capture(CaptureFile& capture, CaptureDecoder& decoder, StarManager& manager,
+                            const std::function<void(const CapturedPacket&)>& on_cycle) {
+    CaptureStats stats;
+    CapturedPacket packet;
+    std::vector<SlaveFrame> slaves;
+    slaves.reserve(kMaxSlaves);
+
+    while (capture.next(packet)) {
+        ++stats.packets;
+        switch (decoder.decode(packet.data, packet.captured_length, slaves)) {
+        case FrameStatus::Ok:
+            break;
+        case FrameStatus::NotEthercat:
+            ++stats.not_ethercat;
+            continue;
+        case FrameStatus::Truncated:
+            ++stats.truncated;
+            continue;
+        case FrameStatus::Malformed:
+            ++stats.malformed;
+            continue;
+        }
+        if (slaves.empty()) {
+            continue; //outgoing copy, or no mapped slave in it
+        }
+        manager.input_cycle(slaves, packet.timestamp_ns);
+        ++stats.cycles;
+        stats.slave_frames += slaves.size();
+        if (on_cycle) {
+            on_cycle(packet);
+        }
+    }
+    return stats;
+}
@@ -0,0 +1,158 @@
+/* checkpoint file:
+- written whole into memory first, then to disk in one go and renamed into place
+- read whole and verified (checksum over header and sections) before any
+component sees a byte of it, and every section parsed before any is applied,
+so a torn, foreign or inconsistent file never half-restores a line
+*/
+
+#include "checkpoint.hpp"
+#include "Ethercat_Hardware_Interface.hpp"
+#include "recorder.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+
+namespace {
+
+constexpr char kMagic[8] = {'S', 'T', 'A', 'R', 'C', 'K', 'P', 'T'};
+constexpr size_t kHeaderSize = sizeof(kMagic) + sizeof(uint32_t);
+constexpr size_t kSectionHeader = 2 * sizeof(uint32_t);
+constexpr size_t kChecksumSize = sizeof(uint64_t);
+
+uint64_t fnv1a(const uint8_t* data, size_t size, uint64_t hash = 0xCBF29CE484222325ull) {
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * 0x100000001B3ull;
+    }
+    return hash;
+}
+
+} // namespace
+
+
+void CheckpointWriter::begin_section(CheckpointSection section){
+    if (in_section_) {
+        throw std::logic_error("checkpoint sections do not nest");
+    }
+    put(static_cast<uint32_t>(section));
+    put(uint32_t{0}); //length, patched by end_section()
+    section_start_ = bytes_.size();
+    in_section_ = true;
+}
+
+void CheckpointWriter::end_section(){
+    if (!in_section_) {
+        throw std::logic_error("end_section() without begin_section()");
+    }
+    store_le(bytes_.data() + section_start_ - sizeof(uint32_t),
+             static_cast<uint32_t>(bytes_.size() - section_start_));
+    in_section_ = false;
+}
+
+void CheckpointWriter::save(const std::string& path) const {
+    if (in_section_) {
+        throw std::logic_error("checkpoint saved with a section still open");
+    }
+    std::vector<uint8_t> file(kHeaderSize);
+    std::memcpy(file.data(), kMagic, sizeof(kMagic));
+    store_le(file.data() + sizeof(kMagic), kCheckpointVersion);
+    file.insert(file.end(), bytes_.begin(), bytes_.end());
+    const uint64_t checksum = fnv1a(file.data(), file.size());
+    file.resize(file.size() + kChecksumSize);
+    store_le(file.data() + file.size() - kChecksumSize, checksum);
+
+    const std::string temporary = path + ".tmp";
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+        if (!out.flush()) {
+            throw std::runtime_error("cannot write checkpoint " + temporary);
+        }
+    }
+    if (std::rename(temporary.c_str(), path.c_str()) != 0) {
+        std::remove(temporary.c_str());
+        throw std::runtime_error("cannot move checkpoint into place at " + path);
+    }
+}
+
+
+CheckpointReader::CheckpointReader(std::vector<uint8_t> file)
+    : file_(std::move(file))
+{
+    if (file_.size() < kHeaderSize + kChecksumSize || std::memcmp(file_.data(), kMagic, sizeof(kMagic)) != 0) {
+        throw std::invalid_argument("not a checkpoint file");
+    }
+    if (load_le<uint32_t>(file_.data() + sizeof(kMagic)) != kCheckpointVersion) {
+        throw std::invalid_argument("checkpoint of another version");
+    }
+    const size_t body_end = file_.size() - kChecksumSize;
+    if (fnv1a(file_.data(), body_end) != load_le<uint64_t>(file_.data() + body_end)) {
+        throw std::invalid_argument("checkpoint checksum mismatch");
+    }
+
+    for (size_t offset = kHeaderSize; offset < body_end;) {
+        if (body_end - offset < kSectionHeader) {
+            throw std::invalid_argument("checkpoint section header cut off");
+        }
+        const uint32_t tag = load_le<uint32_t>(file_.data() + offset);
+        const size_t length = load_le<uint32_t>(file_.data() + offset + sizeof(uint32_t));
+        offset += kSectionHeader;
+        if (body_end - offset < length) {
+            throw std::invalid_argument("checkpoint section longer than the file");
+        }
+        sections_[tag] = {offset, length};
+        offset += length;
+    }
+}
+
+bool CheckpointReader::load(const std::string& path, std::vector<uint8_t>& file){
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        return false;
+    }
+    file.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool CheckpointReader::open(CheckpointSection section){
+    auto it = sections_.find(static_cast<uint32_t>(section));
+    if (it == sections_.end()) {
+        return false;
+    }
+    cursor_ = it->second.first;
+    section_end_ = it->second.first + it->second.second;
+    return true;
+}
+
+
+void save_checkpoint(const std::string& path, const Ethercat_Hardware_Interface& hardware, const Recorder* recorder){
+    CheckpointWriter writer;
+    hardware.writeCheckpoint(writer);
+    if (recorder != nullptr) {
+        recorder->write_checkpoint(writer);
+    }
+    writer.save(path);
+}
+
+bool restore_checkpoint(const std::string& path, Ethercat_Hardware_Interface& hardware, Recorder* recorder){
+    std::vector<uint8_t> file;
+    if (!CheckpointReader::load(path, file)) {
+        return false;
+    }
+    CheckpointReader reader(std::move(file)); //verified whole before anything is read
+
+    //every section parsed and checked first: a malformed one throws with nothing applied
+    Ethercat_Hardware_Interface::Checkpoint line;
+    Recorder::Checkpoint recorded;
+    hardware.loadCheckpoint(reader, line);
+    const bool has_recorder = recorder != nullptr && recorder->load_checkpoint(reader, recorded);
+
+    hardware.applyCheckpoint(line);
+    if (has_recorder) {
+        recorder->apply_checkpoint(recorded);
+    }
+    return true;
+}
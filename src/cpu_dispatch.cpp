@@ -0,0 +1,113 @@
+/* CPU feature detection for the multi-versioned kernels in simd_kernels.cpp
+
+- detect_simd_level() asks the CPU once (CPUID + OS support for the wide registers)
+- the active level starts at the detected one, optionally capped by
+STAR_SIMD_LEVEL, and can be forced lower for tests and benchmarks
+- on non-x86 or non-GCC/Clang builds everything reports Scalar
+*/
+
+#include "cpu_dispatch.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STAR_X86_DISPATCH 1
+#endif
+
+
+namespace {
+
+SimdLevel query_cpu() {
+#ifdef STAR_X86_DISPATCH
+    __builtin_cpu_init();
+    //the AVX-512 kernels use BW/VL byte and word ops, not only the F subset
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw") &&
+        __builtin_cpu_supports("avx512vl")) {
+        return SimdLevel::AVX512;
+    }
+    if (__builtin_cpu_supports("avx2")) {
+        return SimdLevel::AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return SimdLevel::SSE42;
+    }
+#endif
+    return SimdLevel::Scalar;
+}
+
+//STAR_SIMD_LEVEL only lowers the level: asking for more than the CPU has is ignored
+SimdLevel startup_level() {
+    SimdLevel level = detect_simd_level();
+    const char* env = std::getenv("STAR_SIMD_LEVEL");
+    if (env == nullptr) {
+        return level;
+    }
+
+    SimdLevel requested = level;
+    if (std::strcmp(env, "scalar") == 0) {
+        requested = SimdLevel::Scalar;
+    } else if (std::strcmp(env, "sse4.2") == 0 || std::strcmp(env, "sse42") == 0) {
+        requested = SimdLevel::SSE42;
+    } else if (std::strcmp(env, "avx2") == 0) {
+        requested = SimdLevel::AVX2;
+    } else if (std::strcmp(env, "avx512") == 0) {
+        requested = SimdLevel::AVX512;
+    }
+    return requested < level ? requested : level;
+}
+
+std::atomic<uint8_t>& active_level_slot() {
+    static std::atomic<uint8_t> slot{static_cast<uint8_t>(startup_level())};
+    return slot;
+}
+
+} // namespace
+
+
+SimdLevel detect_simd_level() {
+    static const SimdLevel detected = query_cpu();
+    return detected;
+}
+
+SimdLevel active_simd_level() {
+    return static_cast<SimdLevel>(active_level_slot().load(std::memory_order_relaxed));
+}
+
+bool simd_level_supported(SimdLevel level) {
+    return level <= detect_simd_level();
+}
+
+void force_simd_level(SimdLevel level) {
+    if (!simd_level_supported(level)) {
+        throw std::invalid_argument(std::string("SIMD level not supported by this CPU: ") +
+                                    simd_level_name(level));
+    }
+    active_level_slot().store(static_cast<uint8_t>(level), std::memory_order_relaxed);
+}
+
+void reset_simd_level() {
+    active_level_slot().store(static_cast<uint8_t>(startup_level()), std::memory_order_relaxed);
+}
+
+const char* simd_level_name(SimdLevel level) {
+    switch (level) {
+        case SimdLevel::Scalar: return "scalar";
+        case SimdLevel::SSE42:  return "sse4.2";
+        case SimdLevel::AVX2:   return "avx2";
+        case SimdLevel::AVX512: return "avx512";
+    }
+    return "unknown";
+}
+
+bool cpu_has_bmi2() {
+#ifdef STAR_X86_DISPATCH
+    static const bool has_bmi2 = (__builtin_cpu_init(), __builtin_cpu_supports("bmi2"));
+    return has_bmi2;
+#else
+    return false;
+#endif
+}
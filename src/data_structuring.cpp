@@ -1,70 +1,225 @@
 #include "data_structuring.hpp"
-#include <cstring>
+#include "simd_kernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
 
 
-//UNCOMMENT test assertions IN TEST FILE
+//field helpers: generic extract<T>() / insert<T>() in pdo_field.hpp
+//Ethercat buffer uses Little-Endian order
 
-//HELPER FUNCTIONS to extract all elements of the vector-buffer:
-    //Non-generic approach
-//size_t offset is the byte position = index
-uint16_t extract_uint16_t(const std::vector <uint8_t>& buffer, size_t offset){
-    return static_cast<uint16_t>(buffer[offset]) | //LSB
-        (static_cast<uint16_t>(buffer[offset + 1]) << 8); //MSB; shifted to bits 8-15
-}   
-//Ethercat buffer uses Little-Endian order; uints too
-//bitwise OR combines x2 parts of a uint16 value: LSB then MSB
 
-uint8_t extract_uint8_t(const std::vector <uint8_t>& buffer, size_t offset){
-    return buffer[offset];
-}
+//FIXED-POINT FIELDS: value = raw * scale + offset
 
+static size_t scaled_size(ValueEncoding encoding) {
+    return (encoding == ValueEncoding::Int16 || encoding == ValueEncoding::UInt16) ? 2 : 4;
+}
 
-int32_t extract_int32_t(const std::vector <uint8_t>& buffer, size_t offset){
-    uint32_t unsigned_value = 
-        static_cast<uint32_t>(buffer[offset]) |
-        (static_cast<uint32_t>(buffer[offset + 1]) << 8) |
-        (static_cast<uint32_t>(buffer[offset + 2]) << 16) |
-        (static_cast<uint32_t>(buffer[offset + 3]) << 24);
-    return static_cast<int32_t>(unsigned_value);
+int32_t load_scaled_raw(const uint8_t* p, ValueEncoding encoding) {
+    switch (encoding) {
+        case ValueEncoding::Int16:  return load_le<int16_t>(p);
+        case ValueEncoding::UInt16: return load_le<uint16_t>(p);
+        case ValueEncoding::Int32:  return load_le<int32_t>(p);
+        case ValueEncoding::Float32: break;
+    }
+    return load_le<int32_t>(p);
 }
-//Bit 15 (MSB) in int16_t = sign bit
-//casting to signed handles sign
 
-int16_t extract_int16_t(const std::vector <uint8_t>& buffer, size_t offset){
-    uint16_t unsigned_value = 
-        static_cast<uint16_t>(buffer[offset]) | 
-        (static_cast<uint16_t> (buffer[offset + 1]) << 8);
-    return static_cast<int16_t>(unsigned_value);
+float decode_scaled(const uint8_t* data, size_t size, size_t offset, const ScaledFormat& format) {
+    check_field_bounds(size, offset, scaled_size(format.encoding));
+    if (format.encoding == ValueEncoding::Float32) {
+        return load_le<float>(data + offset);
+    }
+    return static_cast<float>(load_scaled_raw(data + offset, format.encoding)) * format.scale + format.offset;
 }
 
+void encode_scaled(uint8_t* data, size_t size, size_t offset, const ScaledFormat& format, float value) {
+    check_field_bounds(size, offset, scaled_size(format.encoding));
+    if (format.encoding == ValueEncoding::Float32) {
+        store_le<float>(data + offset, value);
+        return;
+    }
 
-float extract_float(const std::vector <uint8_t>& buffer, size_t offset){
-    float value;
-    //mecpy takes addresses as args
-    std::memcpy(&value, &buffer[offset], sizeof(float));
-    return value;
+    double raw = std::nearbyint((static_cast<double>(value) - format.offset) / format.scale);
+    switch (format.encoding) {
+        case ValueEncoding::Int16:
+            store_le<int16_t>(data + offset, static_cast<int16_t>(std::clamp(raw, -32768.0, 32767.0)));
+            break;
+        case ValueEncoding::UInt16:
+            store_le<uint16_t>(data + offset, static_cast<uint16_t>(std::clamp(raw, 0.0, 65535.0)));
+            break;
+        default:
+            store_le<int32_t>(data + offset, static_cast<int32_t>(std::clamp(raw, -2147483648.0, 2147483647.0)));
+            break;
+    }
 }
 
 
 /* ReadState class:
 - takes vector-buffer from a single Slave
 - creates instance of SlaveRealTimeData from slaves_state_struct.hpp
-- calls helper functions to extract data from vector-buffer bytes into the struct
+- decodes every TxPdoLayout entry from vector-buffer bytes into the struct
 - returns the populated struct
 */
 SlaveRealTimeData ReadState::parse(const std::vector <uint8_t>& buffer) {
-    SlaveRealTimeData srt;
-
-    //offset = sum of bytes in previous objects
-    srt.status_word = extract_uint16_t(buffer, 0);
-    srt.actual_position = extract_int32_t(buffer, 2);
-    srt.actual_velocity = extract_int32_t(buffer, 6);
-    srt.actual_torque = extract_int16_t(buffer, 10);
-    srt.mode_display = extract_uint8_t(buffer, 12);
-    srt.error_code = extract_uint16_t(buffer, 13);
-    srt.system_status = extract_uint16_t(buffer, 15);
-    srt.motor_temperature = extract_float(buffer, 17);
-    
+    return parse(buffer.data(), buffer.size());
+}
+
+SlaveRealTimeData ReadState::parse(const uint8_t* data, size_t size) {
+    SlaveRealTimeData srt{}; //metadata (timestamp, slave_position, data_valid) is set by StarManager
+
+    //offsets and types come from TxPdoLayout (data_structuring.hpp)
+    //throws std::out_of_range if the buffer is too short
+    decode_layout<TxPdoLayout>(data, size, srt);
+
+    return srt;
+}
+
+SlaveRealTimeData ReadState::parse(const uint8_t* data, size_t size, const FieldFormats& formats) {
+    SlaveRealTimeData srt = parse(data, size);
+    if (formats.motor_temperature.encoding != ValueEncoding::Float32) {
+        srt.motor_temperature = decode_scaled(data, size, PdoInputLayout::motor_temperature,
+                                              formats.motor_temperature);
+    }
     return srt;
 }
 
+SlaveCommandData ReadState::parse_command(const uint8_t* data, size_t size) {
+    SlaveCommandData command;
+    decode_layout<RxPdoLayout>(data, size, command);
+    return command;
+}
+
+
+/* WriteState class:
+- takes a populated struct
+- writes its PDO bytes into a caller buffer, same layout ReadState reads
+*/
+void WriteState::encode(const SlaveRealTimeData& data, uint8_t* out, size_t size) {
+    encode_layout<TxPdoLayout>(data, out, size);
+}
+
+void WriteState::encode(const SlaveRealTimeData& data, std::vector<uint8_t>& buffer) {
+    encode_layout<TxPdoLayout>(data, buffer.data(), buffer.size());
+}
+
+void WriteState::encode(const SlaveRealTimeData& data, uint8_t* out, size_t size, const FieldFormats& formats) {
+    encode_layout<TxPdoLayout>(data, out, size);
+    if (formats.motor_temperature.encoding != ValueEncoding::Float32) {
+        encode_scaled(out, size, PdoInputLayout::motor_temperature, formats.motor_temperature,
+                      data.motor_temperature);
+    }
+}
+
+void WriteState::encode_command(const SlaveCommandData& command, uint8_t* out, size_t size) {
+    encode_layout<RxPdoLayout>(command, out, size);
+}
+
+
+
+
+//BIT-GRANULAR FIELDS (packed digital I/O)
+
+//little-endian load of up to 8 bytes; bytes past the end of the buffer read as 0
+static uint64_t load_window(const std::vector<uint8_t>& buffer, size_t byte_offset) {
+    uint64_t value = 0;
+    size_t end = std::min(buffer.size(), byte_offset + 8);
+    for (size_t i = byte_offset; i < end; ++i) {
+        value |= static_cast<uint64_t>(buffer[i]) << (8 * (i - byte_offset));
+    }
+    return value;
+}
+
+static void store_window(std::vector<uint8_t>& buffer, size_t byte_offset, uint64_t value) {
+    size_t end = std::min(buffer.size(), byte_offset + 8);
+    for (size_t i = byte_offset; i < end; ++i) {
+        buffer[i] = static_cast<uint8_t>(value >> (8 * (i - byte_offset)));
+    }
+}
+
+static void check_bit_field(size_t buffer_size, BitField field) {
+    if (field.bit_width == 0 || field.bit_width > 32) {
+        throw std::invalid_argument("bit field width must be 1..32");
+    }
+    //no offset + width: it wraps for an offset near SIZE_MAX
+    if (field.bit_offset > buffer_size * 8 || field.bit_width > buffer_size * 8 - field.bit_offset) {
+        throw std::out_of_range("bit field outside of buffer");
+    }
+}
+
+//a 1..32 bit field starting anywhere in a byte fits in one 8-byte window: shift/mask is enough
+uint32_t extract_bits(const std::vector<uint8_t>& buffer, BitField field) {
+    check_bit_field(buffer.size(), field);
+    uint64_t window = load_window(buffer, field.bit_offset / 8);
+    uint64_t mask = (uint64_t{1} << field.bit_width) - 1;
+    return static_cast<uint32_t>((window >> (field.bit_offset % 8)) & mask);
+}
+
+void insert_bits(std::vector<uint8_t>& buffer, BitField field, uint32_t value) {
+    check_bit_field(buffer.size(), field);
+    size_t byte_offset = field.bit_offset / 8;
+    unsigned shift = field.bit_offset % 8;
+    uint64_t mask = ((uint64_t{1} << field.bit_width) - 1) << shift;
+    uint64_t window = load_window(buffer, byte_offset);
+    window = (window & ~mask) | ((static_cast<uint64_t>(value) << shift) & mask);
+    store_window(buffer, byte_offset, window);
+}
+
+
+DigitalIoMap::DigitalIoMap(std::vector<size_t> bit_offsets) {
+    std::sort(bit_offsets.begin(), bit_offsets.end());
+    bit_offsets.erase(std::unique(bit_offsets.begin(), bit_offsets.end()), bit_offsets.end());
+
+    //group the bits by 8-byte window; sorted input keeps bitset order = image order
+    for (size_t bit : bit_offsets) {
+        size_t byte_offset = (bit / 64) * 8;
+        if (words_.empty() || words_.back().byte_offset != byte_offset) {
+            words_.push_back(Word{byte_offset, 0, channel_count_, 0});
+        }
+        words_.back().mask |= uint64_t{1} << (bit % 64);
+        ++words_.back().bit_count;
+        ++channel_count_;
+    }
+    if (!bit_offsets.empty()) {
+        min_image_size_ = bit_offsets.back() / 8 + 1;
+    }
+}
+
+void DigitalIoMap::extract(const std::vector<uint8_t>& image, std::vector<uint64_t>& bits) const {
+    if (image.size() < min_image_size_) {
+        throw std::out_of_range("I/O image smaller than the digital I/O map");
+    }
+    bits.assign((channel_count_ + 63) / 64, 0);
+
+    for (const Word& word : words_) {
+        uint64_t packed = extract_bits_u64(load_window(image, word.byte_offset), word.mask);
+        size_t index = word.first_bit / 64;
+        unsigned shift = word.first_bit % 64;
+        bits[index] |= packed << shift;
+        //the window's bits may straddle two bitset words
+        if (shift != 0 && shift + word.bit_count > 64) {
+            bits[index + 1] |= packed >> (64 - shift);
+        }
+    }
+}
+
+void DigitalIoMap::insert(const std::vector<uint64_t>& bits, std::vector<uint8_t>& image) const {
+    if (image.size() < min_image_size_) {
+        throw std::out_of_range("I/O image smaller than the digital I/O map");
+    }
+    if (bits.size() * 64 < channel_count_) {
+        throw std::out_of_range("bitset smaller than the digital I/O map");
+    }
+
+    for (const Word& word : words_) {
+        size_t index = word.first_bit / 64;
+        unsigned shift = word.first_bit % 64;
+        uint64_t packed = bits[index] >> shift;
+        if (shift != 0 && index + 1 < bits.size()) {
+            packed |= bits[index + 1] << (64 - shift);
+        }
+        uint64_t window = load_window(image, word.byte_offset);
+        window = (window & ~word.mask) | deposit_bits_u64(packed, word.mask);
+        store_window(image, word.byte_offset, window);
+    }
+}
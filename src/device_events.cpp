@@ -0,0 +1,151 @@
+#include "device_events.hpp"
+#include "simd_kernels.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+
+namespace {
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+} // namespace
+
+
+std::string describe_event(const DeviceEvent& event, const ErrorCatalogue& catalogue) {
+    char head[96];
+    const DeviceType type = event.device_type < catalogue.device_type_count() ? event.device_type
+                                                                              : ErrorCatalogue::kDefaultDevice;
+    std::snprintf(head, sizeof(head), "cycle %llu slave %u [%s] ", static_cast<unsigned long long>(event.cycle),
+                  unsigned{event.slave_id}, catalogue.device_type_name(type).c_str());
+    std::string out = head;
+
+    char value[48];
+    if (event.kind == DeviceEvent::Kind::ErrorCode) {
+        if (event.code == 0) {
+            std::snprintf(value, sizeof(value), "error 0x%04X cleared", unsigned{event.previous});
+            return out + value;
+        }
+        std::snprintf(value, sizeof(value), "error 0x%04X ", unsigned{event.code});
+        out += value;
+        const ErrorCodeInfo* info = catalogue.code_info(type, event.code);
+        out += info != nullptr ? info->text : std::string("unknown code");
+    } else {
+        std::snprintf(value, sizeof(value), "status 0x%04X -> 0x%04X", unsigned{event.previous}, unsigned{event.code});
+        out += value;
+        //names of the listed bits that came on
+        const uint16_t raised = static_cast<uint16_t>(event.code & ~event.previous);
+        for (uint8_t bit = 0; bit < 16; ++bit) {
+            const ErrorCodeInfo* info = (raised >> bit & 1u) ? catalogue.status_bit_info(type, bit) : nullptr;
+            if (info != nullptr) {
+                out += ", ";
+                out += info->text;
+            }
+        }
+    }
+    out += " (";
+    out += severity_name(event.severity);
+    out += ")";
+    return out;
+}
+
+
+EventQueue::EventQueue(size_t capacity, int numa_node)
+    : capacity_(round_up_pow2(capacity))
+    , storage_(capacity_ * sizeof(DeviceEvent), numa_node)
+    , ring_(reinterpret_cast<DeviceEvent*>(storage_.data()))
+{
+    if (capacity == 0) {
+        throw std::invalid_argument("EventQueue capacity must be positive");
+    }
+}
+
+bool EventQueue::push(const DeviceEvent& event) {
+    const uint64_t head = head_.load(std::memory_order_relaxed);
+    if (head - tail_cache_ == capacity_) {
+        tail_cache_ = tail_.load(std::memory_order_acquire);
+        if (head - tail_cache_ == capacity_) {
+            dropped_.store(dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+    }
+    ring_[head & (capacity_ - 1)] = event;
+    head_.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+size_t EventQueue::pop(DeviceEvent* out, size_t max) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    size_t taken = 0;
+    for (uint64_t i = tail; i != head && taken < max; ++i) {
+        out[taken++] = ring_[i & (capacity_ - 1)];
+    }
+    tail_.store(tail + taken, std::memory_order_release);
+    return taken;
+}
+
+size_t EventQueue::size() const {
+    const uint64_t tail = tail_.load(std::memory_order_acquire);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    return head > tail ? static_cast<size_t>(head - tail) : 0;
+}
+
+
+ErrorMonitor::ErrorMonitor(const ErrorCatalogue& catalogue, EventQueue& events)
+    : catalogue_(catalogue)
+    , queue_(events)
+{
+}
+
+void ErrorMonitor::setDeviceType(uint8_t slave_id, DeviceType type) {
+    if (type >= catalogue_.device_type_count()) {
+        throw std::out_of_range("ErrorMonitor: device type not in the catalogue");
+    }
+    device_type_[slave_id] = type;
+}
+
+size_t ErrorMonitor::scan(const SlaveColumns& columns, size_t count, const uint8_t* slave_id_of_slot,
+                          uint64_t cycle) {
+    const size_t found =
+        emit(DeviceEvent::Kind::ErrorCode, columns.error_code, error_code_.data(), columns.data_valid, count,
+             slave_id_of_slot, cycle) +
+        emit(DeviceEvent::Kind::SystemStatus, columns.system_status, system_status_.data(), columns.data_valid,
+             count, slave_id_of_slot, cycle);
+    if (found != 0) {
+        events_.store(events_.load(std::memory_order_relaxed) + found, std::memory_order_relaxed);
+    }
+    return found;
+}
+
+size_t ErrorMonitor::emit(DeviceEvent::Kind kind, const uint16_t* current, uint16_t* previous,
+                          const uint8_t* data_valid, size_t count, const uint8_t* slave_id_of_slot, uint64_t cycle) {
+    const size_t changed = find_changed_u16(current, previous, count, changed_.data());
+    size_t emitted = 0;
+    for (size_t i = 0; i < changed; ++i) {
+        const size_t slot = changed_[i];
+        if (data_valid[slot] == 0) {
+            continue; //not this cycle's value: compared again once the slave is valid
+        }
+        ++emitted;
+        DeviceEvent event;
+        event.cycle = cycle;
+        event.code = current[slot];
+        event.previous = previous[slot];
+        event.slave_id = slave_id_of_slot[slot];
+        event.kind = kind;
+        event.device_type = device_type_[event.slave_id];
+        event.severity = kind == DeviceEvent::Kind::ErrorCode
+            ? catalogue_.code_severity(event.device_type, event.code)
+            : catalogue_.status_severity(event.device_type, static_cast<uint16_t>(event.code & ~event.previous));
+        queue_.push(event);
+        previous[slot] = event.code;
+    }
+    return emitted;
+}
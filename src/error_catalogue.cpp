@@ -0,0 +1,190 @@
+#include "error_catalogue.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+bool parse_severity(const std::string& name, Severity& out) {
+    static const std::pair<const char*, Severity> kNames[] = {
+        {"info", Severity::Info}, {"warning", Severity::Warning},
+        {"error", Severity::Error}, {"fatal", Severity::Fatal}};
+    for (const auto& entry : kNames) {
+        if (name == entry.first) {
+            out = entry.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::string trimmed(const std::string& text) {
+    const size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) {
+        return {};
+    }
+    return text.substr(first, text.find_last_not_of(" \t\r") - first + 1);
+}
+
+} // namespace
+
+
+const char* severity_name(Severity severity) {
+    switch (severity) {
+    case Severity::Info: return "info";
+    case Severity::Warning: return "warning";
+    case Severity::Error: return "error";
+    case Severity::Fatal: return "fatal";
+    }
+    return "?";
+}
+
+
+ErrorCatalogue::ErrorCatalogue() {
+    add_device_type("default");
+}
+
+DeviceType ErrorCatalogue::add_device_type(const std::string& name) {
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        if (devices_[i].name == name) {
+            return static_cast<DeviceType>(i);
+        }
+    }
+    if (devices_.size() > UINT8_MAX) {
+        throw std::length_error("ErrorCatalogue: too many device types");
+    }
+    devices_.emplace_back();
+    devices_.back().name = name;
+    return static_cast<DeviceType>(devices_.size() - 1);
+}
+
+DeviceType ErrorCatalogue::device_type(const std::string& name) const {
+    for (size_t i = 0; i < devices_.size(); ++i) {
+        if (devices_[i].name == name) {
+            return static_cast<DeviceType>(i);
+        }
+    }
+    throw std::out_of_range("ErrorCatalogue: unknown device type " + name);
+}
+
+const std::string& ErrorCatalogue::device_type_name(DeviceType type) const {
+    return device(type).name;
+}
+
+const ErrorCatalogue::Device& ErrorCatalogue::device(DeviceType type) const {
+    if (type >= devices_.size()) {
+        throw std::out_of_range("ErrorCatalogue: unknown device type");
+    }
+    return devices_[type];
+}
+
+ErrorCatalogue::Device& ErrorCatalogue::device(DeviceType type) {
+    return const_cast<Device&>(static_cast<const ErrorCatalogue&>(*this).device(type));
+}
+
+
+void ErrorCatalogue::add_code(DeviceType type, uint16_t code, Severity severity, std::string text) {
+    Device& target = device(type);
+    auto at = std::lower_bound(target.codes.begin(), target.codes.end(), code);
+    const size_t index = static_cast<size_t>(at - target.codes.begin());
+    if (at != target.codes.end() && *at == code) {
+        target.infos[index] = ErrorCodeInfo{severity, std::move(text)};
+        return;
+    }
+    target.codes.insert(at, code);
+    target.infos.insert(target.infos.begin() + static_cast<std::ptrdiff_t>(index),
+                        ErrorCodeInfo{severity, std::move(text)});
+}
+
+void ErrorCatalogue::add_status_bit(DeviceType type, uint8_t bit, Severity severity, std::string text) {
+    Device& target = device(type);
+    if (bit >= 16) {
+        throw std::out_of_range("ErrorCatalogue: status bit must be below 16");
+    }
+    target.bits[bit] = ErrorCodeInfo{severity, std::move(text)};
+    target.bit_severity[bit] = severity;
+    target.listed_bits = static_cast<uint16_t>(target.listed_bits | (1u << bit));
+}
+
+
+const ErrorCodeInfo* ErrorCatalogue::code_info(DeviceType type, uint16_t code) const {
+    const Device& source = device(type);
+    auto at = std::lower_bound(source.codes.begin(), source.codes.end(), code);
+    if (at == source.codes.end() || *at != code) {
+        return nullptr;
+    }
+    return &source.infos[static_cast<size_t>(at - source.codes.begin())];
+}
+
+const ErrorCodeInfo* ErrorCatalogue::status_bit_info(DeviceType type, uint8_t bit) const {
+    const Device& source = device(type);
+    return bit < 16 && (source.listed_bits >> bit & 1u) ? &source.bits[bit] : nullptr;
+}
+
+Severity ErrorCatalogue::code_severity(DeviceType type, uint16_t code) const {
+    if (code == 0) {
+        return Severity::Info;
+    }
+    const ErrorCodeInfo* info = code_info(type, code);
+    return info != nullptr ? info->severity : Severity::Error;
+}
+
+Severity ErrorCatalogue::status_severity(DeviceType type, uint16_t bits) const {
+    const Device& source = device(type);
+    Severity highest = Severity::Info;
+    for (uint32_t listed = bits & source.listed_bits; listed != 0; listed &= listed - 1) {
+        highest = std::max(highest, source.bit_severity[static_cast<size_t>(__builtin_ctz(listed))]);
+    }
+    return highest;
+}
+
+
+void ErrorCatalogue::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("ErrorCatalogue: cannot read " + path);
+    }
+    DeviceType current = kDefaultDevice;
+    std::string line;
+    for (size_t number = 1; std::getline(in, line); ++number) {
+        const std::string text = trimmed(line);
+        if (text.empty() || text[0] == '#') {
+            continue;
+        }
+        const std::string where = path + ":" + std::to_string(number);
+        if (text.front() == '[') {
+            if (text.back() != ']' || text.size() < 3) {
+                throw std::invalid_argument("ErrorCatalogue: malformed device type at " + where);
+            }
+            current = add_device_type(trimmed(text.substr(1, text.size() - 2)));
+            continue;
+        }
+
+        std::istringstream fields(text);
+        std::string kind;
+        std::string severity_text;
+        unsigned long value = 0;
+        Severity severity = Severity::Error;
+        fields >> kind;
+        if (!(fields >> std::setbase(0) >> value) || !(fields >> severity_text) ||
+            !parse_severity(severity_text, severity)) {
+            throw std::invalid_argument("ErrorCatalogue: malformed entry at " + where);
+        }
+        std::string description;
+        std::getline(fields, description);
+        description = trimmed(description);
+
+        if (kind == "code" && value <= UINT16_MAX) {
+            add_code(current, static_cast<uint16_t>(value), severity, std::move(description));
+        } else if (kind == "status" && value < 16) {
+            add_status_bit(current, static_cast<uint8_t>(value), severity, std::move(description));
+        } else {
+            throw std::invalid_argument("ErrorCatalogue: malformed entry at " + where);
+        }
+    }
+}
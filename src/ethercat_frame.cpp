@@ -0,0 +1,153 @@
+/* EtherCAT frame decoding:
+- decode_ecat_frame(): Ethernet / 802.1Q / EtherCAT header, then the datagram chain,
+bounds-checked against both the frame and the EtherCAT header length
+- CaptureDecoder: process data of each slave out of the logical datagrams
+*/
+
+#include "ethercat_frame.hpp"
+
+#include <algorithm>
+#include <array>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+constexpr size_t kEthernetHeader = 14;
+constexpr size_t kVlanTag = 4;
+constexpr uint16_t kVlanEtherType = 0x8100;
+constexpr size_t kEcatHeader = 2;
+constexpr size_t kDatagramHeader = 10;
+constexpr size_t kWorkingCounter = 2;
+constexpr uint8_t kEcatTypeDatagrams = 1;
+
+uint16_t load_be16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+bool carries_inputs(EcatCommand command) {
+    return command == EcatCommand::LRD || command == EcatCommand::LRW;
+}
+
+} // namespace
+
+
+FrameStatus decode_ecat_frame(const uint8_t* frame, size_t size, std::vector<EcatDatagram>& datagrams) {
+    datagrams.clear();
+    if (size < kEthernetHeader) {
+        return FrameStatus::Truncated;
+    }
+
+    size_t offset = 12;
+    uint16_t ether_type = load_be16(frame + offset);
+    if (ether_type == kVlanEtherType) {
+        offset += kVlanTag;
+        if (size < offset + 2) {
+            return FrameStatus::Truncated;
+        }
+        ether_type = load_be16(frame + offset);
+    }
+    if (ether_type != kEthercatEtherType) {
+        return FrameStatus::NotEthercat;
+    }
+    offset += 2;
+
+    if (size < offset + kEcatHeader) {
+        return FrameStatus::Truncated;
+    }
+    const uint16_t header = load_le<uint16_t>(frame + offset);
+    const size_t length = header & 0x07FF;
+    const uint8_t type = static_cast<uint8_t>(header >> 12);
+    offset += kEcatHeader;
+    if (type != kEcatTypeDatagrams) {
+        return FrameStatus::NotEthercat;
+    }
+    if (size < offset + length) {
+        return FrameStatus::Truncated;
+    }
+
+    //datagrams until the one without the "more follows" bit; all inside `length`
+    const size_t end = offset + length;
+    for (;;) {
+        if (offset + kDatagramHeader > end) {
+            return FrameStatus::Malformed;
+        }
+        const uint8_t* p = frame + offset;
+        const uint16_t length_flags = load_le<uint16_t>(p + 6);
+        EcatDatagram datagram;
+        datagram.command = static_cast<EcatCommand>(p[0]);
+        datagram.index = p[1];
+        datagram.address = load_le<uint32_t>(p + 2);
+        datagram.length = length_flags & 0x07FF;
+        datagram.circulating = (length_flags & 0x4000) != 0;
+        datagram.data = p + kDatagramHeader;
+
+        offset += kDatagramHeader + datagram.length;
+        if (offset + kWorkingCounter > end) {
+            return FrameStatus::Malformed;
+        }
+        datagram.working_counter = load_le<uint16_t>(frame + offset);
+        offset += kWorkingCounter;
+        datagrams.push_back(datagram);
+
+        if ((length_flags & 0x8000) == 0) {
+            return FrameStatus::Ok;
+        }
+    }
+}
+
+
+CaptureDecoder::CaptureDecoder(const std::vector<uint8_t>& slaves_order, uint32_t logical_base)
+    : CaptureDecoder([&] {
+        std::vector<ProcessDataMapping> mapping;
+        for (size_t i = 0; i < slaves_order.size(); ++i) {
+            mapping.push_back({slaves_order[i], logical_base + static_cast<uint32_t>(i * PdoInputLayout::size)});
+        }
+        return mapping;
+    }())
+{
+}
+
+CaptureDecoder::CaptureDecoder(std::vector<ProcessDataMapping> mapping)
+    : mapping_(std::move(mapping))
+{
+    std::array<bool, kMaxSlaves> seen{};
+    for (const ProcessDataMapping& entry : mapping_) {
+        if (seen[entry.slave_id]) {
+            throw std::invalid_argument("CaptureDecoder: slave mapped twice");
+        }
+        seen[entry.slave_id] = true;
+    }
+    std::sort(mapping_.begin(), mapping_.end(), [](const ProcessDataMapping& a, const ProcessDataMapping& b) {
+        return a.logical_address < b.logical_address;
+    });
+    datagrams_.reserve(16);
+}
+
+
+FrameStatus CaptureDecoder::decode(const uint8_t* frame, size_t size, std::vector<SlaveFrame>& slaves) {
+    slaves.clear();
+    const FrameStatus status = decode_ecat_frame(frame, size, datagrams_);
+    if (status != FrameStatus::Ok) {
+        return status;
+    }
+
+    for (const EcatDatagram& datagram : datagrams_) {
+        if (!carries_inputs(datagram.command) || datagram.working_counter == 0) {
+            continue;
+        }
+        //64-bit: a datagram may end past the top of the 32-bit logical space
+        const uint64_t first = datagram.address;
+        const uint64_t last = first + datagram.length;
+        auto it = std::lower_bound(mapping_.begin(), mapping_.end(), first,
+                                   [](const ProcessDataMapping& entry, uint64_t address) {
+                                       return entry.logical_address < address;
+                                   });
+        for (; it != mapping_.end() && it->logical_address + uint64_t{PdoInputLayout::size} <= last; ++it) {
+            slaves.push_back(SlaveFrame{it->slave_id, datagram.data + (it->logical_address - first),
+                                        PdoInputLayout::size});
+        }
+    }
+    return FrameStatus::Ok;
+}
@@ -0,0 +1,151 @@
+/* EthercatLine class:
+- one cycle thread per line, optionally pinned to one core
+- absolute deadlines (sleep_until on steady_clock), so a late cycle does not
+shift every following one
+- records cycle time and wake-up latency per line; lines share nothing
+- registry, snapshots and process images live on the NUMA node of the cycle core,
+on the page size LineConfig::pages asks for (the report says what was obtained)
+*/
+
+#include "ethercat_line.hpp"
+#include "thread_affinity.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return to > from ? std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() : 0;
+}
+
+} // namespace
+
+
+EthercatLine::EthercatLine(LineConfig config, ImageSource source, ImageSink sink,
+                           WorkingCounterSource working_counters)
+    : config_(std::move(config))
+    , source_(std::move(source))
+    , sink_(std::move(sink))
+    , working_counter_source_(std::move(working_counters))
+    , working_counters_(config_.wkc_groups.size())
+    , numa_node_(cpu_numa_node(config_.cpu_core))
+    , hardware_(config_.slaves_order, numa_node_, config_.pages)
+    , input_image_(hardware_.input_image_size(), numa_node_, config_.pages)
+    , output_image_(hardware_.output_image_size(), numa_node_, config_.pages)
+{
+    if (!source_) {
+        throw std::invalid_argument("EthercatLine needs an image source");
+    }
+    if (config_.period <= std::chrono::nanoseconds::zero()) {
+        throw std::invalid_argument("EthercatLine period must be positive");
+    }
+    hardware_.setPriorities(config_.priorities);
+    hardware_.setDecodeBudget(config_.decode_budget);
+    hardware_.setWkcGroups(config_.wkc_groups);
+    hardware_.star_manager().setErrorMonitor(config_.error_monitor);
+    hardware_.star_manager().setFloatPolicies(config_.float_policies);
+    if (config_.logger != nullptr) {
+        log_ = &config_.logger->open_channel(config_.name, 1024, numa_node_);
+        overrun_format_ = config_.logger->register_format(LogLevel::Warning, "cycle {} overran its period by {} ns");
+        wkc_format_ = config_.logger->register_format(LogLevel::Warning,
+                                                      "cycle {}: working counter of group {} is {}, expected {}");
+    }
+}
+
+EthercatLine::~EthercatLine() {
+    stop();
+}
+
+
+void EthercatLine::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&EthercatLine::cycle_loop, this);
+}
+
+void EthercatLine::stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+
+void EthercatLine::run_cycle() {
+    source_(input_image_.data(), input_image_.size());
+    if (working_counter_source_) {
+        working_counter_source_(working_counters_.data(), working_counters_.size());
+        hardware_.read_kernel(input_image_.data(), input_image_.size(),
+                              working_counters_.data(), working_counters_.size()); //commits the cycle
+        if (log_ != nullptr) {
+            for (size_t g = 0; g < working_counters_.size(); ++g) {
+                if (working_counters_[g] != config_.wkc_groups[g].expected) {
+                    log_->log(wkc_format_, hardware_.star_manager().committedCycle(), g, working_counters_[g],
+                              config_.wkc_groups[g].expected);
+                }
+            }
+        }
+    } else {
+        hardware_.read_kernel(input_image_.data(), input_image_.size()); //commits the cycle
+    }
+    hardware_.write_kernel(output_image_.data(), output_image_.size());
+    if (sink_) {
+        sink_(output_image_.data(), output_image_.size());
+    }
+    cycles_.store(cycles_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+
+void EthercatLine::cycle_loop() {
+    if (config_.cpu_core >= 0 && pin_current_thread(config_.cpu_core)) {
+        pinned_core_.store(config_.cpu_core, std::memory_order_relaxed);
+    }
+    if (config_.report_placement) {
+        std::clog << placement_report() << std::endl;
+    }
+
+    auto deadline = std::chrono::steady_clock::now();
+    while (running_.load(std::memory_order_relaxed)) {
+        deadline += config_.period;
+        std::this_thread::sleep_until(deadline);
+
+        auto woke = std::chrono::steady_clock::now();
+        wakeup_latency_.record(elapsed_ns(deadline, woke));
+
+        run_cycle();
+
+        auto done = std::chrono::steady_clock::now();
+        cycle_time_.record(elapsed_ns(woke, done));
+
+        //missed the next deadline: count it and restart the grid from now instead of bursting to catch up
+        if (done > deadline + config_.period) {
+            overruns_.store(overruns_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            if (log_ != nullptr) {
+                log_->log(overrun_format_, hardware_.star_manager().committedCycle(),
+                          elapsed_ns(deadline + config_.period, done));
+            }
+            deadline = done;
+        }
+    }
+}
+
+
+std::string EthercatLine::placement_report() const {
+    const StarManager& manager = hardware_.star_manager();
+    std::ostringstream report;
+    report << "line '" << config_.name << "': core " << config_.cpu_core
+           << (pinned_core() >= 0 ? " (pinned)" : " (not pinned)")
+           << ", node " << numa_node_ << " of " << host_numa_nodes() << " [" << numa_backend_name() << "]"
+           << "; input image node " << input_image_.node() << " " << page_kind_name(input_image_.page_kind())
+           << ", output image node " << output_image_.node() << " " << page_kind_name(output_image_.page_kind())
+           << ", registry node " << manager.registry_numa_node()
+           << " " << page_kind_name(manager.registry_page_kind())
+           << ", snapshots node " << manager.snapshot_numa_node()
+           << " " << page_kind_name(manager.snapshot_page_kind());
+    return report.str();
+}
@@ -0,0 +1,47 @@
+#include "global_view.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+GlobalView::GlobalView(std::vector<const StarManager*> lines, int numa_node)
+    : lines_(std::move(lines))
+{
+    snapshots_.reserve(lines_.size());
+    for (const StarManager* manager : lines_) {
+        if (manager == nullptr) {
+            throw std::invalid_argument("GlobalView line is null");
+        }
+        snapshots_.emplace_back(numa_node);
+    }
+}
+
+void GlobalView::refresh() {
+    for (size_t i = 0; i < lines_.size(); ++i) {
+        lines_[i]->readSnapshot(snapshots_[i]);
+    }
+}
+
+SlaveRealTimeData GlobalView::getSlaveData(size_t line, uint8_t slave_id) const {
+    return snapshots_.at(line).getSlaveData(slave_id);
+}
+
+size_t GlobalView::slave_count() const {
+    size_t total = 0;
+    for (const StarSnapshot& snapshot : snapshots_) {
+        total += snapshot.slave_count;
+    }
+    return total;
+}
+
+uint64_t GlobalView::oldest_commit_ns() const {
+    if (snapshots_.empty()) {
+        return 0;
+    }
+    uint64_t oldest = snapshots_.front().commit_time_ns;
+    for (const StarSnapshot& snapshot : snapshots_) {
+        oldest = std::min(oldest, snapshot.commit_time_ns);
+    }
+    return oldest;
+}
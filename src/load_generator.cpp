@@ -0,0 +1,48 @@
+#include "load_generator.hpp"
+
+#include <stdexcept>
+
+
+LoadGenerator::LoadGenerator(size_t slave_count)
+    : slaves_(slave_count)
+{
+    for (size_t i = 0; i < slaves_.size(); ++i) {
+        SlaveRealTimeData& s = slaves_[i];
+        s.status_word = 0x0237;     //operation enabled
+        s.actual_position = static_cast<int32_t>(i * 100000);
+        s.actual_velocity = (i % 4 == 3) ? 0 : static_cast<int32_t>(1000 + 10 * i);
+        s.actual_torque = 0;
+        s.mode_display = 0x08;      //cyclic synchronous position
+        s.error_code = 0x0000;
+        s.system_status = 0x0001;
+        s.motor_temperature = 35.0f + static_cast<float>(i % 10);
+        s.slave_position = static_cast<uint16_t>(i);
+    }
+}
+
+
+void LoadGenerator::next_cycle(uint8_t* image, size_t size) {
+    if (size < image_size()) {
+        throw std::out_of_range("process image smaller than the simulated line");
+    }
+    ++cycle_;
+
+    for (size_t i = 0; i < slaves_.size(); ++i) {
+        SlaveRealTimeData& s = slaves_[i];
+        if (s.actual_velocity != 0) {
+            s.actual_position += s.actual_velocity;
+            //torque follows a triangle wave, temperature creeps up and resets
+            int32_t phase = static_cast<int32_t>((cycle_ + i) % 200);
+            s.actual_torque = static_cast<int16_t>(phase < 100 ? phase * 10 : (200 - phase) * 10);
+            s.motor_temperature += 0.001f;
+            if (s.motor_temperature > 80.0f) {
+                s.motor_temperature = 35.0f;
+            }
+        }
+        encoder_.encode(s, image + i * PdoInputLayout::size, PdoInputLayout::size);
+    }
+}
+
+void LoadGenerator::next_cycle(std::vector<uint8_t>& image) {
+    next_cycle(image.data(), image.size());
+}
@@ -0,0 +1,327 @@
+#include "numa_placement.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include <utility>
+
+#if defined(STAR_HAVE_LIBNUMA)
+#include <numa.h>
+#include <numaif.h>
+#elif defined(__linux__)
+#include <dirent.h>
+#include <linux/mempolicy.h>
+#endif
+#if defined(__linux__)
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+
+namespace {
+
+constexpr size_t kRegionAlignment = 64;
+
+#if defined(__linux__)
+size_t round_up(size_t bytes, size_t page) {
+    return (bytes + page - 1) / page * page;
+}
+
+size_t page_round_up(size_t bytes) {
+    return round_up(bytes, static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+}
+
+//preferred, not bound: a full node falls back to another one instead of failing the cycle
+void prefer_node(void* p, size_t bytes, int numa_node) {
+    if (numa_node < 0 || numa_node >= 64) {
+        return;
+    }
+    unsigned long mask = 1UL << numa_node;
+    syscall(SYS_mbind, p, bytes, static_cast<unsigned long>(MPOL_PREFERRED), &mask,
+            static_cast<unsigned long>(numa_node + 2), 0UL);
+}
+
+//2 MB aligned anonymous mapping of `bytes` (a multiple of kHugePageSize): over-map, trim both ends
+void* map_huge_aligned(size_t bytes) {
+    void* p = mmap(nullptr, bytes + kHugePageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+        return nullptr;
+    }
+    const uintptr_t start = reinterpret_cast<uintptr_t>(p);
+    const uintptr_t aligned = (start + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+    if (aligned > start) {
+        munmap(p, aligned - start);
+    }
+    const uintptr_t end = start + bytes + kHugePageSize;
+    if (end > aligned + bytes) {
+        munmap(reinterpret_cast<void*>(aligned + bytes), end - (aligned + bytes));
+    }
+    return reinterpret_cast<void*>(aligned);
+}
+
+//AnonHugePages of the mapping holding `address`, from /proc/self/smaps (0 if not found)
+size_t anon_huge_kb(const void* address) {
+    std::FILE* smaps = std::fopen("/proc/self/smaps", "r");
+    if (smaps == nullptr) {
+        return 0;
+    }
+    const uintptr_t target = reinterpret_cast<uintptr_t>(address);
+    char line[256];
+    bool inside = false;
+    size_t kb = 0;
+    while (std::fgets(line, sizeof(line), smaps) != nullptr) {
+        unsigned long long start = 0;
+        unsigned long long end = 0;
+        if (std::sscanf(line, "%llx-%llx ", &start, &end) == 2) {
+            if (inside) {
+                break; //past our mapping without an AnonHugePages line
+            }
+            inside = target >= start && target < end;
+            continue;
+        }
+        size_t value = 0;
+        if (inside && std::sscanf(line, "AnonHugePages: %zu kB", &value) == 1) {
+            kb = value;
+            break;
+        }
+    }
+    std::fclose(smaps);
+    return kb;
+}
+#endif
+
+#if !defined(STAR_HAVE_LIBNUMA) && defined(__linux__)
+//highest N of the nodeN entries in `directory`, -1 if there are none
+int scan_node_entries(const char* directory, int* count) {
+    DIR* dir = opendir(directory);
+    if (dir == nullptr) {
+        return -1;
+    }
+    int last = -1;
+    int seen = 0;
+    while (const dirent* entry = readdir(dir)) {
+        int node = 0;
+        if (std::sscanf(entry->d_name, "node%d", &node) == 1) {
+            last = node > last ? node : last;
+            ++seen;
+        }
+    }
+    closedir(dir);
+    if (count != nullptr) {
+        *count = seen;
+    }
+    return last;
+}
+#endif
+
+} // namespace
+
+
+#if defined(STAR_HAVE_LIBNUMA)
+
+const char* numa_backend_name() {
+    return numa_available() < 0 ? "none" : "libnuma";
+}
+
+int host_numa_nodes() {
+    return numa_available() < 0 ? 1 : numa_num_configured_nodes();
+}
+
+int cpu_numa_node(int cpu) {
+    if (cpu < 0 || numa_available() < 0) {
+        return -1;
+    }
+    return numa_node_of_cpu(cpu);
+}
+
+#elif defined(__linux__)
+
+const char* numa_backend_name() {
+    return "mbind";
+}
+
+int host_numa_nodes() {
+    int count = 0;
+    scan_node_entries("/sys/devices/system/node", &count);
+    return count > 0 ? count : 1;
+}
+
+int cpu_numa_node(int cpu) {
+    if (cpu < 0) {
+        return -1;
+    }
+    char path[64];
+    std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d", cpu);
+    return scan_node_entries(path, nullptr);
+}
+
+#else
+
+const char* numa_backend_name() {
+    return "none";
+}
+
+int host_numa_nodes() {
+    return 1;
+}
+
+int cpu_numa_node(int) {
+    return -1;
+}
+
+#endif
+
+
+int memory_numa_node(const void* address) {
+#if defined(__linux__)
+    if (address == nullptr) {
+        return -1;
+    }
+    int node = -1;
+    //MPOL_F_NODE | MPOL_F_ADDR: node of the page at `address`
+    long rc = syscall(SYS_get_mempolicy, &node, nullptr, 0UL, const_cast<void*>(address),
+                      static_cast<unsigned long>(MPOL_F_NODE | MPOL_F_ADDR));
+    return rc == 0 ? node : -1;
+#else
+    (void)address;
+    return -1;
+#endif
+}
+
+
+const char* page_kind_name(PageKind kind) {
+    switch (kind) {
+    case PageKind::Normal:
+        return "4k";
+    case PageKind::TransparentHuge:
+        return "thp";
+    case PageKind::Huge:
+        return "2M";
+    default:
+        return "none";
+    }
+}
+
+
+MemoryRegion::MemoryRegion(size_t bytes, int numa_node, PagePolicy pages)
+    : size_(bytes)
+    , requested_node_(numa_node)
+{
+    if (bytes == 0) {
+        return;
+    }
+
+#if defined(__linux__)
+    //hugepages: own mapping, NUMA through mbind whichever backend is built
+    bool advised = false;
+    if (pages != PagePolicy::Normal) {
+        const size_t huge_bytes = round_up(bytes, kHugePageSize);
+        if (pages == PagePolicy::Huge) {
+            void* p = mmap(nullptr, huge_bytes, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED) {
+                data_ = static_cast<uint8_t*>(p);
+                page_kind_ = PageKind::Huge;
+            }
+        }
+        if (data_ == nullptr) {
+            data_ = static_cast<uint8_t*>(map_huge_aligned(huge_bytes));
+            advised = data_ != nullptr && madvise(data_, huge_bytes, MADV_HUGEPAGE) == 0;
+        }
+        if (data_ != nullptr) {
+            mapped_ = huge_bytes;
+            backing_ = Backing::Mmap;
+            prefer_node(data_, mapped_, numa_node);
+        }
+    }
+#else
+    (void)pages;
+#endif
+
+#if defined(STAR_HAVE_LIBNUMA)
+    if (data_ == nullptr && numa_node >= 0 && numa_available() >= 0 && numa_node <= numa_max_node()) {
+        mapped_ = page_round_up(bytes);
+        data_ = static_cast<uint8_t*>(numa_alloc_onnode(mapped_, numa_node));
+        if (data_ != nullptr) {
+            backing_ = Backing::LibNuma;
+        }
+    }
+#elif defined(__linux__)
+    if (data_ == nullptr && numa_node >= 0 && numa_node < 64) {
+        mapped_ = page_round_up(bytes);
+        void* p = mmap(nullptr, mapped_, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p != MAP_FAILED) {
+            data_ = static_cast<uint8_t*>(p);
+            backing_ = Backing::Mmap;
+            prefer_node(p, mapped_, numa_node);
+        }
+    }
+#endif
+
+    if (data_ == nullptr) {
+        data_ = static_cast<uint8_t*>(::operator new(bytes, std::align_val_t{kRegionAlignment}));
+        backing_ = Backing::Heap;
+        mapped_ = 0;
+    }
+    std::memset(data_, 0, bytes); //first touch: pages are placed now, under the policy above
+
+    if (page_kind_ == PageKind::None) {
+        page_kind_ = PageKind::Normal;
+#if defined(__linux__)
+        if (advised && anon_huge_kb(data_) > 0) {
+            page_kind_ = PageKind::TransparentHuge;
+        }
+#endif
+    }
+}
+
+MemoryRegion::~MemoryRegion() {
+    release();
+}
+
+MemoryRegion::MemoryRegion(MemoryRegion&& other) noexcept
+    : data_(std::exchange(other.data_, nullptr))
+    , size_(std::exchange(other.size_, 0))
+    , mapped_(std::exchange(other.mapped_, 0))
+    , requested_node_(other.requested_node_)
+    , backing_(std::exchange(other.backing_, Backing::None))
+    , page_kind_(std::exchange(other.page_kind_, PageKind::None))
+{
+}
+
+MemoryRegion& MemoryRegion::operator=(MemoryRegion&& other) noexcept {
+    if (this != &other) {
+        release();
+        data_ = std::exchange(other.data_, nullptr);
+        size_ = std::exchange(other.size_, 0);
+        mapped_ = std::exchange(other.mapped_, 0);
+        requested_node_ = other.requested_node_;
+        backing_ = std::exchange(other.backing_, Backing::None);
+        page_kind_ = std::exchange(other.page_kind_, PageKind::None);
+    }
+    return *this;
+}
+
+void MemoryRegion::release() {
+    switch (backing_) {
+    case Backing::Heap:
+        ::operator delete(data_, std::align_val_t{kRegionAlignment});
+        break;
+#if defined(STAR_HAVE_LIBNUMA)
+    case Backing::LibNuma:
+        numa_free(data_, mapped_);
+        break;
+#endif
+#if defined(__linux__)
+    case Backing::Mmap:
+        munmap(data_, mapped_);
+        break;
+#endif
+    default:
+        break;
+    }
+    data_ = nullptr;
+    backing_ = Backing::None;
+    page_kind_ = PageKind::None;
+}
@@ -0,0 +1,211 @@
+/* PlantSimulator class:
+- every column (state, per-cycle gains, per-axis constants) is carved out of one
+MemoryRegion, 64-byte aligned, on the node of the thread that steps it
+- apply_outputs() is the scalar part: it decodes the commands and folds the mode and
+enable state into the gain columns, so step() is one branch-free kernel over all axes
+*/
+
+#include "plant_simulator.hpp"
+#include "data_structuring.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+
+namespace {
+
+constexpr size_t kColumnAlignment = 64;
+constexpr size_t kPlantColumnCount = 18; //double* members of PlantColumns
+
+constexpr uint8_t kModeCsp = 8;
+constexpr uint8_t kModeCsv = 9;
+constexpr uint8_t kModeCst = 10;
+
+constexpr uint16_t kStatusEnabled = 0x0237;  //operation enabled
+constexpr uint16_t kStatusDisabled = 0x0250; //switch on disabled
+constexpr uint16_t kStatusFault = 0x0218;
+constexpr uint16_t kControlEnable = 0x000F;
+constexpr uint16_t kControlFaultReset = 0x0080;
+
+size_t column_bytes(size_t axis_count) {
+    return (sizeof(double) * axis_count + kColumnAlignment - 1) & ~(kColumnAlignment - 1);
+}
+
+//int32 on the wire: the position counter wraps, velocity and torque saturate
+int32_t wrap_i32(double value) {
+    const double bounded = std::min(std::max(value, -9.0e18), 9.0e18);
+    return static_cast<int32_t>(static_cast<uint32_t>(static_cast<uint64_t>(std::llround(bounded))));
+}
+
+template <typename T>
+T saturate(double value) {
+    const double low = static_cast<double>(std::numeric_limits<T>::min());
+    const double high = static_cast<double>(std::numeric_limits<T>::max());
+    return static_cast<T>(std::lround(std::min(std::max(value, low), high)));
+}
+
+} // namespace
+
+
+PlantSimulator::PlantSimulator(size_t axis_count, std::chrono::nanoseconds period, const AxisParameters& parameters,
+                               size_t substeps, int numa_node)
+    : period_(period)
+    , substeps_(substeps)
+    , dt_(std::chrono::duration<double>(period).count() / static_cast<double>(substeps == 0 ? 1 : substeps))
+    , storage_(std::max<size_t>(column_bytes(axis_count) * kPlantColumnCount, kColumnAlignment), numa_node)
+    , parameters_(axis_count, parameters)
+    , drives_(axis_count)
+{
+    if (period.count() <= 0) {
+        throw std::invalid_argument("PlantSimulator period must be positive");
+    }
+    if (substeps == 0) {
+        throw std::invalid_argument("PlantSimulator needs at least one substep");
+    }
+
+    uint8_t* cursor = storage_.data();
+    std::memset(cursor, 0, storage_.size());
+    auto next = [&cursor, axis_count]() {
+        double* column = reinterpret_cast<double*>(cursor);
+        cursor += column_bytes(axis_count);
+        return column;
+    };
+    columns_.position = next();
+    columns_.velocity = next();
+    columns_.torque = next();
+    columns_.integral = next();
+    columns_.temperature = next();
+    columns_.target_position = next();
+    columns_.velocity_reference = next();
+    columns_.torque_offset = next();
+    columns_.position_gain = next();
+    columns_.velocity_gain = next();
+    columns_.integral_gain = next();
+    columns_.torque_limit = next();
+    columns_.torque_alpha = next();
+    columns_.accel_per_torque = next();
+    columns_.damping = next();
+    columns_.heating = next();
+    columns_.thermal_beta = next();
+    columns_.ambient = next();
+
+    for (size_t i = 0; i < axis_count; ++i) {
+        setParameters(i, parameters);
+        columns_.temperature[i] = parameters.ambient_temperature;
+    }
+}
+
+size_t PlantSimulator::checked(size_t axis) const {
+    if (axis >= drives_.size()) {
+        throw std::out_of_range("PlantSimulator: axis out of range");
+    }
+    return axis;
+}
+
+void PlantSimulator::setParameters(size_t axis, const AxisParameters& p) {
+    checked(axis);
+    if (!(p.torque_limit >= 0.0 && p.torque_limit <= 32767.0) || !(p.torque_time_constant >= 0.0) ||
+        !(p.thermal_time_constant >= 0.0) || !(p.damping >= 0.0)) {
+        throw std::invalid_argument("PlantSimulator: torque limit, time constants and damping out of range");
+    }
+    parameters_[axis] = p;
+    columns_.torque_limit[axis] = p.torque_limit;
+    //time constants shorter than a substep: the lag is gone, not unstable
+    columns_.torque_alpha[axis] = p.torque_time_constant > dt_ ? dt_ / p.torque_time_constant : 1.0;
+    columns_.thermal_beta[axis] = p.thermal_time_constant > dt_ ? dt_ / p.thermal_time_constant : 1.0;
+    columns_.accel_per_torque[axis] = p.accel_per_torque;
+    columns_.damping[axis] = p.damping;
+    columns_.heating[axis] = p.heating;
+    columns_.ambient[axis] = p.ambient_temperature;
+    apply_command(axis, drives_[axis].command); //gains of the current mode
+}
+
+
+void PlantSimulator::apply_outputs(const uint8_t* image, size_t size) {
+    if (size < output_image_size()) {
+        throw std::out_of_range("PlantSimulator: output image smaller than the simulated line");
+    }
+    ReadState decoder;
+    for (size_t i = 0; i < drives_.size(); ++i) {
+        apply_command(i, decoder.parse_command(image + i * PdoOutputLayout::size, PdoOutputLayout::size));
+    }
+}
+
+void PlantSimulator::apply_command(size_t axis, const SlaveCommandData& command) {
+    Drive& drive = drives_[axis];
+    const AxisParameters& p = parameters_[axis];
+
+    //the fault latches until it has cooled down and the master resets it
+    if (columns_.temperature[axis] > p.trip_temperature) {
+        drive.faulted = true;
+    } else if (drive.faulted && (command.control_word & kControlFaultReset) != 0) {
+        drive.faulted = false;
+    }
+    const bool enabled = !drive.faulted && (command.control_word & kControlEnable) == kControlEnable;
+    if (enabled != drive.enabled || command.mode_of_operation != drive.command.mode_of_operation) {
+        columns_.integral[axis] = 0.0; //no windup carried across a mode change or a re-enable
+    }
+    drive.command = command;
+    drive.enabled = enabled;
+
+    const uint8_t mode = command.mode_of_operation;
+    const bool csp = enabled && mode == kModeCsp;
+    const bool csv = enabled && mode == kModeCsv;
+    const bool cst = enabled && mode == kModeCst;
+    columns_.target_position[axis] = static_cast<double>(command.target_position);
+    columns_.velocity_reference[axis] = csv ? static_cast<double>(command.target_velocity) : 0.0;
+    columns_.torque_offset[axis] = cst ? static_cast<double>(command.target_torque) : 0.0;
+    columns_.position_gain[axis] = csp ? p.position_gain : 0.0;
+    columns_.velocity_gain[axis] = csp || csv ? p.velocity_gain : 0.0;
+    columns_.integral_gain[axis] = csp || csv ? p.integral_gain * dt_ : 0.0;
+}
+
+void PlantSimulator::step() {
+    plant_step(columns_, drives_.size(), dt_, substeps_);
+    ++steps_;
+}
+
+void PlantSimulator::write_inputs(uint8_t* image, size_t size) const {
+    if (size < input_image_size()) {
+        throw std::out_of_range("PlantSimulator: input image smaller than the simulated line");
+    }
+    WriteState encoder;
+    for (size_t i = 0; i < drives_.size(); ++i) {
+        encoder.encode(axis(i), image + i * PdoInputLayout::size, PdoInputLayout::size);
+    }
+}
+
+void PlantSimulator::cycle(const uint8_t* outputs, size_t output_size, uint8_t* inputs, size_t input_size) {
+    apply_outputs(outputs, output_size);
+    step();
+    write_inputs(inputs, input_size);
+}
+
+
+SlaveRealTimeData PlantSimulator::axis(size_t axis) const {
+    const Drive& drive = drives_[checked(axis)];
+    const bool over_temperature = drive.faulted || columns_.temperature[axis] > parameters_[axis].trip_temperature;
+    SlaveRealTimeData data{};
+    data.status_word = over_temperature ? kStatusFault : drive.enabled ? kStatusEnabled : kStatusDisabled;
+    data.actual_position = wrap_i32(columns_.position[axis]);
+    data.actual_velocity = saturate<int32_t>(columns_.velocity[axis]);
+    data.actual_torque = saturate<int16_t>(columns_.torque[axis]);
+    data.mode_display = drive.command.mode_of_operation;
+    data.error_code = over_temperature ? kOverTemperatureError : 0;
+    data.system_status = 0x0001;
+    data.motor_temperature = static_cast<float>(columns_.temperature[axis]);
+    data.slave_position = static_cast<uint16_t>(axis);
+    data.data_valid = true;
+    return data;
+}
+
+size_t PlantSimulator::input_image_size() const {
+    return drives_.size() * PdoInputLayout::size;
+}
+
+size_t PlantSimulator::output_image_size() const {
+    return drives_.size() * PdoOutputLayout::size;
+}
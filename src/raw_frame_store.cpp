@@ -0,0 +1,30 @@
+#include "raw_frame_store.hpp"
+
+#include <cstring>
+
+
+RawFrameStore::RawFrameStore(size_t capacity, int numa_node, PagePolicy pages)
+    : frames_(capacity * kFrameSize, numa_node, pages)
+{
+}
+
+void RawFrameStore::copy_from(const RawFrameStore& other, size_t count) {
+    std::memcpy(frames_.data(), other.frames_.data(), count * kFrameSize);
+    std::memcpy(scaled.data(), other.scaled.data(), count);
+}
+
+
+SlaveRealTimeData decode_stored_slave(const RawFrameStore& store, const SlaveColumns& columns, size_t slot) {
+    SlaveRealTimeData data{};
+    decode_layout<TxPdoLayout>(store.frame(slot), RawFrameStore::kFrameSize, data);
+    if (store.scaled[slot]) {
+        data.motor_temperature = columns.motor_temperature[slot];
+    }
+    data.timestamp = columns.timestamp[slot];
+    data.slave_position = columns.slave_position[slot];
+    data.data_valid = columns.data_valid[slot] != 0;
+    data.restored = columns.restored[slot] != 0;
+    data.invalid_fields = columns.invalid_fields[slot];
+    data.deferred = columns.deferred[slot] != 0;
+    return data;
+}
@@ -0,0 +1,102 @@
+#include "recorder.hpp"
+
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+
+static_assert(std::is_trivially_destructible<RecordedCycle>::value, "ring entries are never destroyed");
+
+Recorder::Recorder(size_t capacity, int numa_node, PagePolicy pages) {
+    if (capacity == 0) {
+        throw std::invalid_argument("Recorder capacity must be positive");
+    }
+    storage_ = MemoryRegion(capacity * sizeof(RecordedCycle), numa_node, pages);
+    ring_ = reinterpret_cast<RecordedCycle*>(storage_.data());
+    for (size_t i = 0; i < capacity; ++i) {
+        new (ring_ + i) RecordedCycle();
+    }
+    capacity_ = capacity;
+}
+
+void Recorder::record(const RecordedCycle& entry) {
+    ring_[static_cast<size_t>(written_ % capacity_)] = entry;
+    ++written_;
+}
+
+void Recorder::record(uint32_t line, const StarSnapshot& snapshot) {
+    record(RecordedCycle{line, snapshot.cycle, snapshot.commit_time_ns, snapshot.aggregates});
+}
+
+void Recorder::write_checkpoint(CheckpointWriter& writer) const {
+    writer.begin_section(CheckpointSection::Recorder);
+    writer.put(written_);
+    writer.put(static_cast<uint64_t>(size()));
+    for (size_t i = 0; i < size(); ++i) {
+        const RecordedCycle& entry = at(i);
+        writer.put(entry.line);
+        writer.put(entry.cycle);
+        writer.put(entry.commit_time_ns);
+        writer.put(static_cast<uint64_t>(entry.aggregates.slave_count));
+        writer.put(entry.aggregates.max_motor_temperature);
+        writer.put(static_cast<uint64_t>(entry.aggregates.faulted));
+        writer.put(static_cast<uint64_t>(entry.aggregates.invalid));
+        writer.put(static_cast<uint64_t>(entry.aggregates.restored));
+        writer.put(entry.aggregates.oldest_timestamp);
+        writer.put(entry.aggregates.supply_torque);
+    }
+    writer.end_section();
+}
+
+bool Recorder::restore_checkpoint(CheckpointReader& reader) {
+    Checkpoint checkpoint;
+    if (!load_checkpoint(reader, checkpoint)) {
+        return false;
+    }
+    apply_checkpoint(checkpoint);
+    return true;
+}
+
+bool Recorder::load_checkpoint(CheckpointReader& reader, Checkpoint& out) const {
+    if (!reader.open(CheckpointSection::Recorder)) {
+        return false;
+    }
+    Checkpoint checkpoint;
+    checkpoint.written = reader.get<uint64_t>();
+    const uint64_t count = reader.get<uint64_t>();
+    if (count > checkpoint.written) {
+        throw std::invalid_argument("checkpoint recorder holds more entries than were written");
+    }
+    checkpoint.entries.resize(static_cast<size_t>(count));
+    for (RecordedCycle& entry : checkpoint.entries) {
+        entry.line = reader.get<uint32_t>();
+        entry.cycle = reader.get<uint64_t>();
+        entry.commit_time_ns = reader.get<uint64_t>();
+        entry.aggregates.slave_count = static_cast<size_t>(reader.get<uint64_t>());
+        entry.aggregates.max_motor_temperature = reader.get<float>();
+        entry.aggregates.faulted = static_cast<size_t>(reader.get<uint64_t>());
+        entry.aggregates.invalid = static_cast<size_t>(reader.get<uint64_t>());
+        entry.aggregates.restored = static_cast<size_t>(reader.get<uint64_t>());
+        entry.aggregates.oldest_timestamp = reader.get<uint64_t>();
+        entry.aggregates.supply_torque = reader.get<std::array<int64_t, kMaxSupplyGroups>>();
+    }
+    out = std::move(checkpoint);
+    return true;
+}
+
+void Recorder::apply_checkpoint(const Checkpoint& checkpoint) {
+    //replayed in order: a smaller ring keeps the newest, written() continues where it was
+    written_ = checkpoint.written - checkpoint.entries.size();
+    for (const RecordedCycle& entry : checkpoint.entries) {
+        record(entry);
+    }
+}
+
+const RecordedCycle& Recorder::at(size_t index) const {
+    if (index >= size()) {
+        throw std::out_of_range("Recorder index past the held entries");
+    }
+    const uint64_t oldest = written_ - size();
+    return ring_[static_cast<size_t>((oldest + index) % capacity_)];
+}
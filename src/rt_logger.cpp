@@ -0,0 +1,255 @@
+/* AsyncLogger class:
+- producer side (LogChannel::log) is header-only and touches nothing but its own ring
+- drain(): copy out every channel's published records, free the slots at once,
+then order and format outside the channel list lock, so open_channel() and
+register_format() never wait on the sink
+*/
+
+#include "rt_logger.hpp"
+#include "thread_affinity.hpp"
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstdio>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+uint64_t steady_ns() {
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+size_t round_up_pow2(size_t n) {
+    size_t p = 1;
+    while (p < n) {
+        p <<= 1;
+    }
+    return p;
+}
+
+const char* level_name(LogLevel level) {
+    switch (level) {
+    case LogLevel::Debug: return "DEBUG";
+    case LogLevel::Info: return "INFO";
+    case LogLevel::Warning: return "WARN";
+    case LogLevel::Error: return "ERROR";
+    }
+    return "?";
+}
+
+} // namespace
+
+
+LogChannel::LogChannel(std::string name, size_t capacity, int numa_node)
+    : name_(std::move(name))
+    , capacity_(round_up_pow2(capacity))
+    , storage_(capacity_ * sizeof(LogRecord), numa_node)
+    , ring_(reinterpret_cast<LogRecord*>(storage_.data()))
+{
+}
+
+size_t LogChannel::drain(std::vector<LogRecord>& out) {
+    const uint64_t tail = tail_.load(std::memory_order_relaxed);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    for (uint64_t i = tail; i != head; ++i) {
+        out.push_back(ring_[i & (capacity_ - 1)]);
+    }
+    tail_.store(head, std::memory_order_release);
+    return static_cast<size_t>(head - tail);
+}
+
+
+AsyncLogger::AsyncLogger(LogSink sink)
+    : sink_(std::move(sink))
+    , start_ns_(steady_ns())
+{
+    if (!sink_) {
+        sink_ = [](const std::string& line) { std::clog << line << '\n'; };
+    }
+}
+
+AsyncLogger::~AsyncLogger() {
+    stop();
+}
+
+
+LogFormat AsyncLogger::register_format(LogLevel level, const std::string& text) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < formats_.size(); ++i) {
+        if (formats_[i].level == level && formats_[i].text == text) {
+            return static_cast<LogFormat>(i);
+        }
+    }
+    if (formats_.size() > UINT16_MAX) {
+        throw std::length_error("AsyncLogger: too many formats");
+    }
+    formats_.push_back(Format{level, text});
+    return static_cast<LogFormat>(formats_.size() - 1);
+}
+
+LogChannel& AsyncLogger::open_channel(const std::string& name, size_t capacity, int numa_node) {
+    if (capacity == 0) {
+        throw std::invalid_argument("LogChannel capacity must be positive");
+    }
+    auto channel = std::make_unique<LogChannel>(name, capacity, numa_node);
+    std::lock_guard<std::mutex> lock(mutex_);
+    channels_.push_back(std::move(channel));
+    return *channels_.back();
+}
+
+uint64_t AsyncLogger::dropped() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint64_t total = 0;
+    for (const auto& channel : channels_) {
+        total += channel->dropped();
+    }
+    return total;
+}
+
+
+void AsyncLogger::start(int cpu_core, std::chrono::nanoseconds poll_interval) {
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&AsyncLogger::drain_loop, this, cpu_core, poll_interval);
+}
+
+void AsyncLogger::stop() {
+    running_.store(false);
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+    drain();
+}
+
+void AsyncLogger::drain_loop(int cpu_core, std::chrono::nanoseconds poll_interval) {
+    if (cpu_core >= 0) {
+        pin_current_thread(cpu_core);
+    }
+    while (running_.load(std::memory_order_relaxed)) {
+        drain();
+        std::this_thread::sleep_for(poll_interval);
+    }
+}
+
+
+size_t AsyncLogger::drain() {
+    std::lock_guard<std::mutex> drain_lock(drain_mutex_);
+    batch_.clear();
+    batch_channel_.clear();
+
+    //channel pointers are stable (owned until the logger goes), names and drops read here too
+    std::vector<std::pair<const LogChannel*, uint64_t>> drops;
+    std::vector<const LogChannel*> channels;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        channels.reserve(channels_.size());
+        for (auto& channel : channels_) {
+            const size_t taken = channel->drain(batch_);
+            batch_channel_.insert(batch_channel_.end(), taken, channels.size());
+            channels.push_back(channel.get());
+
+            const uint64_t dropped = channel->dropped();
+            if (dropped != channel->reported_drops_) {
+                drops.emplace_back(channel.get(), dropped - channel->reported_drops_);
+                channel->reported_drops_ = dropped;
+            }
+        }
+    }
+
+    //one timeline over all channels
+    std::vector<size_t> order(batch_.size());
+    std::iota(order.begin(), order.end(), size_t{0});
+    std::stable_sort(order.begin(), order.end(), [this](size_t a, size_t b) {
+        return batch_[a].timestamp_ns < batch_[b].timestamp_ns;
+    });
+
+    size_t lines = 0;
+    for (size_t index : order) {
+        sink_(line(batch_[index], channels[batch_channel_[index]]->name()));
+        ++lines;
+    }
+    for (const auto& drop : drops) {
+        char text[96];
+        std::snprintf(text, sizeof(text), "%.6f WARN [%s] %" PRIu64 " messages dropped (ring full)",
+                      static_cast<double>(steady_ns() - start_ns_) * 1e-9, drop.first->name().c_str(), drop.second);
+        sink_(text);
+        ++lines;
+    }
+    written_.fetch_add(lines, std::memory_order_relaxed);
+    return lines;
+}
+
+std::string AsyncLogger::line(const LogRecord& record, const std::string& channel) const {
+    const double seconds = record.timestamp_ns > start_ns_
+        ? static_cast<double>(record.timestamp_ns - start_ns_) * 1e-9 : 0.0;
+    char prefix[48];
+    Format format{LogLevel::Error, {}};
+    bool known = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (record.format < formats_.size()) {
+            format = formats_[record.format];
+            known = true;
+        }
+    }
+    std::snprintf(prefix, sizeof(prefix), "%.6f %s [", seconds, level_name(format.level));
+    std::string out = prefix;
+    out += channel;
+    out += "] ";
+    if (known) {
+        out += AsyncLogger::format(format.text, record);
+    } else {
+        out += "unknown format " + std::to_string(record.format);
+    }
+    return out;
+}
+
+
+std::string AsyncLogger::format(const std::string& text, const LogRecord& record) {
+    std::string out;
+    out.reserve(text.size() + 16);
+    size_t arg = 0;
+    for (size_t i = 0; i < text.size(); ++i) {
+        const bool plain = text.compare(i, 2, "{}") == 0;
+        const bool hex = !plain && text.compare(i, 3, "{x}") == 0;
+        if (!plain && !hex) {
+            out += text[i];
+            continue;
+        }
+        i += plain ? 1 : 2;
+        if (arg >= record.count) {
+            out += "{?}";
+            continue;
+        }
+
+        char value[32];
+        const uint64_t bits = record.args[arg];
+        switch ((record.types >> (2 * arg)) & 0x3) {
+        case LogRecord::Float: {
+            double real;
+            std::memcpy(&real, &bits, sizeof(real));
+            std::snprintf(value, sizeof(value), "%g", real);
+            break;
+        }
+        case LogRecord::Unsigned:
+            std::snprintf(value, sizeof(value), hex ? "0x%" PRIX64 : "%" PRIu64, bits);
+            break;
+        default:
+            if (hex) {
+                std::snprintf(value, sizeof(value), "0x%" PRIX64, bits);
+            } else {
+                std::snprintf(value, sizeof(value), "%" PRId64, static_cast<int64_t>(bits));
+            }
+            break;
+        }
+        out += value;
+        ++arg;
+    }
+    return out;
+}
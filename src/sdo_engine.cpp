@@ -0,0 +1,272 @@
+/* SdoEngine class:
+- submitters only append to the slave's queue under the lock and wake the poller
+- poll() walks the slaves that have work (active_), not all kMaxSlaves: collects
+answers, expires deadlines, and puts the next request of each idle mailbox on the wire
+- results are gathered under the lock and delivered after it is released, so a
+callback may submit the next request
+*/
+
+#include "sdo_engine.hpp"
+#include "thread_affinity.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return to > from ? std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() : 0;
+}
+
+SdoCallback fulfil(const std::shared_ptr<std::promise<SdoResult>>& promise) {
+    return [promise](uint8_t, const SdoResult& result) { promise->set_value(result); };
+}
+
+} // namespace
+
+
+SdoEngine::SdoEngine(MailboxTransport& transport, std::chrono::nanoseconds default_timeout)
+    : transport_(transport)
+    , default_timeout_(default_timeout)
+{
+    active_.reserve(kMaxSlaves);
+}
+
+SdoEngine::~SdoEngine() {
+    stop();
+
+    std::lock_guard<std::mutex> polling(poll_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = std::chrono::steady_clock::now();
+        SdoResult cancelled;
+        cancelled.status = SdoStatus::Cancelled;
+        for (uint8_t id : active_) {
+            if (busy_[id]) {
+                transport_.abandon(id);
+                complete(id, in_flight_[id], cancelled, now);
+                busy_[id] = false;
+            }
+            for (Pending& pending : queues_[id]) {
+                complete(id, pending, cancelled, now);
+            }
+            queues_[id].clear();
+        }
+        active_.clear();
+        queued_ = 0;
+        in_flight_count_ = 0;
+    }
+    run_callbacks();
+}
+
+
+std::future<SdoResult> SdoEngine::upload(uint8_t slave_id, uint16_t index, uint8_t subindex,
+                                         std::chrono::nanoseconds timeout){
+    auto promise = std::make_shared<std::promise<SdoResult>>();
+    std::future<SdoResult> future = promise->get_future();
+    upload(slave_id, index, subindex, fulfil(promise), timeout);
+    return future;
+}
+
+std::future<SdoResult> SdoEngine::download(uint8_t slave_id, uint16_t index, uint8_t subindex,
+                                           std::vector<uint8_t> data, std::chrono::nanoseconds timeout){
+    auto promise = std::make_shared<std::promise<SdoResult>>();
+    std::future<SdoResult> future = promise->get_future();
+    download(slave_id, index, subindex, std::move(data), fulfil(promise), timeout);
+    return future;
+}
+
+void SdoEngine::upload(uint8_t slave_id, uint16_t index, uint8_t subindex, SdoCallback done,
+                       std::chrono::nanoseconds timeout){
+    submit(slave_id, SdoRequest{SdoRequest::Kind::Upload, index, subindex, {}}, std::move(done), timeout);
+}
+
+void SdoEngine::download(uint8_t slave_id, uint16_t index, uint8_t subindex, std::vector<uint8_t> data,
+                         SdoCallback done, std::chrono::nanoseconds timeout){
+    submit(slave_id, SdoRequest{SdoRequest::Kind::Download, index, subindex, std::move(data)}, std::move(done),
+           timeout);
+}
+
+void SdoEngine::submit(uint8_t slave_id, SdoRequest request, SdoCallback done, std::chrono::nanoseconds timeout){
+    const auto now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        queues_[slave_id].push_back(Pending{std::move(request), std::move(done), now,
+                                            now + (timeout.count() > 0 ? timeout : default_timeout_)});
+        ++queued_;
+        if (!listed_[slave_id]) {
+            listed_[slave_id] = true;
+            active_.push_back(slave_id);
+        }
+    }
+    wake_.notify_one();
+}
+
+
+size_t SdoEngine::poll(){
+    std::lock_guard<std::mutex> polling(poll_mutex_);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        const auto now = std::chrono::steady_clock::now();
+
+        for (size_t a = 0; a < active_.size();) {
+            const uint8_t id = active_[a];
+
+            if (busy_[id]) {
+                SdoResponse response;
+                if (transport_.receive(id, response)) {
+                    SdoResult result;
+                    result.status = response.abort_code == 0 ? SdoStatus::Ok : SdoStatus::Aborted;
+                    result.abort_code = response.abort_code;
+                    result.data = std::move(response.data);
+                    complete(id, in_flight_[id], std::move(result), now);
+                    busy_[id] = false;
+                    --in_flight_count_;
+                } else if (now >= in_flight_[id].deadline) {
+                    transport_.abandon(id);
+                    SdoResult result;
+                    result.status = SdoStatus::Timeout;
+                    complete(id, in_flight_[id], std::move(result), now);
+                    busy_[id] = false;
+                    --in_flight_count_;
+                }
+            }
+
+            std::deque<Pending>& queue = queues_[id];
+            while (!busy_[id] && !queue.empty()) {
+                if (now >= queue.front().deadline) {
+                    SdoResult result;
+                    result.status = SdoStatus::Timeout;
+                    complete(id, queue.front(), std::move(result), now);
+                } else if (transport_.send(id, queue.front().request)) {
+                    in_flight_[id] = std::move(queue.front());
+                    busy_[id] = true;
+                    ++in_flight_count_;
+                    if (in_flight_count_ > counters_.max_in_flight) {
+                        counters_.max_in_flight = in_flight_count_;
+                    }
+                } else {
+                    break; //mailbox still busy on the transport's side: next poll
+                }
+                queue.pop_front();
+                --queued_;
+            }
+
+            if (!busy_[id] && queue.empty()) {
+                listed_[id] = false;
+                active_[a] = active_.back();
+                active_.pop_back();
+                continue;
+            }
+            ++a;
+        }
+    }
+    const size_t completed = completions_.size();
+    run_callbacks();
+    return completed;
+}
+
+//mutex_ held
+void SdoEngine::complete(uint8_t slave_id, Pending& pending, SdoResult result,
+                         std::chrono::steady_clock::time_point now){
+    ++counters_.completed;
+    if (result.status == SdoStatus::Aborted) {
+        ++counters_.aborted;
+    } else if (result.status == SdoStatus::Timeout) {
+        ++counters_.timed_out;
+    }
+    if (result.status == SdoStatus::Ok || result.status == SdoStatus::Aborted) {
+        latency_.record(elapsed_ns(pending.submitted, now));
+    }
+    completions_.push_back(Completion{slave_id, std::move(pending.done), std::move(result)});
+}
+
+//poll_mutex_ held, mutex_ not
+void SdoEngine::run_callbacks(){
+    for (Completion& completion : completions_) {
+        if (!completion.done) {
+            continue;
+        }
+        try {
+            completion.done(completion.slave_id, completion.result);
+        } catch (...) {
+            callback_failures_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    completions_.clear();
+}
+
+
+void SdoEngine::start(const std::vector<int>& rt_cores, std::chrono::nanoseconds poll_interval){
+    std::vector<int> cores = non_rt_cores(rt_cores);
+    if (cores.empty()) {
+        throw std::invalid_argument("SdoEngine: every core is an RT core, pass a cpu_core to poll on");
+    }
+    if (running_.exchange(true)) {
+        return;
+    }
+    thread_ = std::thread(&SdoEngine::poll_loop, this, std::move(cores), poll_interval);
+}
+
+void SdoEngine::start(int cpu_core, std::chrono::nanoseconds poll_interval){
+    if (running_.exchange(true)) {
+        return;
+    }
+    std::vector<int> cores;
+    if (cpu_core >= 0) {
+        cores.push_back(cpu_core);
+    }
+    thread_ = std::thread(&SdoEngine::poll_loop, this, std::move(cores), poll_interval);
+}
+
+void SdoEngine::stop(){
+    {
+        std::lock_guard<std::mutex> lock(mutex_); //no wake-up lost between the check and the wait
+        running_.store(false);
+    }
+    wake_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void SdoEngine::poll_loop(std::vector<int> cores, std::chrono::nanoseconds poll_interval){
+    if (!cores.empty()) {
+        pin_current_thread(cores);
+    }
+    while (running_.load(std::memory_order_relaxed)) {
+        poll();
+
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (in_flight_count_ == 0 && queued_ == 0) {
+            wake_.wait(lock, [this] { return !running_.load() || queued_ > 0; });
+        } else {
+            //answers are polled for, not signalled: look again after poll_interval
+            wake_.wait_for(lock, poll_interval, [this] { return !running_.load(); });
+        }
+    }
+}
+
+
+size_t SdoEngine::queued() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queued_;
+}
+
+size_t SdoEngine::in_flight() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return in_flight_count_;
+}
+
+SdoEngineStats SdoEngine::stats() const {
+    SdoEngineStats stats;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stats = counters_;
+    }
+    stats.callback_failures = callback_failures_.load(std::memory_order_relaxed);
+    stats.latency = latency_.summary();
+    return stats;
+}
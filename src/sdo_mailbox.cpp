@@ -0,0 +1,119 @@
+/* SimulatedMailbox class:
+- answers are computed when the request is sent and handed out once the latency
+has passed, like a slave that takes a few mailbox round trips to reply
+- subindex 0 of a dictionary index that has entries answers with the entry count,
+as CoE records and arrays do, unless it was set explicitly
+*/
+
+#include "sdo_mailbox.hpp"
+
+#include <stdexcept>
+
+
+SimulatedMailbox::SimulatedMailbox(std::chrono::nanoseconds latency)
+    : latency_(latency)
+{
+}
+
+
+void SimulatedMailbox::setObject(uint8_t slave_id, uint16_t index, uint8_t subindex, std::vector<uint8_t> value){
+    std::lock_guard<std::mutex> lock(mutex_);
+    dictionaries_[slave_id][{index, subindex}] = std::move(value);
+}
+
+std::vector<uint8_t> SimulatedMailbox::object(uint8_t slave_id, uint16_t index, uint8_t subindex) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return dictionaries_[slave_id].at({index, subindex});
+}
+
+void SimulatedMailbox::setLatency(std::chrono::nanoseconds latency){
+    std::lock_guard<std::mutex> lock(mutex_);
+    latency_ = latency;
+}
+
+void SimulatedMailbox::setResponsive(uint8_t slave_id, bool responsive){
+    std::lock_guard<std::mutex> lock(mutex_);
+    mailboxes_[slave_id].responsive = responsive;
+}
+
+
+bool SimulatedMailbox::send(uint8_t slave_id, const SdoRequest& request){
+    std::lock_guard<std::mutex> lock(mutex_);
+    Mailbox& mailbox = mailboxes_[slave_id];
+    if (mailbox.busy) {
+        return false;
+    }
+    mailbox.busy = true;
+    mailbox.ready = std::chrono::steady_clock::now() + latency_;
+    mailbox.response = serve(slave_id, request);
+    ++requests_;
+    ++outstanding_;
+    if (outstanding_ > max_outstanding_) {
+        max_outstanding_ = outstanding_;
+    }
+    return true;
+}
+
+bool SimulatedMailbox::receive(uint8_t slave_id, SdoResponse& response){
+    std::lock_guard<std::mutex> lock(mutex_);
+    Mailbox& mailbox = mailboxes_[slave_id];
+    if (!mailbox.busy || !mailbox.responsive || std::chrono::steady_clock::now() < mailbox.ready) {
+        return false;
+    }
+    response = std::move(mailbox.response);
+    mailbox.busy = false;
+    --outstanding_;
+    return true;
+}
+
+void SimulatedMailbox::abandon(uint8_t slave_id){
+    std::lock_guard<std::mutex> lock(mutex_);
+    Mailbox& mailbox = mailboxes_[slave_id];
+    if (mailbox.busy) {
+        mailbox.busy = false;
+        --outstanding_;
+    }
+}
+
+
+uint64_t SimulatedMailbox::requests() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return requests_;
+}
+
+size_t SimulatedMailbox::max_outstanding() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return max_outstanding_;
+}
+
+
+//mutex_ held
+SdoResponse SimulatedMailbox::serve(uint8_t slave_id, const SdoRequest& request){
+    std::map<Key, std::vector<uint8_t>>& dictionary = dictionaries_[slave_id];
+    SdoResponse response;
+
+    auto entry = dictionary.find({request.index, request.subindex});
+    if (entry == dictionary.end()) {
+        auto first = dictionary.lower_bound({request.index, 0});
+        const bool index_exists = first != dictionary.end() && first->first.first == request.index;
+        if (index_exists && request.subindex == 0 && request.kind == SdoRequest::Kind::Upload) {
+            uint8_t count = 0;
+            for (; first != dictionary.end() && first->first.first == request.index; ++first) {
+                ++count;
+            }
+            response.data = {count};
+            return response;
+        }
+        response.abort_code = index_exists ? kSdoAbortSubindexMissing : kSdoAbortObjectMissing;
+        return response;
+    }
+
+    if (request.kind == SdoRequest::Kind::Upload) {
+        response.data = entry->second;
+    } else if (request.data.size() != entry->second.size()) {
+        response.abort_code = kSdoAbortLengthMismatch;
+    } else {
+        entry->second = request.data;
+    }
+    return response;
+}
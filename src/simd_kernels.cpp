@@ -0,0 +1,1102 @@
+/* multi-versioned batch kernels:
+- every kernel has a scalar version (always built, also used for tails)
+- on x86 with GCC/Clang the SSE4.2, AVX2 and AVX-512 versions are compiled
+in this same file with target attributes, so the rest of the build keeps
+baseline flags and the binary still starts on old IPCs
+- the public functions pick a table by active_simd_level() on every call
+*/
+
+#include "simd_kernels.hpp"
+
+#include "cpu_dispatch.hpp"
+#include "data_structuring.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define STAR_X86_DISPATCH 1
+//GCC 12's AVX-512 intrinsics leave their _mm512_undefined_* placeholders uninitialized on
+//purpose and -Wall reports it at every inlined use (GCC PR 105593): silenced for the header only
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wuninitialized"
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#include <immintrin.h>
+#pragma GCC diagnostic pop
+#define STAR_TARGET_SSE42 __attribute__((target("sse4.2,popcnt")))
+#define STAR_TARGET_AVX2 __attribute__((target("avx2,popcnt")))
+#define STAR_TARGET_AVX512 __attribute__((target("avx512f,avx512bw,avx512vl,popcnt")))
+#endif
+
+//_pext_u64/_pdep_u64 are x86-64 only: 32-bit x86 keeps the scalar loop
+#if defined(STAR_X86_DISPATCH) && defined(__x86_64__)
+#define STAR_BMI2_64 1
+#endif
+
+
+namespace {
+
+//the vector decoders read 4 bytes at every field offset
+static_assert(PdoInputLayout::motor_temperature + 4 <= PdoInputLayout::size,
+              "gathers must stay inside a frame");
+
+struct KernelTable {
+    void (*decode)(const uint8_t*, size_t, size_t, const SlaveColumns&);
+    size_t (*detect_changed)(const uint8_t*, const uint8_t*, size_t, size_t, uint8_t*);
+    float (*max_f32)(const float*, size_t);
+    int64_t (*sum_i16)(const int16_t*, size_t);
+    uint64_t (*min_u64)(const uint64_t*, size_t);
+    size_t (*count_flagged)(const uint16_t*, size_t, uint16_t);
+    void (*decode_scaled)(const uint8_t*, size_t, size_t, size_t, ValueEncoding, int32_t*);
+    void (*fixed_to_float)(const int32_t*, size_t, float, float, float*);
+    int32_t (*max_i32)(const int32_t*, size_t);
+    size_t (*find_changed_u16)(const uint16_t*, const uint16_t*, size_t, uint16_t*);
+    void (*plant_step)(const PlantColumns&, size_t, size_t, double, size_t);
+    size_t (*sanitize_f32)(float*, float*, uint8_t*, uint8_t, size_t, const FloatPolicy&);
+};
+
+
+// ============================================================================
+// SCALAR
+// ============================================================================
+
+//same load_le<T> as ReadState::parse, without the per-field bounds check
+void decode_range_scalar(const uint8_t* frames, size_t begin, size_t end, size_t stride,
+                         const SlaveColumns& out) {
+    for (size_t i = begin; i < end; ++i) {
+        const uint8_t* frame = frames + i * stride;
+        out.status_word[i] = load_le<uint16_t>(frame + PdoInputLayout::status_word);
+        out.actual_position[i] = load_le<int32_t>(frame + PdoInputLayout::actual_position);
+        out.actual_velocity[i] = load_le<int32_t>(frame + PdoInputLayout::actual_velocity);
+        out.actual_torque[i] = load_le<int16_t>(frame + PdoInputLayout::actual_torque);
+        out.mode_display[i] = load_le<uint8_t>(frame + PdoInputLayout::mode_display);
+        out.error_code[i] = load_le<uint16_t>(frame + PdoInputLayout::error_code);
+        out.system_status[i] = load_le<uint16_t>(frame + PdoInputLayout::system_status);
+        out.motor_temperature[i] = load_le<float>(frame + PdoInputLayout::motor_temperature);
+    }
+}
+
+void decode_scalar(const uint8_t* frames, size_t count, size_t stride, const SlaveColumns& out) {
+    decode_range_scalar(frames, 0, count, stride, out);
+}
+
+//finishes change detection for bytes [pos, count * stride) after a vector loop
+size_t detect_tail_scalar(const uint8_t* current, const uint8_t* previous, size_t count,
+                          size_t stride, uint8_t* changed, size_t pos) {
+    for (size_t frame = pos / stride; frame < count; ++frame) {
+        if (changed[frame]) {
+            continue;
+        }
+        size_t begin = frame * stride > pos ? frame * stride : pos;
+        size_t end = (frame + 1) * stride;
+        changed[frame] = std::memcmp(current + begin, previous + begin, end - begin) != 0;
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < count; ++i) {
+        total += changed[i];
+    }
+    return total;
+}
+
+size_t detect_changed_scalar(const uint8_t* current, const uint8_t* previous, size_t count,
+                             size_t stride, uint8_t* changed) {
+    std::memset(changed, 0, count);
+    return detect_tail_scalar(current, previous, count, stride, changed, 0);
+}
+
+float max_f32_scalar(const float* values, size_t count) {
+    float result = -std::numeric_limits<float>::infinity();
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] > result) { //false for NaN
+            result = values[i];
+        }
+    }
+    return result;
+}
+
+int64_t sum_i16_scalar(const int16_t* values, size_t count) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sum += values[i];
+    }
+    return sum;
+}
+
+uint64_t min_u64_scalar(const uint64_t* values, size_t count) {
+    uint64_t result = std::numeric_limits<uint64_t>::max();
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] < result) {
+            result = values[i];
+        }
+    }
+    return result;
+}
+
+size_t count_flagged_scalar(const uint16_t* values, size_t count, uint16_t mask) {
+    size_t flagged = 0;
+    for (size_t i = 0; i < count; ++i) {
+        flagged += (values[i] & mask) != 0;
+    }
+    return flagged;
+}
+
+void decode_scaled_range_scalar(const uint8_t* frames, size_t begin, size_t end, size_t stride,
+                                size_t field_offset, ValueEncoding encoding, int32_t* out) {
+    for (size_t i = begin; i < end; ++i) {
+        out[i] = load_scaled_raw(frames + i * stride + field_offset, encoding);
+    }
+}
+
+void decode_scaled_scalar(const uint8_t* frames, size_t count, size_t stride, size_t field_offset,
+                          ValueEncoding encoding, int32_t* out) {
+    decode_scaled_range_scalar(frames, 0, count, stride, field_offset, encoding, out);
+}
+
+void fixed_to_float_scalar(const int32_t* raw, size_t count, float scale, float offset, float* out) {
+    for (size_t i = 0; i < count; ++i) {
+        out[i] = static_cast<float>(raw[i]) * scale + offset;
+    }
+}
+
+int32_t max_i32_scalar(const int32_t* values, size_t count) {
+    int32_t result = std::numeric_limits<int32_t>::min();
+    for (size_t i = 0; i < count; ++i) {
+        if (values[i] > result) {
+            result = values[i];
+        }
+    }
+    return result;
+}
+
+//indices written as first + i: the vector kernels hand over their tail
+size_t find_changed_tail_scalar(const uint16_t* current, const uint16_t* previous, size_t count,
+                                uint16_t* changed_index, size_t first) {
+    size_t found = 0;
+    for (size_t i = 0; i < count; ++i) {
+        if (current[i] != previous[i]) {
+            changed_index[found++] = static_cast<uint16_t>(first + i);
+        }
+    }
+    return found;
+}
+
+size_t find_changed_u16_scalar(const uint16_t* current, const uint16_t* previous, size_t count,
+                               uint16_t* changed_index) {
+    return find_changed_tail_scalar(current, previous, count, changed_index, 0);
+}
+
+//axes [begin, end)
+void plant_step_scalar(const PlantColumns& a, size_t begin, size_t end, double dt, size_t substeps) {
+    for (size_t i = begin; i < end; ++i) {
+        double position = a.position[i];
+        double velocity = a.velocity[i];
+        double torque = a.torque[i];
+        double integral = a.integral[i];
+        double temperature = a.temperature[i];
+        const double limit = a.torque_limit[i];
+        for (size_t s = 0; s < substeps; ++s) {
+            const double error = a.position_gain[i] * (a.target_position[i] - position) + a.velocity_reference[i] - velocity;
+            integral = std::min(std::max(integral + a.integral_gain[i] * error, -limit), limit);
+            const double command = std::min(std::max(a.velocity_gain[i] * error + integral + a.torque_offset[i], -limit), limit);
+            torque = torque + (command - torque) * a.torque_alpha[i];
+            velocity = velocity + (torque * a.accel_per_torque[i] - a.damping[i] * velocity) * dt;
+            position = position + velocity * dt;
+            temperature = temperature + (a.ambient[i] + a.heating[i] * torque * torque - temperature) * a.thermal_beta[i];
+        }
+        a.position[i] = position;
+        a.velocity[i] = velocity;
+        a.torque[i] = torque;
+        a.integral[i] = integral;
+        a.temperature[i] = temperature;
+    }
+}
+
+constexpr uint32_t kFloatExponent = 0x7F800000u;
+constexpr uint32_t kFloatAbs = 0x7FFFFFFFu;
+
+//values [begin, end) one at a time; the vector versions take this path for blocks with a special value
+size_t sanitize_range_scalar(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t begin,
+                             size_t end, const FloatPolicy& policy) {
+    size_t replaced = 0;
+    for (size_t i = begin; i < end; ++i) {
+        float value = values[i];
+        uint32_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const uint32_t exponent = bits & kFloatExponent;
+        if (exponent == kFloatExponent && policy.replace_non_finite) {
+            values[i] = last_good[i];
+            flags[i] = static_cast<uint8_t>(flags[i] | flag);
+            ++replaced;
+            continue;
+        }
+        if (exponent == 0 && policy.flush_denormals) {
+            value = (bits & ~kFloatAbs) != 0 ? -0.0f : 0.0f;
+        }
+        //NaN compares false both ways and passes unclamped
+        value = value < policy.min ? policy.min : value > policy.max ? policy.max : value;
+        values[i] = value;
+        if (std::isfinite(value)) {
+            last_good[i] = value;
+        }
+    }
+    return replaced;
+}
+
+size_t sanitize_f32_scalar(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t count,
+                           const FloatPolicy& policy) {
+    return sanitize_range_scalar(values, last_good, flags, flag, 0, count, policy);
+}
+
+const KernelTable kScalarKernels = {
+    decode_scalar, detect_changed_scalar, max_f32_scalar,
+    sum_i16_scalar, min_u64_scalar, count_flagged_scalar,
+    decode_scaled_scalar, fixed_to_float_scalar, max_i32_scalar,
+    find_changed_u16_scalar, plant_step_scalar, sanitize_f32_scalar,
+};
+
+
+#ifdef STAR_X86_DISPATCH
+
+//jumps to the start of the next frame once a difference is found: the rest of that frame no longer matters
+size_t mark_changed(uint8_t* changed, size_t diff_pos, size_t stride) {
+    size_t frame = diff_pos / stride;
+    changed[frame] = 1;
+    return (frame + 1) * stride;
+}
+
+// ============================================================================
+// SSE4.2
+// ============================================================================
+
+//no gathers below AVX2: per-field loads are what the scalar decoder already does
+
+STAR_TARGET_SSE42
+size_t detect_changed_sse42(const uint8_t* current, const uint8_t* previous, size_t count,
+                            size_t stride, uint8_t* changed) {
+    std::memset(changed, 0, count);
+    const size_t total = count * stride;
+    size_t pos = 0;
+    while (pos + 16 <= total) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + pos));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + pos));
+        unsigned diff = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b))) ^ 0xFFFFu;
+        pos = diff ? mark_changed(changed, pos + __builtin_ctz(diff), stride) : pos + 16;
+    }
+    return detect_tail_scalar(current, previous, count, stride, changed, pos);
+}
+
+STAR_TARGET_SSE42
+float max_f32_sse42(const float* values, size_t count) {
+    __m128 acc = _mm_set1_ps(-std::numeric_limits<float>::infinity());
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm_max_ps(_mm_loadu_ps(values + i), acc); //returns acc when the value is NaN
+    }
+    float lanes[4];
+    _mm_storeu_ps(lanes, acc);
+    float result = max_f32_scalar(lanes, 4);
+    float tail = max_f32_scalar(values + i, count - i);
+    return tail > result ? tail : result;
+}
+
+STAR_TARGET_SSE42
+int64_t sum_i16_sse42(const int16_t* values, size_t count) {
+    const __m128i ones = _mm_set1_epi16(1);
+    __m128i acc = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i pairs = _mm_madd_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), ones);
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(pairs));
+        acc = _mm_add_epi64(acc, _mm_cvtepi32_epi64(_mm_srli_si128(pairs, 8)));
+    }
+    int64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    return lanes[0] + lanes[1] + sum_i16_scalar(values + i, count - i);
+}
+
+STAR_TARGET_SSE42
+uint64_t min_u64_sse42(const uint64_t* values, size_t count) {
+    //no unsigned 64-bit compare: flip the sign bit and use the signed pcmpgtq
+    const __m128i bias = _mm_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+    __m128i acc = _mm_set1_epi64x(-1);
+    __m128i acc_biased = _mm_xor_si128(acc, bias);
+    size_t i = 0;
+    for (; i + 2 <= count; i += 2) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i));
+        __m128i v_biased = _mm_xor_si128(v, bias);
+        __m128i take = _mm_cmpgt_epi64(acc_biased, v_biased);
+        acc = _mm_blendv_epi8(acc, v, take);
+        acc_biased = _mm_blendv_epi8(acc_biased, v_biased, take);
+    }
+    uint64_t lanes[2];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    uint64_t result = lanes[0] < lanes[1] ? lanes[0] : lanes[1];
+    uint64_t tail = min_u64_scalar(values + i, count - i);
+    return tail < result ? tail : result;
+}
+
+STAR_TARGET_SSE42
+size_t count_flagged_sse42(const uint16_t* values, size_t count, uint16_t mask) {
+    const __m128i m = _mm_set1_epi16(static_cast<short>(mask));
+    const __m128i zero = _mm_setzero_si128();
+    size_t flagged = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i v = _mm_and_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)), m);
+        unsigned clear = static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi16(v, zero)));
+        flagged += 8 - static_cast<size_t>(__builtin_popcount(clear)) / 2; //2 mask bits per lane
+    }
+    return flagged + count_flagged_scalar(values + i, count - i, mask);
+}
+
+STAR_TARGET_SSE42
+void fixed_to_float_sse42(const int32_t* raw, size_t count, float scale, float offset, float* out) {
+    const __m128 s = _mm_set1_ps(scale);
+    const __m128 o = _mm_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m128 v = _mm_cvtepi32_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(raw + i)));
+        _mm_storeu_ps(out + i, _mm_add_ps(_mm_mul_ps(v, s), o));
+    }
+    fixed_to_float_scalar(raw + i, count - i, scale, offset, out + i);
+}
+
+STAR_TARGET_SSE42
+int32_t max_i32_sse42(const int32_t* values, size_t count) {
+    __m128i acc = _mm_set1_epi32(std::numeric_limits<int32_t>::min());
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        acc = _mm_max_epi32(acc, _mm_loadu_si128(reinterpret_cast<const __m128i*>(values + i)));
+    }
+    int32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), acc);
+    int32_t result = max_i32_scalar(lanes, 4);
+    int32_t tail = max_i32_scalar(values + i, count - i);
+    return tail > result ? tail : result;
+}
+
+//lanes that differ come out of movemask as bit pairs: one index per pair
+inline size_t append_changed_pairs(uint32_t pairs, size_t first, uint16_t* changed_index, size_t found) {
+    pairs &= 0x55555555u;
+    while (pairs != 0) {
+        changed_index[found++] = static_cast<uint16_t>(first + static_cast<size_t>(__builtin_ctz(pairs)) / 2);
+        pairs &= pairs - 1;
+    }
+    return found;
+}
+
+STAR_TARGET_SSE42
+size_t find_changed_u16_sse42(const uint16_t* current, const uint16_t* previous, size_t count,
+                              uint16_t* changed_index) {
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(current + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(previous + i));
+        uint32_t differ = ~static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi16(a, b))) & 0xFFFFu;
+        if (differ != 0) { //usually nothing changed: one test per 8 slaves
+            found = append_changed_pairs(differ, i, changed_index, found);
+        }
+    }
+    return found + find_changed_tail_scalar(current + i, previous + i, count - i, changed_index + found, i);
+}
+
+STAR_TARGET_SSE42
+size_t sanitize_f32_sse42(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t count,
+                          const FloatPolicy& policy) {
+    //special: NaN/inf always (last_good must not take them), denormals if flushed, out of [min, max]
+    const __m128i abs_mask = _mm_set1_epi32(static_cast<int32_t>(kFloatAbs));
+    const __m128i largest_finite = _mm_set1_epi32(static_cast<int32_t>(kFloatExponent - 1));
+    const __m128i smallest_normal = _mm_set1_epi32(0x00800000);
+    const __m128i check_denormals = _mm_set1_epi32(policy.flush_denormals ? -1 : 0);
+    const __m128 low = _mm_set1_ps(policy.min);
+    const __m128 high = _mm_set1_ps(policy.max);
+    size_t replaced = 0;
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        const __m128 v = _mm_loadu_ps(values + i);
+        const __m128i magnitude = _mm_and_si128(_mm_castps_si128(v), abs_mask);
+        const __m128i denormal = _mm_andnot_si128(_mm_cmpeq_epi32(magnitude, _mm_setzero_si128()),
+                                                  _mm_cmpgt_epi32(smallest_normal, magnitude));
+        __m128i special = _mm_or_si128(_mm_cmpgt_epi32(magnitude, largest_finite),
+                                       _mm_and_si128(denormal, check_denormals));
+        special = _mm_or_si128(special, _mm_castps_si128(_mm_or_ps(_mm_cmplt_ps(v, low), _mm_cmpgt_ps(v, high))));
+        if (_mm_movemask_epi8(special) == 0) {
+            _mm_storeu_ps(last_good + i, v);
+        } else {
+            replaced += sanitize_range_scalar(values, last_good, flags, flag, i, i + 4, policy);
+        }
+    }
+    return replaced + sanitize_range_scalar(values, last_good, flags, flag, i, count, policy);
+}
+
+const KernelTable kSse42Kernels = {
+    decode_scalar, detect_changed_sse42, max_f32_sse42,
+    sum_i16_sse42, min_u64_sse42, count_flagged_sse42,
+    decode_scaled_scalar, fixed_to_float_sse42, max_i32_sse42,
+    find_changed_u16_sse42, plant_step_scalar, sanitize_f32_sse42,
+};
+
+
+// ============================================================================
+// AVX2
+// ============================================================================
+
+STAR_TARGET_AVX2
+inline __m256i gather8(const uint8_t* base, size_t field_offset, __m256i frame_offsets) {
+    return _mm256_i32gather_epi32(reinterpret_cast<const int*>(base + field_offset), frame_offsets, 1);
+}
+
+//low 16 bits of each of 8 dwords -> 8 packed words
+STAR_TARGET_AVX2
+inline void store_low16x8(void* dst, __m256i dwords) {
+    const __m256i pick = _mm256_setr_epi8(0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m256i packed = _mm256_permute4x64_epi64(_mm256_shuffle_epi8(dwords, pick), 0x08);
+    _mm_storeu_si128(static_cast<__m128i*>(dst), _mm256_castsi256_si128(packed));
+}
+
+//low byte of each of 8 dwords -> 8 packed bytes
+STAR_TARGET_AVX2
+inline void store_low8x8(uint8_t* dst, __m256i dwords) {
+    const __m256i pick = _mm256_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                          0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    __m256i packed = _mm256_shuffle_epi8(dwords, pick);
+    uint32_t low = static_cast<uint32_t>(_mm256_extract_epi32(packed, 0));
+    uint32_t high = static_cast<uint32_t>(_mm256_extract_epi32(packed, 4));
+    std::memcpy(dst, &low, 4);
+    std::memcpy(dst + 4, &high, 4);
+}
+
+STAR_TARGET_AVX2
+void decode_avx2(const uint8_t* frames, size_t count, size_t stride, const SlaveColumns& out) {
+    size_t i = 0;
+    //gather indices are 32-bit
+    if (count * stride <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        const __m256i frame_offsets = _mm256_mullo_epi32(
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+        for (; i + 8 <= count; i += 8) {
+            const uint8_t* base = frames + i * stride;
+            store_low16x8(out.status_word + i, gather8(base, PdoInputLayout::status_word, frame_offsets));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.actual_position + i),
+                                gather8(base, PdoInputLayout::actual_position, frame_offsets));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.actual_velocity + i),
+                                gather8(base, PdoInputLayout::actual_velocity, frame_offsets));
+            store_low16x8(out.actual_torque + i, gather8(base, PdoInputLayout::actual_torque, frame_offsets));
+            store_low8x8(out.mode_display + i, gather8(base, PdoInputLayout::mode_display, frame_offsets));
+            store_low16x8(out.error_code + i, gather8(base, PdoInputLayout::error_code, frame_offsets));
+            store_low16x8(out.system_status + i, gather8(base, PdoInputLayout::system_status, frame_offsets));
+            _mm256_storeu_ps(out.motor_temperature + i,
+                             _mm256_castsi256_ps(gather8(base, PdoInputLayout::motor_temperature, frame_offsets)));
+        }
+    }
+    decode_range_scalar(frames, i, count, stride, out);
+}
+
+STAR_TARGET_AVX2
+size_t detect_changed_avx2(const uint8_t* current, const uint8_t* previous, size_t count,
+                           size_t stride, uint8_t* changed) {
+    std::memset(changed, 0, count);
+    const size_t total = count * stride;
+    size_t pos = 0;
+    while (pos + 32 <= total) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + pos));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + pos));
+        uint32_t diff = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+        pos = diff ? mark_changed(changed, pos + __builtin_ctz(diff), stride) : pos + 32;
+    }
+    return detect_tail_scalar(current, previous, count, stride, changed, pos);
+}
+
+STAR_TARGET_AVX2
+float max_f32_avx2(const float* values, size_t count) {
+    __m256 acc = _mm256_set1_ps(-std::numeric_limits<float>::infinity());
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_max_ps(_mm256_loadu_ps(values + i), acc);
+    }
+    float lanes[8];
+    _mm256_storeu_ps(lanes, acc);
+    float result = max_f32_scalar(lanes, 8);
+    float tail = max_f32_scalar(values + i, count - i);
+    return tail > result ? tail : result;
+}
+
+STAR_TARGET_AVX2
+int64_t sum_i16_avx2(const int16_t* values, size_t count) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    __m256i acc = _mm256_setzero_si256();
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i pairs = _mm256_madd_epi16(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), ones);
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_castsi256_si128(pairs)));
+        acc = _mm256_add_epi64(acc, _mm256_cvtepi32_epi64(_mm256_extracti128_si256(pairs, 1)));
+    }
+    int64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    return lanes[0] + lanes[1] + lanes[2] + lanes[3] + sum_i16_scalar(values + i, count - i);
+}
+
+STAR_TARGET_AVX2
+uint64_t min_u64_avx2(const uint64_t* values, size_t count) {
+    const __m256i bias = _mm256_set1_epi64x(static_cast<long long>(0x8000000000000000ULL));
+    __m256i acc = _mm256_set1_epi64x(-1);
+    __m256i acc_biased = _mm256_xor_si256(acc, bias);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i));
+        __m256i v_biased = _mm256_xor_si256(v, bias);
+        __m256i take = _mm256_cmpgt_epi64(acc_biased, v_biased);
+        acc = _mm256_blendv_epi8(acc, v, take);
+        acc_biased = _mm256_blendv_epi8(acc_biased, v_biased, take);
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    uint64_t result = min_u64_scalar(lanes, 4);
+    uint64_t tail = min_u64_scalar(values + i, count - i);
+    return tail < result ? tail : result;
+}
+
+STAR_TARGET_AVX2
+size_t count_flagged_avx2(const uint16_t* values, size_t count, uint16_t mask) {
+    const __m256i m = _mm256_set1_epi16(static_cast<short>(mask));
+    const __m256i zero = _mm256_setzero_si256();
+    size_t flagged = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i v = _mm256_and_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)), m);
+        uint32_t clear = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(v, zero)));
+        flagged += 16 - static_cast<size_t>(__builtin_popcount(clear)) / 2;
+    }
+    return flagged + count_flagged_scalar(values + i, count - i, mask);
+}
+
+//raw 32-bit lanes -> sign- or zero-extended field values
+STAR_TARGET_AVX2
+inline __m256i widen_scaled8(__m256i lanes, ValueEncoding encoding) {
+    switch (encoding) {
+        case ValueEncoding::Int16:  return _mm256_srai_epi32(_mm256_slli_epi32(lanes, 16), 16);
+        case ValueEncoding::UInt16: return _mm256_and_si256(lanes, _mm256_set1_epi32(0xFFFF));
+        default:                    return lanes;
+    }
+}
+
+STAR_TARGET_AVX2
+void decode_scaled_avx2(const uint8_t* frames, size_t count, size_t stride, size_t field_offset,
+                        ValueEncoding encoding, int32_t* out) {
+    size_t i = 0;
+    //the gather reads 4 bytes, which must stay inside the frame for 16-bit fields too
+    if (field_offset + 4 <= stride &&
+        count * stride <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        const __m256i frame_offsets = _mm256_mullo_epi32(
+            _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7), _mm256_set1_epi32(static_cast<int>(stride)));
+        for (; i + 8 <= count; i += 8) {
+            __m256i lanes = gather8(frames + i * stride, field_offset, frame_offsets);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), widen_scaled8(lanes, encoding));
+        }
+    }
+    decode_scaled_range_scalar(frames, i, count, stride, field_offset, encoding, out);
+}
+
+STAR_TARGET_AVX2
+void fixed_to_float_avx2(const int32_t* raw, size_t count, float scale, float offset, float* out) {
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m256 o = _mm256_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        __m256 v = _mm256_cvtepi32_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(raw + i)));
+        _mm256_storeu_ps(out + i, _mm256_add_ps(_mm256_mul_ps(v, s), o));
+    }
+    fixed_to_float_scalar(raw + i, count - i, scale, offset, out + i);
+}
+
+STAR_TARGET_AVX2
+int32_t max_i32_avx2(const int32_t* values, size_t count) {
+    __m256i acc = _mm256_set1_epi32(std::numeric_limits<int32_t>::min());
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm256_max_epi32(acc, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(values + i)));
+    }
+    int32_t lanes[8];
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), acc);
+    int32_t result = max_i32_scalar(lanes, 8);
+    int32_t tail = max_i32_scalar(values + i, count - i);
+    return tail > result ? tail : result;
+}
+
+STAR_TARGET_AVX2
+size_t find_changed_u16_avx2(const uint16_t* current, const uint16_t* previous, size_t count,
+                             uint16_t* changed_index) {
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(current + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(previous + i));
+        uint32_t differ = ~static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi16(a, b)));
+        if (differ != 0) {
+            found = append_changed_pairs(differ, i, changed_index, found);
+        }
+    }
+    return found + find_changed_tail_scalar(current + i, previous + i, count - i, changed_index + found, i);
+}
+
+STAR_TARGET_AVX2
+void plant_step_avx2(const PlantColumns& a, size_t begin, size_t end, double dt, size_t substeps) {
+    const __m256d step = _mm256_set1_pd(dt);
+    const __m256d zero = _mm256_setzero_pd();
+    size_t i = begin;
+    for (; i + 4 <= end; i += 4) {
+        __m256d position = _mm256_loadu_pd(a.position + i);
+        __m256d velocity = _mm256_loadu_pd(a.velocity + i);
+        __m256d torque = _mm256_loadu_pd(a.torque + i);
+        __m256d integral = _mm256_loadu_pd(a.integral + i);
+        __m256d temperature = _mm256_loadu_pd(a.temperature + i);
+        const __m256d target = _mm256_loadu_pd(a.target_position + i);
+        const __m256d velocity_reference = _mm256_loadu_pd(a.velocity_reference + i);
+        const __m256d torque_offset = _mm256_loadu_pd(a.torque_offset + i);
+        const __m256d kp = _mm256_loadu_pd(a.position_gain + i);
+        const __m256d kv = _mm256_loadu_pd(a.velocity_gain + i);
+        const __m256d ki = _mm256_loadu_pd(a.integral_gain + i);
+        const __m256d limit = _mm256_loadu_pd(a.torque_limit + i);
+        const __m256d negative_limit = _mm256_sub_pd(zero, limit);
+        const __m256d alpha = _mm256_loadu_pd(a.torque_alpha + i);
+        const __m256d accel = _mm256_loadu_pd(a.accel_per_torque + i);
+        const __m256d damping = _mm256_loadu_pd(a.damping + i);
+        const __m256d heating = _mm256_loadu_pd(a.heating + i);
+        const __m256d beta = _mm256_loadu_pd(a.thermal_beta + i);
+        const __m256d ambient = _mm256_loadu_pd(a.ambient + i);
+        for (size_t s = 0; s < substeps; ++s) {
+            __m256d error = _mm256_sub_pd(
+                _mm256_add_pd(_mm256_mul_pd(kp, _mm256_sub_pd(target, position)), velocity_reference), velocity);
+            integral = _mm256_min_pd(_mm256_max_pd(_mm256_add_pd(integral, _mm256_mul_pd(ki, error)), negative_limit), limit);
+            __m256d command = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(kv, error), integral), torque_offset);
+            command = _mm256_min_pd(_mm256_max_pd(command, negative_limit), limit);
+            torque = _mm256_add_pd(torque, _mm256_mul_pd(_mm256_sub_pd(command, torque), alpha));
+            __m256d acceleration = _mm256_sub_pd(_mm256_mul_pd(torque, accel), _mm256_mul_pd(damping, velocity));
+            velocity = _mm256_add_pd(velocity, _mm256_mul_pd(acceleration, step));
+            position = _mm256_add_pd(position, _mm256_mul_pd(velocity, step));
+            __m256d settle = _mm256_add_pd(ambient, _mm256_mul_pd(heating, _mm256_mul_pd(torque, torque)));
+            temperature = _mm256_add_pd(temperature, _mm256_mul_pd(_mm256_sub_pd(settle, temperature), beta));
+        }
+        _mm256_storeu_pd(a.position + i, position);
+        _mm256_storeu_pd(a.velocity + i, velocity);
+        _mm256_storeu_pd(a.torque + i, torque);
+        _mm256_storeu_pd(a.integral + i, integral);
+        _mm256_storeu_pd(a.temperature + i, temperature);
+    }
+    plant_step_scalar(a, i, end, dt, substeps);
+}
+
+STAR_TARGET_AVX2
+size_t sanitize_f32_avx2(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t count,
+                         const FloatPolicy& policy) {
+    const __m256i abs_mask = _mm256_set1_epi32(static_cast<int32_t>(kFloatAbs));
+    const __m256i largest_finite = _mm256_set1_epi32(static_cast<int32_t>(kFloatExponent - 1));
+    const __m256i smallest_normal = _mm256_set1_epi32(0x00800000);
+    const __m256i check_denormals = _mm256_set1_epi32(policy.flush_denormals ? -1 : 0);
+    const __m256 low = _mm256_set1_ps(policy.min);
+    const __m256 high = _mm256_set1_ps(policy.max);
+    size_t replaced = 0;
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        const __m256 v = _mm256_loadu_ps(values + i);
+        const __m256i magnitude = _mm256_and_si256(_mm256_castps_si256(v), abs_mask);
+        const __m256i denormal = _mm256_andnot_si256(_mm256_cmpeq_epi32(magnitude, _mm256_setzero_si256()),
+                                                     _mm256_cmpgt_epi32(smallest_normal, magnitude));
+        __m256i special = _mm256_or_si256(_mm256_cmpgt_epi32(magnitude, largest_finite),
+                                          _mm256_and_si256(denormal, check_denormals));
+        special = _mm256_or_si256(special, _mm256_castps_si256(_mm256_or_ps(
+            _mm256_cmp_ps(v, low, _CMP_LT_OQ), _mm256_cmp_ps(v, high, _CMP_GT_OQ))));
+        if (_mm256_testz_si256(special, special)) {
+            _mm256_storeu_ps(last_good + i, v);
+        } else {
+            replaced += sanitize_range_scalar(values, last_good, flags, flag, i, i + 8, policy);
+        }
+    }
+    return replaced + sanitize_range_scalar(values, last_good, flags, flag, i, count, policy);
+}
+
+const KernelTable kAvx2Kernels = {
+    decode_avx2, detect_changed_avx2, max_f32_avx2,
+    sum_i16_avx2, min_u64_avx2, count_flagged_avx2,
+    decode_scaled_avx2, fixed_to_float_avx2, max_i32_avx2,
+    find_changed_u16_avx2, plant_step_avx2, sanitize_f32_avx2,
+};
+
+
+// ============================================================================
+// AVX-512
+// ============================================================================
+
+STAR_TARGET_AVX512
+inline __m512i gather16(const uint8_t* base, size_t field_offset, __m512i frame_offsets) {
+    return _mm512_i32gather_epi32(frame_offsets, base + field_offset, 1);
+}
+
+STAR_TARGET_AVX512
+void decode_avx512(const uint8_t* frames, size_t count, size_t stride, const SlaveColumns& out) {
+    size_t i = 0;
+    if (count * stride <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        const __m512i frame_offsets = _mm512_mullo_epi32(
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm512_set1_epi32(static_cast<int>(stride)));
+        for (; i + 16 <= count; i += 16) {
+            const uint8_t* base = frames + i * stride;
+            //vpmovdw/vpmovdb truncate: the low bits are the field, for signed fields too
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.status_word + i),
+                                _mm512_cvtepi32_epi16(gather16(base, PdoInputLayout::status_word, frame_offsets)));
+            _mm512_storeu_si512(out.actual_position + i,
+                                gather16(base, PdoInputLayout::actual_position, frame_offsets));
+            _mm512_storeu_si512(out.actual_velocity + i,
+                                gather16(base, PdoInputLayout::actual_velocity, frame_offsets));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.actual_torque + i),
+                                _mm512_cvtepi32_epi16(gather16(base, PdoInputLayout::actual_torque, frame_offsets)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out.mode_display + i),
+                             _mm512_cvtepi32_epi8(gather16(base, PdoInputLayout::mode_display, frame_offsets)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.error_code + i),
+                                _mm512_cvtepi32_epi16(gather16(base, PdoInputLayout::error_code, frame_offsets)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out.system_status + i),
+                                _mm512_cvtepi32_epi16(gather16(base, PdoInputLayout::system_status, frame_offsets)));
+            _mm512_storeu_ps(out.motor_temperature + i,
+                             _mm512_castsi512_ps(gather16(base, PdoInputLayout::motor_temperature, frame_offsets)));
+        }
+    }
+    decode_range_scalar(frames, i, count, stride, out);
+}
+
+STAR_TARGET_AVX512
+size_t detect_changed_avx512(const uint8_t* current, const uint8_t* previous, size_t count,
+                             size_t stride, uint8_t* changed) {
+    std::memset(changed, 0, count);
+    const size_t total = count * stride;
+    size_t pos = 0;
+    while (pos + 64 <= total) {
+        __m512i a = _mm512_loadu_si512(current + pos);
+        __m512i b = _mm512_loadu_si512(previous + pos);
+        uint64_t diff = _mm512_cmpneq_epi8_mask(a, b);
+        pos = diff ? mark_changed(changed, pos + __builtin_ctzll(diff), stride) : pos + 64;
+    }
+    return detect_tail_scalar(current, previous, count, stride, changed, pos);
+}
+
+STAR_TARGET_AVX512
+float max_f32_avx512(const float* values, size_t count) {
+    __m512 acc = _mm512_set1_ps(-std::numeric_limits<float>::infinity());
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm512_max_ps(_mm512_loadu_ps(values + i), acc);
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, acc);
+    float result = max_f32_scalar(lanes, 16);
+    float tail = max_f32_scalar(values + i, count - i);
+    return tail > result ? tail : result;
+}
+
+STAR_TARGET_AVX512
+int64_t sum_i16_avx512(const int16_t* values, size_t count) {
+    const __m512i ones = _mm512_set1_epi16(1);
+    __m512i acc = _mm512_setzero_si512();
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __m512i pairs = _mm512_madd_epi16(_mm512_loadu_si512(values + i), ones);
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_castsi512_si256(pairs)));
+        acc = _mm512_add_epi64(acc, _mm512_cvtepi32_epi64(_mm512_extracti64x4_epi64(pairs, 1)));
+    }
+    return _mm512_reduce_add_epi64(acc) + sum_i16_scalar(values + i, count - i);
+}
+
+STAR_TARGET_AVX512
+uint64_t min_u64_avx512(const uint64_t* values, size_t count) {
+    __m512i acc = _mm512_set1_epi64(-1);
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8) {
+        acc = _mm512_min_epu64(acc, _mm512_loadu_si512(values + i));
+    }
+    uint64_t result = _mm512_reduce_min_epu64(acc);
+    uint64_t tail = min_u64_scalar(values + i, count - i);
+    return tail < result ? tail : result;
+}
+
+STAR_TARGET_AVX512
+size_t count_flagged_avx512(const uint16_t* values, size_t count, uint16_t mask) {
+    const __m512i m = _mm512_set1_epi16(static_cast<short>(mask));
+    size_t flagged = 0;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __mmask32 hit = _mm512_test_epi16_mask(_mm512_loadu_si512(values + i), m);
+        flagged += static_cast<size_t>(__builtin_popcount(hit));
+    }
+    return flagged + count_flagged_scalar(values + i, count - i, mask);
+}
+
+STAR_TARGET_AVX512
+void decode_scaled_avx512(const uint8_t* frames, size_t count, size_t stride, size_t field_offset,
+                          ValueEncoding encoding, int32_t* out) {
+    size_t i = 0;
+    if (field_offset + 4 <= stride &&
+        count * stride <= static_cast<size_t>(std::numeric_limits<int32_t>::max())) {
+        const __m512i frame_offsets = _mm512_mullo_epi32(
+            _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15),
+            _mm512_set1_epi32(static_cast<int>(stride)));
+        for (; i + 16 <= count; i += 16) {
+            __m512i lanes = gather16(frames + i * stride, field_offset, frame_offsets);
+            if (encoding == ValueEncoding::Int16) {
+                lanes = _mm512_srai_epi32(_mm512_slli_epi32(lanes, 16), 16);
+            } else if (encoding == ValueEncoding::UInt16) {
+                lanes = _mm512_and_si512(lanes, _mm512_set1_epi32(0xFFFF));
+            }
+            _mm512_storeu_si512(out + i, lanes);
+        }
+    }
+    decode_scaled_range_scalar(frames, i, count, stride, field_offset, encoding, out);
+}
+
+STAR_TARGET_AVX512
+void fixed_to_float_avx512(const int32_t* raw, size_t count, float scale, float offset, float* out) {
+    const __m512 s = _mm512_set1_ps(scale);
+    const __m512 o = _mm512_set1_ps(offset);
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        __m512 v = _mm512_cvtepi32_ps(_mm512_loadu_si512(raw + i));
+        _mm512_storeu_ps(out + i, _mm512_add_ps(_mm512_mul_ps(v, s), o));
+    }
+    fixed_to_float_scalar(raw + i, count - i, scale, offset, out + i);
+}
+
+STAR_TARGET_AVX512
+int32_t max_i32_avx512(const int32_t* values, size_t count) {
+    __m512i acc = _mm512_set1_epi32(std::numeric_limits<int32_t>::min());
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        acc = _mm512_max_epi32(acc, _mm512_loadu_si512(values + i));
+    }
+    int32_t result = _mm512_reduce_max_epi32(acc);
+    int32_t tail = max_i32_scalar(values + i, count - i);
+    return tail > result ? tail : result;
+}
+
+STAR_TARGET_AVX512
+size_t find_changed_u16_avx512(const uint16_t* current, const uint16_t* previous, size_t count,
+                               uint16_t* changed_index) {
+    size_t found = 0;
+    size_t i = 0;
+    for (; i + 32 <= count; i += 32) {
+        __mmask32 differ = _mm512_cmpneq_epi16_mask(_mm512_loadu_si512(current + i), _mm512_loadu_si512(previous + i));
+        while (differ != 0) {
+            changed_index[found++] = static_cast<uint16_t>(i + static_cast<size_t>(__builtin_ctz(differ)));
+            differ &= differ - 1;
+        }
+    }
+    return found + find_changed_tail_scalar(current + i, previous + i, count - i, changed_index + found, i);
+}
+
+STAR_TARGET_AVX512
+void plant_step_avx512(const PlantColumns& a, size_t begin, size_t end, double dt, size_t substeps) {
+    const __m512d step = _mm512_set1_pd(dt);
+    const __m512d zero = _mm512_setzero_pd();
+    size_t i = begin;
+    for (; i + 8 <= end; i += 8) {
+        __m512d position = _mm512_loadu_pd(a.position + i);
+        __m512d velocity = _mm512_loadu_pd(a.velocity + i);
+        __m512d torque = _mm512_loadu_pd(a.torque + i);
+        __m512d integral = _mm512_loadu_pd(a.integral + i);
+        __m512d temperature = _mm512_loadu_pd(a.temperature + i);
+        const __m512d target = _mm512_loadu_pd(a.target_position + i);
+        const __m512d velocity_reference = _mm512_loadu_pd(a.velocity_reference + i);
+        const __m512d torque_offset = _mm512_loadu_pd(a.torque_offset + i);
+        const __m512d kp = _mm512_loadu_pd(a.position_gain + i);
+        const __m512d kv = _mm512_loadu_pd(a.velocity_gain + i);
+        const __m512d ki = _mm512_loadu_pd(a.integral_gain + i);
+        const __m512d limit = _mm512_loadu_pd(a.torque_limit + i);
+        const __m512d negative_limit = _mm512_sub_pd(zero, limit);
+        const __m512d alpha = _mm512_loadu_pd(a.torque_alpha + i);
+        const __m512d accel = _mm512_loadu_pd(a.accel_per_torque + i);
+        const __m512d damping = _mm512_loadu_pd(a.damping + i);
+        const __m512d heating = _mm512_loadu_pd(a.heating + i);
+        const __m512d beta = _mm512_loadu_pd(a.thermal_beta + i);
+        const __m512d ambient = _mm512_loadu_pd(a.ambient + i);
+        for (size_t s = 0; s < substeps; ++s) {
+            __m512d error = _mm512_sub_pd(
+                _mm512_add_pd(_mm512_mul_pd(kp, _mm512_sub_pd(target, position)), velocity_reference), velocity);
+            integral = _mm512_min_pd(_mm512_max_pd(_mm512_add_pd(integral, _mm512_mul_pd(ki, error)), negative_limit), limit);
+            __m512d command = _mm512_add_pd(_mm512_add_pd(_mm512_mul_pd(kv, error), integral), torque_offset);
+            command = _mm512_min_pd(_mm512_max_pd(command, negative_limit), limit);
+            torque = _mm512_add_pd(torque, _mm512_mul_pd(_mm512_sub_pd(command, torque), alpha));
+            __m512d acceleration = _mm512_sub_pd(_mm512_mul_pd(torque, accel), _mm512_mul_pd(damping, velocity));
+            velocity = _mm512_add_pd(velocity, _mm512_mul_pd(acceleration, step));
+            position = _mm512_add_pd(position, _mm512_mul_pd(velocity, step));
+            __m512d settle = _mm512_add_pd(ambient, _mm512_mul_pd(heating, _mm512_mul_pd(torque, torque)));
+            temperature = _mm512_add_pd(temperature, _mm512_mul_pd(_mm512_sub_pd(settle, temperature), beta));
+        }
+        _mm512_storeu_pd(a.position + i, position);
+        _mm512_storeu_pd(a.velocity + i, velocity);
+        _mm512_storeu_pd(a.torque + i, torque);
+        _mm512_storeu_pd(a.integral + i, integral);
+        _mm512_storeu_pd(a.temperature + i, temperature);
+    }
+    plant_step_avx2(a, i, end, dt, substeps);
+}
+
+STAR_TARGET_AVX512
+size_t sanitize_f32_avx512(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t count,
+                           const FloatPolicy& policy) {
+    const __m512i abs_mask = _mm512_set1_epi32(static_cast<int32_t>(kFloatAbs));
+    const __m512i largest_finite = _mm512_set1_epi32(static_cast<int32_t>(kFloatExponent - 1));
+    const __m512i smallest_normal = _mm512_set1_epi32(0x00800000);
+    const __mmask16 check_denormals = policy.flush_denormals ? 0xFFFF : 0;
+    const __m512 low = _mm512_set1_ps(policy.min);
+    const __m512 high = _mm512_set1_ps(policy.max);
+    size_t replaced = 0;
+    size_t i = 0;
+    for (; i + 16 <= count; i += 16) {
+        const __m512 v = _mm512_loadu_ps(values + i);
+        const __m512i magnitude = _mm512_and_si512(_mm512_castps_si512(v), abs_mask);
+        const __mmask16 denormal = _mm512_test_epi32_mask(magnitude, magnitude) &
+                                   _mm512_cmpgt_epi32_mask(smallest_normal, magnitude);
+        const __mmask16 special = _mm512_cmpgt_epi32_mask(magnitude, largest_finite) | (denormal & check_denormals) |
+                                  _mm512_cmp_ps_mask(v, low, _CMP_LT_OQ) | _mm512_cmp_ps_mask(v, high, _CMP_GT_OQ);
+        if (special == 0) {
+            _mm512_storeu_ps(last_good + i, v);
+        } else {
+            replaced += sanitize_range_scalar(values, last_good, flags, flag, i, i + 16, policy);
+        }
+    }
+    return replaced + sanitize_range_scalar(values, last_good, flags, flag, i, count, policy);
+}
+
+const KernelTable kAvx512Kernels = {
+    decode_avx512, detect_changed_avx512, max_f32_avx512,
+    sum_i16_avx512, min_u64_avx512, count_flagged_avx512,
+    decode_scaled_avx512, fixed_to_float_avx512, max_i32_avx512,
+    find_changed_u16_avx512, plant_step_avx512, sanitize_f32_avx512,
+};
+
+#endif // STAR_X86_DISPATCH
+
+
+uint64_t pext_scalar(uint64_t value, uint64_t mask) {
+    uint64_t result = 0;
+    for (uint64_t out = 1; mask != 0; mask &= mask - 1, out <<= 1) {
+        if (value & mask & (~mask + 1)) { //lowest remaining mask bit
+            result |= out;
+        }
+    }
+    return result;
+}
+
+uint64_t pdep_scalar(uint64_t value, uint64_t mask) {
+    uint64_t result = 0;
+    for (uint64_t in = 1; mask != 0; mask &= mask - 1, in <<= 1) {
+        if (value & in) {
+            result |= mask & (~mask + 1);
+        }
+    }
+    return result;
+}
+
+#ifdef STAR_BMI2_64
+__attribute__((target("bmi2")))
+uint64_t pext_bmi2(uint64_t value, uint64_t mask) {
+    return _pext_u64(value, mask);
+}
+
+__attribute__((target("bmi2")))
+uint64_t pdep_bmi2(uint64_t value, uint64_t mask) {
+    return _pdep_u64(value, mask);
+}
+
+bool use_bmi2() {
+    return cpu_has_bmi2() && active_simd_level() >= SimdLevel::AVX2;
+}
+#endif
+
+
+const KernelTable& kernels() {
+#ifdef STAR_X86_DISPATCH
+    switch (active_simd_level()) {
+        case SimdLevel::AVX512: return kAvx512Kernels;
+        case SimdLevel::AVX2:   return kAvx2Kernels;
+        case SimdLevel::SSE42:  return kSse42Kernels;
+        case SimdLevel::Scalar: break;
+    }
+#endif
+    return kScalarKernels;
+}
+
+} // namespace
+
+
+void decode_frames(const uint8_t* frames, size_t count, size_t stride, const SlaveColumns& out) {
+    kernels().decode(frames, count, stride, out);
+}
+
+size_t detect_changed_frames(const uint8_t* current, const uint8_t* previous,
+                             size_t count, size_t stride, uint8_t* changed) {
+    return kernels().detect_changed(current, previous, count, stride, changed);
+}
+
+void decode_scaled_field(const uint8_t* frames, size_t count, size_t stride, size_t field_offset,
+                         ValueEncoding encoding, int32_t* out) {
+    if (encoding == ValueEncoding::Float32) {
+        throw std::invalid_argument("decode_scaled_field: Float32 is not a fixed-point encoding");
+    }
+    kernels().decode_scaled(frames, count, stride, field_offset, encoding, out);
+}
+
+void fixed_to_float(const int32_t* raw, size_t count, float scale, float offset, float* out) {
+    kernels().fixed_to_float(raw, count, scale, offset, out);
+}
+
+int32_t reduce_max_i32(const int32_t* values, size_t count) {
+    return kernels().max_i32(values, count);
+}
+
+float reduce_max_f32(const float* values, size_t count) {
+    return kernels().max_f32(values, count);
+}
+
+int64_t reduce_sum_i16(const int16_t* values, size_t count) {
+    return kernels().sum_i16(values, count);
+}
+
+uint64_t reduce_min_u64(const uint64_t* values, size_t count) {
+    return kernels().min_u64(values, count);
+}
+
+size_t count_flagged_u16(const uint16_t* values, size_t count, uint16_t mask) {
+    return kernels().count_flagged(values, count, mask);
+}
+
+void plant_step(const PlantColumns& axes, size_t count, double dt, size_t substeps) {
+    kernels().plant_step(axes, 0, count, dt, substeps);
+}
+
+size_t find_changed_u16(const uint16_t* current, const uint16_t* previous, size_t count, uint16_t* changed_index) {
+    return kernels().find_changed_u16(current, previous, count, changed_index);
+}
+
+size_t sanitize_f32(float* values, float* last_good, uint8_t* flags, uint8_t flag, size_t count,
+                    const FloatPolicy& policy) {
+    return kernels().sanitize_f32(values, last_good, flags, flag, count, policy);
+}
+
+uint64_t extract_bits_u64(uint64_t value, uint64_t mask) {
+#ifdef STAR_BMI2_64
+    if (use_bmi2()) {
+        return pext_bmi2(value, mask);
+    }
+#endif
+    return pext_scalar(value, mask);
+}
+
+uint64_t deposit_bits_u64(uint64_t value, uint64_t mask) {
+#ifdef STAR_BMI2_64
+    if (use_bmi2()) {
+        return pdep_bmi2(value, mask);
+    }
+#endif
+    return pdep_scalar(value, mask);
+}
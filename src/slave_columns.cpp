@@ -0,0 +1,175 @@
+/* SlaveColumnStore class:
+- sizes every column for `capacity` slots
+- carves all columns out of one allocation (MemoryRegion, on the requested NUMA node),
+each starting on a 64-byte boundary
+- hands out a SlaveColumns view for the kernels
+*/
+
+#include "slave_columns.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+
+namespace {
+
+constexpr size_t kColumnAlignment = 64;
+
+size_t align_up(size_t value) {
+    return (value + kColumnAlignment - 1) & ~(kColumnAlignment - 1);
+}
+
+//hands out consecutive aligned columns from one block
+class ColumnCarver {
+public:
+    ColumnCarver(uint8_t* base, size_t capacity) : cursor_(base), capacity_(capacity) {}
+
+    template <typename T>
+    T* next() {
+        T* column = reinterpret_cast<T*>(cursor_);
+        cursor_ += align_up(sizeof(T) * capacity_);
+        return column;
+    }
+
+private:
+    uint8_t* cursor_;
+    size_t capacity_;
+};
+
+template <typename Carver>
+void carve_columns(Carver& carver, SlaveColumns& columns) {
+    columns.status_word = carver.template next<uint16_t>();
+    columns.actual_position = carver.template next<int32_t>();
+    columns.actual_velocity = carver.template next<int32_t>();
+    columns.actual_torque = carver.template next<int16_t>();
+    columns.mode_display = carver.template next<uint8_t>();
+    columns.error_code = carver.template next<uint16_t>();
+    columns.system_status = carver.template next<uint16_t>();
+    columns.motor_temperature = carver.template next<float>();
+    columns.motor_temperature_raw = carver.template next<int32_t>();
+    columns.timestamp = carver.template next<uint64_t>();
+    columns.slave_position = carver.template next<uint16_t>();
+    columns.data_valid = carver.template next<uint8_t>();
+    columns.restored = carver.template next<uint8_t>();
+    columns.invalid_fields = carver.template next<uint8_t>();
+    columns.deferred = carver.template next<uint8_t>();
+}
+
+//sizing pass: same carving order, counts bytes instead of handing out pointers
+class ColumnSizer {
+public:
+    explicit ColumnSizer(size_t capacity) : capacity_(capacity) {}
+
+    template <typename T>
+    T* next() {
+        bytes_ += align_up(sizeof(T) * capacity_);
+        return nullptr;
+    }
+
+    size_t bytes() const { return bytes_; }
+
+private:
+    size_t capacity_;
+    size_t bytes_ = 0;
+};
+
+} // namespace
+
+
+SlaveColumnStore::SlaveColumnStore(size_t capacity, int numa_node, PagePolicy pages) {
+    ColumnSizer sizer(capacity);
+    SlaveColumns unused;
+    carve_columns(sizer, unused);
+
+    //MemoryRegion is zero-filled and 64-byte aligned, so the first column starts at the base
+    storage_ = MemoryRegion(sizer.bytes(), numa_node, pages);
+
+    ColumnCarver carver(storage_.data(), capacity);
+    carve_columns(carver, columns_);
+    columns_.capacity = capacity;
+}
+
+
+void store_slave(const SlaveColumns& columns, size_t slot, const SlaveRealTimeData& data) {
+    columns.status_word[slot] = data.status_word;
+    columns.actual_position[slot] = data.actual_position;
+    columns.actual_velocity[slot] = data.actual_velocity;
+    columns.actual_torque[slot] = data.actual_torque;
+    columns.mode_display[slot] = data.mode_display;
+    columns.error_code[slot] = data.error_code;
+    columns.system_status[slot] = data.system_status;
+    columns.motor_temperature[slot] = data.motor_temperature;
+    columns.timestamp[slot] = data.timestamp;
+    columns.slave_position[slot] = data.slave_position;
+    columns.data_valid[slot] = data.data_valid ? 1 : 0;
+    columns.restored[slot] = data.restored ? 1 : 0;
+    columns.invalid_fields[slot] = data.invalid_fields;
+    columns.deferred[slot] = data.deferred ? 1 : 0;
+}
+
+SlaveRealTimeData load_slave(const SlaveColumns& columns, size_t slot) {
+    SlaveRealTimeData data;
+    data.status_word = columns.status_word[slot];
+    data.actual_position = columns.actual_position[slot];
+    data.actual_velocity = columns.actual_velocity[slot];
+    data.actual_torque = columns.actual_torque[slot];
+    data.mode_display = columns.mode_display[slot];
+    data.error_code = columns.error_code[slot];
+    data.system_status = columns.system_status[slot];
+    data.motor_temperature = columns.motor_temperature[slot];
+    data.timestamp = columns.timestamp[slot];
+    data.slave_position = columns.slave_position[slot];
+    data.data_valid = columns.data_valid[slot] != 0;
+    data.restored = columns.restored[slot] != 0;
+    data.invalid_fields = columns.invalid_fields[slot];
+    data.deferred = columns.deferred[slot] != 0;
+    return data;
+}
+
+namespace {
+
+template <typename T>
+void copy_column(const T* from, T* to, size_t count) {
+    std::memcpy(to, from, count * sizeof(T));
+}
+
+} // namespace
+
+void copy_columns(const SlaveColumns& from, const SlaveColumns& to, size_t count) {
+    copy_column(from.status_word, to.status_word, count);
+    copy_column(from.actual_position, to.actual_position, count);
+    copy_column(from.actual_velocity, to.actual_velocity, count);
+    copy_column(from.actual_torque, to.actual_torque, count);
+    copy_column(from.mode_display, to.mode_display, count);
+    copy_column(from.error_code, to.error_code, count);
+    copy_column(from.system_status, to.system_status, count);
+    copy_column(from.motor_temperature, to.motor_temperature, count);
+    copy_column(from.motor_temperature_raw, to.motor_temperature_raw, count);
+    copy_column(from.timestamp, to.timestamp, count);
+    copy_column(from.slave_position, to.slave_position, count);
+    copy_column(from.data_valid, to.data_valid, count);
+    copy_column(from.restored, to.restored, count);
+    copy_column(from.invalid_fields, to.invalid_fields, count);
+    copy_column(from.deferred, to.deferred, count);
+}
+
+SlaveColumns columns_from(const SlaveColumns& columns, size_t first_slot) {
+    SlaveColumns view;
+    view.status_word = columns.status_word + first_slot;
+    view.actual_position = columns.actual_position + first_slot;
+    view.actual_velocity = columns.actual_velocity + first_slot;
+    view.actual_torque = columns.actual_torque + first_slot;
+    view.mode_display = columns.mode_display + first_slot;
+    view.error_code = columns.error_code + first_slot;
+    view.system_status = columns.system_status + first_slot;
+    view.motor_temperature = columns.motor_temperature + first_slot;
+    view.motor_temperature_raw = columns.motor_temperature_raw + first_slot;
+    view.timestamp = columns.timestamp + first_slot;
+    view.slave_position = columns.slave_position + first_slot;
+    view.data_valid = columns.data_valid + first_slot;
+    view.restored = columns.restored + first_slot;
+    view.invalid_fields = columns.invalid_fields + first_slot;
+    view.deferred = columns.deferred + first_slot;
+    view.capacity = first_slot < columns.capacity ? columns.capacity - first_slot : 0;
+    return view;
+}
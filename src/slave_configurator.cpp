@@ -0,0 +1,254 @@
+/* SlaveConfigurator class:
+- two phases over all slaves: identity (one upload each), then writes (the
+configurations that changed); every slave's identity read, and then the first write
+of every slave's chain, is submitted before waiting on any of them
+- a chain submits its next write from the callback of the previous one, on the
+engine's polling thread (or in the poll() that wait() drives)
+- results are collected in submission order; the engine keeps one mailbox request
+per slave in flight, so waiting on slave 1 does not hold back slave 2
+*/
+
+#include "slave_configurator.hpp"
+
+#include <array>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+
+namespace {
+
+constexpr uint16_t kIdentityObject = 0x1018;
+constexpr uint8_t kSerialNumber = 4;
+
+std::vector<uint8_t> le_bytes(uint32_t value, size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; ++i) {
+        bytes[i] = static_cast<uint8_t>(value >> (8 * i));
+    }
+    return bytes;
+}
+
+uint64_t fnv1a(uint64_t hash, uint8_t byte) {
+    return (hash ^ byte) * 0x100000001B3ull;
+}
+
+} // namespace
+
+
+std::vector<SdoWrite> pdo_mapping_writes(uint16_t assign_index, uint16_t pdo_index, const uint32_t* entries,
+                                         size_t count){
+    std::vector<SdoWrite> writes;
+    writes.push_back({assign_index, 0, {0}});
+    writes.push_back({pdo_index, 0, {0}});
+    for (size_t i = 0; i < count; ++i) {
+        writes.push_back({pdo_index, static_cast<uint8_t>(i + 1), le_bytes(entries[i], 4)});
+    }
+    writes.push_back({pdo_index, 0, {static_cast<uint8_t>(count)}});
+    writes.push_back({assign_index, 1, le_bytes(pdo_index, 2)});
+    writes.push_back({assign_index, 0, {1}});
+    return writes;
+}
+
+std::vector<SdoWrite> standard_pdo_mapping(){
+    std::vector<SdoWrite> writes =
+        pdo_mapping_writes(0x1C12, 0x1600, kRxPdoMappingEntries.data(), kRxPdoMappingEntries.size());
+    std::vector<SdoWrite> inputs =
+        pdo_mapping_writes(0x1C13, 0x1A00, kTxPdoMappingEntries.data(), kTxPdoMappingEntries.size());
+    writes.insert(writes.end(), inputs.begin(), inputs.end());
+    return writes;
+}
+
+uint64_t configuration_hash(const SlaveConfiguration& configuration){
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (const SdoWrite& write : configuration.writes) {
+        hash = fnv1a(hash, static_cast<uint8_t>(write.index));
+        hash = fnv1a(hash, static_cast<uint8_t>(write.index >> 8));
+        hash = fnv1a(hash, write.subindex);
+        const uint32_t length = static_cast<uint32_t>(write.value.size());
+        for (int shift = 0; shift < 32; shift += 8) {
+            hash = fnv1a(hash, static_cast<uint8_t>(length >> shift));
+        }
+        for (uint8_t byte : write.value) {
+            hash = fnv1a(hash, byte);
+        }
+    }
+    return hash;
+}
+
+
+bool ConfigCache::matches(uint8_t slave_id, uint32_t serial, uint64_t hash) const {
+    auto it = entries_.find(slave_id);
+    return it != entries_.end() && it->second.serial == serial && it->second.hash == hash;
+}
+
+//one slave per line: id serial hash (hex)
+void ConfigCache::load(const std::string& path){
+    std::ifstream in(path);
+    entries_.clear();
+    if (!in) {
+        return;
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) {
+            continue;
+        }
+        std::istringstream fields(line);
+        unsigned id = 0;
+        uint32_t serial = 0;
+        uint64_t hash = 0;
+        if (!(fields >> std::hex >> id >> serial >> hash) || id >= kMaxSlaves) {
+            throw std::invalid_argument("ConfigCache: malformed line in " + path);
+        }
+        entries_[static_cast<uint8_t>(id)] = Entry{serial, hash};
+    }
+}
+
+void ConfigCache::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::trunc);
+    for (const auto& entry : entries_) {
+        out << std::hex << unsigned{entry.first} << ' ' << entry.second.serial << ' ' << entry.second.hash << '\n';
+    }
+    if (!out) {
+        throw std::runtime_error("ConfigCache: cannot write " + path);
+    }
+}
+
+
+//one slave's writes; written by the callbacks, read once `finished` is ready
+struct SlaveConfigurator::WriteChain {
+    uint8_t slave_id = 0;
+    const std::vector<SdoWrite>* writes = nullptr; //configure() outlives the chain
+    size_t sent = 0;
+    SdoResult failure;                           //status Ok: every write succeeded
+    std::promise<void> finished;
+};
+
+SlaveConfigurator::SlaveConfigurator(SdoEngine& engine, ConfigCache& cache)
+    : engine_(engine)
+    , cache_(cache)
+{
+}
+
+void SlaveConfigurator::write_next(const std::shared_ptr<WriteChain>& chain){
+    if (chain->sent == chain->writes->size()) {
+        chain->finished.set_value();
+        return;
+    }
+    const SdoWrite& write = (*chain->writes)[chain->sent++];
+    engine_.download(chain->slave_id, write.index, write.subindex, write.value,
+                     [this, chain](uint8_t, const SdoResult& result) {
+                         if (result.status != SdoStatus::Ok) {
+                             chain->failure = result;
+                             chain->finished.set_value();
+                             return;
+                         }
+                         write_next(chain);
+                     });
+}
+
+template <typename T>
+void SlaveConfigurator::wait(std::future<T>& future){
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        if (engine_.running()) {
+            future.wait();
+            return;
+        }
+        if (engine_.poll() == 0) {
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+    }
+}
+
+ConfigureReport SlaveConfigurator::configure(const std::vector<SlaveConfiguration>& slaves){
+    std::array<bool, kMaxSlaves> listed{};
+    for (const SlaveConfiguration& slave : slaves) {
+        if (listed[slave.slave_id]) {
+            throw std::invalid_argument("SlaveConfigurator: slave listed twice");
+        }
+        listed[slave.slave_id] = true;
+    }
+
+    const auto started = std::chrono::steady_clock::now();
+    ConfigureReport report;
+    report.slaves.resize(slaves.size());
+
+    //identity of every slave in one round
+    std::vector<std::future<SdoResult>> serials;
+    serials.reserve(slaves.size());
+    for (const SlaveConfiguration& slave : slaves) {
+        serials.push_back(engine_.upload(slave.slave_id, kIdentityObject, kSerialNumber));
+    }
+
+    //then the writes of every slave whose configuration changed
+    std::vector<uint32_t> serial_of(slaves.size(), 0);
+    std::vector<uint64_t> hash_of(slaves.size(), 0);
+    std::vector<std::shared_ptr<WriteChain>> chains(slaves.size());
+    std::vector<std::future<void>> finished(slaves.size());
+    for (size_t s = 0; s < slaves.size(); ++s) {
+        SlaveConfigResult& result = report.slaves[s];
+        result.slave_id = slaves[s].slave_id;
+
+        wait(serials[s]);
+        const SdoResult identity = serials[s].get();
+        if (identity.status != SdoStatus::Ok || identity.data.size() < 4) {
+            result.outcome = SlaveConfigResult::Outcome::Failed;
+            result.status = identity.status;
+            result.abort_code = identity.abort_code;
+            result.index = kIdentityObject;
+            result.subindex = kSerialNumber;
+            cache_.forget(result.slave_id);
+            continue;
+        }
+        serial_of[s] = load_le<uint32_t>(identity.data.data());
+        hash_of[s] = configuration_hash(slaves[s]);
+        if (cache_.matches(result.slave_id, serial_of[s], hash_of[s])) {
+            result.outcome = SlaveConfigResult::Outcome::Skipped;
+            continue;
+        }
+
+        result.outcome = SlaveConfigResult::Outcome::Configured;
+        chains[s] = std::make_shared<WriteChain>();
+        chains[s]->slave_id = result.slave_id;
+        chains[s]->writes = &slaves[s].writes;
+        finished[s] = chains[s]->finished.get_future();
+        write_next(chains[s]);
+    }
+
+    for (size_t s = 0; s < slaves.size(); ++s) {
+        SlaveConfigResult& result = report.slaves[s];
+        if (chains[s]) {
+            wait(finished[s]);
+            const WriteChain& chain = *chains[s];
+            report.writes += chain.sent;
+            if (chain.failure.status != SdoStatus::Ok) {
+                const SdoWrite& failed = (*chain.writes)[chain.sent - 1];
+                result.outcome = SlaveConfigResult::Outcome::Failed;
+                result.status = chain.failure.status;
+                result.abort_code = chain.failure.abort_code;
+                result.index = failed.index;
+                result.subindex = failed.subindex;
+            }
+        }
+
+        switch (result.outcome) {
+        case SlaveConfigResult::Outcome::Configured:
+            cache_.store(result.slave_id, ConfigCache::Entry{serial_of[s], hash_of[s]});
+            ++report.configured;
+            break;
+        case SlaveConfigResult::Outcome::Skipped:
+            ++report.skipped;
+            break;
+        case SlaveConfigResult::Outcome::Failed:
+            cache_.forget(result.slave_id);
+            ++report.failed;
+            break;
+        }
+    }
+
+    report.elapsed = std::chrono::steady_clock::now() - started;
+    return report;
+}
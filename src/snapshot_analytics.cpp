@@ -0,0 +1,68 @@
+#include "snapshot_analytics.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+
+SnapshotAnalytics::SnapshotAnalytics(TaskPool& pool, const StarManager& manager)
+    : pool_(pool)
+    , manager_(manager)
+{
+}
+
+void SnapshotAnalytics::add_cycle_job(const std::string& name, CycleJob job, uint32_t every_n_cycles) {
+    if (every_n_cycles == 0 || !job) {
+        throw std::invalid_argument("cycle job needs a function and every_n_cycles > 0");
+    }
+    jobs_.push_back(std::make_shared<const Job>(
+        Job{pool_.register_kind(name), every_n_cycles, {}, std::move(job), nullptr}));
+    last_run_.push_back(0);
+}
+
+void SnapshotAnalytics::add_group_job(const std::string& name, std::vector<uint8_t> slave_ids, GroupJob job,
+                                      uint32_t every_n_cycles) {
+    if (every_n_cycles == 0 || !job || slave_ids.empty()) {
+        throw std::invalid_argument("group job needs a function, slaves and every_n_cycles > 0");
+    }
+    jobs_.push_back(std::make_shared<const Job>(
+        Job{pool_.register_kind(name), every_n_cycles, std::move(slave_ids), nullptr, std::move(job)}));
+    last_run_.push_back(0);
+}
+
+
+size_t SnapshotAnalytics::poll() {
+    const uint64_t committed = manager_.committedCycle();
+    if (committed == last_cycle_) {
+        return 0;
+    }
+
+    //one copy per commit, shared by every job of this cycle
+    auto snapshot = std::make_shared<StarSnapshot>();
+    manager_.readSnapshot(*snapshot);
+    if (snapshot->cycle <= last_cycle_) {
+        return 0;
+    }
+    if (last_cycle_ != 0) {
+        skipped_cycles_ += snapshot->cycle - last_cycle_ - 1;
+    }
+    last_cycle_ = snapshot->cycle;
+
+    std::shared_ptr<const StarSnapshot> shared = std::move(snapshot);
+    size_t spawned = 0;
+    for (size_t j = 0; j < jobs_.size(); ++j) {
+        const std::shared_ptr<const Job>& job = jobs_[j];
+        if (shared->cycle < last_run_[j] + job->every_n_cycles) {
+            continue;
+        }
+        last_run_[j] = shared->cycle;
+        pool_.submit(job->kind, [shared, job] {
+            if (job->cycle_job) {
+                job->cycle_job(*shared);
+            } else {
+                job->group_job(*shared, job->slave_ids);
+            }
+        });
+        ++spawned;
+    }
+    return spawned;
+}
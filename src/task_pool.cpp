@@ -0,0 +1,198 @@
+#include "task_pool.hpp"
+#include "thread_affinity.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+namespace {
+
+//set on worker threads: submit() from a task goes to the worker's own deque
+thread_local const TaskPool* t_pool = nullptr;
+thread_local size_t t_worker = 0;
+
+uint64_t elapsed_ns(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return to > from ? std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count() : 0;
+}
+
+} // namespace
+
+
+TaskPool::TaskPool(std::vector<int> cores, size_t workers)
+    : cores_(std::move(cores))
+{
+    if (cores_.empty()) {
+        throw std::invalid_argument("TaskPool without a core to pin to (TaskPool::Unpinned for unpinned workers)");
+    }
+    for (int core : cores_) {
+        if (core < 0) {
+            throw std::invalid_argument("TaskPool core must not be negative");
+        }
+    }
+    start_workers(workers == 0 ? cores_.size() : workers);
+}
+
+TaskPool::TaskPool(Unpinned, size_t workers) {
+    start_workers(std::max<size_t>(workers, 1));
+}
+
+void TaskPool::start_workers(size_t workers) {
+    workers_.reserve(workers);
+    for (size_t i = 0; i < workers; ++i) {
+        workers_.push_back(std::make_unique<Worker>());
+    }
+    for (size_t i = 0; i < workers; ++i) {
+        workers_[i]->thread = std::thread(&TaskPool::worker_loop, this, i);
+    }
+}
+
+TaskPool::~TaskPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& worker : workers_) {
+        worker->thread.join();
+    }
+}
+
+
+TaskKind TaskPool::register_kind(const std::string& name) {
+    std::lock_guard<std::mutex> lock(kinds_mutex_);
+    for (size_t i = 0; i < kinds_.size(); ++i) {
+        if (kinds_[i] == name) {
+            return static_cast<TaskKind>(i);
+        }
+    }
+    if (kinds_.size() == kMaxTaskKinds) {
+        throw std::length_error("TaskPool: too many task kinds");
+    }
+    kinds_.push_back(name);
+    return static_cast<TaskKind>(kinds_.size() - 1);
+}
+
+
+void TaskPool::submit(TaskKind kind, Task task) {
+    {
+        std::lock_guard<std::mutex> lock(kinds_mutex_);
+        if (kind >= kinds_.size()) {
+            throw std::out_of_range("TaskPool: unknown task kind");
+        }
+    }
+
+    //own deque from a worker, round robin from everywhere else
+    size_t target = t_pool == this ? t_worker
+                                   : next_worker_.fetch_add(1, std::memory_order_relaxed) % workers_.size();
+
+    pending_.fetch_add(1);
+    {
+        Worker& worker = *workers_[target];
+        std::lock_guard<std::mutex> lock(worker.mutex);
+        queued_.fetch_add(1); //before the push, so a thief never takes the count below zero
+        worker.deque.push_back(Item{std::move(task), kind, std::chrono::steady_clock::now()});
+    }
+
+    //empty critical section: a worker between its check and wait() cannot miss this
+    { std::lock_guard<std::mutex> lock(sleep_mutex_); }
+    wake_.notify_one();
+}
+
+
+void TaskPool::wait_idle() {
+    std::unique_lock<std::mutex> lock(sleep_mutex_);
+    idle_.wait(lock, [&] { return pending_.load() == 0; });
+}
+
+
+TaskKindStats TaskPool::stats(TaskKind kind) const {
+    TaskKindStats stats;
+    {
+        std::lock_guard<std::mutex> lock(kinds_mutex_);
+        stats.name = kinds_.at(kind);
+    }
+    std::vector<const TimingMetrics*> queue_wait;
+    std::vector<const TimingMetrics*> run_time;
+    for (const auto& worker : workers_) {
+        queue_wait.push_back(&worker->queue_wait[kind]);
+        run_time.push_back(&worker->run_time[kind]);
+        stats.failed += worker->failed[kind].load(std::memory_order_relaxed);
+    }
+    stats.queue_wait = TimingMetrics::merged(queue_wait);
+    stats.run_time = TimingMetrics::merged(run_time);
+    return stats;
+}
+
+
+bool TaskPool::pop_local(size_t index, Item& item) {
+    Worker& worker = *workers_[index];
+    std::lock_guard<std::mutex> lock(worker.mutex);
+    if (worker.deque.empty()) {
+        return false;
+    }
+    item = std::move(worker.deque.back());
+    worker.deque.pop_back();
+    return true;
+}
+
+bool TaskPool::steal(size_t thief, Item& item) {
+    //start after the thief so victims are spread instead of all hitting worker 0
+    for (size_t offset = 1; offset < workers_.size(); ++offset) {
+        Worker& victim = *workers_[(thief + offset) % workers_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.deque.empty()) {
+            item = std::move(victim.deque.front());
+            victim.deque.pop_front();
+            stolen_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TaskPool::run(size_t index, Item& item) {
+    Worker& worker = *workers_[index];
+    auto started = std::chrono::steady_clock::now();
+    worker.queue_wait[item.kind].record(elapsed_ns(item.submitted, started));
+
+    try {
+        item.task();
+    } catch (...) {
+        auto& failed = worker.failed[item.kind];
+        failed.store(failed.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+    }
+
+    worker.run_time[item.kind].record(elapsed_ns(started, std::chrono::steady_clock::now()));
+    item.task = nullptr; //captured state (e.g. a snapshot) is released before the task counts as done
+    completed_.fetch_add(1, std::memory_order_relaxed);
+
+    if (pending_.fetch_sub(1) == 1) {
+        std::lock_guard<std::mutex> lock(sleep_mutex_);
+        idle_.notify_all();
+    }
+}
+
+
+void TaskPool::worker_loop(size_t index) {
+    t_pool = this;
+    t_worker = index;
+    if (!cores_.empty()) {
+        pin_current_thread(cores_[index % cores_.size()]);
+    }
+
+    Item item;
+    for (;;) {
+        if (pop_local(index, item) || steal(index, item)) {
+            queued_.fetch_sub(1);
+            run(index, item);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex_);
+        if (stopping_ && queued_.load() == 0) {
+            return;
+        }
+        wake_.wait(lock, [&] { return stopping_ || queued_.load() > 0; });
+    }
+}
@@ -0,0 +1,72 @@
+#include "thread_affinity.hpp"
+
+#include <algorithm>
+#include <thread>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+
+bool pin_current_thread(int core) {
+#ifdef __linux__
+    if (core < 0 || core >= CPU_SETSIZE) {
+        return false;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)core;
+    return false;
+#endif
+}
+
+bool pin_current_thread(const std::vector<int>& cores) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    bool any = false;
+    for (int core : cores) {
+        if (core >= 0 && core < CPU_SETSIZE) {
+            CPU_SET(core, &set);
+            any = true;
+        }
+    }
+    return any && pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+#else
+    (void)cores;
+    return false;
+#endif
+}
+
+std::vector<int> allowed_cores() {
+    std::vector<int> cores;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int core = 0; core < CPU_SETSIZE; ++core) {
+            if (CPU_ISSET(core, &set)) {
+                cores.push_back(core);
+            }
+        }
+        return cores;
+    }
+#endif
+    unsigned count = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned core = 0; core < count; ++core) {
+        cores.push_back(static_cast<int>(core));
+    }
+    return cores;
+}
+
+std::vector<int> non_rt_cores(const std::vector<int>& rt_cores) {
+    std::vector<int> cores = allowed_cores();
+    cores.erase(std::remove_if(cores.begin(), cores.end(), [&](int core) {
+        return std::find(rt_cores.begin(), rt_cores.end(), core) != rt_cores.end();
+    }), cores.end());
+    return cores;
+}
@@ -0,0 +1,105 @@
+#include "timing_metrics.hpp"
+
+#include <algorithm>
+
+
+namespace {
+
+//single writer: read-modify-write without a locked instruction
+void bump(std::atomic<uint64_t>& counter, uint64_t amount) {
+    counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+} // namespace
+
+
+size_t TimingMetrics::bucket_of(uint64_t ns) {
+    size_t bucket = 0;
+    while (ns != 0 && bucket < kBuckets - 1) {
+        ns >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+void TimingMetrics::record(uint64_t ns) {
+    bump(buckets_[bucket_of(ns)], 1);
+    bump(total_ns_, ns);
+    if (ns < min_ns_.load(std::memory_order_relaxed)) {
+        min_ns_.store(ns, std::memory_order_relaxed);
+    }
+    if (ns > max_ns_.load(std::memory_order_relaxed)) {
+        max_ns_.store(ns, std::memory_order_relaxed);
+    }
+    //last, so a reader that sees the count also sees the sample's bucket
+    count_.store(count_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+TimingMetrics::Histogram TimingMetrics::histogram() const {
+    Histogram histogram{};
+    for (size_t b = 0; b < kBuckets; ++b) {
+        histogram[b] = buckets_[b].load(std::memory_order_relaxed);
+    }
+    return histogram;
+}
+
+uint64_t TimingMetrics::percentile(const Histogram& histogram, uint64_t per_mille) {
+    uint64_t total = 0;
+    for (uint64_t n : histogram) {
+        total += n;
+    }
+    const uint64_t rank = (total * per_mille + 999) / 1000;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < kBuckets; ++b) {
+        seen += histogram[b];
+        if (seen >= rank && seen != 0) {
+            return b == 0 ? 0 : (uint64_t{1} << b) - 1;
+        }
+    }
+    return 0;
+}
+
+TimingSummary TimingMetrics::summary() const {
+    return merged({this});
+}
+
+TimingSummary TimingMetrics::merged(const std::vector<const TimingMetrics*>& parts) {
+    TimingSummary s;
+    uint64_t total_ns = 0;
+    uint64_t min_ns = UINT64_MAX;
+    Histogram histogram{};
+
+    for (const TimingMetrics* part : parts) {
+        uint64_t count = part->count_.load(std::memory_order_acquire);
+        if (count == 0) {
+            continue;
+        }
+        s.count += count;
+        total_ns += part->total_ns_.load(std::memory_order_relaxed);
+        min_ns = std::min(min_ns, part->min_ns_.load(std::memory_order_relaxed));
+        s.max_ns = std::max(s.max_ns, part->max_ns_.load(std::memory_order_relaxed));
+        for (size_t b = 0; b < kBuckets; ++b) {
+            histogram[b] += part->buckets_[b].load(std::memory_order_relaxed);
+        }
+    }
+    if (s.count == 0) {
+        return s;
+    }
+    s.min_ns = min_ns;
+    s.mean_ns = static_cast<double>(total_ns) / static_cast<double>(s.count);
+
+    //rank over the histogram itself: it may hold samples newer than `count`
+    s.p50_ns = std::min(percentile(histogram, 500), s.max_ns);
+    s.p99_ns = std::min(percentile(histogram, 990), s.max_ns);
+    return s;
+}
+
+void TimingMetrics::reset() {
+    count_.store(0, std::memory_order_relaxed);
+    total_ns_.store(0, std::memory_order_relaxed);
+    min_ns_.store(UINT64_MAX, std::memory_order_relaxed);
+    max_ns_.store(0, std::memory_order_relaxed);
+    for (auto& bucket : buckets_) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+}
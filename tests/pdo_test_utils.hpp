@@ -0,0 +1,52 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include "data_structuring.hpp"
+#include "slaves_state_struct.hpp"
+
+// ============================================================================
+// MOCK DATA GENERATION: shared by all test files
+// ============================================================================
+
+/**
+ * @brief Generate a complete PDO buffer matching the EtherCAT protocol layout
+ * This simulates the raw byte stream that would come from the EtherCAT kernel module.
+ * Uses the library encoder (WriteState), which is generated from the same
+ * TxPdoLayout as ReadState::parse
+ * 
+ * @param status_word CiA402 status word (0x6041)
+ * @param actual_position Current position in encoder counts (0x6064)
+ * @param actual_velocity Current velocity in counts/sec (0x606C)
+ * @param actual_torque Current torque/effort (0x6077)
+ * @param mode_display Active operation mode (0x6061)
+ * @param error_code Custom error code from slave firmware
+ * @param system_status Custom system status flags
+ * @param motor_temperature Motor temperature in Celsius
+ * @return std::vector<uint8_t> Complete PDO buffer in protocol byte order (21 bytes)
+ */
+inline std::vector<uint8_t> generate_pdo_buffer(
+    uint16_t status_word,
+    int32_t actual_position,
+    int32_t actual_velocity,
+    int16_t actual_torque,
+    uint8_t mode_display,
+    uint16_t error_code,
+    uint16_t system_status,
+    float motor_temperature
+) {
+    SlaveRealTimeData data{};
+    data.status_word = status_word;
+    data.actual_position = actual_position;
+    data.actual_velocity = actual_velocity;
+    data.actual_torque = actual_torque;
+    data.mode_display = mode_display;
+    data.error_code = error_code;
+    data.system_status = system_status;
+    data.motor_temperature = motor_temperature;
+
+    std::vector<uint8_t> buffer(PdoInputLayout::size);
+    WriteState encoder;
+    encoder.encode(data, buffer);
+    return buffer;
+}
@@ -0,0 +1,301 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <chrono>
+#include <cstdint>
+#include "Ethercat_Hardware_Interface.hpp"
+#include "device_events.hpp"
+#include "error_catalogue.hpp"
+#include "load_generator.hpp"
+#include "data_structuring.hpp"
+#include "slaves_state_struct.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+class EthercatHardwareInterfaceTest : public ::testing::Test {
+protected:
+    // slave ids in bus order; deliberately not 0..n-1
+    std::vector<uint8_t> slaves_order_ = {7, 3, 12, 0};
+    Ethercat_Hardware_Interface hw_{slaves_order_};
+};
+
+// ============================================================================
+// TEST CASE 1: Input Image is Routed to the Right Slaves
+// ============================================================================
+
+TEST_F(EthercatHardwareInterfaceTest, ReadKernelRoutesFramesBySlavesOrder) {
+    LoadGenerator generator(slaves_order_.size());
+    std::vector<uint8_t> image(hw_.input_image_size());
+
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        generator.next_cycle(image);
+        hw_.read_kernel(image);
+    }
+
+    for (size_t i = 0; i < slaves_order_.size(); ++i) {
+        SlaveRealTimeData data = hw_.star_manager().getSlaveData(slaves_order_[i]);
+        EXPECT_EQ(data.actual_position, generator.slave(i).actual_position);
+        EXPECT_EQ(data.actual_torque, generator.slave(i).actual_torque);
+        EXPECT_FLOAT_EQ(data.motor_temperature, generator.slave(i).motor_temperature);
+        EXPECT_EQ(data.slave_position, slaves_order_[i]);
+        EXPECT_TRUE(data.data_valid);
+    }
+}
+
+// ============================================================================
+// TEST CASE 2: Output Image is Encoded from Commands
+// ============================================================================
+
+TEST_F(EthercatHardwareInterfaceTest, WriteKernelEncodesCommands) {
+    hw_.setCommand(12, SlaveCommandData{0x000F, 5000, -20, 300, 0x08});
+    hw_.setCommand(7, SlaveCommandData{0x0006, -1, 0, 0, 0x09});
+
+    std::vector<uint8_t> image(hw_.output_image_size(), 0xAA);
+    hw_.write_kernel(image);
+
+    ReadState parser;
+    SlaveCommandData slave7 = parser.parse_command(image.data() + 0 * PdoOutputLayout::size, PdoOutputLayout::size);
+    SlaveCommandData slave3 = parser.parse_command(image.data() + 1 * PdoOutputLayout::size, PdoOutputLayout::size);
+    SlaveCommandData slave12 = parser.parse_command(image.data() + 2 * PdoOutputLayout::size, PdoOutputLayout::size);
+
+    EXPECT_EQ(slave7.control_word, 0x0006);
+    EXPECT_EQ(slave7.target_position, -1);
+    EXPECT_EQ(slave7.mode_of_operation, 0x09);
+
+    EXPECT_EQ(slave12.control_word, 0x000F);
+    EXPECT_EQ(slave12.target_position, 5000);
+    EXPECT_EQ(slave12.target_velocity, -20);
+    EXPECT_EQ(slave12.target_torque, 300);
+
+    // no command yet: all-zero frame (control word 0 = disable voltage)
+    EXPECT_EQ(slave3.control_word, 0);
+    EXPECT_EQ(slave3.target_position, 0);
+}
+
+// ============================================================================
+// TEST CASE 3: Image Size Checks
+// ============================================================================
+
+TEST_F(EthercatHardwareInterfaceTest, RejectsShortProcessImages) {
+    EXPECT_EQ(hw_.input_image_size(), slaves_order_.size() * PdoInputLayout::size);
+    EXPECT_EQ(hw_.output_image_size(), slaves_order_.size() * PdoOutputLayout::size);
+
+    std::vector<uint8_t> short_input(hw_.input_image_size() - 1);
+    std::vector<uint8_t> short_output(hw_.output_image_size() - 1);
+    EXPECT_THROW(hw_.read_kernel(short_input), std::out_of_range);
+    EXPECT_THROW(hw_.write_kernel(short_output), std::out_of_range);
+}
+
+// ============================================================================
+// TEST CASE 4: Priority Classes and Decode Budget
+// ============================================================================
+
+TEST_F(EthercatHardwareInterfaceTest, DefersLowerClassesWhenBudgetIsSpent) {
+    EXPECT_THROW(hw_.setPriorities({SlavePriority::Safety}), std::invalid_argument);
+    hw_.setPriorities({SlavePriority::Safety, SlavePriority::Diagnostics,
+                       SlavePriority::Motion, SlavePriority::Diagnostics});
+    EXPECT_EQ(hw_.priority(1), SlavePriority::Diagnostics);
+    hw_.setDecodeBudget(std::chrono::nanoseconds(1)); // spent as soon as Safety is done
+
+    LoadGenerator generator(slaves_order_.size());
+    std::vector<uint8_t> image(hw_.input_image_size());
+    std::vector<std::vector<SlaveRealTimeData>> sent;
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        generator.next_cycle(image);
+        sent.push_back({});
+        for (size_t i = 0; i < slaves_order_.size(); ++i) {
+            sent.back().push_back(generator.slave(i));
+        }
+        hw_.read_kernel(image);
+
+        if (cycle == 0) {
+            EXPECT_NO_THROW(hw_.star_manager().getSlaveData(7));
+            EXPECT_THROW(hw_.star_manager().getSlaveData(3), std::out_of_range); // deferred
+        }
+    }
+
+    // cycles 1 and 3 deferred Motion and Diagnostics, cycle 2 caught up on them
+    EXPECT_EQ(hw_.star_manager().committedCycle(), 3u);
+    EXPECT_EQ(hw_.deferrals(SlavePriority::Safety), 0u);
+    EXPECT_EQ(hw_.deferrals(SlavePriority::Motion), 2u);
+    EXPECT_EQ(hw_.deferrals(SlavePriority::Diagnostics), 2u);
+    EXPECT_EQ(hw_.deferred_frames(), 6u);
+
+    StarManager& manager = hw_.star_manager();
+    EXPECT_EQ(manager.getSlaveData(7).actual_position, sent[2][0].actual_position);
+    for (size_t i = 1; i < slaves_order_.size(); ++i) {
+        EXPECT_EQ(manager.getSlaveData(slaves_order_[i]).actual_position, sent[1][i].actual_position);
+    }
+
+    // readers see which slaves hold last cycle's values
+    StarSnapshot snapshot;
+    manager.readSnapshot(snapshot);
+    EXPECT_FALSE(snapshot.getSlaveData(7).deferred);
+    for (size_t i = 1; i < slaves_order_.size(); ++i) {
+        EXPECT_TRUE(snapshot.getSlaveData(slaves_order_[i]).deferred);
+    }
+    EXPECT_EQ(snapshot.aggregates.deferred, slaves_order_.size() - 1);
+
+    // no budget: every class, every cycle
+    hw_.setDecodeBudget(std::chrono::nanoseconds(0));
+    generator.next_cycle(image);
+    hw_.read_kernel(image);
+    for (size_t i = 0; i < slaves_order_.size(); ++i) {
+        EXPECT_EQ(manager.getSlaveData(slaves_order_[i]).actual_position, generator.slave(i).actual_position);
+        EXPECT_FALSE(manager.getSlaveData(slaves_order_[i]).deferred);
+    }
+    EXPECT_EQ(hw_.deferred_frames(), 6u);
+    EXPECT_EQ(manager.aggregates().deferred, 0u);
+
+    // a deferred frame is no arrival: the gap across it is not taken for one long interval
+    EXPECT_EQ(manager.arrivalStats(7).intervals, 3u);
+    for (size_t i = 1; i < slaves_order_.size(); ++i) {
+        EXPECT_EQ(manager.arrivalStats(slaves_order_[i]).intervals, 0u);
+    }
+}
+
+// ============================================================================
+// TEST CASE 5: Working Counter Validation
+// ============================================================================
+
+TEST_F(EthercatHardwareInterfaceTest, WorkingCounterMismatchInvalidatesItsGroup) {
+    EXPECT_THROW(hw_.setWkcGroups({{{7, 99}, 3, 0}}), std::invalid_argument);       // 99 not on the line
+    EXPECT_THROW(hw_.setWkcGroups({{{7}, 3, 0}, {{7, 3}, 3, 0}}), std::invalid_argument); // 7 twice
+
+    // domain 0: {7, 3} and {12}; domain 1: {0}
+    hw_.setWkcGroups({{{7, 3}, 6, 0}, {{12}, 3, 0}, {{0}, 3, 1}});
+    LoadGenerator generator(slaves_order_.size());
+    std::vector<uint8_t> image(hw_.input_image_size());
+    StarManager& manager = hw_.star_manager();
+
+    generator.next_cycle(image);
+    const std::vector<uint16_t> wrong_count = {6, 3};
+    EXPECT_THROW(hw_.read_kernel(image.data(), image.size(), wrong_count.data(), wrong_count.size()),
+                 std::invalid_argument);
+
+    const std::vector<std::vector<uint16_t>> cycles = {
+        {6, 3, 3}, // all fine
+        {4, 3, 3}, // one of 7/3 did not process the datagram
+        {4, 3, 0}, // still, and domain 1 lost its frame
+        {6, 3, 3},
+    };
+    const std::vector<std::vector<bool>> valid = { // by slaves_order: 7, 3, 12, 0
+        {true, true, true, true},
+        {false, false, true, true},
+        {false, false, true, false},
+        {true, true, true, true},
+    };
+    std::vector<int32_t> last_good(slaves_order_.size());
+    for (size_t c = 0; c < cycles.size(); ++c) {
+        generator.next_cycle(image);
+        hw_.read_kernel(image.data(), image.size(), cycles[c].data(), cycles[c].size());
+        size_t invalid = 0;
+        for (size_t i = 0; i < slaves_order_.size(); ++i) {
+            const SlaveRealTimeData data = manager.getSlaveData(slaves_order_[i]);
+            EXPECT_EQ(data.data_valid, valid[c][i]) << "cycle " << c << " slave " << int(slaves_order_[i]);
+            if (valid[c][i]) {
+                last_good[i] = generator.slave(i).actual_position;
+            }
+            EXPECT_EQ(data.actual_position, last_good[i]); // a rejected frame is not decoded
+            invalid += !valid[c][i];
+        }
+        EXPECT_EQ(manager.aggregates().invalid, invalid);
+
+        // readers see the flag in the committed snapshot
+        StarSnapshot snapshot;
+        manager.readSnapshot(snapshot);
+        EXPECT_EQ(snapshot.getSlaveData(3).data_valid, valid[c][1]);
+    }
+
+    const WkcStats pair = hw_.wkcStats(0);
+    EXPECT_EQ(pair.checks, 4u);
+    EXPECT_EQ(pair.mismatches, 2u);
+    EXPECT_EQ(pair.consecutive, 0u);
+    EXPECT_EQ(pair.longest_run, 2u);
+    EXPECT_EQ(pair.last_working_counter, 6u);
+    EXPECT_EQ(hw_.wkcStats(1).mismatches, 0u);
+
+    const WkcStats domain0 = hw_.domainWkcStats(0);
+    EXPECT_EQ(domain0.mismatches, 2u);
+    EXPECT_EQ(domain0.last_working_counter, 9u);
+    EXPECT_EQ(hw_.domainWkcStats(1).mismatches, 1u);
+    EXPECT_EQ(hw_.invalidated_frames(), 5u);
+    EXPECT_THROW(hw_.wkcStats(3), std::out_of_range);
+    EXPECT_THROW(hw_.domainWkcStats(2), std::out_of_range);
+
+    // without counters nothing is checked
+    generator.next_cycle(image);
+    hw_.read_kernel(image);
+    EXPECT_EQ(hw_.wkcStats(0).checks, 4u);
+    EXPECT_TRUE(manager.getSlaveData(7).data_valid);
+}
+
+// ============================================================================
+// TEST CASE 6: A Rejected Frame Reaches Nothing Downstream
+// ============================================================================
+
+TEST_F(EthercatHardwareInterfaceTest, RejectedFrameStaysOutOfAggregatesAndEvents) {
+    ErrorCatalogue catalogue;
+    EventQueue events(16);
+    ErrorMonitor monitor(catalogue, events);
+    StarManager& manager = hw_.star_manager();
+    manager.setErrorMonitor(&monitor);
+    hw_.setWkcGroups({{{7}, 3, 0}, {{3, 12, 0}, 9, 0}});
+
+    // every slave healthy: 40 degC, 100 torque, no fault, no error
+    SlaveRealTimeData healthy{};
+    healthy.status_word = 0x0237;
+    healthy.actual_torque = 100;
+    healthy.motor_temperature = 40.0f;
+    std::vector<uint8_t> image(hw_.input_image_size());
+    WriteState encoder;
+    for (size_t i = 0; i < slaves_order_.size(); ++i) {
+        encoder.encode(healthy, image.data() + i * PdoInputLayout::size, PdoInputLayout::size);
+    }
+    const std::vector<uint16_t> good = {3, 9};
+    hw_.read_kernel(image.data(), image.size(), good.data(), good.size());
+    const CycleAggregates before = manager.aggregates();
+    EXPECT_EQ(before.supply_torque[0], 400);
+
+    // slave 7's datagram comes back unprocessed, its bytes garbage
+    SlaveRealTimeData garbage{};
+    garbage.status_word = kFaultStatusBit;
+    garbage.actual_torque = 30000;
+    garbage.motor_temperature = 9999.0f;
+    garbage.error_code = 0x2310;
+    garbage.system_status = 0xFFFF;
+    encoder.encode(garbage, image.data(), PdoInputLayout::size);
+    const std::vector<uint16_t> lost = {0, 9};
+    hw_.read_kernel(image.data(), image.size(), lost.data(), lost.size());
+
+    const CycleAggregates& aggregates = manager.aggregates();
+    EXPECT_EQ(aggregates.invalid, 1u);
+    EXPECT_FLOAT_EQ(aggregates.max_motor_temperature, 40.0f);
+    EXPECT_EQ(aggregates.faulted, 0u);
+    EXPECT_EQ(aggregates.supply_torque[0], 300); // the three valid slaves
+    EXPECT_EQ(monitor.events(), 0u);
+    const SlaveRealTimeData kept = manager.getSlaveData(7);
+    EXPECT_FALSE(kept.data_valid);
+    EXPECT_FLOAT_EQ(kept.motor_temperature, 40.0f); // last good value, not the garbage
+    EXPECT_EQ(kept.error_code, 0u);
+    EXPECT_EQ(manager.arrivalStats(7).intervals, 0u); // the lost frame is no arrival
+
+    // back to normal: no "cleared" event for an error that never was
+    encoder.encode(healthy, image.data(), PdoInputLayout::size);
+    hw_.read_kernel(image.data(), image.size(), good.data(), good.size());
+    EXPECT_TRUE(manager.getSlaveData(7).data_valid);
+    EXPECT_EQ(manager.aggregates().supply_torque[0], 400);
+    EXPECT_EQ(monitor.events(), 0u);
+    DeviceEvent event;
+    EXPECT_EQ(events.pop(&event, 1), 0u);
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
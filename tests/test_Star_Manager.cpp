@@ -3,59 +3,16 @@
 #include <cstdint>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <cmath>
 #include <cstring>
 #include <limits>
 #include "Star_Manager.hpp"
 #include "data_structuring.hpp"
 #include "slaves_state_struct.hpp"
+#include "pdo_test_utils.hpp"
 
-// Reuse the helper functions from test_data_structuring.cpp
-// (You might want to extract these to a common test utilities file)
-
-void append_uint16(std::vector<uint8_t>& buffer, uint16_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-}
-
-void append_int16(std::vector<uint8_t>& buffer, int16_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-}
-
-void append_int32(std::vector<uint8_t>& buffer, int32_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-}
-
-void append_float(std::vector<uint8_t>& buffer, float value) {
-    uint8_t bytes[4];
-    std::memcpy(bytes, &value, sizeof(float));
-    buffer.insert(buffer.end(), bytes, bytes + 4);
-}
-
-std::vector<uint8_t> generate_pdo_buffer(
-    uint16_t status_word,
-    int32_t actual_position,
-    int32_t actual_velocity,
-    int16_t actual_torque,
-    uint8_t mode_display,
-    uint16_t error_code,
-    uint16_t system_status,
-    float motor_temperature
-) {
-    std::vector<uint8_t> buffer;
-    append_uint16(buffer, status_word);
-    append_int32(buffer, actual_position);
-    append_int32(buffer, actual_velocity);
-    append_int16(buffer, actual_torque);
-    buffer.push_back(mode_display);
-    append_uint16(buffer, error_code);
-    append_uint16(buffer, system_status);
-    append_float(buffer, motor_temperature);
-    return buffer;
-}
+// generate_pdo_buffer(): shared with test_data_structuring.cpp, see pdo_test_utils.hpp
 
 // ============================================================================
 // TEST FIXTURE
@@ -306,6 +263,536 @@ TEST_F(StarManagerTest, HandlesRapidUpdates) {
     EXPECT_EQ(result.actual_position, 1009);  // Last value should be stored
 }
 
+// ============================================================================
+// TEST CASE 11: Per-Slave Fixed-Point Temperature
+// ============================================================================
+
+TEST_F(StarManagerTest, DecodesFixedPointTemperaturePerSlave) {
+    // Slave 2 is an STM32 board sending 0.1 degC counts as int16; slave 1 sends IEEE floats
+    FieldFormats fixed;
+    fixed.motor_temperature = ScaledFormat{ValueEncoding::Int16, 0.1f, 0.0f};
+    manager_.setFieldFormats(2, fixed);
+
+    auto fixed_buffer = test_buffer_;
+    insert<int16_t>(fixed_buffer, PdoInputLayout::motor_temperature, 612);
+
+    manager_.input_handler(1, test_buffer_);
+    manager_.input_handler(2, fixed_buffer);
+
+    EXPECT_FLOAT_EQ(manager_.getSlaveData(1).motor_temperature, 45.5f);
+    EXPECT_FLOAT_EQ(manager_.getSlaveData(2).motor_temperature, 61.2f);
+    EXPECT_EQ(manager_.getSlaveData(2).actual_position, 1000000);
+}
+
+// ============================================================================
+// TEST CASE 12: Committed Snapshots
+// ============================================================================
+
+TEST_F(StarManagerTest, SnapshotHoldsStateOfLastCommit) {
+    StarSnapshot snapshot;
+    manager_.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.cycle, 0u);     // nothing committed yet
+    EXPECT_EQ(snapshot.slave_count, 0u);
+    EXPECT_THROW(snapshot.getSlaveData(1), std::out_of_range);
+
+    manager_.input_handler(7, test_buffer_);
+    manager_.input_handler(1, test_buffer_);
+    manager_.commit();
+
+    // updates after the commit stay invisible until the next one
+    auto moved = generate_pdo_buffer(0x1234, 42, 0, 0, 0x08, 0, 0xFF, 45.5f);
+    manager_.input_handler(7, moved);
+
+    manager_.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.cycle, 1u);
+    EXPECT_EQ(manager_.committedCycle(), 1u);
+    EXPECT_EQ(snapshot.slave_count, 2u);
+    EXPECT_TRUE(snapshot.contains(1));
+    EXPECT_FALSE(snapshot.contains(2));
+    EXPECT_EQ(snapshot.getSlaveData(7).actual_position, 1000000);
+    EXPECT_EQ(snapshot.getSlaveData(7).slave_position, 7);
+    EXPECT_GT(snapshot.commit_time_ns, 0u);
+
+    manager_.commit();
+    manager_.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.cycle, 2u);
+    EXPECT_EQ(snapshot.getSlaveData(7).actual_position, 42);
+    EXPECT_EQ(snapshot.getSlaveData(1).actual_position, 1000000);
+}
+
+TEST_F(StarManagerTest, ReaderNeverSeesTornSnapshot) {
+    // every slave of a cycle carries the cycle number as position: a snapshot mixing two cycles shows up
+    const uint8_t slaves[] = {1, 2, 3, 4};
+    std::atomic<bool> done{false};
+
+    std::thread writer([&] {
+        for (int32_t cycle = 1; cycle <= 20000; ++cycle) {
+            auto buffer = generate_pdo_buffer(0x1234, cycle, 0, 0, 0x08, 0, 0xFF, 45.5f);
+            for (uint8_t id : slaves) {
+                manager_.input_handler(id, buffer);
+            }
+            manager_.commit();
+        }
+        done = true;
+    });
+
+    StarSnapshot snapshot;
+    while (!done) {
+        manager_.readSnapshot(snapshot);
+        if (snapshot.cycle == 0) {
+            continue;
+        }
+        int32_t position = snapshot.getSlaveData(1).actual_position;
+        EXPECT_EQ(position, static_cast<int32_t>(snapshot.cycle));
+        for (uint8_t id : slaves) {
+            ASSERT_EQ(snapshot.getSlaveData(id).actual_position, position);
+        }
+    }
+    writer.join();
+
+    manager_.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.cycle, 20000u);
+    EXPECT_EQ(snapshot.getSlaveData(4).actual_position, 20000);
+}
+
+// ============================================================================
+// TEST CASE 13: Batched Cycle Input
+// ============================================================================
+
+TEST_F(StarManagerTest, InputCycleMatchesPerSlaveInput) {
+    // back-to-back frames as in a process image, and a scattered set in another order
+    std::vector<uint8_t> image;
+    std::vector<std::vector<uint8_t>> frames;
+    for (int i = 0; i < 5; ++i) {
+        frames.push_back(generate_pdo_buffer(0x0237, 1000 * i, -i, static_cast<int16_t>(10 * i), 0x08,
+                                             0, 0xFF, 30.0f + i));
+        image.insert(image.end(), frames.back().begin(), frames.back().end());
+    }
+
+    std::vector<SlaveFrame> contiguous;
+    for (uint8_t i = 0; i < 5; ++i) {
+        contiguous.push_back(SlaveFrame{static_cast<uint8_t>(i + 1), image.data() + i * PdoInputLayout::size,
+                                        PdoInputLayout::size});
+    }
+    std::vector<SlaveFrame> scattered = {
+        {9, frames[3].data(), frames[3].size()},
+        {7, frames[1].data(), frames[1].size()},
+        {8, frames[4].data(), frames[4].size()},
+    };
+
+    StarManager reference;
+    for (uint8_t i = 0; i < 5; ++i) {
+        reference.input_handler(i + 1, frames[i]);
+    }
+
+    manager_.input_cycle(contiguous);
+    EXPECT_EQ(manager_.committedCycle(), 1u); // one commit per batch
+    manager_.input_cycle(scattered);
+    EXPECT_EQ(manager_.committedCycle(), 2u);
+
+    for (uint8_t id = 1; id <= 5; ++id) {
+        SlaveRealTimeData expected = reference.getSlaveData(id);
+        SlaveRealTimeData result = manager_.getSlaveData(id);
+        EXPECT_EQ(result.actual_position, expected.actual_position);
+        EXPECT_EQ(result.actual_velocity, expected.actual_velocity);
+        EXPECT_EQ(result.actual_torque, expected.actual_torque);
+        EXPECT_FLOAT_EQ(result.motor_temperature, expected.motor_temperature);
+        EXPECT_EQ(result.slave_position, id);
+        EXPECT_TRUE(result.data_valid);
+    }
+    EXPECT_EQ(manager_.getSlaveData(7).actual_position, 1000);
+    EXPECT_EQ(manager_.getSlaveData(9).actual_position, 3000);
+
+    // one clock read per cycle: every slave of a batch carries the same timestamp
+    EXPECT_EQ(manager_.getSlaveData(1).timestamp, manager_.getSlaveData(5).timestamp);
+    EXPECT_EQ(manager_.getSlaveData(7).timestamp, manager_.getSlaveData(8).timestamp);
+
+    StarSnapshot snapshot;
+    manager_.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.slave_count, 8u);
+    EXPECT_EQ(snapshot.getSlaveData(8).actual_torque, 40);
+}
+
+TEST_F(StarManagerTest, InputCycleAppliesFixedPointAndRejectsShortFrames) {
+    FieldFormats fixed;
+    fixed.motor_temperature = ScaledFormat{ValueEncoding::Int16, 0.1f, 0.0f};
+    manager_.setFieldFormats(2, fixed);
+
+    auto fixed_buffer = test_buffer_;
+    insert<int16_t>(fixed_buffer, PdoInputLayout::motor_temperature, 612);
+    manager_.input_cycle({{1, test_buffer_.data(), test_buffer_.size()},
+                          {2, fixed_buffer.data(), fixed_buffer.size()}});
+    EXPECT_FLOAT_EQ(manager_.getSlaveData(1).motor_temperature, 45.5f);
+    EXPECT_FLOAT_EQ(manager_.getSlaveData(2).motor_temperature, 61.2f);
+
+    // second frame too short: nothing of this cycle is applied or committed
+    auto moved = generate_pdo_buffer(0x1234, 5, 0, 0, 0x08, 0, 0xFF, 45.5f);
+    EXPECT_THROW(manager_.input_cycle({{1, moved.data(), moved.size()},
+                                       {3, moved.data(), PdoInputLayout::size - 1}}),
+                 std::out_of_range);
+    EXPECT_EQ(manager_.getSlaveData(1).actual_position, 1000000);
+    EXPECT_THROW(manager_.getSlaveData(3), std::out_of_range);
+    EXPECT_EQ(manager_.committedCycle(), 1u);
+}
+
+// ============================================================================
+// TEST CASE 14: Lazy Decode
+// ============================================================================
+
+TEST_F(StarManagerTest, LazyModesDecodeOnAccess) {
+    FieldFormats fixed;
+    fixed.motor_temperature = ScaledFormat{ValueEncoding::Int16, 0.1f, 0.0f};
+    auto fixed_buffer = generate_pdo_buffer(0x0237, -77, 12, -5, 0x09, 0x2310, 0x0001, 0.0f);
+    insert<int16_t>(fixed_buffer, PdoInputLayout::motor_temperature, 612);
+
+    for (DecodeMode mode : {DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        StarManager lazy(kAnyNumaNode, mode);
+        EXPECT_EQ(lazy.decodeMode(), mode);
+        lazy.setFieldFormats(2, fixed);
+        manager_.setFieldFormats(2, fixed);
+
+        for (StarManager* m : {&lazy, &manager_}) {
+            m->input_cycle({{1, test_buffer_.data(), test_buffer_.size()},
+                            {2, fixed_buffer.data(), fixed_buffer.size()}});
+        }
+
+        for (uint8_t id : {1, 2}) {
+            SlaveRealTimeData expected = manager_.getSlaveData(id);
+            EXPECT_EQ(lazy.getField<&SlaveRealTimeData::actual_position>(id), expected.actual_position);
+            EXPECT_EQ(lazy.getField<&SlaveRealTimeData::status_word>(id), expected.status_word);
+            EXPECT_FLOAT_EQ(lazy.getField<&SlaveRealTimeData::motor_temperature>(id), expected.motor_temperature);
+
+            // twice: LazyCached answers the second read from the columns
+            for (int read = 0; read < 2; ++read) {
+                SlaveRealTimeData result = lazy.getSlaveData(id);
+                EXPECT_EQ(result.actual_velocity, expected.actual_velocity);
+                EXPECT_EQ(result.error_code, expected.error_code);
+                EXPECT_FLOAT_EQ(result.motor_temperature, expected.motor_temperature);
+                EXPECT_EQ(result.slave_position, id);
+                EXPECT_TRUE(result.data_valid);
+            }
+        }
+        EXPECT_FLOAT_EQ(lazy.getField<&SlaveRealTimeData::motor_temperature>(2), 61.2f);
+
+        // a new cycle replaces what the cache holds
+        auto moved = generate_pdo_buffer(0x1234, 4242, 0, 0, 0x08, 0, 0xFF, 45.5f);
+        lazy.input_cycle({{1, moved.data(), moved.size()}});
+        EXPECT_EQ(lazy.getSlaveData(1).actual_position, 4242);
+        EXPECT_EQ(lazy.getField<&SlaveRealTimeData::actual_position>(1), 4242);
+        lazy.input_handler(1, test_buffer_);
+        EXPECT_EQ(lazy.getSlaveData(1).actual_position, 1000000);
+
+        // snapshots carry the raw frames and decode the same way
+        lazy.commit();
+        StarSnapshot snapshot;
+        lazy.readSnapshot(snapshot);
+        EXPECT_EQ(snapshot.mode, mode);
+        EXPECT_EQ(snapshot.getField<&SlaveRealTimeData::actual_position>(1), 1000000);
+        EXPECT_FLOAT_EQ(snapshot.getSlaveData(2).motor_temperature, 61.2f);
+        EXPECT_EQ(snapshot.getSlaveData(2).actual_position, -77);
+
+        EXPECT_THROW(lazy.getField<&SlaveRealTimeData::actual_position>(3), std::out_of_range);
+        std::vector<uint8_t> short_buffer(PdoInputLayout::size - 1);
+        EXPECT_THROW(lazy.input_handler(3, short_buffer), std::out_of_range);
+    }
+}
+
+// ============================================================================
+// TEST CASE 15: Cycle Aggregates
+// ============================================================================
+
+TEST_F(StarManagerTest, CommitReducesColumnsToAggregates) {
+    for (DecodeMode mode : {DecodeMode::Eager, DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        StarManager manager(kAnyNumaNode, mode);
+        EXPECT_EQ(manager.aggregates().slave_count, 0u);
+        manager.commit();
+        EXPECT_EQ(manager.aggregates().oldest_timestamp, UINT64_MAX);
+
+        manager.setSupplyGroup(3, 1); // before slave 3 reports
+        auto a = generate_pdo_buffer(0x0237, 0, 0, 100, 0x08, 0, 0, 41.0f);
+        auto b = generate_pdo_buffer(0x0208, 0, 0, -30, 0x08, 0x2310, 0, 77.5f); // fault bit
+        auto c = generate_pdo_buffer(0x0218, 0, 0, 250, 0x08, 0x2310, 0, 52.0f); // fault bit
+        manager.input_handler(1, a);
+        manager.input_cycle({{2, b.data(), b.size()}, {3, c.data(), c.size()}});
+
+        CycleAggregates aggregates = manager.aggregates();
+        EXPECT_EQ(aggregates.slave_count, 3u);
+        EXPECT_FLOAT_EQ(aggregates.max_motor_temperature, 77.5f);
+        EXPECT_EQ(aggregates.faulted, 2u);
+        EXPECT_EQ(aggregates.oldest_timestamp, manager.getSlaveData(1).timestamp);
+        EXPECT_EQ(aggregates.supply_torque[0], 70);
+        EXPECT_EQ(aggregates.supply_torque[1], 250);
+
+        // regrouping an already registered slave, and the snapshot carries the same record
+        manager.setSupplyGroup(1, 1);
+        manager.commit();
+        StarSnapshot snapshot;
+        manager.readSnapshot(snapshot);
+        EXPECT_EQ(snapshot.aggregates.supply_torque[0], -30);
+        EXPECT_EQ(snapshot.aggregates.supply_torque[1], 350);
+        EXPECT_EQ(snapshot.aggregates.faulted, 2u);
+
+        EXPECT_THROW(manager.setSupplyGroup(1, kMaxSupplyGroups), std::invalid_argument);
+    }
+}
+
+TEST_F(StarManagerTest, LazyCommitDecodesOnlyNewFrames) {
+    for (DecodeMode mode : {DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        StarManager manager(kAnyNumaNode, mode);
+        std::vector<uint8_t> image;
+        std::vector<SlaveFrame> frames;
+        for (int i = 0; i < 8; ++i) {
+            auto frame = generate_pdo_buffer(0x0237, i, 0, static_cast<int16_t>(10 * i), 0x08, 0, 0, 40.0f + i);
+            image.insert(image.end(), frame.begin(), frame.end());
+        }
+        for (size_t i = 0; i < 8; ++i) {
+            frames.push_back({static_cast<uint8_t>(i + 1), image.data() + i * PdoInputLayout::size,
+                              PdoInputLayout::size});
+        }
+        manager.input_cycle(frames);
+        EXPECT_EQ(manager.aggregateDecodes(), 8u);
+
+        // commits without new frames decode nothing, and the figures stand
+        manager.commit();
+        manager.commit();
+        EXPECT_EQ(manager.aggregateDecodes(), 8u);
+        EXPECT_FLOAT_EQ(manager.aggregates().max_motor_temperature, 47.0f);
+        EXPECT_EQ(manager.aggregates().supply_torque[0], 280);
+
+        // two slaves report, one of them twice before the commit
+        auto hot = generate_pdo_buffer(0x0208, 0, 0, 5, 0x08, 0, 0, 90.0f);
+        manager.input_cycle({{3, hot.data(), hot.size()}, {5, hot.data(), hot.size()}});
+        EXPECT_EQ(manager.aggregateDecodes(), 10u);
+        manager.input_handler(3, image);
+        manager.input_handler(3, hot);
+        manager.commit();
+        EXPECT_EQ(manager.aggregateDecodes(), 11u);
+        EXPECT_FLOAT_EQ(manager.aggregates().max_motor_temperature, 90.0f);
+        EXPECT_EQ(manager.aggregates().faulted, 2u);
+
+        // LazyCached: a slot read in this cycle is already in the columns
+        manager.input_frames(frames.data(), 2);
+        manager.getSlaveData(1);
+        manager.commit();
+        EXPECT_EQ(manager.aggregateDecodes(), mode == DecodeMode::LazyCached ? 12u : 13u);
+    }
+}
+
+// ============================================================================
+// TEST CASE 16: Arrival Statistics
+// ============================================================================
+
+TEST(ArrivalTrackerTest, EstimatesRateAndFlagsDriftJitterAndSilence) {
+    ArrivalThresholds thresholds;
+    thresholds.warmup = 8;
+    ArrivalTracker tracker(thresholds);
+    tracker.setExpectedPeriod(2, 1000000);
+
+    // slave 1: steady 1 ms, learns its baseline; slave 2: 1.5 ms against an expected 1 ms
+    uint64_t t = 1000000000;
+    for (int i = 0; i < 40; ++i) {
+        tracker.record(1, t + i * 1000000ull);
+        tracker.record(2, t + i * 1500000ull);
+    }
+    const ArrivalStats& steady = tracker.stats(1);
+    EXPECT_EQ(steady.intervals, 39u);
+    EXPECT_DOUBLE_EQ(steady.mean_ns, 1000000.0);
+    EXPECT_DOUBLE_EQ(steady.baseline_ns, 1000000.0);
+    EXPECT_NEAR(steady.rate_hz(), 1000.0, 1e-6);
+    EXPECT_EQ(steady.min_ns, 1000000u);
+    EXPECT_EQ(steady.max_ns, 1000000u);
+    EXPECT_EQ(steady.flags, 0);
+    EXPECT_EQ(tracker.stats(2).flags, kArrivalDrift);
+
+    // slave 1 turns bursty: alternating 0.2 ms / 1.8 ms keeps the mean but not the spread
+    uint64_t last = t + 39 * 1000000ull;
+    for (int i = 0; i < 40; ++i) {
+        last += (i % 2 == 0) ? 200000 : 1800000;
+        tracker.record(1, last);
+    }
+    EXPECT_NEAR(tracker.stats(1).mean_ns, 1000000.0, 100000.0);
+    EXPECT_TRUE(tracker.stats(1).flags & kArrivalJitter);
+    EXPECT_EQ(tracker.stats(1).max_ns, 1800000u);
+
+    // silence is only visible at query time
+    EXPECT_EQ(tracker.flags(1, last + 1000000) & kArrivalLate, 0);
+    EXPECT_TRUE(tracker.flags(1, last + 5000000) & kArrivalLate);
+    EXPECT_EQ(tracker.anomalies(last), (std::vector<uint8_t>{1, 2}));
+
+    tracker.reset(1);
+    EXPECT_EQ(tracker.stats(1).intervals, 0u);
+    thresholds.alpha = 0.0;
+    EXPECT_THROW(tracker.setThresholds(thresholds), std::invalid_argument);
+}
+
+TEST_F(StarManagerTest, TracksArrivalOfEverySlave) {
+    EXPECT_THROW(manager_.arrivalStats(1), std::out_of_range);
+    for (int i = 0; i < 3; ++i) {
+        manager_.input_handler(1, test_buffer_);
+        manager_.input_cycle({{2, test_buffer_.data(), test_buffer_.size()}});
+    }
+    EXPECT_EQ(manager_.arrivalStats(1).intervals, 2u);
+    EXPECT_EQ(manager_.arrivalStats(2).intervals, 2u);
+    EXPECT_GT(manager_.arrivalStats(2).last_ns, 0u);
+    EXPECT_GT(manager_.arrivalStats(1).mean_ns, 0.0);
+    EXPECT_TRUE(manager_.timingAnomalies().empty()); // still warming up
+}
+
+TEST_F(StarManagerTest, WallClockStepsAreNotArrivalIntervals) {
+    ArrivalThresholds thresholds;
+    thresholds.warmup = 4;
+    manager_.setArrivalThresholds(thresholds);
+
+    // 1 ms cycles on the steady clock; NTP steps the wall clock an hour forward at cycle 10
+    // and slews it back by 0.5 ms per cycle afterwards
+    const uint64_t hour = 3600000000000ull;
+    uint64_t wall = 1700000000000000000ull;
+    uint64_t steady = 5000000000ull;
+    for (int cycle = 0; cycle < 30; ++cycle) {
+        wall += cycle == 10 ? hour : cycle > 10 ? 500000 : 1000000;
+        steady += 1000000;
+        manager_.input_cycle({{1, test_buffer_.data(), test_buffer_.size()}}, wall, steady);
+    }
+
+    EXPECT_EQ(manager_.getSlaveData(1).timestamp, wall); // the snapshot keeps wall-clock time
+    const ArrivalStats stats = manager_.arrivalStats(1);
+    EXPECT_EQ(stats.intervals, 29u);
+    EXPECT_EQ(stats.max_ns, 1000000u);
+    EXPECT_EQ(stats.min_ns, 1000000u);
+    EXPECT_DOUBLE_EQ(stats.mean_ns, 1000000.0);
+    EXPECT_EQ(stats.flags, 0);
+}
+
+// ============================================================================
+// TEST CASE 17: Float Sanitization
+// ============================================================================
+
+TEST_F(StarManagerTest, FloatPoliciesSanitizeTemperatures) {
+    FloatPolicies policies;
+    policies.motor_temperature.flush_denormals = true;
+    policies.motor_temperature.replace_non_finite = true;
+    policies.motor_temperature.max = 150.0f;
+
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float denormal = std::numeric_limits<float>::denorm_min();
+    const std::vector<float> cycle1 = {41.0f, 42.0f, 43.0f};
+    const std::vector<float> cycle2 = {nan, denormal, 900.0f};
+
+    for (DecodeMode mode : {DecodeMode::Eager, DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        StarManager manager(kAnyNumaNode, mode);
+        manager.setFloatPolicies(policies);
+        for (const auto& temperatures : {cycle1, cycle2}) {
+            std::vector<uint8_t> image;
+            for (float t : temperatures) {
+                auto frame = generate_pdo_buffer(0x0237, 1, 2, 3, 0x08, 0, 0x0001, t);
+                image.insert(image.end(), frame.begin(), frame.end());
+            }
+            std::vector<SlaveFrame> frames;
+            for (size_t i = 0; i < temperatures.size(); ++i) {
+                frames.push_back({static_cast<uint8_t>(i + 1), image.data() + i * PdoInputLayout::size,
+                                  PdoInputLayout::size});
+            }
+            manager.input_cycle(frames);
+        }
+
+        // NaN: last good value, flagged; denormal: flushed; out of range: clamped
+        SlaveRealTimeData replaced = manager.getSlaveData(1);
+        EXPECT_FLOAT_EQ(replaced.motor_temperature, 41.0f) << static_cast<int>(mode);
+        EXPECT_EQ(replaced.invalid_fields, kInvalidMotorTemperature);
+        EXPECT_TRUE(replaced.data_valid);
+        EXPECT_EQ(manager.getField<&SlaveRealTimeData::motor_temperature>(2), 0.0f);
+        EXPECT_EQ(manager.getSlaveData(2).invalid_fields, 0);
+        EXPECT_FLOAT_EQ(manager.getSlaveData(3).motor_temperature, 150.0f);
+        EXPECT_EQ(manager.aggregates().invalid_fields, 1u);
+        EXPECT_FLOAT_EQ(manager.aggregates().max_motor_temperature, 150.0f);
+
+        StarSnapshot snapshot;
+        manager.readSnapshot(snapshot);
+        EXPECT_EQ(snapshot.getSlaveData(1).invalid_fields, kInvalidMotorTemperature) << static_cast<int>(mode);
+        EXPECT_FLOAT_EQ(snapshot.getSlaveData(1).motor_temperature, 41.0f);
+
+        // a good value clears the flag
+        auto good = generate_pdo_buffer(0x0237, 1, 2, 3, 0x08, 0, 0x0001, 44.0f);
+        manager.input_handler(1, good);
+        EXPECT_EQ(manager.getSlaveData(1).invalid_fields, 0);
+        EXPECT_FLOAT_EQ(manager.getSlaveData(1).motor_temperature, 44.0f);
+    }
+
+    // without a policy the wire value comes through
+    auto frame = generate_pdo_buffer(0x0237, 1, 2, 3, 0x08, 0, 0x0001, nan);
+    manager_.input_cycle({{1, frame.data(), frame.size()}});
+    EXPECT_TRUE(std::isnan(manager_.getSlaveData(1).motor_temperature));
+    EXPECT_EQ(manager_.getSlaveData(1).invalid_fields, 0);
+}
+
+// ============================================================================
+// TEST CASE 18: Batched Fixed-Point Columns
+// ============================================================================
+
+TEST_F(StarManagerTest, FixedPointRunsAreConvertedOrKept) {
+    // slaves 1-4: 0.1 degC int16 counts; 5-6: kept as integers; 7: IEEE float
+    FieldFormats converted;
+    converted.motor_temperature = ScaledFormat{ValueEncoding::Int16, 0.1f, 0.0f};
+    FieldFormats kept = converted;
+    kept.motor_temperature.keep_fixed_point = true;
+    FloatPolicies policies;
+    policies.motor_temperature.replace_non_finite = true;
+
+    for (DecodeMode mode : {DecodeMode::Eager, DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        StarManager manager(kAnyNumaNode, mode);
+        manager.setFloatPolicies(policies); // kept slaves must not be flagged for their NaN column
+        for (uint8_t id = 1; id <= 6; ++id) {
+            manager.setFieldFormats(id, id <= 4 ? converted : kept);
+        }
+
+        std::vector<uint8_t> image;
+        std::vector<SlaveFrame> frames;
+        for (int i = 0; i < 7; ++i) {
+            auto frame = generate_pdo_buffer(0x0237, i, 0, 0, 0x08, 0, 0x0001, 36.5f);
+            if (i < 6) {
+                insert<int16_t>(frame, PdoInputLayout::motor_temperature, static_cast<int16_t>(400 + 10 * i));
+            }
+            image.insert(image.end(), frame.begin(), frame.end());
+        }
+        for (size_t i = 0; i < 7; ++i) {
+            frames.push_back({static_cast<uint8_t>(i + 1), image.data() + i * PdoInputLayout::size,
+                              PdoInputLayout::size});
+        }
+        manager.input_cycle(frames);
+
+        for (uint8_t id = 1; id <= 4; ++id) {
+            EXPECT_FLOAT_EQ(manager.getSlaveData(id).motor_temperature, 40.0f + (id - 1)) << static_cast<int>(mode);
+        }
+        for (uint8_t id = 5; id <= 6; ++id) {
+            EXPECT_TRUE(std::isnan(manager.getSlaveData(id).motor_temperature)) << static_cast<int>(mode);
+            EXPECT_EQ(manager.getSlaveData(id).invalid_fields, 0);
+        }
+        EXPECT_FLOAT_EQ(manager.getSlaveData(7).motor_temperature, 36.5f);
+
+        const CycleAggregates& aggregates = manager.aggregates();
+        EXPECT_FLOAT_EQ(aggregates.max_motor_temperature, 43.0f); // kept slaves are not in the float max
+        EXPECT_EQ(aggregates.max_motor_temperature_raw, 450);
+        EXPECT_EQ(aggregates.invalid_fields, 0u);
+
+        StarSnapshot snapshot;
+        manager.readSnapshot(snapshot);
+        const SlaveColumns& columns = snapshot.columns.columns();
+        EXPECT_EQ(columns.motor_temperature_raw[snapshot.slot_of[2]], 410);
+        EXPECT_EQ(columns.motor_temperature_raw[snapshot.slot_of[6]], 450);
+        EXPECT_EQ(columns.motor_temperature_raw[snapshot.slot_of[7]], std::numeric_limits<int32_t>::min());
+
+        // one frame on its own takes the same path
+        auto single = generate_pdo_buffer(0x0237, 0, 0, 0, 0x08, 0, 0x0001, 0.0f);
+        insert<int16_t>(single, PdoInputLayout::motor_temperature, 612);
+        manager.input_handler(6, single);
+        manager.input_handler(2, single);
+        manager.commit();
+        EXPECT_EQ(manager.aggregates().max_motor_temperature_raw, 612);
+        EXPECT_FLOAT_EQ(manager.getSlaveData(2).motor_temperature, 61.2f);
+        EXPECT_TRUE(std::isnan(manager.getSlaveData(6).motor_temperature));
+    }
+}
+
 // ============================================================================
 // MAIN FUNCTION
 // ============================================================================
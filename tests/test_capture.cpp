@@ -0,0 +1,407 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include "capture_file.hpp"
+#include "ethercat_frame.hpp"
+#include "load_generator.hpp"
+#include "Star_Manager.hpp"
+
+// ============================================================================
+// CAPTURE BUILDERS: what Wireshark writes, built byte by byte
+// ============================================================================
+
+namespace {
+
+void put16(std::vector<uint8_t>& out, uint16_t v) {
+    out.push_back(static_cast<uint8_t>(v));
+    out.push_back(static_cast<uint8_t>(v >> 8));
+}
+
+void put32(std::vector<uint8_t>& out, uint32_t v) {
+    put16(out, static_cast<uint16_t>(v));
+    put16(out, static_cast<uint16_t>(v >> 16));
+}
+
+void put32_be(std::vector<uint8_t>& out, uint32_t v) {
+    for (int shift = 24; shift >= 0; shift -= 8) {
+        out.push_back(static_cast<uint8_t>(v >> shift));
+    }
+}
+
+struct Datagram {
+    EcatCommand command;
+    uint32_t address;
+    std::vector<uint8_t> data;
+    uint16_t working_counter;
+};
+
+// Ethernet header (optionally VLAN-tagged), EtherCAT header, datagram chain
+std::vector<uint8_t> ecat_frame(const std::vector<Datagram>& datagrams, bool vlan = false) {
+    std::vector<uint8_t> frame(12, 0xFF); // broadcast destination, any source
+    if (vlan) {
+        frame.push_back(0x81); frame.push_back(0x00);
+        frame.push_back(0x00); frame.push_back(0x05);
+    }
+    frame.push_back(0x88); frame.push_back(0xA4);
+
+    size_t length = 0;
+    for (const Datagram& d : datagrams) {
+        length += 10 + d.data.size() + 2;
+    }
+    put16(frame, static_cast<uint16_t>(length | (1u << 12)));
+    for (size_t i = 0; i < datagrams.size(); ++i) {
+        const Datagram& d = datagrams[i];
+        frame.push_back(static_cast<uint8_t>(d.command));
+        frame.push_back(static_cast<uint8_t>(i));
+        put32(frame, d.address);
+        const bool more = i + 1 < datagrams.size();
+        put16(frame, static_cast<uint16_t>(d.data.size() | (more ? 0x8000 : 0)));
+        put16(frame, 0); // irq
+        frame.insert(frame.end(), d.data.begin(), d.data.end());
+        put16(frame, d.working_counter);
+    }
+    return frame;
+}
+
+struct Packet {
+    std::vector<uint8_t> frame;
+    uint64_t timestamp_ns;
+};
+
+std::vector<uint8_t> pcap(const std::vector<Packet>& packets, bool nanoseconds, bool big_endian = false) {
+    auto u32 = [big_endian](std::vector<uint8_t>& out, uint32_t v) {
+        big_endian ? put32_be(out, v) : put32(out, v);
+    };
+    std::vector<uint8_t> file;
+    u32(file, nanoseconds ? 0xA1B23C4D : 0xA1B2C3D4);
+    u32(file, 0x00040002); // version, not checked by the reader
+    u32(file, 0);          // thiszone
+    u32(file, 0);          // sigfigs
+    u32(file, 65535);      // snaplen
+    u32(file, 1);          // Ethernet
+    for (const Packet& p : packets) {
+        u32(file, static_cast<uint32_t>(p.timestamp_ns / 1000000000));
+        const uint64_t fraction = p.timestamp_ns % 1000000000;
+        u32(file, static_cast<uint32_t>(nanoseconds ? fraction : fraction / 1000));
+        u32(file, static_cast<uint32_t>(p.frame.size()));
+        u32(file, static_cast<uint32_t>(p.frame.size()));
+        file.insert(file.end(), p.frame.begin(), p.frame.end());
+    }
+    return file;
+}
+
+void pcapng_block(std::vector<uint8_t>& file, uint32_t type, const std::vector<uint8_t>& body) {
+    std::vector<uint8_t> padded = body;
+    padded.resize((padded.size() + 3) & ~size_t{3}, 0);
+    const uint32_t total = static_cast<uint32_t>(12 + padded.size());
+    put32(file, type);
+    put32(file, total);
+    file.insert(file.end(), padded.begin(), padded.end());
+    put32(file, total);
+}
+
+void pcapng_section(std::vector<uint8_t>& file) {
+    std::vector<uint8_t> body;
+    put32(body, 0x1A2B3C4D);
+    put16(body, 1); put16(body, 0);
+    put32(body, 0xFFFFFFFF); put32(body, 0xFFFFFFFF); // section length unknown
+    pcapng_block(file, 0x0A0D0D0A, body);
+}
+
+// interface with an optional if_tsresol
+void pcapng_interface(std::vector<uint8_t>& file, uint16_t linktype, int tsresol = -1) {
+    std::vector<uint8_t> body;
+    put16(body, linktype); put16(body, 0);
+    put32(body, 65535);
+    if (tsresol >= 0) {
+        put16(body, 9); put16(body, 1);
+        body.push_back(static_cast<uint8_t>(tsresol));
+        body.push_back(0); body.push_back(0); body.push_back(0);
+        put16(body, 0); put16(body, 0); // opt_endofopt
+    }
+    pcapng_block(file, 1, body);
+}
+
+void pcapng_packet(std::vector<uint8_t>& file, uint32_t interface_id, uint64_t units, const std::vector<uint8_t>& frame) {
+    std::vector<uint8_t> body;
+    put32(body, interface_id);
+    put32(body, static_cast<uint32_t>(units >> 32));
+    put32(body, static_cast<uint32_t>(units));
+    put32(body, static_cast<uint32_t>(frame.size()));
+    put32(body, static_cast<uint32_t>(frame.size()));
+    body.insert(body.end(), frame.begin(), frame.end());
+    pcapng_block(file, 6, body);
+}
+
+} // namespace
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+// One line of four drives, process image back to back from logical address 0x10000
+class CaptureTest : public ::testing::Test {
+protected:
+    static constexpr uint32_t kLogicalBase = 0x10000;
+
+    CaptureTest() : generator_(4), order_{3, 1, 4, 2}, decoder_(order_, kLogicalBase) {}
+
+    // a cycle on the wire: the outgoing LRD (WKC 0, stale data) and its processed return
+    std::vector<Packet> next_cycle_packets(uint64_t timestamp_ns) {
+        std::vector<uint8_t> image(generator_.image_size());
+        generator_.next_cycle(image);
+        std::vector<uint8_t> stale(image.size(), 0xAA);
+        return {
+            {ecat_frame({{EcatCommand::LRD, kLogicalBase, stale, 0}}), timestamp_ns - 20000},
+            {ecat_frame({{EcatCommand::LRD, kLogicalBase, image, 4}}), timestamp_ns},
+        };
+    }
+
+    LoadGenerator generator_;
+    std::vector<uint8_t> order_;
+    CaptureDecoder decoder_;
+};
+
+// ============================================================================
+// TEST CASE 1: Frame and Datagram Decoding
+// ============================================================================
+
+TEST_F(CaptureTest, DecodesDatagramChainZeroCopy) {
+    const std::vector<uint8_t> status{0x08, 0x02};
+    std::vector<uint8_t> image(generator_.image_size());
+    generator_.next_cycle(image);
+    const std::vector<uint8_t> frame = ecat_frame({
+        {EcatCommand::FPRD, 0x01300003, status, 1},     // AL status of station 3
+        {EcatCommand::LRW, kLogicalBase, image, 12},
+        {EcatCommand::BRD, 0x01300000, status, 4},
+    });
+
+    std::vector<EcatDatagram> datagrams;
+    ASSERT_EQ(decode_ecat_frame(frame.data(), frame.size(), datagrams), FrameStatus::Ok);
+    ASSERT_EQ(datagrams.size(), 3u);
+    EXPECT_EQ(datagrams[0].command, EcatCommand::FPRD);
+    EXPECT_EQ(datagrams[0].address & 0xFFFF, 3u);
+    EXPECT_EQ(datagrams[1].command, EcatCommand::LRW);
+    EXPECT_EQ(datagrams[1].index, 1u);
+    EXPECT_EQ(datagrams[1].length, image.size());
+    EXPECT_EQ(datagrams[1].working_counter, 12u);
+    EXPECT_EQ(datagrams[2].working_counter, 4u);
+    // views into the frame, not copies
+    EXPECT_GE(datagrams[1].data, frame.data());
+    EXPECT_LT(datagrams[1].data, frame.data() + frame.size());
+
+    std::vector<SlaveFrame> slaves;
+    ASSERT_EQ(decoder_.decode(frame.data(), frame.size(), slaves), FrameStatus::Ok);
+    ASSERT_EQ(slaves.size(), 4u);
+    ReadState reader;
+    for (size_t i = 0; i < slaves.size(); ++i) {
+        EXPECT_EQ(slaves[i].slave_id, order_[i]);
+        EXPECT_EQ(slaves[i].size, PdoInputLayout::size);
+        const SlaveRealTimeData decoded = reader.parse(slaves[i].data, slaves[i].size);
+        EXPECT_EQ(decoded.actual_position, generator_.slave(i).actual_position);
+        EXPECT_EQ(decoded.status_word, generator_.slave(i).status_word);
+        EXPECT_FLOAT_EQ(decoded.motor_temperature, generator_.slave(i).motor_temperature);
+    }
+}
+
+// ============================================================================
+// TEST CASE 2: VLAN, Partial Coverage and Bad Frames
+// ============================================================================
+
+TEST_F(CaptureTest, HandlesVlanSplitDatagramsAndBadFrames) {
+    std::vector<uint8_t> image(generator_.image_size());
+    generator_.next_cycle(image);
+    const size_t half = 2 * PdoInputLayout::size;
+    std::vector<uint8_t> first(image.begin(), image.begin() + half + 3); // third slave cut in two
+    std::vector<uint8_t> second(image.begin() + half, image.end());
+
+    // process image in two datagrams, VLAN-tagged frame
+    const std::vector<uint8_t> split = ecat_frame({
+        {EcatCommand::LRD, kLogicalBase, first, 2},
+        {EcatCommand::LRD, static_cast<uint32_t>(kLogicalBase + half), second, 2},
+    }, true);
+    std::vector<SlaveFrame> slaves;
+    ASSERT_EQ(decoder_.decode(split.data(), split.size(), slaves), FrameStatus::Ok);
+    ASSERT_EQ(slaves.size(), 4u); // the cut slave comes from the second datagram only
+    EXPECT_EQ(slaves[2].slave_id, order_[2]);
+    EXPECT_EQ(ReadState().parse(slaves[2].data, slaves[2].size).actual_velocity,
+              generator_.slave(2).actual_velocity);
+
+    // outgoing frame: no input data yet
+    const std::vector<uint8_t> outgoing = ecat_frame({{EcatCommand::LRD, kLogicalBase, image, 0}});
+    EXPECT_EQ(decoder_.decode(outgoing.data(), outgoing.size(), slaves), FrameStatus::Ok);
+    EXPECT_TRUE(slaves.empty());
+
+    // outputs only: nothing to read
+    const std::vector<uint8_t> writes = ecat_frame({{EcatCommand::LWR, kLogicalBase, image, 4}});
+    EXPECT_EQ(decoder_.decode(writes.data(), writes.size(), slaves), FrameStatus::Ok);
+    EXPECT_TRUE(slaves.empty());
+
+    // not EtherCAT (IPv4)
+    std::vector<uint8_t> ip = outgoing;
+    ip[12] = 0x08; ip[13] = 0x00;
+    EXPECT_EQ(decoder_.decode(ip.data(), ip.size(), slaves), FrameStatus::NotEthercat);
+
+    // cut by the snap length
+    EXPECT_EQ(decoder_.decode(split.data(), 40, slaves), FrameStatus::Truncated);
+    EXPECT_EQ(decoder_.decode(split.data(), 10, slaves), FrameStatus::Truncated);
+
+    // "more follows" on the last datagram: the chain runs past the EtherCAT length
+    std::vector<uint8_t> chained = outgoing;
+    chained[14 + 2 + 7] |= 0x80;
+    EXPECT_EQ(decoder_.decode(chained.data(), chained.size(), slaves), FrameStatus::Malformed);
+
+    // datagram longer than the frame says
+    std::vector<uint8_t> overlong = outgoing;
+    overlong[14 + 2 + 6] = 0xFF;
+    overlong[14 + 2 + 7] = 0x07;
+    EXPECT_EQ(decoder_.decode(overlong.data(), overlong.size(), slaves), FrameStatus::Malformed);
+
+    EXPECT_THROW(CaptureDecoder({{1, 0}, {1, 100}}), std::invalid_argument);
+}
+
+// ============================================================================
+// TEST CASE 3: pcap Replay into StarManager
+// ============================================================================
+
+TEST_F(CaptureTest, ReplaysPcapIntoStarManager) {
+    const uint64_t start = 1700000000ull * 1000000000ull + 123456000;
+    for (bool nanoseconds : {false, true}) {
+        for (bool big_endian : {false, true}) {
+            std::vector<Packet> packets;
+            std::vector<std::vector<SlaveRealTimeData>> expected;
+            for (uint64_t c = 1; c <= 5; ++c) {
+                const std::vector<Packet> cycle = next_cycle_packets(start + c * 1000000);
+                packets.insert(packets.end(), cycle.begin(), cycle.end());
+                expected.emplace_back();
+                for (size_t i = 0; i < 4; ++i) {
+                    expected.back().push_back(generator_.slave(i));
+                }
+            }
+            packets.push_back({std::vector<uint8_t>(60, 0), start}); // something else on the wire
+            const std::vector<uint8_t> file = pcap(packets, nanoseconds, big_endian);
+
+            CaptureFile capture(file.data(), file.size());
+            EXPECT_EQ(capture.format(), CaptureFile::Format::Pcap);
+            StarManager manager;
+            size_t cycle = 0;
+            const CaptureStats stats = replay_capture(capture, decoder_, manager, [&](const CapturedPacket& packet) {
+                EXPECT_EQ(packet.timestamp_ns, start + (cycle + 1) * 1000000);
+                for (size_t i = 0; i < 4; ++i) {
+                    const SlaveRealTimeData data = manager.getSlaveData(order_[i]);
+                    EXPECT_EQ(data.actual_position, expected[cycle][i].actual_position);
+                    EXPECT_EQ(data.actual_torque, expected[cycle][i].actual_torque);
+                    EXPECT_EQ(data.timestamp, packet.timestamp_ns);
+                }
+                ++cycle;
+            });
+
+            EXPECT_EQ(stats.packets, 11u);
+            EXPECT_EQ(stats.cycles, 5u);
+            EXPECT_EQ(stats.slave_frames, 20u);
+            EXPECT_EQ(stats.not_ethercat, 1u);
+            EXPECT_EQ(manager.committedCycle(), 5u);
+            EXPECT_FALSE(capture.truncated());
+
+            // a second pass sees the same packets
+            capture.rewind();
+            CapturedPacket packet;
+            size_t count = 0;
+            while (capture.next(packet)) {
+                ++count;
+            }
+            EXPECT_EQ(count, 11u);
+        }
+    }
+}
+
+// ============================================================================
+// TEST CASE 4: pcapng Sections, Interfaces and Resolutions
+// ============================================================================
+
+TEST_F(CaptureTest, ReadsPcapngInterfacesAndResolutions) {
+    std::vector<uint8_t> image(generator_.image_size());
+    generator_.next_cycle(image);
+    const std::vector<uint8_t> frame = ecat_frame({{EcatCommand::LRD, kLogicalBase, image, 4}});
+
+    std::vector<uint8_t> file;
+    pcapng_section(file);
+    pcapng_interface(file, 1);             // microseconds (default)
+    pcapng_interface(file, 1, 9);          // nanoseconds
+    pcapng_interface(file, 113);           // Linux cooked: skipped
+    pcapng_interface(file, 1, 0x80 | 10);  // 2^-10 s
+    pcapng_packet(file, 0, 1500000, frame);
+    pcapng_packet(file, 1, 2000000123, frame);
+    pcapng_packet(file, 2, 1, frame);
+    pcapng_block(file, 5, std::vector<uint8_t>(20, 0)); // interface statistics: skipped
+    pcapng_packet(file, 3, 3 * 1024 + 512, frame);
+    // a new section forgets the interfaces
+    pcapng_section(file);
+    pcapng_interface(file, 1, 3);          // milliseconds
+    pcapng_packet(file, 0, 42, frame);
+
+    CaptureFile capture(file.data(), file.size());
+    EXPECT_EQ(capture.format(), CaptureFile::Format::PcapNg);
+    std::vector<uint64_t> timestamps;
+    CapturedPacket packet;
+    while (capture.next(packet)) {
+        ASSERT_EQ(packet.captured_length, frame.size());
+        timestamps.push_back(packet.timestamp_ns);
+    }
+    EXPECT_FALSE(capture.truncated());
+    EXPECT_EQ(timestamps, (std::vector<uint64_t>{1500000000, 2000000123, 3500000000, 42000000}));
+
+    // cut off inside the last block: ends at the last whole packet
+    CaptureFile cut(file.data(), file.size() - 7);
+    size_t count = 0;
+    while (cut.next(packet)) {
+        ++count;
+    }
+    EXPECT_EQ(count, 3u);
+    EXPECT_TRUE(cut.truncated());
+
+    // packet on an interface that was never described
+    std::vector<uint8_t> orphan;
+    pcapng_section(orphan);
+    pcapng_packet(orphan, 0, 0, frame);
+    CaptureFile bad(orphan.data(), orphan.size());
+    EXPECT_THROW(bad.next(packet), std::invalid_argument);
+
+    const std::vector<uint8_t> junk(64, 0x5A);
+    EXPECT_THROW(CaptureFile(junk.data(), junk.size()), std::invalid_argument);
+}
+
+// ============================================================================
+// TEST CASE 5: Memory-Mapped Files
+// ============================================================================
+
+TEST_F(CaptureTest, MapsCaptureFilesFromDisk) {
+    std::vector<Packet> packets;
+    for (uint64_t c = 1; c <= 3; ++c) {
+        const std::vector<Packet> cycle = next_cycle_packets(c * 1000000);
+        packets.insert(packets.end(), cycle.begin(), cycle.end());
+    }
+    std::vector<uint8_t> file = pcap(packets, true);
+    file.resize(file.size() - 5); // capture still being written
+
+    const std::string path = ::testing::TempDir() + "star_capture_test.pcap";
+    FILE* out = std::fopen(path.c_str(), "wb");
+    ASSERT_NE(out, nullptr);
+    std::fwrite(file.data(), 1, file.size(), out);
+    std::fclose(out);
+
+    {
+        CaptureFile capture(path);
+        EXPECT_EQ(capture.size(), file.size());
+        StarManager manager;
+        const CaptureStats stats = replay_capture(capture, decoder_, manager);
+        EXPECT_EQ(stats.packets, 5u);
+        EXPECT_EQ(stats.cycles, 2u);
+        EXPECT_TRUE(capture.truncated());
+    }
+    std::remove(path.c_str());
+
+    EXPECT_THROW(CaptureFile{path}, std::runtime_error);
+}
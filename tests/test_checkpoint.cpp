@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <string>
+#include <vector>
+#include "checkpoint.hpp"
+#include "Ethercat_Hardware_Interface.hpp"
+#include "recorder.hpp"
+#include "load_generator.hpp"
+#include "pdo_test_utils.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+class CheckpointTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        std::remove(path_.c_str());
+        std::remove((path_ + ".tmp").c_str());
+    }
+
+    std::string path_ = ::testing::TempDir() + "star_checkpoint.bin";
+    std::vector<uint8_t> slaves_order_ = {7, 3, 12, 0};
+};
+
+// ============================================================================
+// TEST CASE 1: Warm Restart of a Line
+// ============================================================================
+
+TEST_F(CheckpointTest, RestoresRegistryCommandsAndRecorder) {
+    LoadGenerator generator(slaves_order_.size());
+    std::vector<uint8_t> image(generator.image_size());
+    std::vector<SlaveRealTimeData> last(slaves_order_.size());
+    uint64_t cycle = 0;
+    {
+        Ethercat_Hardware_Interface hw(slaves_order_);
+        Recorder recorder(4);
+        hw.setCommand(12, SlaveCommandData{0x000F, 5000, -20, 300, 0x08});
+        for (int i = 0; i < 6; ++i) {
+            generator.next_cycle(image);
+            hw.read_kernel(image);
+            StarSnapshot snapshot;
+            hw.star_manager().readSnapshot(snapshot);
+            recorder.record(1, snapshot);
+        }
+        for (size_t i = 0; i < slaves_order_.size(); ++i) {
+            last[i] = hw.star_manager().getSlaveData(slaves_order_[i]);
+        }
+        cycle = hw.star_manager().committedCycle();
+        save_checkpoint(path_, hw, &recorder);
+    }
+
+    Ethercat_Hardware_Interface hw(slaves_order_);
+    Recorder recorder(2); // smaller ring: keeps the newest entries
+    ASSERT_TRUE(restore_checkpoint(path_, hw, &recorder));
+
+    // readers see the last-known values at once, flagged restored
+    EXPECT_EQ(hw.star_manager().committedCycle(), cycle + 1);
+    StarSnapshot snapshot;
+    hw.star_manager().readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.aggregates.restored, slaves_order_.size());
+    for (size_t i = 0; i < slaves_order_.size(); ++i) {
+        SlaveRealTimeData data = hw.star_manager().getSlaveData(slaves_order_[i]);
+        EXPECT_EQ(data.actual_position, last[i].actual_position);
+        EXPECT_EQ(data.status_word, last[i].status_word);
+        EXPECT_FLOAT_EQ(data.motor_temperature, last[i].motor_temperature);
+        EXPECT_EQ(data.timestamp, last[i].timestamp);
+        EXPECT_EQ(data.slave_position, slaves_order_[i]);
+        EXPECT_TRUE(data.restored);
+        EXPECT_EQ(hw.star_manager().arrivalStats(slaves_order_[i]).intervals, 5u);
+    }
+
+    EXPECT_EQ(recorder.written(), 6u);
+    EXPECT_EQ(recorder.size(), 2u);
+    EXPECT_EQ(recorder.latest().cycle, cycle);
+    EXPECT_EQ(recorder.latest().aggregates.slave_count, slaves_order_.size());
+
+    // commands come back and go out with the next output image
+    std::vector<uint8_t> output(hw.output_image_size());
+    hw.write_kernel(output);
+    ReadState parser;
+    SlaveCommandData slave12 = parser.parse_command(output.data() + 2 * PdoOutputLayout::size, PdoOutputLayout::size);
+    EXPECT_EQ(slave12.control_word, 0x000F);
+    EXPECT_EQ(slave12.target_position, 5000);
+    EXPECT_EQ(slave12.mode_of_operation, 0x08);
+
+    // the next input clears the flag and the cycle count goes on
+    generator.next_cycle(image);
+    hw.read_kernel(image);
+    EXPECT_EQ(hw.star_manager().committedCycle(), cycle + 2);
+    hw.star_manager().readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.aggregates.restored, 0u);
+    for (size_t i = 0; i < slaves_order_.size(); ++i) {
+        SlaveRealTimeData data = hw.star_manager().getSlaveData(slaves_order_[i]);
+        EXPECT_FALSE(data.restored);
+        EXPECT_EQ(data.actual_position, generator.slave(i).actual_position);
+        // the restart gap is not an interval
+        EXPECT_EQ(hw.star_manager().arrivalStats(slaves_order_[i]).intervals, 5u);
+    }
+}
+
+// ============================================================================
+// TEST CASE 2: Lazy Decode Modes
+// ============================================================================
+
+TEST_F(CheckpointTest, RestoresIntoLazyRegistries) {
+    FieldFormats fixed;
+    fixed.motor_temperature = ScaledFormat{ValueEncoding::Int16, 0.1f, 0.0f};
+    auto plain = generate_pdo_buffer(0x0237, 1000000, 12, -5, 0x09, 0x2310, 0x0001, 36.5f);
+    auto scaled = generate_pdo_buffer(0x0237, -77, 12, -5, 0x09, 0x2310, 0x0001, 0.0f);
+    insert<int16_t>(scaled, PdoInputLayout::motor_temperature, 612);
+
+    for (DecodeMode saved_mode : {DecodeMode::Eager, DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        for (DecodeMode restored_mode : {DecodeMode::Eager, DecodeMode::Lazy, DecodeMode::LazyCached}) {
+            StarManager saved(kAnyNumaNode, saved_mode);
+            saved.setFieldFormats(2, fixed);
+            saved.input_cycle({{1, plain.data(), plain.size()}, {2, scaled.data(), scaled.size()}});
+            CheckpointWriter writer;
+            saved.writeCheckpoint(writer);
+            writer.save(path_);
+
+            std::vector<uint8_t> file;
+            ASSERT_TRUE(CheckpointReader::load(path_, file));
+            CheckpointReader reader(std::move(file));
+            StarManager restored(kAnyNumaNode, restored_mode);
+            ASSERT_TRUE(restored.restoreCheckpoint(reader));
+
+            EXPECT_EQ(restored.getSlaveData(1).actual_position, 1000000);
+            EXPECT_FLOAT_EQ(restored.getSlaveData(1).motor_temperature, 36.5f);
+            EXPECT_EQ(restored.getField<&SlaveRealTimeData::actual_position>(2), -77);
+            EXPECT_FLOAT_EQ(restored.getField<&SlaveRealTimeData::motor_temperature>(2), 61.2f);
+            EXPECT_FLOAT_EQ(restored.getSlaveData(2).motor_temperature, 61.2f);
+            EXPECT_TRUE(restored.getSlaveData(2).restored);
+
+            StarSnapshot snapshot;
+            restored.readSnapshot(snapshot);
+            EXPECT_EQ(snapshot.getSlaveData(1).error_code, 0x2310);
+            EXPECT_TRUE(snapshot.getSlaveData(1).restored);
+        }
+    }
+}
+
+// ============================================================================
+// TEST CASE 3: Missing and Corrupt Checkpoints
+// ============================================================================
+
+TEST_F(CheckpointTest, MissingFileIsAColdStartAndCorruptFileThrows) {
+    Ethercat_Hardware_Interface hw(slaves_order_);
+    EXPECT_FALSE(restore_checkpoint(path_, hw));
+    EXPECT_EQ(hw.star_manager().committedCycle(), 0u);
+
+    LoadGenerator generator(slaves_order_.size());
+    std::vector<uint8_t> image(generator.image_size());
+    generator.next_cycle(image);
+    hw.read_kernel(image);
+    save_checkpoint(path_, hw);
+
+    std::vector<uint8_t> file;
+    ASSERT_TRUE(CheckpointReader::load(path_, file));
+    EXPECT_NO_THROW(CheckpointReader{file});
+
+    // a flipped byte fails the checksum; nothing is applied
+    std::vector<uint8_t> corrupt = file;
+    corrupt[corrupt.size() / 2] ^= 0x40;
+    EXPECT_THROW(CheckpointReader{corrupt}, std::invalid_argument);
+    {
+        std::ofstream out(path_, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(corrupt.data()), static_cast<std::streamsize>(corrupt.size()));
+    }
+    Ethercat_Hardware_Interface fresh(slaves_order_);
+    EXPECT_THROW(restore_checkpoint(path_, fresh), std::invalid_argument);
+    EXPECT_EQ(fresh.star_manager().committedCycle(), 0u);
+
+    // cut short, foreign or of another version
+    std::vector<uint8_t> truncated(file.begin(), file.begin() + file.size() / 2);
+    EXPECT_THROW(CheckpointReader{truncated}, std::invalid_argument);
+    std::vector<uint8_t> foreign = file;
+    foreign[0] = 'X';
+    EXPECT_THROW(CheckpointReader{foreign}, std::invalid_argument);
+    std::vector<uint8_t> newer = file;
+    newer[8] = kCheckpointVersion + 1;
+    EXPECT_THROW(CheckpointReader{newer}, std::invalid_argument);
+
+    // a checkpoint without a recorder section leaves the recorder alone
+    std::ofstream(path_, std::ios::binary | std::ios::trunc)
+        .write(reinterpret_cast<const char*>(file.data()), static_cast<std::streamsize>(file.size()));
+    Recorder recorder(4);
+    Ethercat_Hardware_Interface restored(slaves_order_);
+    EXPECT_TRUE(restore_checkpoint(path_, restored, &recorder));
+    EXPECT_EQ(recorder.written(), 0u);
+    EXPECT_EQ(restored.star_manager().committedCycle(), 2u);
+}
+
+// ============================================================================
+// TEST CASE 4: Inconsistent Sections Apply Nothing
+// ============================================================================
+
+TEST_F(CheckpointTest, MalformedSectionLeavesEveryComponentAsItWas) {
+    LoadGenerator generator(slaves_order_.size());
+    std::vector<uint8_t> image(generator.image_size());
+    Ethercat_Hardware_Interface saved(slaves_order_);
+    saved.setCommand(12, SlaveCommandData{0x000F, 5000, -20, 300, 0x08});
+    generator.next_cycle(image);
+    saved.read_kernel(image);
+
+    // checksum and bounds are fine, but the recorder claims more entries than it wrote
+    CheckpointWriter writer;
+    saved.writeCheckpoint(writer);
+    writer.begin_section(CheckpointSection::Recorder);
+    writer.put(uint64_t{1});
+    writer.put(uint64_t{2});
+    writer.end_section();
+    writer.save(path_);
+
+    Ethercat_Hardware_Interface hw(slaves_order_);
+    hw.setCommand(12, SlaveCommandData{0x0006, 1, 0, 0, 0x01});
+    Recorder recorder(4);
+    EXPECT_THROW(restore_checkpoint(path_, hw, &recorder), std::invalid_argument);
+
+    // the registry and commands, read before the recorder section, were not applied either
+    EXPECT_EQ(hw.star_manager().committedCycle(), 0u);
+    EXPECT_THROW(hw.star_manager().getSlaveData(12), std::out_of_range);
+    EXPECT_EQ(recorder.written(), 0u);
+    std::vector<uint8_t> output(hw.output_image_size());
+    hw.write_kernel(output);
+    ReadState parser;
+    SlaveCommandData slave12 = parser.parse_command(output.data() + 2 * PdoOutputLayout::size, PdoOutputLayout::size);
+    EXPECT_EQ(slave12.control_word, 0x0006);
+    EXPECT_EQ(slave12.target_position, 1);
+}
+
+// ============================================================================
+// TEST CASE 5: Flagged Float Fields Survive a Restart
+// ============================================================================
+
+TEST_F(CheckpointTest, RestoresInvalidFieldFlags) {
+    FloatPolicies policies;
+    policies.motor_temperature.replace_non_finite = true;
+    auto good = generate_pdo_buffer(0x0237, 10, 0, 0, 0x08, 0, 0, 40.0f);
+    auto bad = generate_pdo_buffer(0x0237, 11, 0, 0, 0x08, 0, 0, std::numeric_limits<float>::quiet_NaN());
+
+    StarManager saved;
+    saved.setFloatPolicies(policies);
+    saved.input_cycle({{1, good.data(), good.size()}, {2, good.data(), good.size()}});
+    saved.input_cycle({{1, good.data(), good.size()}, {2, bad.data(), bad.size()}});
+    ASSERT_EQ(saved.getSlaveData(2).invalid_fields, kInvalidMotorTemperature);
+    CheckpointWriter writer;
+    saved.writeCheckpoint(writer);
+    writer.save(path_);
+
+    std::vector<uint8_t> file;
+    ASSERT_TRUE(CheckpointReader::load(path_, file));
+    CheckpointReader reader(std::move(file));
+    StarManager restored;
+    ASSERT_TRUE(restored.restoreCheckpoint(reader));
+    EXPECT_EQ(restored.getSlaveData(1).invalid_fields, 0u);
+    EXPECT_EQ(restored.getSlaveData(2).invalid_fields, kInvalidMotorTemperature);
+    EXPECT_FLOAT_EQ(restored.getSlaveData(2).motor_temperature, 40.0f); // the last good value
+    EXPECT_EQ(restored.aggregates().invalid_fields, 1u);
+}
@@ -3,95 +3,13 @@
 #include <cstdint>
 #include <cstring>
 #include <limits>
+#include <array>
 #include "data_structuring.hpp"
 #include "slaves_state_struct.hpp"
+#include "cpu_dispatch.hpp"
+#include "pdo_test_utils.hpp"
 
-// ============================================================================
-// MOCK DATA GENERATION FUNCTIONS
-// ============================================================================
-
-/**
- * @brief Helper function to append a 16-bit unsigned integer to buffer (little-endian)
- * EtherCAT uses little-endian byte order, so least significant byte comes first
- */
-void append_uint16(std::vector<uint8_t>& buffer, uint16_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));           // LSB (Least Significant Byte)
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));    // MSB (Most Significant Byte)
-}
-
-//static_cast
-    //int16_t value = 100;
-    //int32_t larger = static_cast<int32_t>(value);  // Convert int16 to int32
-
-/**
- * @brief Helper function to append a 16-bit signed integer to buffer (little-endian)
- */
-void append_int16(std::vector<uint8_t>& buffer, int16_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-}
-
-/**
- * @brief Helper function to append a 32-bit signed integer to buffer (little-endian)
- */
-void append_int32(std::vector<uint8_t>& buffer, int32_t value) {
-    buffer.push_back(static_cast<uint8_t>(value & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 8) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 16) & 0xFF));
-    buffer.push_back(static_cast<uint8_t>((value >> 24) & 0xFF));
-}
-
-/**
- * @brief Helper function to append a float to buffer (little-endian)
- * Uses memcpy to preserve exact bit representation
- */
-void append_float(std::vector<uint8_t>& buffer, float value) {
-    uint8_t bytes[4];
-    std::memcpy(bytes, &value, sizeof(float));
-    buffer.insert(buffer.end(), bytes, bytes + 4);
-}
-
-/**
- * @brief Generate a complete PDO buffer matching the EtherCAT protocol layout
- * This simulates the raw byte stream that would come from the EtherCAT kernel module
- * 
- * @param status_word CiA402 status word (0x6041)
- * @param actual_position Current position in encoder counts (0x6064)
- * @param actual_velocity Current velocity in counts/sec (0x606C)
- * @param actual_torque Current torque/effort (0x6077)
- * @param mode_display Active operation mode (0x6061)
- * @param error_code Custom error code from slave firmware
- * @param system_status Custom system status flags
- * @param motor_temperature Motor temperature in Celsius
- * @return std::vector<uint8_t> Complete PDO buffer in protocol byte order
- */
-std::vector<uint8_t> generate_pdo_buffer(
-    uint16_t status_word,
-    int32_t actual_position,
-    int32_t actual_velocity,
-    int16_t actual_torque,
-    uint8_t mode_display,
-    uint16_t error_code,
-    uint16_t system_status,
-    float motor_temperature
-) {  //arguments are provided in SetUp() and other tests
-    std::vector<uint8_t> buffer;
-    
-    // Append fields in the exact order they appear in the struct
-    // This matches the byte layout expected by the protocol
-    append_uint16(buffer, status_word);                              // 2 bytes: offset 0
-    append_int32(buffer, actual_position);                           // 4 bytes: offset 2
-    append_int32(buffer, actual_velocity);                           // 4 bytes: offset 6
-    append_int16(buffer, actual_torque);                             // 2 bytes: offset 10
-    buffer.push_back(mode_display);                                   // 1 byte: offset 12
-    append_uint16(buffer, error_code);                                // 2 bytes: offset 13
-    append_uint16(buffer, system_status);                             // 2 bytes: offset 15
-    append_float(buffer, motor_temperature);                          // 4 bytes: offset 17
-    
-    // Total: 21 bytes (PDO data only, excluding timestamp, slave_position, data_valid which are metadata)
-    
-    return buffer;
-}
+// generate_pdo_buffer(): tests/pdo_test_utils.hpp, built on the library encoder
 
 // ============================================================================
 // TEST FIXTURE: Sets up common test data and environment
@@ -272,11 +190,9 @@ TEST_F(DataStructuringTest, HandlesInvalidBufferSize) {
     // Create a buffer that's too small
     std::vector<uint8_t> invalid_buffer = {0x01, 0x02, 0x03};  // Only 3 bytes
     
-    // Parser should detect this and mark data as invalid
-    // ReadState parser;
-    // SlaveRealTimeData result = parser.parse(invalid_buffer);
-    // EXPECT_FALSE(result.data_valid);
-    // EXPECT_THROW(parser.parse(invalid_buffer), std::runtime_error);
+    // Parser should detect this: extract<T> is bounds-aware and throws
+    ReadState parser;
+    EXPECT_THROW(parser.parse(invalid_buffer), std::out_of_range);
     
     // For now, just verify the buffer is indeed too small
     EXPECT_LT(invalid_buffer.size(), 21);
@@ -410,6 +326,347 @@ TEST_F(DataStructuringTest, HandlesMultipleSlaves) {
     // }
 }
 
+// ============================================================================
+// TEST CASE 11: Bit-Granular Fields - Extraction
+// ============================================================================
+
+/**
+ * @brief Test 1-bit and 4-bit fields that are not byte aligned
+ * Packed digital I/O terminals map fields across byte boundaries
+ */
+TEST_F(DataStructuringTest, ExtractsBitFields) {
+    // 0xA5 = 1010 0101, 0x3C = 0011 1100 (bit 0 = LSB of byte 0)
+    std::vector<uint8_t> image = {0xA5, 0x3C};
+
+    EXPECT_EQ(extract_bits(image, BitField{0, 1}), 1u);
+    EXPECT_EQ(extract_bits(image, BitField{1, 1}), 0u);
+    EXPECT_EQ(extract_bits(image, BitField{7, 1}), 1u);
+    EXPECT_EQ(extract_bits(image, BitField{4, 4}), 0xAu);   // high nibble of byte 0
+    EXPECT_EQ(extract_bits(image, BitField{6, 4}), 0x2u);   // straddles bytes: bits 6,7 of 0xA5 + bits 0,1 of 0x3C
+    EXPECT_EQ(extract_bits(image, BitField{0, 16}), 0x3CA5u);
+}
+
+// ============================================================================
+// TEST CASE 12: Bit-Granular Fields - Insertion and Bounds
+// ============================================================================
+
+/**
+ * @brief Test that insert_bits only touches the field's bits and rejects out-of-range fields
+ */
+TEST_F(DataStructuringTest, InsertsBitFieldsAndChecksBounds) {
+    std::vector<uint8_t> image = {0xFF, 0x00, 0x00};
+
+    insert_bits(image, BitField{6, 4}, 0x5);   // 0101 across bytes 0 and 1
+    EXPECT_EQ(extract_bits(image, BitField{6, 4}), 0x5u);
+    EXPECT_EQ(image[0] & 0x3F, 0x3F);          // bits below the field untouched
+    EXPECT_EQ(image[2], 0x00);
+
+    EXPECT_THROW(extract_bits(image, BitField{20, 5}), std::out_of_range);
+    EXPECT_THROW(insert_bits(image, BitField{23, 2}, 1), std::out_of_range);
+    EXPECT_THROW(extract_bits(image, BitField{SIZE_MAX - 3, 8}), std::out_of_range); // no wrap-around
+    EXPECT_THROW(insert_bits(image, BitField{SIZE_MAX - 3, 8}, 1), std::out_of_range);
+    EXPECT_THROW(extract_bits(image, BitField{0, 0}), std::invalid_argument);
+    EXPECT_THROW(extract_bits(image, BitField{0, 33}), std::invalid_argument);
+}
+
+// ============================================================================
+// TEST CASE 13: Digital I/O Image - Batch Extraction into a Bitset
+// ============================================================================
+
+/**
+ * @brief Test batch extraction of scattered digital inputs from a whole I/O image
+ * Runs with pext (if the CPU has BMI2) and with the shift/mask fallback
+ */
+TEST_F(DataStructuringTest, ExtractsDigitalInputImage) {
+    // 40-byte image; every third bit is a digital input -> 107 inputs over 6 image words
+    std::vector<uint8_t> image(40);
+    for (size_t i = 0; i < image.size(); ++i) {
+        image[i] = static_cast<uint8_t>(i * 73 + 11);
+    }
+    std::vector<size_t> offsets;
+    for (size_t bit = 1; bit < image.size() * 8; bit += 3) {
+        offsets.push_back(bit);
+    }
+    DigitalIoMap map(offsets);
+    ASSERT_EQ(map.size(), offsets.size());
+
+    for (SimdLevel level : {SimdLevel::Scalar, detect_simd_level()}) {
+        force_simd_level(level);
+
+        std::vector<uint64_t> bits;
+        map.extract(image, bits);
+        ASSERT_EQ(bits.size(), (offsets.size() + 63) / 64);
+
+        for (size_t k = 0; k < offsets.size(); ++k) {
+            bool expected = extract_bits(image, BitField{offsets[k], 1}) != 0;
+            bool actual = (bits[k / 64] >> (k % 64)) & 1;
+            EXPECT_EQ(actual, expected) << "input " << k << " at " << simd_level_name(level);
+        }
+    }
+    reset_simd_level();
+
+    std::vector<uint64_t> bits;
+    std::vector<uint8_t> short_image(10);
+    EXPECT_THROW(map.extract(short_image, bits), std::out_of_range);
+}
+
+// ============================================================================
+// TEST CASE 14: Digital I/O Image - Bitset back into the Image
+// ============================================================================
+
+/**
+ * @brief Test that insert() writes digital outputs and leaves unmapped bits alone
+ */
+TEST_F(DataStructuringTest, InsertsDigitalOutputImage) {
+    std::vector<size_t> offsets = {0, 3, 9, 63, 64, 65, 130};
+    DigitalIoMap map(offsets);
+
+    for (SimdLevel level : {SimdLevel::Scalar, detect_simd_level()}) {
+        force_simd_level(level);
+
+        std::vector<uint8_t> image(17, 0xF0);
+        std::vector<uint64_t> bits = {0b1010101};   // outputs 0, 2, 4, 6 on
+        map.insert(bits, image);
+
+        std::vector<uint64_t> read_back;
+        map.extract(image, read_back);
+        EXPECT_EQ(read_back[0], 0b1010101u) << simd_level_name(level);
+
+        EXPECT_EQ(extract_bits(image, BitField{0, 1}), 1u);
+        EXPECT_EQ(extract_bits(image, BitField{3, 1}), 0u);
+        EXPECT_EQ(extract_bits(image, BitField{4, 4}), 0xFu);   // unmapped bits keep 0xF0 pattern
+        EXPECT_EQ(extract_bits(image, BitField{130, 1}), 1u);
+    }
+    reset_simd_level();
+}
+
+// ============================================================================
+// TEST CASE 15: Generic extract<T> / insert<T> - Round Trip
+// ============================================================================
+
+enum class DriveMode : uint8_t { Position = 0x08, Velocity = 0x09, Torque = 0x0A };
+
+/**
+ * @brief Test that insert<T> and extract<T> are symmetric for every supported field type
+ * Integers of every width, float, double, enums and fixed arrays (8 analog channels)
+ */
+TEST_F(DataStructuringTest, GenericFieldsRoundTrip) {
+    const std::array<int16_t, 8> analog = {-32768, -1, 0, 1, 1000, -1000, 32767, 42};
+    std::vector<uint8_t> buffer(1 + 2 + 4 + 8 + 4 + 8 + 1 + 16 + 1, 0);
+
+    size_t offset = 0;
+    insert<int8_t>(buffer, offset, -5);                                 offset += 1;
+    insert<uint16_t>(buffer, offset, 0xBEEF);                           offset += 2;
+    insert<int32_t>(buffer, offset, INT32_MIN);                         offset += 4;
+    insert<uint64_t>(buffer, offset, 0x0123456789ABCDEFULL);            offset += 8;
+    insert<float>(buffer, offset, -273.15f);                            offset += 4;
+    insert<double>(buffer, offset, 6.02214076e23);                      offset += 8;
+    insert<DriveMode>(buffer, offset, DriveMode::Torque);               offset += 1;
+    insert<std::array<int16_t, 8>>(buffer, offset, analog);             offset += 16;
+    insert<bool>(buffer, offset, true);
+
+    offset = 0;
+    EXPECT_EQ(extract<int8_t>(buffer, offset), -5);                     offset += 1;
+    EXPECT_EQ(extract<uint16_t>(buffer, offset), 0xBEEF);               offset += 2;
+    EXPECT_EQ(extract<int32_t>(buffer, offset), INT32_MIN);             offset += 4;
+    EXPECT_EQ(extract<uint64_t>(buffer, offset), 0x0123456789ABCDEFULL); offset += 8;
+    EXPECT_FLOAT_EQ(extract<float>(buffer, offset), -273.15f);          offset += 4;
+    EXPECT_DOUBLE_EQ(extract<double>(buffer, offset), 6.02214076e23);   offset += 8;
+    EXPECT_EQ(extract<DriveMode>(buffer, offset), DriveMode::Torque);   offset += 1;
+    EXPECT_EQ((extract<std::array<int16_t, 8>>(buffer, offset)), analog); offset += 16;
+    EXPECT_TRUE(extract<bool>(buffer, offset));
+
+    // Little-endian on the wire regardless of the host: 0xBEEF -> EF BE
+    EXPECT_EQ(buffer[1], 0xEF);
+    EXPECT_EQ(buffer[2], 0xBE);
+}
+
+// ============================================================================
+// TEST CASE 16: Generic extract<T> / insert<T> - Bounds
+// ============================================================================
+
+/**
+ * @brief Test that fields reaching past the end of the buffer are rejected, not read
+ */
+TEST_F(DataStructuringTest, GenericFieldsAreBoundsChecked) {
+    // size and offsets read at run time: with constants, optimized builds trace the
+    // rejected accesses below into the buffer and warn (-Wstringop-overflow, -Warray-bounds)
+    volatile size_t size = 6;
+    volatile size_t far = SIZE_MAX;
+    std::vector<uint8_t> buffer(size, 0);
+
+    EXPECT_NO_THROW(extract<uint32_t>(buffer, 2));
+    EXPECT_THROW(extract<uint32_t>(buffer, 3), std::out_of_range);
+    EXPECT_THROW(extract<uint8_t>(buffer, 6), std::out_of_range);
+    EXPECT_THROW(extract<uint16_t>(buffer, far), std::out_of_range);        // no wrap-around
+    EXPECT_THROW((extract<std::array<int16_t, 4>>(buffer, 0)), std::out_of_range);
+    EXPECT_THROW(insert<double>(buffer, 0, 1.0), std::out_of_range);
+
+    // parse() of the fixture buffer shortened by one byte loses the last float byte
+    std::vector<uint8_t> truncated(test_buffer_.begin(), test_buffer_.end() - 1);
+    ReadState parser;
+    EXPECT_THROW(parser.parse(truncated), std::out_of_range);
+    EXPECT_NO_THROW(parser.parse(test_buffer_));
+}
+
+// ============================================================================
+// TEST CASE 17: Encoder / Decoder Symmetry
+// ============================================================================
+
+/**
+ * @brief Test that WriteState and ReadState, generated from the same layouts, round-trip
+ * Covers both directions: input PDO (SlaveRealTimeData) and output PDO (SlaveCommandData)
+ */
+TEST_F(DataStructuringTest, EncoderAndDecoderAreSymmetric) {
+    WriteState encoder;
+    ReadState parser;
+
+    // In place into a larger caller buffer (e.g. a process image) at a frame offset
+    std::vector<uint8_t> image(3 * PdoInputLayout::size, 0xCC);
+    encoder.encode(expected_data_, image.data() + PdoInputLayout::size, PdoInputLayout::size);
+    SlaveRealTimeData decoded = parser.parse(image.data() + PdoInputLayout::size, PdoInputLayout::size);
+
+    EXPECT_EQ(decoded.status_word, expected_data_.status_word);
+    EXPECT_EQ(decoded.actual_position, expected_data_.actual_position);
+    EXPECT_EQ(decoded.actual_velocity, expected_data_.actual_velocity);
+    EXPECT_EQ(decoded.actual_torque, expected_data_.actual_torque);
+    EXPECT_EQ(decoded.mode_display, expected_data_.mode_display);
+    EXPECT_EQ(decoded.error_code, expected_data_.error_code);
+    EXPECT_EQ(decoded.system_status, expected_data_.system_status);
+    EXPECT_FLOAT_EQ(decoded.motor_temperature, expected_data_.motor_temperature);
+    EXPECT_EQ(image[0], 0xCC);                          // neighbouring frames untouched
+    EXPECT_EQ(image[2 * PdoInputLayout::size], 0xCC);
+
+    SlaveCommandData command{0x000F, -123456, 789, -42, 0x08};
+    std::vector<uint8_t> out(PdoOutputLayout::size);
+    encoder.encode_command(command, out.data(), out.size());
+    SlaveCommandData back = parser.parse_command(out.data(), out.size());
+    EXPECT_EQ(back.control_word, 0x000F);
+    EXPECT_EQ(back.target_position, -123456);
+    EXPECT_EQ(back.target_velocity, 789);
+    EXPECT_EQ(back.target_torque, -42);
+    EXPECT_EQ(back.mode_of_operation, 0x08);
+
+    std::vector<uint8_t> too_small(PdoInputLayout::size - 1);
+    EXPECT_THROW(encoder.encode(expected_data_, too_small), std::out_of_range);
+}
+
+// ============================================================================
+// TEST CASE 18: Fixed-Point Fields
+// ============================================================================
+
+/**
+ * @brief Test scaled-integer decoding (STM32 boards without float PDOs) next to IEEE floats
+ * value = raw * scale + offset
+ */
+TEST_F(DataStructuringTest, DecodesFixedPointFields) {
+    std::vector<uint8_t> buffer(4, 0);
+
+    // Int16, 0.1 degC per count: 455 -> 45.5 degC
+    ScaledFormat deci_celsius{ValueEncoding::Int16, 0.1f, 0.0f};
+    insert<int16_t>(buffer, 0, 455);
+    EXPECT_FLOAT_EQ(decode_scaled(buffer.data(), buffer.size(), 0, deci_celsius), 45.5f);
+    insert<int16_t>(buffer, 0, -123);
+    EXPECT_FLOAT_EQ(decode_scaled(buffer.data(), buffer.size(), 0, deci_celsius), -12.3f);
+
+    // UInt16 with offset: 0.5 degC per count starting at -40 degC
+    ScaledFormat offset_format{ValueEncoding::UInt16, 0.5f, -40.0f};
+    encode_scaled(buffer.data(), buffer.size(), 0, offset_format, 25.0f);
+    EXPECT_EQ(extract<uint16_t>(buffer, 0), 130);
+    EXPECT_FLOAT_EQ(decode_scaled(buffer.data(), buffer.size(), 0, offset_format), 25.0f);
+
+    // Out-of-range values saturate instead of wrapping
+    encode_scaled(buffer.data(), buffer.size(), 0, deci_celsius, 1.0e6f);
+    EXPECT_EQ(extract<int16_t>(buffer, 0), INT16_MAX);
+
+    // Bounds: a 4-byte Int32 field does not fit at offset 2
+    EXPECT_THROW(decode_scaled(buffer.data(), buffer.size(), 2, ScaledFormat{ValueEncoding::Int32, 1.0f, 0.0f}),
+                 std::out_of_range);
+}
+
+/**
+ * @brief Test ReadState/WriteState with a fixed-point motor_temperature
+ */
+TEST_F(DataStructuringTest, ParsesFixedPointTemperature) {
+    FieldFormats formats;
+    formats.motor_temperature = ScaledFormat{ValueEncoding::Int32, 0.01f, 0.0f};
+
+    std::vector<uint8_t> buffer(PdoInputLayout::size);
+    WriteState encoder;
+    encoder.encode(expected_data_, buffer.data(), buffer.size(), formats);
+    EXPECT_EQ(extract<int32_t>(buffer, PdoInputLayout::motor_temperature), 4550);
+
+    ReadState parser;
+    SlaveRealTimeData result = parser.parse(buffer.data(), buffer.size(), formats);
+    EXPECT_FLOAT_EQ(result.motor_temperature, 45.5f);
+    EXPECT_EQ(result.actual_position, expected_data_.actual_position);
+
+    // Default formats keep the IEEE float path
+    SlaveRealTimeData as_float = parser.parse(test_buffer_.data(), test_buffer_.size(), FieldFormats{});
+    EXPECT_FLOAT_EQ(as_float.motor_temperature, 45.5f);
+}
+
+// ============================================================================
+// TEST CASE 19: Golden Frames - Wire Bytes Written Out by Hand
+// ============================================================================
+
+/**
+ * @brief Test parse and encode against frames spelled out byte by byte, independent of
+ * the layout tables both are generated from: a wrong offset or byte order in the tables
+ * would round-trip in the symmetry test but not here
+ */
+TEST_F(DataStructuringTest, MatchesGoldenFrames) {
+    const std::vector<uint8_t> input_frame = {
+        0x34, 0x12,             // status_word     0x1234
+        0x40, 0x42, 0x0F, 0x00, // actual_position 1000000
+        0xB0, 0x3C, 0xFF, 0xFF, // actual_velocity -50000
+        0x64, 0x00,             // actual_torque   100
+        0x08,                   // mode_display    position mode
+        0x00, 0x00,             // error_code      none
+        0xFF, 0x00,             // system_status   0x00FF
+        0x00, 0x00, 0x36, 0x42  // motor_temperature 45.5f (IEEE 754 0x42360000)
+    };
+    ASSERT_EQ(input_frame.size(), PdoInputLayout::size);
+
+    ReadState parser;
+    SlaveRealTimeData parsed = parser.parse(input_frame);
+    EXPECT_EQ(parsed.status_word, 0x1234);
+    EXPECT_EQ(parsed.actual_position, 1000000);
+    EXPECT_EQ(parsed.actual_velocity, -50000);
+    EXPECT_EQ(parsed.actual_torque, 100);
+    EXPECT_EQ(parsed.mode_display, 0x08);
+    EXPECT_EQ(parsed.error_code, 0x0000);
+    EXPECT_EQ(parsed.system_status, 0x00FF);
+    EXPECT_FLOAT_EQ(parsed.motor_temperature, 45.5f);
+
+    WriteState encoder;
+    std::vector<uint8_t> encoded(PdoInputLayout::size);
+    encoder.encode(expected_data_, encoded);
+    EXPECT_EQ(encoded, input_frame);
+    EXPECT_EQ(test_buffer_, input_frame); // the fixture buffer the other tests use
+
+    const std::vector<uint8_t> output_frame = {
+        0x0F, 0x00,             // control_word      0x000F
+        0xC0, 0x1D, 0xFE, 0xFF, // target_position   -123456
+        0x15, 0x03, 0x00, 0x00, // target_velocity   789
+        0xD6, 0xFF,             // target_torque     -42
+        0x08                    // mode_of_operation position mode
+    };
+    ASSERT_EQ(output_frame.size(), PdoOutputLayout::size);
+
+    SlaveCommandData command = parser.parse_command(output_frame.data(), output_frame.size());
+    EXPECT_EQ(command.control_word, 0x000F);
+    EXPECT_EQ(command.target_position, -123456);
+    EXPECT_EQ(command.target_velocity, 789);
+    EXPECT_EQ(command.target_torque, -42);
+    EXPECT_EQ(command.mode_of_operation, 0x08);
+
+    std::vector<uint8_t> encoded_command(PdoOutputLayout::size);
+    encoder.encode_command(SlaveCommandData{0x000F, -123456, 789, -42, 0x08}, encoded_command.data(),
+                           encoded_command.size());
+    EXPECT_EQ(encoded_command, output_frame);
+}
+
 // ============================================================================
 // MAIN FUNCTION: Google Test Entry Point
 // ============================================================================
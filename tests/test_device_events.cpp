@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "device_events.hpp"
+#include "error_catalogue.hpp"
+#include "Star_Manager.hpp"
+#include "pdo_test_utils.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+class DeviceEventsTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        servo_ = catalogue_.add_device_type("servo-x");
+        catalogue_.add_code(servo_, 0x2310, Severity::Error, "Continuous overcurrent");
+        catalogue_.add_code(servo_, 0x4310, Severity::Warning, "Drive temperature high");
+        catalogue_.add_code(servo_, 0x5530, Severity::Fatal, "EEPROM fault");
+        catalogue_.add_status_bit(servo_, 3, Severity::Warning, "Fan failure");
+        catalogue_.add_status_bit(servo_, 7, Severity::Fatal, "STO active");
+    }
+
+    void TearDown() override {
+        std::remove(path_.c_str());
+    }
+
+    // one cycle with the given error code and status per slave
+    static void input(StarManager& manager, const std::vector<std::pair<uint16_t, uint16_t>>& slaves) {
+        std::vector<std::vector<uint8_t>> buffers;
+        std::vector<SlaveFrame> frames;
+        for (size_t i = 0; i < slaves.size(); ++i) {
+            buffers.push_back(generate_pdo_buffer(0x0237, 0, 0, 0, 0x08, slaves[i].first, slaves[i].second, 40.0f));
+        }
+        for (size_t i = 0; i < slaves.size(); ++i) {
+            frames.push_back({static_cast<uint8_t>(i + 1), buffers[i].data(), buffers[i].size()});
+        }
+        manager.input_cycle(frames);
+    }
+
+    ErrorCatalogue catalogue_;
+    DeviceType servo_ = 0;
+    std::string path_ = ::testing::TempDir() + "error_catalogue.txt";
+};
+
+// ============================================================================
+// TEST CASE 1: Catalogue Lookups
+// ============================================================================
+
+TEST_F(DeviceEventsTest, CatalogueMapsCodesAndStatusBits) {
+    EXPECT_EQ(catalogue_.device_type("default"), ErrorCatalogue::kDefaultDevice);
+    EXPECT_EQ(catalogue_.add_device_type("servo-x"), servo_);
+    EXPECT_EQ(catalogue_.device_type_name(servo_), "servo-x");
+    EXPECT_THROW(catalogue_.device_type("io-y"), std::out_of_range);
+    EXPECT_THROW(catalogue_.add_code(42, 1, Severity::Info, ""), std::out_of_range);
+
+    ASSERT_NE(catalogue_.code_info(servo_, 0x2310), nullptr);
+    EXPECT_EQ(catalogue_.code_info(servo_, 0x2310)->text, "Continuous overcurrent");
+    EXPECT_EQ(catalogue_.code_severity(servo_, 0x5530), Severity::Fatal);
+    EXPECT_EQ(catalogue_.code_info(ErrorCatalogue::kDefaultDevice, 0x2310), nullptr); // per device type
+    EXPECT_EQ(catalogue_.code_severity(servo_, 0x1234), Severity::Error);              // unknown code
+    EXPECT_EQ(catalogue_.code_severity(servo_, 0), Severity::Info);                    // no error
+
+    EXPECT_EQ(catalogue_.status_severity(servo_, 1u << 3), Severity::Warning);
+    EXPECT_EQ(catalogue_.status_severity(servo_, (1u << 3) | (1u << 7)), Severity::Fatal);
+    EXPECT_EQ(catalogue_.status_severity(servo_, 1u << 0), Severity::Info); // not listed
+    EXPECT_THROW(catalogue_.add_status_bit(servo_, 16, Severity::Info, ""), std::out_of_range);
+
+    catalogue_.add_code(servo_, 0x2310, Severity::Fatal, "Overcurrent"); // replaces
+    EXPECT_EQ(catalogue_.code_severity(servo_, 0x2310), Severity::Fatal);
+}
+
+TEST_F(DeviceEventsTest, CatalogueLoadsFromFile) {
+    {
+        std::ofstream out(path_);
+        out << "# drives of cell 1\n"
+               "code 0x1000 warning Generic\n"
+               "\n"
+               "[io-y]\n"
+               "code 0xFF01 fatal Bus coupler lost\n"
+               "  status 2 error Short circuit channel 3  \n"
+               "[servo-x]\n"
+               "code 0x7500 error Communication\n";
+    }
+    catalogue_.load(path_);
+
+    const DeviceType io = catalogue_.device_type("io-y");
+    EXPECT_EQ(catalogue_.code_severity(ErrorCatalogue::kDefaultDevice, 0x1000), Severity::Warning);
+    EXPECT_EQ(catalogue_.code_info(io, 0xFF01)->text, "Bus coupler lost");
+    EXPECT_EQ(catalogue_.status_bit_info(io, 2)->text, "Short circuit channel 3");
+    EXPECT_EQ(catalogue_.code_severity(io, 0xFF01), Severity::Fatal);
+    // appended to the existing type
+    EXPECT_EQ(catalogue_.code_severity(servo_, 0x7500), Severity::Error);
+    EXPECT_EQ(catalogue_.code_severity(servo_, 0x5530), Severity::Fatal);
+
+    for (const char* bad : {"code 0x1 severe text\n", "code\n", "status 16 info x\n", "flag 1 info x\n", "[]\n"}) {
+        std::ofstream(path_, std::ios::trunc) << bad;
+        EXPECT_THROW(catalogue_.load(path_), std::invalid_argument) << bad;
+    }
+    EXPECT_THROW(catalogue_.load(path_ + ".missing"), std::runtime_error);
+}
+
+// ============================================================================
+// TEST CASE 2: Event Queue
+// ============================================================================
+
+TEST_F(DeviceEventsTest, QueueDropsWhenFull) {
+    EXPECT_THROW(EventQueue(0), std::invalid_argument);
+    EventQueue queue(3);
+    EXPECT_EQ(queue.capacity(), 4u);
+
+    for (uint16_t i = 0; i < 6; ++i) {
+        queue.push(DeviceEvent{i, i, 0, 1, DeviceEvent::Kind::ErrorCode, Severity::Error, 0});
+    }
+    EXPECT_EQ(queue.size(), 4u);
+    EXPECT_EQ(queue.dropped(), 2u);
+
+    DeviceEvent out[8];
+    ASSERT_EQ(queue.pop(out, 3), 3u);
+    EXPECT_EQ(out[0].code, 0);
+    EXPECT_EQ(out[2].code, 2);
+    ASSERT_EQ(queue.pop(out, 8), 1u);
+    EXPECT_EQ(out[0].code, 3);
+    EXPECT_EQ(queue.pop(out, 8), 0u);
+    EXPECT_TRUE(queue.push(DeviceEvent{}));
+}
+
+// ============================================================================
+// TEST CASE 3: Edge Detection per Commit
+// ============================================================================
+
+TEST_F(DeviceEventsTest, MonitorEmitsOneEventPerChange) {
+    for (DecodeMode mode : {DecodeMode::Eager, DecodeMode::Lazy, DecodeMode::LazyCached}) {
+        EventQueue queue(64);
+        ErrorMonitor monitor(catalogue_, queue);
+        monitor.setDeviceType(2, servo_);
+        EXPECT_THROW(monitor.setDeviceType(3, 99), std::out_of_range);
+
+        StarManager manager(kAnyNumaNode, mode);
+        manager.setErrorMonitor(&monitor);
+
+        // cycle 1: slave 2 comes up with an error, slave 1 is clean
+        input(manager, {{0, 0}, {0x2310, 0}});
+        std::vector<DeviceEvent> events(8);
+        events.resize(queue.pop(events.data(), events.size()));
+        ASSERT_EQ(events.size(), 1u);
+        EXPECT_EQ(events[0].cycle, 1u);
+        EXPECT_EQ(events[0].slave_id, 2);
+        EXPECT_EQ(events[0].kind, DeviceEvent::Kind::ErrorCode);
+        EXPECT_EQ(events[0].code, 0x2310);
+        EXPECT_EQ(events[0].previous, 0);
+        EXPECT_EQ(events[0].severity, Severity::Error);
+        EXPECT_EQ(events[0].device_type, servo_);
+
+        // steady state: nothing
+        input(manager, {{0, 0}, {0x2310, 0}});
+        input(manager, {{0, 0}, {0x2310, 0}});
+        EXPECT_EQ(queue.size(), 0u);
+
+        // cycle 4: slave 1 gets an unknown code on the default type, slave 2 clears and a fan bit comes on
+        input(manager, {{0x0042, 0}, {0, 1u << 3}});
+        events.resize(8);
+        events.resize(queue.pop(events.data(), events.size()));
+        ASSERT_EQ(events.size(), 3u);
+        // error codes first, then status, each in slot order
+        EXPECT_EQ(events[0].slave_id, 1);
+        EXPECT_EQ(events[0].severity, Severity::Error);
+        EXPECT_EQ(events[0].device_type, ErrorCatalogue::kDefaultDevice);
+        EXPECT_EQ(events[1].slave_id, 2);
+        EXPECT_EQ(events[1].code, 0);
+        EXPECT_EQ(events[1].previous, 0x2310);
+        EXPECT_EQ(events[1].severity, Severity::Info);
+        EXPECT_EQ(events[2].kind, DeviceEvent::Kind::SystemStatus);
+        EXPECT_EQ(events[2].code, 1u << 3);
+        EXPECT_EQ(events[2].severity, Severity::Warning);
+        EXPECT_EQ(events[2].cycle, 4u);
+        EXPECT_EQ(monitor.events(), 4u);
+
+        // a bit going off alone is Info
+        input(manager, {{0x0042, 0}, {0, 0}});
+        events.resize(8);
+        events.resize(queue.pop(events.data(), events.size()));
+        ASSERT_EQ(events.size(), 1u);
+        EXPECT_EQ(events[0].severity, Severity::Info);
+
+        manager.setErrorMonitor(nullptr);
+        input(manager, {{0, 0}, {0, 0}});
+        EXPECT_EQ(queue.size(), 0u);
+    }
+}
+
+// ============================================================================
+// TEST CASE 4: Event Text
+// ============================================================================
+
+TEST_F(DeviceEventsTest, DescribesEventsFromTheCatalogue) {
+    DeviceEvent raised{12, 0x2310, 0, 7, DeviceEvent::Kind::ErrorCode, Severity::Error, servo_};
+    EXPECT_EQ(describe_event(raised, catalogue_),
+              "cycle 12 slave 7 [servo-x] error 0x2310 Continuous overcurrent (error)");
+
+    DeviceEvent cleared{13, 0, 0x2310, 7, DeviceEvent::Kind::ErrorCode, Severity::Info, servo_};
+    EXPECT_EQ(describe_event(cleared, catalogue_), "cycle 13 slave 7 [servo-x] error 0x2310 cleared");
+
+    DeviceEvent unknown{14, 0x1234, 0, 1, DeviceEvent::Kind::ErrorCode, Severity::Error, 0};
+    EXPECT_EQ(describe_event(unknown, catalogue_), "cycle 14 slave 1 [default] error 0x1234 unknown code (error)");
+
+    DeviceEvent status{15, 0x0088, 0x0001, 7, DeviceEvent::Kind::SystemStatus, Severity::Fatal, servo_};
+    EXPECT_EQ(describe_event(status, catalogue_),
+              "cycle 15 slave 7 [servo-x] status 0x0001 -> 0x0088, Fan failure, STO active (fatal)");
+}
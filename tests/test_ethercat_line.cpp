@@ -0,0 +1,267 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include "ethercat_line.hpp"
+#include "global_view.hpp"
+#include "load_generator.hpp"
+#include "recorder.hpp"
+#include "timing_metrics.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+// Two lines of one cell; slave ids repeat across lines on purpose
+class EthercatLineTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        generators_.push_back(std::make_unique<LoadGenerator>(3));
+        generators_.push_back(std::make_unique<LoadGenerator>(5));
+
+        lines_.push_back(make_line("line A", {1, 2, 3}, *generators_[0]));
+        lines_.push_back(make_line("line B", {1, 2, 3, 4, 5}, *generators_[1]));
+    }
+
+    static std::unique_ptr<EthercatLine> make_line(const char* name, std::vector<uint8_t> order,
+                                                   LoadGenerator& generator) {
+        LineConfig config;
+        config.name = name;
+        config.slaves_order = std::move(order);
+        config.period = std::chrono::microseconds(500);
+        config.report_placement = false;
+        return std::make_unique<EthercatLine>(config, [&generator](uint8_t* image, size_t size) {
+            generator.next_cycle(image, size);
+        });
+    }
+
+    std::vector<std::unique_ptr<LoadGenerator>> generators_;
+    std::vector<std::unique_ptr<EthercatLine>> lines_;
+};
+
+// ============================================================================
+// TEST CASE 1: Global View Merges Lines
+// ============================================================================
+
+TEST_F(EthercatLineTest, GlobalViewMergesCommittedSnapshots) {
+    GlobalView view({&lines_[0]->star_manager(), &lines_[1]->star_manager()});
+    view.refresh();
+    EXPECT_EQ(view.slave_count(), 0u);
+    EXPECT_EQ(view.oldest_commit_ns(), 0u);
+
+    lines_[0]->run_cycle();
+    lines_[1]->run_cycle();
+    lines_[1]->run_cycle();
+    view.refresh();
+
+    EXPECT_EQ(view.line_count(), 2u);
+    EXPECT_EQ(view.line(0).cycle, 1u);
+    EXPECT_EQ(view.line(1).cycle, 2u);
+    EXPECT_EQ(view.slave_count(), 8u);
+    EXPECT_GT(view.oldest_commit_ns(), 0u);
+
+    // same slave id, different line, different drive
+    EXPECT_EQ(view.getSlaveData(0, 2).actual_position, generators_[0]->slave(1).actual_position);
+    EXPECT_EQ(view.getSlaveData(1, 2).actual_position, generators_[1]->slave(1).actual_position);
+    EXPECT_EQ(view.getSlaveData(1, 5).actual_torque, generators_[1]->slave(4).actual_torque);
+
+    EXPECT_THROW(view.getSlaveData(0, 5), std::out_of_range); // line A has no slave 5
+    EXPECT_THROW(view.getSlaveData(2, 1), std::out_of_range); // no third line
+}
+
+// ============================================================================
+// TEST CASE 2: Cycle Threads and Metrics
+// ============================================================================
+
+TEST_F(EthercatLineTest, LinesRunOnTheirOwnThreadsWithOwnMetrics) {
+    GlobalView view({&lines_[0]->star_manager(), &lines_[1]->star_manager()});
+
+    for (auto& line : lines_) {
+        line->start();
+    }
+    EXPECT_TRUE(lines_[0]->running());
+
+    // the reader keeps refreshing while both cycle threads publish
+    auto until = std::chrono::steady_clock::now() + std::chrono::milliseconds(50);
+    while (std::chrono::steady_clock::now() < until) {
+        view.refresh();
+    }
+
+    for (auto& line : lines_) {
+        line->stop();
+    }
+    EXPECT_FALSE(lines_[0]->running());
+
+    for (auto& line : lines_) {
+        EXPECT_GT(line->cycles(), 0u) << line->config().name;
+        EXPECT_EQ(line->star_manager().committedCycle(), line->cycles()) << line->config().name;
+
+        TimingSummary cycle_time = line->cycle_time().summary();
+        EXPECT_EQ(cycle_time.count, line->cycles());
+        EXPECT_LE(cycle_time.min_ns, cycle_time.max_ns);
+        EXPECT_LE(cycle_time.p50_ns, cycle_time.p99_ns);
+        EXPECT_EQ(line->wakeup_latency().count(), line->cycles());
+    }
+
+    // stopped lines: the view catches up with the last commit of each
+    view.refresh();
+    EXPECT_EQ(view.line(0).cycle, lines_[0]->cycles());
+    EXPECT_EQ(view.line(1).cycle, lines_[1]->cycles());
+    EXPECT_EQ(view.getSlaveData(1, 4).actual_position, generators_[1]->slave(3).actual_position);
+}
+
+TEST_F(EthercatLineTest, PinsCycleThreadToConfiguredCore) {
+    LoadGenerator generator(2);
+    LineConfig config;
+    config.name = "pinned";
+    config.slaves_order = {1, 2};
+    config.cpu_core = 0;
+    config.period = std::chrono::microseconds(200);
+    EthercatLine line(config, [&](uint8_t* image, size_t size) { generator.next_cycle(image, size); });
+
+    // core 0 is on node 0 on every host; the registry follows it
+    EXPECT_EQ(line.numa_node(), cpu_numa_node(0));
+    if (line.numa_node() >= 0 && line.star_manager().registry_numa_node() >= 0) {
+        EXPECT_EQ(line.star_manager().registry_numa_node(), line.numa_node());
+        EXPECT_EQ(line.star_manager().snapshot_numa_node(), line.numa_node());
+    }
+
+    line.start();
+    while (line.cycles() == 0) {
+        std::this_thread::yield();
+    }
+    line.stop();
+
+#ifdef __linux__
+    EXPECT_EQ(line.pinned_core(), 0);
+#endif
+    EXPECT_NE(line.placement_report().find("line 'pinned': core 0 (pinned)"), std::string::npos)
+        << line.placement_report();
+    EXPECT_EQ(lines_[0]->pinned_core(), -1); // never started, never pinned
+}
+
+// ============================================================================
+// TEST CASE 3: Configuration Errors
+// ============================================================================
+
+TEST_F(EthercatLineTest, RejectsMissingSourceAndBadPeriod) {
+    LineConfig config;
+    config.slaves_order = {1};
+    EXPECT_THROW(EthercatLine(config, nullptr), std::invalid_argument);
+
+    config.period = std::chrono::nanoseconds(0);
+    EXPECT_THROW(EthercatLine(config, [](uint8_t*, size_t) {}), std::invalid_argument);
+
+    EXPECT_THROW(GlobalView({nullptr}), std::invalid_argument);
+}
+
+// ============================================================================
+// TEST CASE 4: Timing Histogram
+// ============================================================================
+
+TEST(TimingMetricsTest, SummarizesRecordedDurations) {
+    TimingMetrics metrics;
+    EXPECT_EQ(metrics.summary().count, 0u);
+
+    for (uint64_t i = 0; i < 99; ++i) {
+        metrics.record(1000); // bucket [512, 1024)
+    }
+    metrics.record(1000000);
+
+    TimingSummary s = metrics.summary();
+    EXPECT_EQ(s.count, 100u);
+    EXPECT_EQ(s.min_ns, 1000u);
+    EXPECT_EQ(s.max_ns, 1000000u);
+    EXPECT_DOUBLE_EQ(s.mean_ns, (99.0 * 1000 + 1000000) / 100.0);
+    EXPECT_EQ(s.p50_ns, 1023u);
+    EXPECT_EQ(s.p99_ns, 1023u);
+
+    // interval histogram: difference of two reads
+    TimingMetrics::Histogram before = metrics.histogram();
+    metrics.record(1000000);
+    metrics.record(1000000);
+    TimingMetrics::Histogram interval = metrics.histogram();
+    for (size_t b = 0; b < interval.size(); ++b) {
+        interval[b] -= before[b];
+    }
+    EXPECT_EQ(TimingMetrics::percentile(interval, 500), 1048575u);
+    EXPECT_EQ(TimingMetrics::percentile(TimingMetrics::Histogram{}, 990), 0u);
+
+    metrics.reset();
+    EXPECT_EQ(metrics.summary().count, 0u);
+}
+
+// ============================================================================
+// TEST CASE 5: Recorder Ring
+// ============================================================================
+
+TEST_F(EthercatLineTest, RecorderKeepsLatestCommitsInOrder) {
+    EXPECT_THROW(Recorder(0), std::invalid_argument);
+    Recorder recorder(4);
+    GlobalView view({&lines_[0]->star_manager(), &lines_[1]->star_manager()});
+
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        lines_[0]->run_cycle();
+        lines_[1]->run_cycle();
+        view.refresh();
+        recorder.record(0, view.line(0));
+        recorder.record(1, view.line(1));
+    }
+
+    // 6 written into 4 slots: the first cycle of both lines is gone
+    EXPECT_EQ(recorder.size(), 4u);
+    EXPECT_EQ(recorder.written(), 6u);
+    EXPECT_EQ(recorder.overwritten(), 2u);
+    EXPECT_EQ(recorder.at(0).line, 0u);
+    EXPECT_EQ(recorder.at(0).cycle, 2u);
+    EXPECT_EQ(recorder.at(1).line, 1u);
+    EXPECT_EQ(recorder.latest().cycle, 3u);
+    EXPECT_EQ(recorder.latest().aggregates.slave_count, 5u);
+    EXPECT_GT(recorder.latest().commit_time_ns, 0u);
+    EXPECT_THROW(recorder.at(4), std::out_of_range);
+
+    recorder.clear();
+    EXPECT_EQ(recorder.size(), 0u);
+}
+
+// ============================================================================
+// TEST CASE 6: Working Counters per Cycle
+// ============================================================================
+
+TEST_F(EthercatLineTest, WorkingCounterSourceFeedsDataValid) {
+    LoadGenerator generator(3);
+    LineConfig config;
+    config.name = "wkc";
+    config.slaves_order = {1, 2, 3};
+    config.report_placement = false;
+    config.wkc_groups = {{{1, 2}, 2, 0}, {{3}, 1, 0}};
+
+    uint16_t second_group = 1;
+    EthercatLine line(config, [&generator](uint8_t* image, size_t size) { generator.next_cycle(image, size); },
+                      nullptr, [&second_group](uint16_t* working_counters, size_t count) {
+                          ASSERT_EQ(count, 2u);
+                          working_counters[0] = 2;
+                          working_counters[1] = second_group;
+                      });
+
+    line.run_cycle();
+    EXPECT_TRUE(line.star_manager().getSlaveData(3).data_valid);
+    second_group = 0; // slave 3 dropped off
+    line.run_cycle();
+    EXPECT_TRUE(line.star_manager().getSlaveData(1).data_valid);
+    EXPECT_FALSE(line.star_manager().getSlaveData(3).data_valid);
+    EXPECT_EQ(line.invalidated_frames(), 1u);
+    EXPECT_EQ(line.hardware().domainWkcStats(0).mismatches, 1u);
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
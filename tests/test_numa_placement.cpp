@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <utility>
+#include "numa_placement.hpp"
+#include "slave_columns.hpp"
+#include "Star_Manager.hpp"
+#include "pdo_test_utils.hpp"
+
+// Every host has node 0, so placement on node 0 is checkable everywhere;
+// where the backend cannot tell (-1) only the allocation itself is checked.
+
+// ============================================================================
+// TEST CASE 1: Topology Queries
+// ============================================================================
+
+TEST(NumaPlacementTest, ReportsTopology) {
+    const std::string backend = numa_backend_name();
+    EXPECT_TRUE(backend == "libnuma" || backend == "mbind" || backend == "none") << backend;
+    EXPECT_GE(host_numa_nodes(), 1);
+
+    int node = cpu_numa_node(0);
+    EXPECT_GE(node, -1);
+    EXPECT_LT(node, host_numa_nodes());
+    EXPECT_EQ(cpu_numa_node(-1), -1);
+    EXPECT_EQ(memory_numa_node(nullptr), -1);
+}
+
+// ============================================================================
+// TEST CASE 2: MemoryRegion
+// ============================================================================
+
+TEST(NumaPlacementTest, RegionIsZeroedAlignedAndOnRequestedNode) {
+    for (int node : {kAnyNumaNode, 0}) {
+        MemoryRegion region(10000, node);
+        ASSERT_NE(region.data(), nullptr);
+        EXPECT_EQ(region.size(), 10000u);
+        EXPECT_EQ(region.requested_node(), node);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % 64, 0u);
+
+        std::vector<uint8_t> zeros(region.size(), 0);
+        EXPECT_EQ(std::memcmp(region.data(), zeros.data(), zeros.size()), 0);
+
+        if (node >= 0 && region.node() >= 0) {
+            EXPECT_EQ(region.node(), node);
+        }
+    }
+}
+
+TEST(NumaPlacementTest, RegionMoveKeepsAddress) {
+    MemoryRegion first(256, 0);
+    uint8_t* address = first.data();
+    first.data()[3] = 0x5A;
+
+    MemoryRegion second(std::move(first));
+    EXPECT_EQ(second.data(), address);
+    EXPECT_EQ(second.data()[3], 0x5A);
+    EXPECT_EQ(first.data(), nullptr);
+
+    MemoryRegion third;
+    third = std::move(second);
+    EXPECT_EQ(third.data(), address);
+    EXPECT_EQ(third.size(), 256u);
+}
+
+// ============================================================================
+// TEST CASE 3: Registry and Snapshots Follow the Node
+// ============================================================================
+
+TEST(NumaPlacementTest, StarManagerStorageOnRequestedNode) {
+    StarManager manager(0);
+    EXPECT_EQ(manager.requested_numa_node(), 0);
+    if (manager.registry_numa_node() >= 0) {
+        EXPECT_EQ(manager.registry_numa_node(), 0);
+        EXPECT_EQ(manager.snapshot_numa_node(), 0);
+    }
+
+    // placement does not change behaviour
+    auto buffer = generate_pdo_buffer(0x1234, 77, 0, 0, 0x08, 0, 0xFF, 30.0f);
+    manager.input_handler(9, buffer);
+    manager.commit();
+
+    StarSnapshot snapshot(0);
+    manager.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.getSlaveData(9).actual_position, 77);
+
+    SlaveColumnStore store(100, 0);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(store.columns().actual_position) % 64, 0u);
+    EXPECT_EQ(store.columns().actual_position[99], 0);
+}
+
+// ============================================================================
+// TEST CASE 4: Hugepage Backing
+// ============================================================================
+
+// What the host grants depends on vm.nr_hugepages and the THP setting: only the
+// fallback chain is fixed (Huge -> Transparent -> Normal), and the memory must work.
+TEST(NumaPlacementTest, HugepageRequestsFallBackAndReportWhatTheyGot) {
+    EXPECT_EQ(MemoryRegion().page_kind(), PageKind::None);
+    EXPECT_EQ(MemoryRegion(4096).page_kind(), PageKind::Normal);
+    EXPECT_STREQ(page_kind_name(PageKind::Huge), "2M");
+
+    for (PagePolicy policy : {PagePolicy::Transparent, PagePolicy::Huge}) {
+        MemoryRegion region(3 * kHugePageSize + 100, 0, policy);
+        ASSERT_NE(region.data(), nullptr);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % 64, 0u);
+        EXPECT_EQ(region.data()[3 * kHugePageSize + 99], 0);
+        region.data()[3 * kHugePageSize + 99] = 1;
+
+        const PageKind kind = region.page_kind();
+        EXPECT_NE(kind, PageKind::None);
+        if (policy == PagePolicy::Transparent) {
+            EXPECT_NE(kind, PageKind::Huge);
+        }
+        if (kind != PageKind::Normal) {
+            EXPECT_EQ(reinterpret_cast<uintptr_t>(region.data()) % kHugePageSize, 0u);
+        }
+
+        MemoryRegion moved(std::move(region));
+        EXPECT_EQ(moved.page_kind(), kind);
+        EXPECT_EQ(region.page_kind(), PageKind::None);
+    }
+
+    StarManager manager(0, DecodeMode::Eager, PagePolicy::Huge);
+    EXPECT_NE(manager.registry_page_kind(), PageKind::None);
+    EXPECT_NE(manager.snapshot_page_kind(), PageKind::None);
+    manager.input_handler(4, generate_pdo_buffer(0x1234, 5, 0, 0, 0x08, 0, 0xFF, 30.0f));
+    manager.commit();
+    StarSnapshot snapshot;
+    manager.readSnapshot(snapshot);
+    EXPECT_EQ(snapshot.getSlaveData(4).actual_position, 5);
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
@@ -0,0 +1,249 @@
+#include <gtest/gtest.h>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include "Ethercat_Hardware_Interface.hpp"
+#include "cpu_dispatch.hpp"
+#include "data_structuring.hpp"
+#include "plant_simulator.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+class PlantSimulatorTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        reset_simd_level();
+    }
+
+    // every axis gets the same command, then one cycle
+    static void run(PlantSimulator& plant, const SlaveCommandData& command, size_t cycles) {
+        std::vector<uint8_t> outputs(plant.output_image_size());
+        std::vector<uint8_t> inputs(plant.input_image_size());
+        WriteState encoder;
+        for (size_t i = 0; i < plant.axis_count(); ++i) {
+            encoder.encode_command(command, outputs.data() + i * PdoOutputLayout::size, PdoOutputLayout::size);
+        }
+        for (size_t c = 0; c < cycles; ++c) {
+            plant.cycle(outputs.data(), outputs.size(), inputs.data(), inputs.size());
+        }
+    }
+
+    static SlaveCommandData command(uint16_t control_word, uint8_t mode, int32_t position = 0,
+                                    int32_t velocity = 0, int16_t torque = 0) {
+        return SlaveCommandData{control_word, position, velocity, torque, mode};
+    }
+
+    static constexpr std::chrono::nanoseconds kPeriod = std::chrono::milliseconds(1);
+};
+
+// ============================================================================
+// TEST CASE 1: Construction
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, RejectsBadConfiguration) {
+    EXPECT_THROW(PlantSimulator(4, std::chrono::nanoseconds(0)), std::invalid_argument);
+    EXPECT_THROW(PlantSimulator(4, kPeriod, AxisParameters{}, 0), std::invalid_argument);
+
+    PlantSimulator plant(4, kPeriod);
+    EXPECT_EQ(plant.axis_count(), 4u);
+    EXPECT_EQ(plant.input_image_size(), 4 * PdoInputLayout::size);
+    EXPECT_EQ(plant.output_image_size(), 4 * PdoOutputLayout::size);
+    EXPECT_DOUBLE_EQ(plant.temperature(3), AxisParameters{}.ambient_temperature);
+    EXPECT_THROW(plant.axis(4), std::out_of_range);
+
+    AxisParameters bad;
+    bad.torque_limit = 40000.0;
+    EXPECT_THROW(plant.setParameters(0, bad), std::invalid_argument);
+    EXPECT_THROW(plant.setParameters(4, AxisParameters{}), std::out_of_range);
+
+    std::vector<uint8_t> short_image(plant.output_image_size() - 1);
+    EXPECT_THROW(plant.apply_outputs(short_image.data(), short_image.size()), std::out_of_range);
+    EXPECT_THROW(plant.write_inputs(short_image.data(), short_image.size()), std::out_of_range);
+}
+
+// ============================================================================
+// TEST CASE 2: Cyclic Synchronous Velocity
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, VelocityModeSettlesOnTarget) {
+    PlantSimulator plant(3, kPeriod);
+    run(plant, command(0x000F, 9, 0, 20000), 1000);
+
+    for (size_t i = 0; i < plant.axis_count(); ++i) {
+        //the integrator takes out the damping load: no steady-state error
+        EXPECT_NEAR(plant.velocity(i), 20000.0, 1.0) << "axis " << i;
+        SlaveRealTimeData data = plant.axis(i);
+        EXPECT_EQ(data.status_word, 0x0237);
+        EXPECT_EQ(data.mode_display, 9);
+        EXPECT_EQ(data.actual_velocity, 20000);
+        //holding speed against damping: 5/s * 20000 counts/s / 2000 counts/s^2 per mille
+        EXPECT_NEAR(data.actual_torque, 50, 1);
+        EXPECT_GT(data.actual_position, 15000);
+    }
+}
+
+// ============================================================================
+// TEST CASE 3: Cyclic Synchronous Position
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, PositionModeReachesTarget) {
+    PlantSimulator plant(2, kPeriod);
+    run(plant, command(0x000F, 8, 50000), 1000);
+
+    EXPECT_NEAR(plant.position(0), 50000.0, 1.0);
+    EXPECT_NEAR(plant.velocity(0), 0.0, 1.0);
+    EXPECT_EQ(plant.axis(1).actual_position, 50000);
+
+    //a new target is followed from where the axis stands
+    run(plant, command(0x000F, 8, -20000), 1000);
+    EXPECT_NEAR(plant.position(0), -20000.0, 1.0);
+}
+
+// ============================================================================
+// TEST CASE 4: Torque Limit
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, TorqueStaysWithinLimit) {
+    AxisParameters parameters;
+    parameters.torque_limit = 1000.0;
+    PlantSimulator plant(2, kPeriod, parameters);
+
+    //torque mode asks for more than the limit
+    run(plant, command(0x000F, 10, 0, 0, 5000), 50);
+    EXPECT_NEAR(plant.torque(0), 1000.0, 1e-6);
+
+    //a velocity step far beyond reach saturates the cascade, not the torque
+    run(plant, command(0x000F, 9, 0, -2000000), 50);
+    EXPECT_LE(std::fabs(plant.torque(1)), 1000.0 + 1e-9);
+    EXPECT_EQ(plant.axis(1).actual_torque, -1000);
+}
+
+// ============================================================================
+// TEST CASE 5: Thermal Model and Over-Temperature Fault
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, OverTemperatureFaultsAndResets) {
+    AxisParameters parameters;
+    parameters.thermal_time_constant = 0.5;
+    parameters.heating = 100e-6; //1500 per mille settles at 25 + 225 degrees C
+    PlantSimulator plant(1, kPeriod, parameters);
+
+    run(plant, command(0x000F, 10, 0, 0, 1500), 100);
+    const double warm = plant.temperature(0);
+    EXPECT_GT(warm, 40.0);
+    EXPECT_FALSE(plant.faulted(0));
+
+    run(plant, command(0x000F, 10, 0, 0, 1500), 1000);
+    EXPECT_TRUE(plant.faulted(0));
+    SlaveRealTimeData data = plant.axis(0);
+    EXPECT_EQ(data.status_word, 0x0218);
+    EXPECT_EQ(data.error_code, PlantSimulator::kOverTemperatureError);
+    //the faulted drive drops the torque and cools down
+    EXPECT_NEAR(plant.torque(0), 0.0, 1e-3);
+    EXPECT_LT(plant.temperature(0), parameters.trip_temperature);
+
+    //still enabled by the master: the fault stays until it is reset
+    run(plant, command(0x000F, 10, 0, 0, 0), 10);
+    EXPECT_TRUE(plant.faulted(0));
+    run(plant, command(0x008F, 10, 0, 0, 0), 1);
+    EXPECT_FALSE(plant.faulted(0));
+    EXPECT_EQ(plant.axis(0).status_word, 0x0237);
+    EXPECT_EQ(plant.axis(0).error_code, 0);
+}
+
+// ============================================================================
+// TEST CASE 6: Disabled Axis Coasts
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, DisabledAxisCoastsDown) {
+    PlantSimulator plant(1, kPeriod);
+    run(plant, command(0x000F, 9, 0, 10000), 500);
+    const double moving = plant.velocity(0);
+    const double position = plant.position(0);
+
+    run(plant, command(0x0006, 9, 0, 10000), 200);
+    EXPECT_EQ(plant.axis(0).status_word, 0x0250);
+    //only the damping slows it: v0 * e^(-5/s * 0.2 s)
+    EXPECT_NEAR(plant.velocity(0), moving * std::exp(-1.0), moving * 0.01);
+    EXPECT_GT(plant.position(0), position);
+    EXPECT_NEAR(plant.torque(0), 0.0, 1e-3);
+}
+
+// ============================================================================
+// TEST CASE 7: SIMD Levels Agree
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, EverySimdLevelMatchesScalar) {
+    const SimdLevel levels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512};
+    constexpr size_t kAxes = 37; //vector blocks and a scalar tail
+
+    std::vector<double> expected;
+    for (SimdLevel level : levels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+        PlantSimulator plant(kAxes, kPeriod);
+        std::vector<uint8_t> outputs(plant.output_image_size());
+        std::vector<uint8_t> inputs(plant.input_image_size());
+        WriteState encoder;
+        for (size_t i = 0; i < kAxes; ++i) {
+            AxisParameters parameters;
+            parameters.torque_limit = 500.0 + 50.0 * static_cast<double>(i);
+            parameters.damping = 1.0 + 0.25 * static_cast<double>(i % 7);
+            plant.setParameters(i, parameters);
+            const SlaveCommandData axis_command = command(0x000F, static_cast<uint8_t>(8 + i % 3),
+                static_cast<int32_t>(1000 * i), static_cast<int32_t>(500 * i), static_cast<int16_t>(10 * i));
+            encoder.encode_command(axis_command, outputs.data() + i * PdoOutputLayout::size, PdoOutputLayout::size);
+        }
+        for (int c = 0; c < 300; ++c) {
+            plant.cycle(outputs.data(), outputs.size(), inputs.data(), inputs.size());
+        }
+
+        std::vector<double> state;
+        for (size_t i = 0; i < kAxes; ++i) {
+            state.insert(state.end(), {plant.position(i), plant.velocity(i), plant.torque(i), plant.temperature(i)});
+        }
+        if (expected.empty()) {
+            expected = state;
+            continue;
+        }
+        for (size_t k = 0; k < state.size(); ++k) {
+            EXPECT_NEAR(state[k], expected[k], 1e-9 * (1.0 + std::fabs(expected[k])))
+                << simd_level_name(level) << " axis " << k / 4;
+        }
+    }
+}
+
+// ============================================================================
+// TEST CASE 8: Closed Loop Through the Hardware Interface
+// ============================================================================
+
+TEST_F(PlantSimulatorTest, ClosesTheLoopThroughTheHardwareInterface) {
+    const std::vector<uint8_t> order = {3, 7};
+    Ethercat_Hardware_Interface hw(order);
+    PlantSimulator plant(order.size(), kPeriod);
+    std::vector<uint8_t> outputs(hw.output_image_size());
+    std::vector<uint8_t> inputs(hw.input_image_size());
+
+    hw.setCommand(3, command(0x000F, 8, 30000));
+    hw.setCommand(7, command(0x000F, 9, 0, -8000));
+    for (int c = 0; c < 1000; ++c) {
+        hw.write_kernel(outputs);
+        plant.cycle(outputs.data(), outputs.size(), inputs.data(), inputs.size());
+        hw.read_kernel(inputs);
+    }
+
+    SlaveRealTimeData positioned = hw.star_manager().getSlaveData(3);
+    SlaveRealTimeData spinning = hw.star_manager().getSlaveData(7);
+    EXPECT_EQ(positioned.status_word, 0x0237);
+    EXPECT_NEAR(positioned.actual_position, 30000, 1);
+    EXPECT_EQ(positioned.mode_display, 8);
+    EXPECT_NEAR(spinning.actual_velocity, -8000, 1);
+    EXPECT_EQ(spinning.mode_display, 9);
+    EXPECT_FLOAT_EQ(spinning.motor_temperature, static_cast<float>(plant.temperature(1)));
+}
@@ -0,0 +1,163 @@
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "rt_logger.hpp"
+#include "ethercat_line.hpp"
+#include "load_generator.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+class AsyncLoggerTest : public ::testing::Test {
+protected:
+    std::vector<std::string> lines_;
+    std::mutex mutex_;
+    AsyncLogger logger_{[this](const std::string& line) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lines_.push_back(line);
+    }};
+
+    static bool ends_with(const std::string& line, const std::string& tail) {
+        return line.size() >= tail.size() && line.compare(line.size() - tail.size(), tail.size(), tail) == 0;
+    }
+};
+
+// ============================================================================
+// TEST CASE 1: Formatting on the Logger Thread
+// ============================================================================
+
+TEST_F(AsyncLoggerTest, FormatsArgumentsByType) {
+    LogFormat invalid = logger_.register_format(LogLevel::Warning, "slave {} invalid frame, status {x}");
+    LogFormat mixed = logger_.register_format(LogLevel::Info, "{} {} {} {}");
+    EXPECT_EQ(logger_.register_format(LogLevel::Warning, "slave {} invalid frame, status {x}"), invalid);
+    EXPECT_NE(logger_.register_format(LogLevel::Error, "slave {} invalid frame, status {x}"), invalid);
+
+    enum class Phase : uint8_t { Idle = 3 };
+    LogChannel& channel = logger_.open_channel("cycle", 8);
+    EXPECT_TRUE(channel.log(invalid, uint8_t{7}, uint16_t{0x0237}));
+    EXPECT_TRUE(channel.log(mixed, int16_t{-5}, 2.5f, true, Phase::Idle));
+    EXPECT_TRUE(channel.log(invalid)); // too few arguments
+    EXPECT_TRUE(channel.log(LogFormat{999}));
+    EXPECT_TRUE(lines_.empty()); // nothing formatted until a drain
+
+    EXPECT_EQ(logger_.drain(), 4u);
+    ASSERT_EQ(lines_.size(), 4u);
+    EXPECT_TRUE(ends_with(lines_[0], "WARN [cycle] slave 7 invalid frame, status 0x237")) << lines_[0];
+    EXPECT_TRUE(ends_with(lines_[1], "INFO [cycle] -5 2.5 1 3")) << lines_[1];
+    EXPECT_TRUE(ends_with(lines_[2], "slave {?} invalid frame, status {?}")) << lines_[2];
+    EXPECT_TRUE(ends_with(lines_[3], "unknown format 999")) << lines_[3];
+    EXPECT_EQ(logger_.written(), 4u);
+    EXPECT_EQ(logger_.drain(), 0u);
+
+    EXPECT_THROW(logger_.open_channel("empty", 0), std::invalid_argument);
+}
+
+// ============================================================================
+// TEST CASE 2: Full Ring Drops and Counts
+// ============================================================================
+
+TEST_F(AsyncLoggerTest, FullRingDropsAndReportsDrops) {
+    LogFormat format = logger_.register_format(LogLevel::Debug, "message {}");
+    LogChannel& channel = logger_.open_channel("line-a", 3);
+    EXPECT_EQ(channel.capacity(), 4u); // rounded up to a power of two
+
+    for (int i = 0; i < 10; ++i) {
+        channel.log(format, i);
+    }
+    EXPECT_EQ(channel.logged(), 4u);
+    EXPECT_EQ(channel.dropped(), 6u);
+    EXPECT_EQ(logger_.dropped(), 6u);
+
+    EXPECT_EQ(logger_.drain(), 5u); // the 4 kept, then the drop report
+    EXPECT_TRUE(ends_with(lines_[0], "message 0"));
+    EXPECT_TRUE(ends_with(lines_[3], "message 3"));
+    EXPECT_TRUE(ends_with(lines_[4], "WARN [line-a] 6 messages dropped (ring full)")) << lines_[4];
+
+    // the slots are free again; drops are reported once
+    EXPECT_TRUE(channel.log(format, 10));
+    EXPECT_EQ(logger_.drain(), 1u);
+    EXPECT_TRUE(ends_with(lines_.back(), "message 10"));
+}
+
+// ============================================================================
+// TEST CASE 3: Several Producers, One Timeline
+// ============================================================================
+
+TEST_F(AsyncLoggerTest, MergesChannelsInTimestampOrderWhileRunning) {
+    LogFormat format = logger_.register_format(LogLevel::Info, "{} {}");
+    constexpr int kThreads = 3;
+    constexpr int kMessages = 20000;
+    std::vector<LogChannel*> channels;
+    for (int t = 0; t < kThreads; ++t) {
+        channels.push_back(&logger_.open_channel("t" + std::to_string(t), 256));
+    }
+
+    logger_.start(-1, std::chrono::microseconds(100));
+    std::vector<std::thread> producers;
+    for (int t = 0; t < kThreads; ++t) {
+        producers.emplace_back([&, t] {
+            for (int i = 0; i < kMessages; ++i) {
+                channels[t]->log(format, t, i);
+            }
+        });
+    }
+    for (std::thread& producer : producers) {
+        producer.join();
+    }
+    logger_.stop();
+
+    uint64_t logged = 0;
+    uint64_t dropped = 0;
+    for (LogChannel* channel : channels) {
+        EXPECT_EQ(channel->logged() + channel->dropped(), uint64_t{kMessages});
+        logged += channel->logged();
+        dropped += channel->dropped();
+    }
+
+    // every kept message was written, per thread in the order it was logged
+    size_t messages = 0;
+    std::vector<int> last(kThreads, -1);
+    for (const std::string& line : lines_) {
+        if (line.find("dropped") != std::string::npos) {
+            continue;
+        }
+        ++messages;
+        int thread = 0;
+        int index = 0;
+        ASSERT_EQ(std::sscanf(line.c_str() + line.find("] ") + 2, "%d %d", &thread, &index), 2) << line;
+        EXPECT_GT(index, last[thread]);
+        last[thread] = index;
+    }
+    EXPECT_EQ(messages, logged);
+    EXPECT_EQ(logger_.dropped(), dropped);
+}
+
+// ============================================================================
+// TEST CASE 4: Cycle Diagnostics of a Line
+// ============================================================================
+
+TEST_F(AsyncLoggerTest, LineLogsWorkingCounterMismatches) {
+    LoadGenerator generator(2);
+    LineConfig config;
+    config.name = "cell-1";
+    config.slaves_order = {1, 2};
+    config.report_placement = false;
+    config.wkc_groups = {{{1, 2}, 3, 0}};
+    config.logger = &logger_;
+
+    uint16_t counter = 3;
+    EthercatLine line(config, [&generator](uint8_t* image, size_t size) { generator.next_cycle(image, size); },
+                      nullptr, [&counter](uint16_t* working_counters, size_t) { working_counters[0] = counter; });
+
+    line.run_cycle();
+    counter = 1;
+    line.run_cycle();
+    EXPECT_EQ(logger_.drain(), 1u);
+    EXPECT_TRUE(ends_with(lines_[0], "WARN [cell-1] cycle 2: working counter of group 0 is 1, expected 3"))
+        << lines_[0];
+}
@@ -0,0 +1,390 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <mutex>
+#include <thread>
+#include "sdo_engine.hpp"
+#include "sdo_mailbox.hpp"
+#include "thread_affinity.hpp"
+#include "slave_configurator.hpp"
+#include "ethercat_line.hpp"
+#include "load_generator.hpp"
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+namespace {
+
+std::vector<uint8_t> u32_bytes(uint32_t v) {
+    return {static_cast<uint8_t>(v), static_cast<uint8_t>(v >> 8), static_cast<uint8_t>(v >> 16),
+            static_cast<uint8_t>(v >> 24)};
+}
+
+uint32_t u32_value(const std::vector<uint8_t>& bytes) {
+    return bytes.size() < 4 ? 0
+                            : bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | (uint32_t{bytes[3]} << 24);
+}
+
+// polls a manually driven engine until `future` is ready
+template <typename Future>
+void drive(SdoEngine& engine, Future& future) {
+    while (future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        engine.poll();
+        std::this_thread::sleep_for(std::chrono::microseconds(20));
+    }
+}
+
+} // namespace
+
+// Eight drives with identity objects (0x1018) and an error history (0x1003)
+class SdoEngineTest : public ::testing::Test {
+protected:
+    static constexpr size_t kSlaves = 8;
+
+    SdoEngineTest() : mailbox_(std::chrono::milliseconds(5)) {
+        for (uint8_t id = 1; id <= kSlaves; ++id) {
+            mailbox_.setObject(id, 0x1018, 1, u32_bytes(0x00000002));        // vendor
+            mailbox_.setObject(id, 0x1018, 2, u32_bytes(0x1DD00000 + id));   // product code
+            mailbox_.setObject(id, 0x1018, 3, u32_bytes(0x00010000));        // revision
+            mailbox_.setObject(id, 0x1018, 4, u32_bytes(1000 + id));         // serial
+            mailbox_.setObject(id, 0x1003, 1, u32_bytes(0x2310));            // last error
+        }
+    }
+
+    SimulatedMailbox mailbox_;
+};
+
+// ============================================================================
+// TEST CASE 1: Requests Across Slaves Are Pipelined
+// ============================================================================
+
+TEST_F(SdoEngineTest, IdentityOfAllSlavesInOneRoundTrip) {
+    SdoEngine engine(mailbox_);
+    std::vector<std::vector<std::future<SdoResult>>> identity(kSlaves);
+    for (uint8_t id = 1; id <= kSlaves; ++id) {
+        for (uint8_t sub = 0; sub <= 4; ++sub) {
+            identity[id - 1].push_back(engine.upload(id, 0x1018, sub));
+        }
+    }
+    EXPECT_EQ(engine.queued(), kSlaves * 5);
+
+    // 5 requests per slave at 5 ms each: one slave after another would take 200 ms
+    const auto started = std::chrono::steady_clock::now();
+    drive(engine, identity.back().back());
+    const auto took = std::chrono::steady_clock::now() - started;
+    EXPECT_LT(took, std::chrono::milliseconds(150));
+
+    for (uint8_t id = 1; id <= kSlaves; ++id) {
+        std::vector<SdoResult> results;
+        for (auto& future : identity[id - 1]) {
+            results.push_back(future.get());
+            EXPECT_EQ(results.back().status, SdoStatus::Ok);
+        }
+        EXPECT_EQ(results[0].data, std::vector<uint8_t>{4}); // subindex 0: entry count
+        EXPECT_EQ(u32_value(results[2].data), 0x1DD00000u + id);
+        EXPECT_EQ(u32_value(results[4].data), 1000u + id);
+    }
+
+    EXPECT_EQ(mailbox_.max_outstanding(), kSlaves); // every mailbox busy at once
+    const SdoEngineStats stats = engine.stats();
+    EXPECT_EQ(stats.completed, kSlaves * 5);
+    EXPECT_EQ(stats.max_in_flight, kSlaves);
+    EXPECT_EQ(stats.latency.count, kSlaves * 5);
+    EXPECT_EQ(engine.in_flight(), 0u);
+}
+
+// ============================================================================
+// TEST CASE 2: Order per Slave, Downloads and Aborts
+// ============================================================================
+
+TEST_F(SdoEngineTest, KeepsOrderPerSlaveAndReportsAborts) {
+    mailbox_.setLatency(std::chrono::microseconds(100));
+    SdoEngine engine(mailbox_);
+
+    std::mutex mutex;
+    std::vector<uint32_t> seen;
+    auto record = [&](uint8_t, const SdoResult& result) {
+        std::lock_guard<std::mutex> lock(mutex);
+        seen.push_back(u32_value(result.data));
+    };
+    // read, write, read back: the second read must see the write
+    engine.upload(3, 0x1003, 1, record);
+    auto written = engine.download(3, 0x1003, 1, u32_bytes(0x7500));
+    engine.upload(3, 0x1003, 1, record);
+    auto missing = engine.upload(3, 0x6000, 1);
+    auto bad_sub = engine.upload(3, 0x1018, 9);
+    auto bad_length = engine.download(3, 0x1003, 1, {1, 2});
+    drive(engine, bad_length);
+
+    EXPECT_EQ(written.get().status, SdoStatus::Ok);
+    EXPECT_EQ(seen, (std::vector<uint32_t>{0x2310, 0x7500}));
+    EXPECT_EQ(u32_value(mailbox_.object(3, 0x1003, 1)), 0x7500u);
+
+    const SdoResult object = missing.get();
+    EXPECT_EQ(object.status, SdoStatus::Aborted);
+    EXPECT_EQ(object.abort_code, kSdoAbortObjectMissing);
+    EXPECT_EQ(bad_sub.get().abort_code, kSdoAbortSubindexMissing);
+    EXPECT_EQ(bad_length.get().abort_code, kSdoAbortLengthMismatch);
+    EXPECT_EQ(engine.stats().aborted, 3u);
+}
+
+// ============================================================================
+// TEST CASE 3: Timeouts Free the Mailbox
+// ============================================================================
+
+TEST_F(SdoEngineTest, UnansweredRequestsTimeOut) {
+    mailbox_.setLatency(std::chrono::microseconds(100));
+    mailbox_.setResponsive(5, false);
+    SdoEngine engine(mailbox_, std::chrono::milliseconds(20));
+
+    auto lost = engine.upload(5, 0x1018, 4);
+    auto behind = engine.upload(5, 0x1018, 2, std::chrono::seconds(5));
+    auto other = engine.upload(6, 0x1018, 4);
+    drive(engine, lost);
+    EXPECT_EQ(lost.get().status, SdoStatus::Timeout);
+    EXPECT_EQ(other.get().status, SdoStatus::Ok); // other slaves are not held up
+
+    // the slave comes back: the next request goes out once the lost one was abandoned
+    mailbox_.setResponsive(5, true);
+    drive(engine, behind);
+    EXPECT_EQ(u32_value(behind.get().data), 0x1DD00005u);
+
+    const SdoEngineStats stats = engine.stats();
+    EXPECT_EQ(stats.timed_out, 1u);
+    EXPECT_EQ(stats.latency.count, 2u); // timeouts are not latencies
+}
+
+// ============================================================================
+// TEST CASE 4: Polling Thread Beside a Running Line
+// ============================================================================
+
+TEST_F(SdoEngineTest, PollingThreadRunsBesideTheCycle) {
+    mailbox_.setLatency(std::chrono::microseconds(300));
+    LoadGenerator generator(kSlaves);
+    LineConfig config;
+    config.name = "mailbox";
+    config.slaves_order = {1, 2, 3, 4, 5, 6, 7, 8};
+    config.period = std::chrono::microseconds(500);
+    config.report_placement = false;
+    EthercatLine line(config, [&generator](uint8_t* image, size_t size) { generator.next_cycle(image, size); });
+
+    SdoEngine engine(mailbox_);
+    line.start();
+    const std::vector<int> process_cores = allowed_cores();
+    const int rt_core = process_cores.front(); // the core the line would be pinned to
+    EXPECT_THROW(engine.start(process_cores), std::invalid_argument); // no core left that is not RT
+    EXPECT_FALSE(engine.running());
+    if (process_cores.size() > 1) {
+        engine.start(std::vector<int>{rt_core}, std::chrono::microseconds(20));
+    } else {
+        engine.start(-1, std::chrono::microseconds(20)); // one core: nowhere else to go
+    }
+    EXPECT_TRUE(engine.running());
+
+    // callbacks may chain the next request
+    std::promise<uint32_t> serial;
+    std::vector<int> polling_cores;
+    engine.upload(2, 0x1018, 1, [&](uint8_t slave, const SdoResult& vendor) {
+        polling_cores = allowed_cores(); // callbacks run on the polling thread
+        EXPECT_EQ(u32_value(vendor.data), 2u);
+        engine.upload(slave, 0x1018, 4, [&](uint8_t, const SdoResult& result) {
+            serial.set_value(u32_value(result.data));
+        });
+    });
+    std::vector<std::future<SdoResult>> errors;
+    for (int round = 0; round < 20; ++round) {
+        for (uint8_t id = 1; id <= kSlaves; ++id) {
+            errors.push_back(engine.upload(id, 0x1003, 1));
+        }
+    }
+    auto serial_future = serial.get_future();
+    ASSERT_EQ(serial_future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+    EXPECT_EQ(serial_future.get(), 1002u);
+    if (process_cores.size() > 1) { // kept off the RT core
+        EXPECT_EQ(polling_cores, non_rt_cores({rt_core}));
+    }
+    for (auto& future : errors) {
+        ASSERT_EQ(future.wait_for(std::chrono::seconds(5)), std::future_status::ready);
+        EXPECT_EQ(future.get().status, SdoStatus::Ok);
+    }
+
+    engine.stop();
+    line.stop();
+    EXPECT_GT(line.cycles(), 0u);
+    EXPECT_EQ(line.star_manager().committedCycle(), line.cycles()); // the cycle never waited on the mailbox
+    EXPECT_EQ(engine.stats().completed, 20u * kSlaves + 2);
+}
+
+// ============================================================================
+// TEST CASE 5: Shutdown Cancels What Is Left
+// ============================================================================
+
+TEST_F(SdoEngineTest, DestructorCancelsOutstandingRequests) {
+    std::future<SdoResult> sent;
+    std::future<SdoResult> waiting;
+    {
+        SdoEngine engine(mailbox_);
+        sent = engine.upload(1, 0x1018, 1);
+        waiting = engine.upload(1, 0x1018, 2);
+        engine.upload(2, 0x1018, 1, [](uint8_t, const SdoResult&) { throw std::runtime_error("consumer bug"); });
+        engine.poll(); // first of slave 1 and the one of slave 2 are on the wire
+        EXPECT_EQ(engine.in_flight(), 2u);
+    }
+    EXPECT_EQ(sent.get().status, SdoStatus::Cancelled);
+    EXPECT_EQ(waiting.get().status, SdoStatus::Cancelled);
+
+    // the abandoned mailboxes take new requests
+    SdoEngine engine(mailbox_);
+    engine.upload(2, 0x1018, 1, [](uint8_t, const SdoResult&) { throw std::runtime_error("consumer bug"); });
+    auto after = engine.upload(1, 0x1018, 3);
+    drive(engine, after);
+    EXPECT_EQ(after.get().status, SdoStatus::Ok);
+    EXPECT_EQ(engine.stats().callback_failures, 1u);
+}
+
+// ============================================================================
+// TEST CASE 6: Parallel Bring-up and Warm Restart
+// ============================================================================
+
+TEST_F(SdoEngineTest, ConfiguratorSkipsUnchangedSlavesOnWarmRestart) {
+    mailbox_.setLatency(std::chrono::milliseconds(1));
+    std::vector<SlaveConfiguration> line;
+    for (uint8_t id = 1; id <= kSlaves; ++id) {
+        SlaveConfiguration configuration{id, standard_pdo_mapping()};
+        configuration.writes.push_back({0x6072, 0, {0xE8, 0x03}});       // max torque
+        configuration.writes.push_back({0x6065, 0, u32_bytes(10000)});   // following error window
+        for (const SdoWrite& write : configuration.writes) {
+            mailbox_.setObject(id, write.index, write.subindex, std::vector<uint8_t>(write.value.size(), 0));
+        }
+        line.push_back(configuration);
+    }
+    const size_t writes_per_slave = line[0].writes.size();
+    ASSERT_EQ(writes_per_slave, 2u * 5 + 5 + 8 + 2);
+
+    ConfigCache cache;
+    SdoEngine engine(mailbox_);
+    SlaveConfigurator configurator(engine, cache);
+
+    // cold start: every slave written, in parallel
+    const ConfigureReport cold = configurator.configure(line);
+    EXPECT_EQ(cold.configured, kSlaves);
+    EXPECT_EQ(cold.failed, 0u);
+    EXPECT_EQ(cold.writes, kSlaves * writes_per_slave);
+    EXPECT_EQ(mailbox_.max_outstanding(), kSlaves);
+    // one slave after another would take kSlaves * writes_per_slave mailbox round trips
+    EXPECT_LT(cold.elapsed, std::chrono::milliseconds(kSlaves * writes_per_slave));
+    EXPECT_EQ(mailbox_.object(4, 0x1A00, 0), std::vector<uint8_t>{8});
+    EXPECT_EQ(mailbox_.object(4, 0x1A00, 2), u32_bytes(0x60640020));
+    EXPECT_EQ(mailbox_.object(4, 0x1C13, 1), (std::vector<uint8_t>{0x00, 0x1A}));
+    EXPECT_EQ(u32_value(mailbox_.object(4, 0x6065, 0)), 10000u);
+
+    // restart of the master: the cache comes back from disk
+    const std::string path = ::testing::TempDir() + "star_config_cache.txt";
+    cache.save(path);
+    ConfigCache restarted;
+    restarted.load(path);
+    EXPECT_EQ(restarted.size(), kSlaves);
+    SlaveConfigurator warm_configurator(engine, restarted);
+
+    // unchanged line: identities only, nothing written
+    const uint64_t requests_before = mailbox_.requests();
+    const ConfigureReport warm = warm_configurator.configure(line);
+    EXPECT_EQ(warm.skipped, kSlaves);
+    EXPECT_EQ(warm.writes, 0u);
+    EXPECT_EQ(mailbox_.requests() - requests_before, kSlaves);
+    EXPECT_LT(warm.elapsed, cold.elapsed);
+
+    // one parameter changed, one drive swapped (new serial): exactly those two are written
+    line[2].writes.back().value = u32_bytes(20000);
+    mailbox_.setObject(6, 0x1018, 4, u32_bytes(9999));
+    const ConfigureReport changed = warm_configurator.configure(line);
+    EXPECT_EQ(changed.configured, 2u);
+    EXPECT_EQ(changed.skipped, kSlaves - 2);
+    EXPECT_EQ(changed.slaves[2].outcome, SlaveConfigResult::Outcome::Configured);
+    EXPECT_EQ(changed.slaves[5].outcome, SlaveConfigResult::Outcome::Configured);
+    EXPECT_EQ(u32_value(mailbox_.object(3, 0x6065, 0)), 20000u);
+    std::remove(path.c_str());
+}
+
+// ============================================================================
+// TEST CASE 7: Failed Slaves Are Reported and Retried
+// ============================================================================
+
+TEST_F(SdoEngineTest, ConfiguratorReportsAndRetriesFailedSlaves) {
+    mailbox_.setLatency(std::chrono::microseconds(100));
+    std::vector<SlaveConfiguration> line = {
+        {1, {{0x6072, 0, {0xE8, 0x03}}}},
+        {2, {{0x6072, 0, {0xE8, 0x03}}}}, // object missing on this drive
+        {3, {{0x6072, 0, {0xE8, 0x03}}}}, // never answers
+    };
+    mailbox_.setObject(1, 0x6072, 0, {0, 0});
+    mailbox_.setObject(3, 0x6072, 0, {0, 0});
+    mailbox_.setResponsive(3, false);
+
+    ConfigCache cache;
+    SdoEngine engine(mailbox_, std::chrono::milliseconds(10));
+    engine.start();
+    SlaveConfigurator configurator(engine, cache);
+    ConfigureReport report = configurator.configure(line);
+
+    EXPECT_EQ(report.configured, 1u);
+    EXPECT_EQ(report.failed, 2u);
+    EXPECT_EQ(report.slaves[1].outcome, SlaveConfigResult::Outcome::Failed);
+    EXPECT_EQ(report.slaves[1].status, SdoStatus::Aborted);
+    EXPECT_EQ(report.slaves[1].abort_code, kSdoAbortObjectMissing);
+    EXPECT_EQ(report.slaves[1].index, 0x6072u);
+    EXPECT_EQ(report.slaves[2].status, SdoStatus::Timeout);
+    EXPECT_EQ(report.slaves[2].index, 0x1018u); // identity read already
+    EXPECT_EQ(cache.size(), 1u);
+
+    // fixed: the failed slaves are configured on the next start, the good one skipped
+    mailbox_.setObject(2, 0x6072, 0, {0, 0});
+    mailbox_.setResponsive(3, true);
+    report = configurator.configure(line);
+    EXPECT_EQ(report.configured, 2u);
+    EXPECT_EQ(report.skipped, 1u);
+    EXPECT_EQ(cache.size(), 3u);
+
+    EXPECT_NE(configuration_hash(line[0]), configuration_hash({1, {{0x6072, 0, {0xE9, 0x03}}}}));
+    EXPECT_EQ(configuration_hash(line[0]), configuration_hash(line[1])); // not the slave id
+}
+
+TEST_F(SdoEngineTest, ConfiguratorStopsASlaveAtItsFirstFailedWrite) {
+    // slave 1 lacks TxPDO entry 3: nothing after it may reach the drive
+    std::vector<SlaveConfiguration> line = {{1, standard_pdo_mapping()}, {2, standard_pdo_mapping()}};
+    for (const SlaveConfiguration& configuration : line) {
+        for (const SdoWrite& write : configuration.writes) {
+            if (configuration.slave_id == 1 && write.index == 0x1A00 && write.subindex == 3) {
+                continue;
+            }
+            mailbox_.setObject(configuration.slave_id, write.index, write.subindex,
+                               std::vector<uint8_t>(write.value.size(), 0));
+        }
+    }
+
+    ConfigCache cache;
+    SdoEngine engine(mailbox_);
+    SlaveConfigurator configurator(engine, cache);
+    const ConfigureReport report = configurator.configure(line);
+
+    EXPECT_EQ(report.configured, 1u);
+    EXPECT_EQ(report.failed, 1u);
+    EXPECT_EQ(report.slaves[0].status, SdoStatus::Aborted);
+    EXPECT_EQ(report.slaves[0].index, 0x1A00u);
+    EXPECT_EQ(report.slaves[0].subindex, 3u);
+    // RxPDO (10 writes), then TxPDO up to the failed entry (5)
+    EXPECT_EQ(report.writes, line[1].writes.size() + 15);
+    EXPECT_EQ(mailbox_.object(1, 0x1A00, 0), std::vector<uint8_t>{0});
+    EXPECT_EQ(mailbox_.object(1, 0x1C13, 0), std::vector<uint8_t>{0});
+    EXPECT_EQ(mailbox_.object(1, 0x1C13, 1), (std::vector<uint8_t>{0, 0})); // PDO never assigned
+    EXPECT_EQ(mailbox_.object(2, 0x1C13, 1), (std::vector<uint8_t>{0x00, 0x1A}));
+
+    line.push_back({2, {}});
+    const uint64_t requests_before = mailbox_.requests();
+    EXPECT_THROW(configurator.configure(line), std::invalid_argument);
+    EXPECT_EQ(mailbox_.requests(), requests_before);
+}
@@ -0,0 +1,333 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <limits>
+#include "cpu_dispatch.hpp"
+#include "simd_kernels.hpp"
+#include "slave_columns.hpp"
+#include "data_structuring.hpp"
+
+// Every kernel is run at every SIMD level this CPU supports and compared with
+// the scalar result, so a level that is wrong on some box shows up here.
+
+namespace {
+
+const SimdLevel kAllLevels[] = {SimdLevel::Scalar, SimdLevel::SSE42, SimdLevel::AVX2, SimdLevel::AVX512};
+
+// Deterministic pseudo-random bytes (no <random> distributions: same bytes on every platform)
+std::vector<uint8_t> make_image(size_t count, size_t stride, uint32_t seed) {
+    std::vector<uint8_t> image(count * stride);
+    uint32_t state = seed;
+    for (auto& byte : image) {
+        state = state * 1664525u + 1013904223u;
+        byte = static_cast<uint8_t>(state >> 24);
+    }
+    return image;
+}
+
+} // namespace
+
+// ============================================================================
+// TEST FIXTURE
+// ============================================================================
+
+class SimdKernelsTest : public ::testing::Test {
+protected:
+    void TearDown() override {
+        reset_simd_level();
+    }
+};
+
+// ============================================================================
+// TEST CASE 1: Dispatch
+// ============================================================================
+
+TEST_F(SimdKernelsTest, ForcingLevelsChangesActiveLevel) {
+    EXPECT_TRUE(simd_level_supported(SimdLevel::Scalar));
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            EXPECT_THROW(force_simd_level(level), std::invalid_argument);
+            continue;
+        }
+        force_simd_level(level);
+        EXPECT_EQ(active_simd_level(), level);
+    }
+
+    reset_simd_level();
+    EXPECT_LE(active_simd_level(), detect_simd_level());
+}
+
+// ============================================================================
+// TEST CASE 2: Batch decode matches ReadState::parse
+// ============================================================================
+
+TEST_F(SimdKernelsTest, BatchDecodeMatchesParse) {
+    // 37 frames: full vectors at every width plus a scalar tail; stride with padding
+    const size_t count = 37;
+    const size_t stride = PdoInputLayout::size + 3;
+    std::vector<uint8_t> image = make_image(count, stride, 7);
+
+    ReadState parser;
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        SlaveColumnStore store(count);
+        const SlaveColumns& cols = store.columns();
+        decode_frames(image.data(), count, stride, cols);
+
+        for (size_t i = 0; i < count; ++i) {
+            std::vector<uint8_t> frame(image.begin() + i * stride, image.begin() + i * stride + PdoInputLayout::size);
+            SlaveRealTimeData expected = parser.parse(frame);
+
+            EXPECT_EQ(cols.status_word[i], expected.status_word) << simd_level_name(level) << " slot " << i;
+            EXPECT_EQ(cols.actual_position[i], expected.actual_position) << simd_level_name(level);
+            EXPECT_EQ(cols.actual_velocity[i], expected.actual_velocity) << simd_level_name(level);
+            EXPECT_EQ(cols.actual_torque[i], expected.actual_torque) << simd_level_name(level);
+            EXPECT_EQ(cols.mode_display[i], expected.mode_display) << simd_level_name(level);
+            EXPECT_EQ(cols.error_code[i], expected.error_code) << simd_level_name(level);
+            EXPECT_EQ(cols.system_status[i], expected.system_status) << simd_level_name(level);
+            // bit-exact: random bytes include NaN patterns
+            EXPECT_EQ(std::memcmp(&cols.motor_temperature[i], &expected.motor_temperature, sizeof(float)), 0)
+                << simd_level_name(level);
+        }
+    }
+}
+
+// ============================================================================
+// TEST CASE 3: Change detection
+// ============================================================================
+
+TEST_F(SimdKernelsTest, DetectsChangedFrames) {
+    const size_t count = 50;
+    const size_t stride = PdoInputLayout::size;
+    std::vector<uint8_t> previous = make_image(count, stride, 3);
+    std::vector<uint8_t> current = previous;
+
+    // first byte, last byte of a frame, middle of a frame, and the very last byte of the image
+    current[0] ^= 0x01;
+    current[5 * stride + stride - 1] ^= 0x80;
+    current[17 * stride + 9] ^= 0x10;
+    current[count * stride - 1] ^= 0xFF;
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        std::vector<uint8_t> changed(count, 0xAA);
+        size_t n = detect_changed_frames(current.data(), previous.data(), count, stride, changed.data());
+
+        EXPECT_EQ(n, 4u) << simd_level_name(level);
+        for (size_t i = 0; i < count; ++i) {
+            bool expected = (i == 0 || i == 5 || i == 17 || i == count - 1);
+            EXPECT_EQ(changed[i], expected ? 1 : 0) << simd_level_name(level) << " frame " << i;
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, IdenticalImagesHaveNoChanges) {
+    const size_t count = 64;
+    std::vector<uint8_t> image = make_image(count, PdoInputLayout::size, 11);
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        std::vector<uint8_t> changed(count, 1);
+        EXPECT_EQ(detect_changed_frames(image.data(), image.data(), count, PdoInputLayout::size, changed.data()), 0u);
+        for (uint8_t flag : changed) {
+            EXPECT_EQ(flag, 0);
+        }
+    }
+}
+
+TEST_F(SimdKernelsTest, FindsChangedColumnEntries) {
+    const size_t count = 77; // 2 AVX-512 blocks, then a scalar tail
+    std::vector<uint16_t> previous(count);
+    for (size_t i = 0; i < count; ++i) {
+        previous[i] = static_cast<uint16_t>(i * 257);
+    }
+    std::vector<uint16_t> current = previous;
+    const std::vector<uint16_t> expected = {0, 7, 8, 31, 32, 63, 76};
+    for (uint16_t i : expected) {
+        current[i] ^= static_cast<uint16_t>(i % 2 ? 0x8000 : 0x0001); // high and low byte of a lane
+    }
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        std::vector<uint16_t> changed(count, 0xFFFF);
+        ASSERT_EQ(find_changed_u16(current.data(), previous.data(), count, changed.data()), expected.size())
+            << simd_level_name(level);
+        changed.resize(expected.size());
+        EXPECT_EQ(changed, expected) << simd_level_name(level);
+        EXPECT_EQ(find_changed_u16(previous.data(), previous.data(), count, changed.data()), 0u);
+        EXPECT_EQ(find_changed_u16(nullptr, nullptr, 0, changed.data()), 0u);
+    }
+}
+
+TEST_F(SimdKernelsTest, SanitizesFloatsLikeScalar) {
+    const size_t count = 53; // blocks with and without special values, then a scalar tail
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    const float inf = std::numeric_limits<float>::infinity();
+    const float denormal = std::numeric_limits<float>::denorm_min() * 3.0f;
+    std::vector<float> input(count);
+    for (size_t i = 0; i < count; ++i) {
+        input[i] = 30.0f + static_cast<float>(i);
+    }
+    input[3] = nan;
+    input[17] = -inf;
+    input[18] = denormal;
+    input[19] = -denormal;
+    input[33] = 500.0f; // above max
+    input[50] = nan;
+
+    FloatPolicy policy;
+    policy.flush_denormals = true;
+    policy.replace_non_finite = true;
+    policy.min = -40.0f;
+    policy.max = 200.0f;
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        std::vector<float> values = input;
+        std::vector<float> last_good(count, 25.0f);
+        last_good[50] = nan; // no good value yet
+        std::vector<uint8_t> flags(count, 0x10);
+        EXPECT_EQ(sanitize_f32(values.data(), last_good.data(), flags.data(), 0x01, count, policy), 3u)
+            << simd_level_name(level);
+
+        EXPECT_EQ(values[3], 25.0f) << simd_level_name(level);
+        EXPECT_EQ(values[17], 25.0f);
+        EXPECT_EQ(values[18], 0.0f);
+        EXPECT_TRUE(std::signbit(values[19]) && values[19] == 0.0f);
+        EXPECT_EQ(values[33], 200.0f);
+        EXPECT_TRUE(std::isnan(values[50])); // flagged, nothing to replace it with
+        for (size_t i : {size_t{3}, size_t{17}, size_t{50}}) {
+            EXPECT_EQ(flags[i], 0x11) << simd_level_name(level) << " value " << i;
+        }
+        for (size_t i = 0; i < count; ++i) {
+            if (i != 3 && i != 17 && i != 50) {
+                EXPECT_EQ(flags[i], 0x10) << simd_level_name(level) << " value " << i;
+                EXPECT_EQ(last_good[i], values[i]) << simd_level_name(level) << " value " << i;
+            }
+        }
+        EXPECT_EQ(values[0], 30.0f);
+        EXPECT_EQ(last_good[3], 25.0f);
+
+        // the default policy passes everything through; NaN still never becomes a last good value
+        values = input;
+        EXPECT_EQ(sanitize_f32(values.data(), last_good.data(), flags.data(), 0x01, count, FloatPolicy{}), 0u);
+        EXPECT_EQ(std::memcmp(values.data(), input.data(), count * sizeof(float)), 0);
+        EXPECT_EQ(last_good[3], 25.0f);
+        EXPECT_EQ(last_good[33], 500.0f);
+    }
+}
+
+// ============================================================================
+// TEST CASE 4: SoA reductions
+// ============================================================================
+
+TEST_F(SimdKernelsTest, ReductionsAgreeAcrossLevels) {
+    const size_t count = 259; // not a multiple of any vector width
+    std::vector<float> temperatures(count);
+    std::vector<int16_t> torques(count);
+    std::vector<uint64_t> timestamps(count);
+    std::vector<uint16_t> status(count);
+
+    int64_t expected_sum = 0;
+    for (size_t i = 0; i < count; ++i) {
+        temperatures[i] = 20.0f + static_cast<float>((i * 37) % 101) * 0.5f;
+        torques[i] = static_cast<int16_t>(i % 2 ? INT16_MAX - i : INT16_MIN + i);
+        timestamps[i] = 0x8000000000000000ULL + 1000 + ((i * 7919) % count);
+        status[i] = static_cast<uint16_t>(i % 5 == 0 ? 0x0008 : 0x0237);
+        expected_sum += torques[i];
+    }
+    temperatures[200] = 99.25f;
+    temperatures[13] = std::numeric_limits<float>::quiet_NaN(); // skipped, not propagated
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        EXPECT_FLOAT_EQ(reduce_max_f32(temperatures.data(), count), 99.25f) << simd_level_name(level);
+        EXPECT_EQ(reduce_sum_i16(torques.data(), count), expected_sum) << simd_level_name(level);
+        EXPECT_EQ(reduce_min_u64(timestamps.data(), count), 0x8000000000000000ULL + 1000) << simd_level_name(level);
+        EXPECT_EQ(count_flagged_u16(status.data(), count, 0x0008), (count + 4) / 5) << simd_level_name(level);
+    }
+}
+
+TEST_F(SimdKernelsTest, ReductionsOfEmptyInput) {
+    EXPECT_TRUE(std::isinf(reduce_max_f32(nullptr, 0)));
+    EXPECT_EQ(reduce_sum_i16(nullptr, 0), 0);
+    EXPECT_EQ(reduce_min_u64(nullptr, 0), std::numeric_limits<uint64_t>::max());
+    EXPECT_EQ(count_flagged_u16(nullptr, 0, 0xFFFF), 0u);
+}
+
+// ============================================================================
+// TEST CASE 5: Fixed-point columns
+// ============================================================================
+
+TEST_F(SimdKernelsTest, DecodesAndConvertsFixedPointColumns) {
+    const size_t count = 45;
+    const size_t stride = PdoInputLayout::size;
+    std::vector<uint8_t> image(count * stride);
+    for (size_t i = 0; i < count; ++i) {
+        int16_t raw = static_cast<int16_t>(static_cast<int>(i) * 37 - 800);
+        insert<int16_t>(image, i * stride + PdoInputLayout::motor_temperature, raw);
+        image[i * stride + PdoInputLayout::motor_temperature + 2] = 0xEE; // bytes past the int16 are ignored
+    }
+
+    for (SimdLevel level : kAllLevels) {
+        if (!simd_level_supported(level)) {
+            continue;
+        }
+        force_simd_level(level);
+
+        std::vector<int32_t> raw(count);
+        decode_scaled_field(image.data(), count, stride, PdoInputLayout::motor_temperature,
+                            ValueEncoding::Int16, raw.data());
+        std::vector<float> celsius(count);
+        fixed_to_float(raw.data(), count, 0.1f, 0.0f, celsius.data());
+
+        for (size_t i = 0; i < count; ++i) {
+            int32_t expected = static_cast<int32_t>(i) * 37 - 800;
+            EXPECT_EQ(raw[i], expected) << simd_level_name(level) << " slot " << i;
+            EXPECT_FLOAT_EQ(celsius[i], static_cast<float>(expected) * 0.1f) << simd_level_name(level);
+        }
+        // Integer-only reduction straight on the fixed-point column
+        EXPECT_EQ(reduce_max_i32(raw.data(), count), 44 * 37 - 800) << simd_level_name(level);
+    }
+
+    std::vector<int32_t> raw(count);
+    EXPECT_THROW(decode_scaled_field(image.data(), count, stride, 0, ValueEncoding::Float32, raw.data()),
+                 std::invalid_argument);
+    EXPECT_EQ(reduce_max_i32(nullptr, 0), std::numeric_limits<int32_t>::min());
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}
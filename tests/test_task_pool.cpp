@@ -0,0 +1,233 @@
+#include <gtest/gtest.h>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include "task_pool.hpp"
+#include "snapshot_analytics.hpp"
+#include "thread_affinity.hpp"
+#include "Star_Manager.hpp"
+#include "pdo_test_utils.hpp"
+
+#ifdef __linux__
+#include <sched.h>
+#endif
+
+// ============================================================================
+// TEST CASE 1: Core Selection
+// ============================================================================
+
+TEST(TaskPoolTest, NonRtCoresExcludeLineCores) {
+    std::vector<int> all = allowed_cores();
+    ASSERT_FALSE(all.empty());
+
+    std::vector<int> rest = non_rt_cores({all.front()});
+    EXPECT_EQ(rest.size(), all.size() - 1);
+    EXPECT_EQ(std::find(rest.begin(), rest.end(), all.front()), rest.end());
+
+    EXPECT_EQ(non_rt_cores({}).size(), all.size());
+    EXPECT_THROW(TaskPool({-1}), std::invalid_argument);
+    // every core taken by a line: no silent fallback onto the RT cores
+    EXPECT_THROW(TaskPool(non_rt_cores(all)), std::invalid_argument);
+}
+
+// ============================================================================
+// TEST CASE 2: Running, Nesting and Stealing
+// ============================================================================
+
+TEST(TaskPoolTest, RunsEverySubmittedTask) {
+    TaskPool pool(TaskPool::Unpinned{}, 3);
+    EXPECT_EQ(pool.worker_count(), 3u);
+    TaskKind kind = pool.register_kind("count");
+    EXPECT_EQ(pool.register_kind("count"), kind); // same name, same kind
+
+    std::atomic<int> sum{0};
+    for (int i = 1; i <= 100; ++i) {
+        pool.submit(kind, [&sum, i] { sum += i; });
+    }
+    pool.wait_idle();
+
+    EXPECT_EQ(sum.load(), 5050);
+    EXPECT_EQ(pool.completed(), 100u);
+    EXPECT_THROW(pool.submit(static_cast<TaskKind>(kind + 1), [] {}), std::out_of_range);
+}
+
+TEST(TaskPoolTest, IdleWorkerStealsNestedTasks) {
+    TaskPool pool(TaskPool::Unpinned{}, 2);
+    TaskKind parent = pool.register_kind("parent");
+    TaskKind child = pool.register_kind("child");
+
+    std::mutex mutex;
+    std::set<std::thread::id> child_threads;
+    std::thread::id parent_thread;
+
+    pool.submit(parent, [&] {
+        parent_thread = std::this_thread::get_id();
+        for (int i = 0; i < 10; ++i) {
+            pool.submit(child, [&] {
+                std::lock_guard<std::mutex> lock(mutex);
+                child_threads.insert(std::this_thread::get_id());
+            });
+        }
+        // children sit in this worker's deque while it is busy: only a thief can run them now
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    });
+    pool.wait_idle();
+
+    EXPECT_EQ(pool.completed(), 11u);
+    EXPECT_GT(pool.stolen(), 0u);
+    EXPECT_TRUE(child_threads.count(parent_thread) == 0 || child_threads.size() > 1);
+}
+
+// ============================================================================
+// TEST CASE 3: Per-Task Metrics
+// ============================================================================
+
+TEST(TaskPoolTest, RecordsLatencyAndFailuresPerKind) {
+    TaskPool pool(TaskPool::Unpinned{}, 2);
+    TaskKind slow = pool.register_kind("slow");
+    TaskKind failing = pool.register_kind("failing");
+
+    for (int i = 0; i < 4; ++i) {
+        pool.submit(slow, [] { std::this_thread::sleep_for(std::chrono::milliseconds(2)); });
+    }
+    pool.submit(failing, [] { throw std::runtime_error("export target gone"); });
+    pool.wait_idle();
+
+    TaskKindStats slow_stats = pool.stats(slow);
+    EXPECT_EQ(slow_stats.name, "slow");
+    EXPECT_EQ(slow_stats.run_time.count, 4u);
+    EXPECT_GE(slow_stats.run_time.min_ns, 2000000u);
+    EXPECT_EQ(slow_stats.queue_wait.count, 4u);
+    EXPECT_EQ(slow_stats.failed, 0u);
+
+    TaskKindStats failing_stats = pool.stats(failing);
+    EXPECT_EQ(failing_stats.failed, 1u);
+    EXPECT_EQ(failing_stats.run_time.count, 1u);
+
+    // the worker survived the exception
+    std::atomic<bool> ran{false};
+    pool.submit(slow, [&] { ran = true; });
+    pool.wait_idle();
+    EXPECT_TRUE(ran);
+}
+
+TEST(TaskPoolTest, PinsWorkersToGivenCores) {
+    std::vector<int> cores = allowed_cores();
+    TaskPool pool({cores.back()});
+    TaskKind kind = pool.register_kind("where");
+
+    int cpu = -1;
+    pool.submit(kind, [&] {
+#ifdef __linux__
+        cpu = sched_getcpu();
+#endif
+    });
+    pool.wait_idle();
+#ifdef __linux__
+    EXPECT_EQ(cpu, cores.back());
+#endif
+}
+
+// ============================================================================
+// TEST CASE 4: Analytics on Committed Snapshots
+// ============================================================================
+
+TEST(SnapshotAnalyticsTest, SpawnsJobsPerCommittedCycle) {
+    StarManager manager;
+    TaskPool pool(TaskPool::Unpinned{}, 2);
+    SnapshotAnalytics analytics(pool, manager);
+
+    std::mutex mutex;
+    std::vector<uint64_t> stats_cycles;
+    std::vector<int32_t> group_positions;
+    int decimated = 0;
+
+    analytics.add_cycle_job("statistics", [&](const StarSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        stats_cycles.push_back(snapshot.cycle);
+    });
+    analytics.add_group_job("axis 1 trend", {2, 3}, [&](const StarSnapshot& snapshot, const std::vector<uint8_t>& ids) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (uint8_t id : ids) {
+            group_positions.push_back(snapshot.getSlaveData(id).actual_position);
+        }
+    });
+    analytics.add_cycle_job("decimation", [&](const StarSnapshot&) {
+        std::lock_guard<std::mutex> lock(mutex);
+        ++decimated;
+    }, 2);
+
+    EXPECT_EQ(analytics.poll(), 0u); // nothing committed
+
+    for (uint8_t id : {1, 2, 3}) {
+        manager.input_handler(id, generate_pdo_buffer(0x1234, id * 100, 0, 0, 0x08, 0, 0xFF, 40.0f));
+    }
+    manager.commit();
+    EXPECT_EQ(analytics.poll(), 2u); // cycle 1: statistics + group, no decimation
+    EXPECT_EQ(analytics.poll(), 0u); // same cycle again
+
+    manager.commit();
+    manager.commit();
+    manager.commit();
+    EXPECT_EQ(analytics.poll(), 3u); // cycle 4, cycles 2 and 3 never seen
+    pool.wait_idle();
+
+    EXPECT_EQ(analytics.last_cycle(), 4u);
+    EXPECT_EQ(analytics.skipped_cycles(), 2u);
+    EXPECT_EQ(stats_cycles.size(), 2u);
+    EXPECT_EQ(decimated, 1);
+    EXPECT_EQ(group_positions, (std::vector<int32_t>{200, 300, 200, 300}));
+
+    EXPECT_EQ(pool.stats(pool.register_kind("statistics")).run_time.count, 2u);
+    EXPECT_THROW(analytics.add_group_job("empty", {}, [](const StarSnapshot&, const std::vector<uint8_t>&) {}),
+                 std::invalid_argument);
+    EXPECT_THROW(analytics.add_cycle_job("never", [](const StarSnapshot&) {}, 0), std::invalid_argument);
+}
+
+TEST(SnapshotAnalyticsTest, JobRateHoldsWhenPollsMissCommits) {
+    StarManager manager;
+    TaskPool pool(TaskPool::Unpinned{}, 1);
+    SnapshotAnalytics analytics(pool, manager);
+
+    std::mutex mutex;
+    std::vector<uint64_t> every_2;
+    std::vector<uint64_t> every_3;
+    analytics.add_cycle_job("every 2", [&](const StarSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        every_2.push_back(snapshot.cycle);
+    }, 2);
+    analytics.add_cycle_job("every 3", [&](const StarSnapshot& snapshot) {
+        std::lock_guard<std::mutex> lock(mutex);
+        every_3.push_back(snapshot.cycle);
+    }, 3);
+
+    // the poller only ever sees the odd cycles
+    for (int cycle = 1; cycle <= 20; ++cycle) {
+        manager.commit();
+        if (cycle % 2 == 1) {
+            analytics.poll();
+        }
+    }
+    pool.wait_idle();
+
+    std::sort(every_2.begin(), every_2.end());
+    std::sort(every_3.begin(), every_3.end());
+    EXPECT_EQ(every_2, (std::vector<uint64_t>{3, 5, 7, 9, 11, 13, 15, 17, 19}));
+    EXPECT_EQ(every_3, (std::vector<uint64_t>{3, 7, 11, 15, 19}));
+    EXPECT_EQ(analytics.skipped_cycles(), 9u);
+}
+
+// ============================================================================
+// MAIN FUNCTION
+// ============================================================================
+
+int main(int argc, char **argv) {
+    ::testing::InitGoogleTest(&argc, argv);
+    return RUN_ALL_TESTS();
+}